@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+//  AlgorithmsBenchmark.cc
+//  Compares the Algorithms sort functions against std::sort from 10K to
+//  10M elements, the bulk-build paths of Map and Set against sorted
+//  inserts, and the SIMD linear search against a plain loop. Prints
+//  median/p99/min time per element, optionally writes JSON (-json path).
+//  The number of timed runs for the biggest size can be changed
+//  with -runs N (smaller sizes get more runs).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Containers/Algorithms.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/String/StringBuilder.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include <algorithm>
+
+using namespace Oryol;
+
+class AlgorithmsBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(AlgorithmsBenchmarkApp);
+
+namespace {
+
+const int MaxElements = 10000000;
+const int NumSetElements = 10000;
+const int NumSearchElements = 1000;
+
+Array<uint32_t> input;
+Array<uint32_t> work;
+
+//------------------------------------------------------------------------------
+// pseudo-random 32-bit values
+void
+makeInput(int num) {
+    input.Clear();
+    input.Reserve(num);
+    uint32_t x = 2463534242;
+    for (int i = 0; i < num; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        input.Add(x);
+    }
+}
+
+//------------------------------------------------------------------------------
+// copy the first num input values into the work array (not timed)
+void
+resetWork(int num) {
+    work.Clear();
+    for (int i = 0; i < num; i++) {
+        work.Add(input[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+sortBenchmarks(BenchmarkSuite& suite, int maxRuns) {
+    StringBuilder name;
+    for (int num = 10000; num <= MaxElements; num *= 10) {
+        // fewer runs for the big sizes, more for the small ones
+        suite.NumWarmupRuns = (num >= 1000000) ? 1 : 3;
+        suite.NumRuns = std::max(maxRuns, int(int64_t(maxRuns) * 1000000 / num));
+        suite.NumRuns = std::min(suite.NumRuns, 31);
+        auto setup = [num] { resetWork(num); };
+
+        name.Format(64, "std::sort.%d", num);
+        suite.Run(name.AsCStr(), num, setup, [] {
+            std::sort(work.begin(), work.end());
+            BenchmarkSuite::DoNotOptimize(work);
+        });
+        name.Format(64, "Algorithms::Sort.%d", num);
+        suite.Run(name.AsCStr(), num, setup, [] {
+            Algorithms::Sort(work.MakeSlice());
+            BenchmarkSuite::DoNotOptimize(work);
+        });
+        name.Format(64, "Algorithms::ParallelSort.%d", num);
+        suite.Run(name.AsCStr(), num, setup, [] {
+            Algorithms::ParallelSort(work.MakeSlice());
+            BenchmarkSuite::DoNotOptimize(work);
+        });
+        name.Format(64, "Algorithms::RadixSort.%d", num);
+        suite.Run(name.AsCStr(), num, setup, [] {
+            Algorithms::RadixSort(work.MakeSlice());
+            BenchmarkSuite::DoNotOptimize(work);
+        });
+    }
+    suite.NumWarmupRuns = 3;
+    suite.NumRuns = 31;
+}
+
+//------------------------------------------------------------------------------
+void
+bulkBenchmarks(BenchmarkSuite& suite) {
+    static Set<uint32_t> set;
+    suite.Run("Set.Add", NumSetElements, [] {
+        set.Clear();
+        for (int i = 0; i < NumSetElements; i++) {
+            set.Add(input[i]);
+        }
+        BenchmarkSuite::DoNotOptimize(set);
+    });
+    suite.Run("Set.AddBulk", NumSetElements, [] {
+        set.Clear();
+        set.BeginBulk();
+        for (int i = 0; i < NumSetElements; i++) {
+            set.AddBulk(input[i]);
+        }
+        set.EndBulk();
+        BenchmarkSuite::DoNotOptimize(set);
+    });
+    static Map<uint32_t, int> map;
+    suite.Run("Map.Add", NumSetElements, [] {
+        map.Clear();
+        for (int i = 0; i < NumSetElements; i++) {
+            map.Add(input[i], i);
+        }
+        BenchmarkSuite::DoNotOptimize(map);
+    });
+    suite.Run("Map.AddBulk", NumSetElements, [] {
+        map.Clear();
+        map.BeginBulk();
+        for (int i = 0; i < NumSetElements; i++) {
+            map.AddBulk(input[i], i);
+        }
+        map.EndBulk();
+        BenchmarkSuite::DoNotOptimize(map);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+searchBenchmarks(BenchmarkSuite& suite) {
+    static Array<int> values;
+    for (int i = 0; i < NumSearchElements; i++) {
+        values.Add(i);
+    }
+    // search every 10th value, the average search covers half the array
+    suite.Run("FindIndex.loop", NumSearchElements / 10, [] {
+        int sum = 0;
+        for (int val = 0; val < NumSearchElements; val += 10) {
+            BenchmarkSuite::DoNotOptimize(val);
+            for (int i = 0; i < values.Size(); i++) {
+                if (values[i] == val) {
+                    sum += i;
+                    break;
+                }
+            }
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    suite.Run("FindIndex.Algorithms", NumSearchElements / 10, [] {
+        int sum = 0;
+        for (int val = 0; val < NumSearchElements; val += 10) {
+            BenchmarkSuite::DoNotOptimize(val);
+            sum += Algorithms::FindIndex(values.MakeSlice(), val);
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+AlgorithmsBenchmarkApp::OnRunning() {
+    BenchmarkSuite suite("AlgorithmsBenchmark");
+    makeInput(MaxElements);
+    sortBenchmarks(suite, OryolArgs.GetInt("-runs", 3));
+    bulkBenchmarks(suite);
+    searchBenchmarks(suite);
+    suite.PrintResults();
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+    input.Clear();
+    work.Clear();
+    return AppState::Cleanup;
+}
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//  BenchmarkSuite.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "BenchmarkSuite.h"
+#include "CountingAllocator.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include "Core/String/StringBuilder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+BenchmarkSuite::BenchmarkSuite(const char* name_) :
+name(name_) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+const BenchmarkSuite::Result&
+BenchmarkSuite::Run(const char* name, int numOps, std::function<void()> func) {
+    return this->Run(name, numOps, nullptr, func);
+}
+
+//------------------------------------------------------------------------------
+const BenchmarkSuite::Result&
+BenchmarkSuite::Run(const char* name, int numOps, std::function<void()> setup, std::function<void()> func) {
+    o_assert_dbg(name && func);
+    o_assert(numOps > 0);
+    o_assert(this->NumRuns > 0);
+
+    for (int i = 0; i < this->NumWarmupRuns; i++) {
+        if (setup) {
+            setup();
+        }
+        func();
+    }
+
+    // allocations are only counted if the CountingAllocator is installed
+    const CountingAllocator* counter = nullptr;
+    if (Memory::GetAllocator() == CountingAllocator::Instance()) {
+        counter = CountingAllocator::Instance();
+    }
+    int64_t numAllocs = 0;
+    int64_t numBytes = 0;
+    Array<double> nsPerOp;
+    nsPerOp.Reserve(this->NumRuns);
+    for (int i = 0; i < this->NumRuns; i++) {
+        if (setup) {
+            setup();
+        }
+        const int64_t allocs = counter ? counter->NumAllocs() : 0;
+        const int64_t bytes = counter ? counter->NumBytes() : 0;
+        // NOTE: Clock::Now() only has microsecond resolution
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        if (counter) {
+            numAllocs += counter->NumAllocs() - allocs;
+            numBytes += counter->NumBytes() - bytes;
+        }
+        const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        nsPerOp.Add(ns / numOps);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    Result& result = this->results.Add();
+    result.Name = name;
+    result.NumOps = numOps;
+    result.NumRuns = this->NumRuns;
+    result.MedianNs = nsPerOp[this->NumRuns / 2];
+    result.P99Ns = nsPerOp[std::min(this->NumRuns - 1, (this->NumRuns * 99 + 99) / 100 - 1)];
+    result.MinNs = nsPerOp[0];
+    if (counter) {
+        const double totalOps = double(numOps) * this->NumRuns;
+        result.AllocsPerOp = double(numAllocs) / totalOps;
+        result.BytesPerOp = double(numBytes) / totalOps;
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+const Array<BenchmarkSuite::Result>&
+BenchmarkSuite::Results() const {
+    return this->results;
+}
+
+//------------------------------------------------------------------------------
+void
+BenchmarkSuite::PrintResults() const {
+    Log::Info("%s (median / p99 / min ns per op, allocs and bytes per op):\n", this->name.AsCStr());
+    for (const Result& r : this->results) {
+        Log::Info("  %-36s %10.2f %10.2f %10.2f %8.2f %10.1f\n",
+            r.Name.AsCStr(), r.MedianNs, r.P99Ns, r.MinNs, r.AllocsPerOp, r.BytesPerOp);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+BenchmarkSuite::WriteJSON(StringBuilder& builder) const {
+    // benchmark names are plain identifiers, no escaping needed
+    builder.AppendFormat(256, "{\"suite\":\"%s\",\"results\":[\n", this->name.AsCStr());
+    for (int i = 0; i < this->results.Size(); i++) {
+        const Result& r = this->results[i];
+        builder.AppendFormat(512,
+            "{\"name\":\"%s\",\"ops\":%d,\"runs\":%d,\"median_ns\":%.3f,\"p99_ns\":%.3f,"
+            "\"min_ns\":%.3f,\"allocs_per_op\":%.4f,\"bytes_per_op\":%.2f}%s\n",
+            r.Name.AsCStr(), r.NumOps, r.NumRuns, r.MedianNs, r.P99Ns,
+            r.MinNs, r.AllocsPerOp, r.BytesPerOp,
+            (i + 1) < this->results.Size() ? "," : "");
+    }
+    builder.Append("]}\n");
+}
+
+//------------------------------------------------------------------------------
+bool
+BenchmarkSuite::WriteJSONFile(const char* path) const {
+    o_assert_dbg(path);
+    StringBuilder builder;
+    this->WriteJSON(builder);
+    #if ORYOL_WINDOWS
+    FILE* fp = nullptr;
+    if (0 != fopen_s(&fp, path, "wb")) {
+        fp = nullptr;
+    }
+    #else
+    FILE* fp = std::fopen(path, "wb");
+    #endif
+    if (nullptr == fp) {
+        return false;
+    }
+    const size_t len = size_t(builder.Length());
+    const bool success = (len == std::fwrite(builder.AsCStr(), 1, len, fp));
+    std::fclose(fp);
+    return success;
+}
+
+} // namespace Oryol
@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::BenchmarkSuite
+    @brief run micro-benchmarks and collect timing statistics
+
+    Each benchmark is a function which performs a number of operations.
+    The function is called a few times to warm up, and then for a number
+    of timed runs, the suite records the time per operation of each run
+    and reports the median, 99th percentile and minimum. An optional
+    setup function is called before each run outside of the timed
+    section.
+
+    If a CountingAllocator is installed as Memory backend, the suite
+    also reports the number of allocations and allocated bytes per
+    operation (otherwise these are -1).
+
+    The results can be printed to the Log, or written as JSON for
+    diffing the results of different commits.
+
+    @code
+    BenchmarkSuite suite("CoreBenchmarks");
+    suite.Run("Array.Add", 10000, [] {
+        Array<int> array;
+        for (int i = 0; i < 10000; i++) {
+            array.Add(i);
+        }
+        BenchmarkSuite::DoNotOptimize(array);
+    });
+    suite.PrintResults();
+    suite.WriteJSONFile("core.json");
+    @endcode
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include <functional>
+
+namespace Oryol {
+
+class StringBuilder;
+
+class BenchmarkSuite {
+public:
+    /// the result of a benchmark
+    struct Result {
+        /// name of the benchmark
+        String Name;
+        /// number of operations per run
+        int NumOps = 0;
+        /// number of timed runs
+        int NumRuns = 0;
+        /// median time per operation in nanoseconds
+        double MedianNs = 0.0;
+        /// 99th percentile time per operation in nanoseconds
+        double P99Ns = 0.0;
+        /// minimum time per operation in nanoseconds
+        double MinNs = 0.0;
+        /// allocations per operation (-1 if not counted)
+        double AllocsPerOp = -1.0;
+        /// allocated bytes per operation (-1 if not counted)
+        double BytesPerOp = -1.0;
+    };
+
+    /// constructor
+    BenchmarkSuite(const char* name);
+
+    /// number of untimed warm-up runs
+    int NumWarmupRuns = 3;
+    /// number of timed runs
+    int NumRuns = 31;
+
+    /// run a benchmark, func performs numOps operations
+    const Result& Run(const char* name, int numOps, std::function<void()> func);
+    /// run a benchmark, setup is called (untimed) before each run
+    const Result& Run(const char* name, int numOps, std::function<void()> setup, std::function<void()> func);
+
+    /// get all results
+    const Array<Result>& Results() const;
+    /// print the results to the Log
+    void PrintResults() const;
+    /// append the results as JSON
+    void WriteJSON(StringBuilder& builder) const;
+    /// write the results as JSON to a file
+    bool WriteJSONFile(const char* path) const;
+
+    /// prevent the compiler from optimizing away a value
+    template<class TYPE> static void DoNotOptimize(const TYPE& val);
+
+private:
+    String name;
+    Array<Result> results;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+BenchmarkSuite::DoNotOptimize(const TYPE& val) {
+    #if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&val) : "memory");
+    #else
+    static const void* volatile sink;
+    sink = &val;
+    #endif
+}
+
+} // namespace Oryol
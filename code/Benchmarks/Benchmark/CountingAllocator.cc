@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  CountingAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "CountingAllocator.h"
+#include <cstdlib>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+CountingAllocator*
+CountingAllocator::Instance() {
+    static CountingAllocator instance;
+    return &instance;
+}
+
+//------------------------------------------------------------------------------
+CountingAllocator::CountingAllocator(Allocator* backend_) :
+backend(backend_) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void*
+CountingAllocator::Alloc(int size) {
+    this->numAllocs.fetch_add(1, std::memory_order_relaxed);
+    this->numBytes.fetch_add(size, std::memory_order_relaxed);
+    return this->backend ? this->backend->Alloc(size) : std::malloc(size);
+}
+
+//------------------------------------------------------------------------------
+void*
+CountingAllocator::ReAlloc(void* ptr, int size) {
+    this->numAllocs.fetch_add(1, std::memory_order_relaxed);
+    this->numBytes.fetch_add(size, std::memory_order_relaxed);
+    return this->backend ? this->backend->ReAlloc(ptr, size) : std::realloc(ptr, size);
+}
+
+//------------------------------------------------------------------------------
+void
+CountingAllocator::Free(void* ptr) {
+    this->numFrees.fetch_add(1, std::memory_order_relaxed);
+    if (this->backend) {
+        this->backend->Free(ptr);
+    }
+    else {
+        std::free(ptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+CountingAllocator::Owns(const void* ptr) const {
+    // without backend, all pointers come from std::malloc, so this
+    // allocator can also free memory allocated before it was installed
+    return this->backend ? this->backend->Owns(ptr) : true;
+}
+
+//------------------------------------------------------------------------------
+void
+CountingAllocator::ReleaseThreadCache() {
+    if (this->backend) {
+        this->backend->ReleaseThreadCache();
+    }
+}
+
+//------------------------------------------------------------------------------
+int64_t
+CountingAllocator::NumAllocs() const {
+    return this->numAllocs.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int64_t
+CountingAllocator::NumFrees() const {
+    return this->numFrees.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int64_t
+CountingAllocator::NumBytes() const {
+    return this->numBytes.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::CountingAllocator
+    @brief allocator backend which counts allocations
+
+    Forwards to a backend allocator (or to std::malloc/free if no backend
+    is given) and counts the number of allocations and allocated bytes
+    with relaxed atomics. Install it with CoreSetup::MemoryAllocator
+    (or Memory::SetAllocator()) to let the BenchmarkSuite report
+    allocations per operation.
+*/
+#include "Core/Memory/Allocator.h"
+#include <atomic>
+
+namespace Oryol {
+
+class CountingAllocator : public Allocator {
+public:
+    /// get the shared instance (forwarding to std::malloc)
+    static CountingAllocator* Instance();
+
+    /// constructor with optional backend
+    CountingAllocator(Allocator* backend = nullptr);
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr) override;
+    /// return true if the pointer belongs to the allocator
+    virtual bool Owns(const void* ptr) const override;
+    /// release the backend's per-thread resources
+    virtual void ReleaseThreadCache() override;
+
+    /// number of Alloc() and ReAlloc() calls since start
+    int64_t NumAllocs() const;
+    /// number of Free() calls since start
+    int64_t NumFrees() const;
+    /// number of allocated bytes since start
+    int64_t NumBytes() const;
+
+private:
+    Allocator* backend;
+    std::atomic<int64_t> numAllocs{0};
+    std::atomic<int64_t> numFrees{0};
+    std::atomic<int64_t> numBytes{0};
+};
+
+} // namespace Oryol
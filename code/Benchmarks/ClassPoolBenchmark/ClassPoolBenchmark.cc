@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+//  ClassPoolBenchmark.cc
+//  Measure IORead::Create() throughput with the pool allocator against
+//  an identical class which is allocated through Memory::New().
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "IO/private/ioRequests.h"
+#include <thread>
+
+using namespace Oryol;
+
+class ClassPoolBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(ClassPoolBenchmarkApp);
+
+namespace {
+
+// same layout as IORead, but without the pool allocator
+class heapRead : public IORequest {
+    OryolClassDecl(heapRead);
+    OryolTypeDecl(heapRead, IORequest);
+public:
+    bool CacheReadEnabled = false;
+    bool CacheWriteEnabled = false;
+};
+
+const int NumOps = 1000000;
+
+//------------------------------------------------------------------------------
+// create and immediately release a request
+template<class TYPE> void
+createRelease(int numOps) {
+    for (int i = 0; i < numOps; i++) {
+        Ptr<TYPE> req = TYPE::Create();
+        req->StartOffset = i;
+    }
+}
+
+//------------------------------------------------------------------------------
+// keep a batch of requests in flight (like the loadQueue does)
+template<class TYPE> void
+batched() {
+    const int batchSize = 256;
+    Ptr<TYPE> reqs[batchSize];
+    for (int i = 0; i < NumOps / batchSize; i++) {
+        for (auto& req : reqs) {
+            req = TYPE::Create();
+        }
+        for (auto& req : reqs) {
+            req = nullptr;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// create and release requests on 4 threads (the IO worker threads)
+template<class TYPE> void
+threaded() {
+    const int numThreads = 4;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([]() {
+            createRelease<TYPE>(NumOps / 4);
+        });
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+runAll(const char* name) {
+    TimePoint t = Clock::Now();
+    createRelease<TYPE>(NumOps);
+    Log::Info("  %-8s createRelease: %8.3f ms\n", name, Clock::LapTime(t).AsMilliSeconds());
+    batched<TYPE>();
+    Log::Info("  %-8s batched:       %8.3f ms\n", name, Clock::LapTime(t).AsMilliSeconds());
+    threaded<TYPE>();
+    Log::Info("  %-8s threaded:      %8.3f ms\n", name, Clock::LapTime(t).AsMilliSeconds());
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+ClassPoolBenchmarkApp::OnRunning() {
+    Log::Info("ClassPoolBenchmark (%d ops per mix):\n", NumOps);
+    runAll<heapRead>("heap");
+    runAll<IORead>("pool");
+    return AppState::Cleanup;
+}
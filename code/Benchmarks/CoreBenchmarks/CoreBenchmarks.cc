@@ -0,0 +1,407 @@
+//------------------------------------------------------------------------------
+//  CoreBenchmarks.cc
+//  Micro-benchmarks for the Core containers and string classes. Prints
+//  median/p99/min time and allocations per operation, and optionally
+//  writes the results as JSON (-json path) for diffing between commits.
+//  The number of timed runs can be changed with -runs N.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Containers/SlotMap.h"
+#include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/StringBuilder.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include "Benchmarks/Benchmark/CountingAllocator.h"
+
+using namespace Oryol;
+
+class CoreBenchmarksApp : public App {
+public:
+    CoreBenchmarksApp();
+    AppState::Code OnRunning();
+};
+OryolMain(CoreBenchmarksApp);
+
+namespace {
+
+const int NumElements = 10000;
+const int NumInserts = 1000;
+const int NumStrings = 1000;
+
+//------------------------------------------------------------------------------
+// unique pseudo-random keys (xorshift is a permutation of the non-zero values)
+Array<int> makeKeys(int num) {
+    Array<int> keys;
+    keys.Reserve(num);
+    uint32_t x = 2463534242;
+    for (int i = 0; i < num; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        keys.Add(int(x & 0x7FFFFFFF));
+    }
+    return keys;
+}
+
+//------------------------------------------------------------------------------
+// strings of different length, some short enough to be stored inline
+Array<String> makeStrings(int num) {
+    Array<String> strings;
+    strings.Reserve(num);
+    StringBuilder builder;
+    for (int i = 0; i < num; i++) {
+        if (i & 1) {
+            builder.Format(64, "res:%d", i);
+        }
+        else {
+            builder.Format(128, "data:textures/level%d/material_%d_diffuse.dds", i % 7, i);
+        }
+        strings.Add(builder.GetString());
+    }
+    return strings;
+}
+
+//------------------------------------------------------------------------------
+void
+arrayBenchmarks(BenchmarkSuite& suite) {
+    suite.Run("Array.Add", NumElements, [] {
+        Array<int> array;
+        for (int i = 0; i < NumElements; i++) {
+            array.Add(i);
+        }
+        BenchmarkSuite::DoNotOptimize(array);
+    });
+    suite.Run("Array.AddReserved", NumElements, [] {
+        Array<int> array;
+        array.Reserve(NumElements);
+        for (int i = 0; i < NumElements; i++) {
+            array.Add(i);
+        }
+        BenchmarkSuite::DoNotOptimize(array);
+    });
+    suite.Run("Array.InsertMiddle", NumInserts, [] {
+        Array<int> array;
+        for (int i = 0; i < NumInserts; i++) {
+            array.Insert(array.Size() / 2, i);
+        }
+        BenchmarkSuite::DoNotOptimize(array);
+    });
+    static Array<int> eraseArray;
+    auto fill = [] {
+        eraseArray.Clear();
+        for (int i = 0; i < NumInserts; i++) {
+            eraseArray.Add(i);
+        }
+    };
+    suite.Run("Array.EraseFront", NumInserts, fill, [] {
+        while (!eraseArray.Empty()) {
+            eraseArray.Erase(0);
+        }
+        BenchmarkSuite::DoNotOptimize(eraseArray);
+    });
+    suite.Run("Array.EraseMiddle", NumInserts, fill, [] {
+        while (!eraseArray.Empty()) {
+            eraseArray.Erase(eraseArray.Size() / 2);
+        }
+        BenchmarkSuite::DoNotOptimize(eraseArray);
+    });
+    suite.Run("Array.EraseSwap", NumInserts, fill, [] {
+        while (!eraseArray.Empty()) {
+            eraseArray.EraseSwap(0);
+        }
+        BenchmarkSuite::DoNotOptimize(eraseArray);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+mapBenchmarks(BenchmarkSuite& suite) {
+    static const Array<int> keys = makeKeys(NumInserts);
+    static Map<int, int> map;
+    suite.Run("Map.Add", NumInserts, [] {
+        map.Clear();
+        for (int key : keys) {
+            map.Add(key, key);
+        }
+        BenchmarkSuite::DoNotOptimize(map);
+    });
+    suite.Run("Map.FindIndex", NumElements, [] {
+        int64_t sum = 0;
+        for (int i = 0; i < NumElements; i++) {
+            // half of the lookups miss
+            const int key = keys[i % NumInserts] + (i & 1);
+            const int index = map.FindIndex(key);
+            if (InvalidIndex != index) {
+                sum += map.ValueAtIndex(index);
+            }
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    static HashSet<int> set;
+    suite.Run("HashSet.Add", NumElements, [] {
+        set.Clear();
+        for (int i = 0; i < NumElements; i++) {
+            set.Add(i * 7919);
+        }
+        BenchmarkSuite::DoNotOptimize(set);
+    });
+    suite.Run("HashSet.Contains", NumElements, [] {
+        int num = 0;
+        for (int i = 0; i < NumElements; i++) {
+            num += set.Contains(i * 3967) ? 1 : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(num);
+    });
+}
+
+//------------------------------------------------------------------------------
+// the ResourcePool approach (slot array, free-index queue and unique
+// stamps) as baseline for the SlotMap
+struct slotPool {
+    struct slot {
+        uint32_t id = 0;
+        int64_t value = 0;
+    };
+    Array<slot> slots;
+    Queue<uint16_t> freeSlots;
+    uint32_t uniqueCounter = 1;
+
+    void setup(int num) {
+        slots.SetFixedCapacity(num);
+        freeSlots.SetFixedCapacity(num);
+        for (int i = 0; i < num; i++) {
+            slots.Add();
+            freeSlots.Enqueue(uint16_t(i));
+        }
+    };
+    uint32_t add(int64_t value) {
+        const uint16_t index = freeSlots.Dequeue();
+        slots[index].id = ((uniqueCounter++) << 16) | index;
+        slots[index].value = value;
+        return slots[index].id;
+    };
+    void erase(uint32_t id) {
+        slots[id & 0xFFFF].id = 0;
+        freeSlots.Enqueue(uint16_t(id & 0xFFFF));
+    };
+    const int64_t* find(uint32_t id) const {
+        const slot& s = slots[id & 0xFFFF];
+        return (id == s.id) ? &s.value : nullptr;
+    };
+};
+
+//------------------------------------------------------------------------------
+void
+slotMapBenchmarks(BenchmarkSuite& suite) {
+    // half-filled containers, the other half of the handles are stale,
+    // handles are accessed in random order
+    static const Array<int> keys = makeKeys(NumElements);
+    static SlotMap<int64_t> slotMap;
+    static slotPool pool;
+    static HashMap<uint32_t, int64_t> hashMap;
+    static Array<uint32_t> slotMapHandles;
+    static Array<uint32_t> poolHandles;
+    slotMap.Setup(NumElements);
+    pool.setup(NumElements);
+    for (int i = 0; i < NumElements; i++) {
+        slotMapHandles.Add(slotMap.Add(i));
+        poolHandles.Add(pool.add(i));
+    }
+    for (int i = 0; i < NumElements; i += 2) {
+        slotMap.Erase(slotMapHandles[i]);
+        pool.erase(poolHandles[i]);
+    }
+    for (int i = 1; i < NumElements; i += 2) {
+        hashMap.Add(poolHandles[i], i);
+    }
+
+    suite.Run("SlotMap.Find", NumElements, [] {
+        int64_t sum = 0;
+        for (int key : keys) {
+            const int64_t* val = slotMap.Find(slotMapHandles[key % NumElements]);
+            sum += val ? *val : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    suite.Run("SlotPool.Find", NumElements, [] {
+        int64_t sum = 0;
+        for (int key : keys) {
+            const int64_t* val = pool.find(poolHandles[key % NumElements]);
+            sum += val ? *val : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    suite.Run("HashMap.FindIndex", NumElements, [] {
+        int64_t sum = 0;
+        for (int key : keys) {
+            const int index = hashMap.FindIndex(poolHandles[key % NumElements]);
+            sum += (InvalidIndex != index) ? hashMap.ValueAtIndex(index) : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    suite.Run("SlotMap.Iterate", NumElements / 2, [] {
+        int64_t sum = 0;
+        for (int64_t val : slotMap) {
+            sum += val;
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    suite.Run("SlotPool.Iterate", NumElements / 2, [] {
+        int64_t sum = 0;
+        for (const auto& slot : pool.slots) {
+            if (slot.id) {
+                sum += slot.value;
+            }
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+    // replace live elements in random order
+    suite.Run("SlotMap.EraseAdd", NumElements, [] {
+        for (int key : keys) {
+            uint32_t& handle = slotMapHandles[(key % (NumElements / 2)) * 2 + 1];
+            slotMap.Erase(handle);
+            handle = slotMap.Add(key);
+        }
+        BenchmarkSuite::DoNotOptimize(slotMap);
+    });
+    suite.Run("SlotPool.EraseAdd", NumElements, [] {
+        for (int key : keys) {
+            uint32_t& handle = poolHandles[(key % (NumElements / 2)) * 2 + 1];
+            pool.erase(handle);
+            handle = pool.add(key);
+        }
+        BenchmarkSuite::DoNotOptimize(pool);
+    });
+    slotMap.Discard();
+}
+
+//------------------------------------------------------------------------------
+void
+queueBenchmarks(BenchmarkSuite& suite) {
+    static Queue<int> queue;
+    suite.Run("Queue.Enqueue", NumElements, [] {
+        queue = Queue<int>();
+        for (int i = 0; i < NumElements; i++) {
+            queue.Enqueue(i);
+        }
+        BenchmarkSuite::DoNotOptimize(queue);
+    });
+    suite.Run("Queue.EnqueueDequeue", NumElements, [] {
+        int64_t sum = 0;
+        for (int i = 0; i < NumElements; i++) {
+            queue.Enqueue(i);
+            sum += queue.Dequeue();
+        }
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+stringBenchmarks(BenchmarkSuite& suite) {
+    static const Array<String> strings = makeStrings(NumStrings);
+    static Array<String> copies;
+    suite.Run("String.CreateFromCStr", NumStrings, [] {
+        copies.Clear();
+        for (const String& str : strings) {
+            copies.Add(str.AsCStr());
+        }
+        BenchmarkSuite::DoNotOptimize(copies);
+    });
+    suite.Run("String.Copy", NumStrings, [] {
+        copies.Clear();
+        for (const String& str : strings) {
+            copies.Add(str);
+        }
+        BenchmarkSuite::DoNotOptimize(copies);
+    });
+    suite.Run("String.Compare", NumStrings, [] {
+        int num = 0;
+        for (int i = 0; i < NumStrings; i++) {
+            num += (strings[i] == copies[(i * 7) % NumStrings]) ? 1 : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(num);
+    });
+
+    static Array<StringAtom> atoms;
+    suite.Run("StringAtom.Create", NumStrings, [] {
+        atoms.Clear();
+        for (const String& str : strings) {
+            atoms.Add(str.AsCStr());
+        }
+        BenchmarkSuite::DoNotOptimize(atoms);
+    });
+    suite.Run("StringAtom.Compare", NumStrings, [] {
+        int num = 0;
+        for (int i = 0; i < NumStrings; i++) {
+            num += (atoms[i] == atoms[(i * 7) % NumStrings]) ? 1 : 0;
+        }
+        BenchmarkSuite::DoNotOptimize(num);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+stringBuilderBenchmarks(BenchmarkSuite& suite) {
+    static StringBuilder builder;
+    suite.Run("StringBuilder.Format", NumStrings, [] {
+        int len = 0;
+        for (int i = 0; i < NumStrings; i++) {
+            builder.Format(128, "data:textures/level%d/material_%d.dds", i % 7, i);
+            len += builder.Length();
+        }
+        BenchmarkSuite::DoNotOptimize(len);
+    });
+    suite.Run("StringBuilder.SubstituteAll", NumStrings, [] {
+        int num = 0;
+        for (int i = 0; i < NumStrings; i++) {
+            builder.Set("root:textures/level/material.dds;root:models/level/mesh.omsh");
+            num += builder.SubstituteAll("root:", "data:");
+        }
+        BenchmarkSuite::DoNotOptimize(num);
+    });
+    static Array<String> tokens;
+    suite.Run("StringBuilder.Tokenize", NumStrings, [] {
+        int num = 0;
+        for (int i = 0; i < NumStrings; i++) {
+            builder.Set("position normal texcoord0 color0 boneweights boneindices");
+            tokens.Clear();
+            num += builder.Tokenize(" ", tokens);
+        }
+        BenchmarkSuite::DoNotOptimize(num);
+    });
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+CoreBenchmarksApp::CoreBenchmarksApp() {
+    this->coreSetup.MemoryAllocator = CountingAllocator::Instance();
+}
+
+//------------------------------------------------------------------------------
+AppState::Code
+CoreBenchmarksApp::OnRunning() {
+    BenchmarkSuite suite("CoreBenchmarks");
+    suite.NumRuns = OryolArgs.GetInt("-runs", suite.NumRuns);
+    arrayBenchmarks(suite);
+    mapBenchmarks(suite);
+    slotMapBenchmarks(suite);
+    queueBenchmarks(suite);
+    stringBenchmarks(suite);
+    stringBuilderBenchmarks(suite);
+    suite.PrintResults();
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+    return AppState::Cleanup;
+}
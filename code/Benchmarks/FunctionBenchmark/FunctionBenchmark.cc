@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+//  FunctionBenchmark.cc
+//  Compares Oryol::Function with std::function for typical callback
+//  captures (construct, move through an array like the IO load queue
+//  does, call), and measures allocations per IO::Load() call for 10K
+//  loads through a file system which handles requests immediately.
+//  Global operator new/delete are routed through the CountingAllocator,
+//  so that std::function allocations are counted too. Optionally writes
+//  the results as JSON (-json path), the number of timed runs can be
+//  changed with -runs N.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Core.h"
+#include "Core/Creator.h"
+#include "Core/Function.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include "Benchmarks/Benchmark/CountingAllocator.h"
+#include <functional>
+#include <new>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+void* operator new(std::size_t size) {
+    return CountingAllocator::Instance()->Alloc(int(size));
+}
+void* operator new[](std::size_t size) {
+    return CountingAllocator::Instance()->Alloc(int(size));
+}
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        CountingAllocator::Instance()->Free(ptr);
+    }
+}
+void operator delete[](void* ptr) noexcept {
+    if (ptr) {
+        CountingAllocator::Instance()->Free(ptr);
+    }
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+    ::operator delete[](ptr);
+}
+
+class FunctionBenchmarkApp : public App {
+public:
+    FunctionBenchmarkApp();
+    AppState::Code OnRunning();
+};
+OryolMain(FunctionBenchmarkApp);
+
+namespace {
+
+const int NumCallbacks = 10000;
+const int NumLoads = 10000;
+
+//------------------------------------------------------------------------------
+class NullFileSystem : public FileSystemBase {
+    OryolClassDecl(NullFileSystem);
+    OryolClassCreator(NullFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        if (msg->IsA<IORead>()) {
+            static const uint8_t payload[] = { 'A', 'B', 'C', 'D' };
+            Ptr<IORead> ioRead = msg->DynamicCast<IORead>();
+            ioRead->Data.Add(payload, sizeof(payload));
+            ioRead->Status = IOStatus::OK;
+        }
+        msg->Handled = true;
+    };
+};
+
+//------------------------------------------------------------------------------
+// construct a callback with a StringAtom, an index and a pointer capture
+// (not trivially copyable, so std::function heap-allocates it), move it
+// into an array and call it from there
+template<class FUNC> void
+callbackBenchmark(BenchmarkSuite& suite, const char* name) {
+    static Array<FUNC> funcs;
+    static int sum;
+    funcs.Reserve(NumCallbacks);
+    const StringAtom atom("texture");
+    suite.Run(name, NumCallbacks, [atom] {
+        sum = 0;
+        for (int i = 0; i < NumCallbacks; i++) {
+            FUNC func = [atom, i](int* ptr) { *ptr += i + atom.Length(); };
+            funcs.Add(std::move(func));
+        }
+        for (const FUNC& func : funcs) {
+            func(&sum);
+        }
+        funcs.Clear();
+        BenchmarkSuite::DoNotOptimize(sum);
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+loadBenchmarks(BenchmarkSuite& suite) {
+    IO::Setup(IOSetup());
+    IO::RegisterFileSystem("null", NullFileSystem::Creator());
+    static Array<URL> urls;
+    StringBuilder strBuilder;
+    for (int i = 0; i < NumLoads; i++) {
+        strBuilder.Format(64, "null://bench/file%d.bin", i);
+        urls.Add(URL(strBuilder.GetString()));
+    }
+    static int numLoaded;
+    suite.Run("IO.Load", NumLoads, [] {
+        numLoaded = 0;
+        const StringAtom tag("texture");
+        for (int i = 0; i < NumLoads; i++) {
+            IO::Load(urls[i],
+                [tag, i](IO::LoadResult res) {
+                    numLoaded += res.Data.Size() > 0 ? 1 : 0;
+                    BenchmarkSuite::DoNotOptimize(i + tag.Length());
+                },
+                [tag](const URL& url, IOStatus::Code ioStatus) {
+                    Log::Warn("Failed to load '%s' (%s)\n", url.AsCStr(), tag.AsCStr());
+                });
+        }
+        while (IO::NumPendingLoads() > 0) {
+            Core::PreRunLoop()->Run();
+        }
+        o_assert(NumLoads == numLoaded);
+    });
+    urls.Clear();
+    IO::Discard();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+FunctionBenchmarkApp::FunctionBenchmarkApp() {
+    this->coreSetup.MemoryAllocator = CountingAllocator::Instance();
+}
+
+//------------------------------------------------------------------------------
+AppState::Code
+FunctionBenchmarkApp::OnRunning() {
+    BenchmarkSuite suite("FunctionBenchmark");
+    suite.NumRuns = OryolArgs.GetInt("-runs", suite.NumRuns);
+    callbackBenchmark<std::function<void(int*)>>(suite, "std::function");
+    callbackBenchmark<Function<void(int*)>>(suite, "Function");
+    loadBenchmarks(suite);
+    suite.PrintResults();
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+    return AppState::Cleanup;
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//  HashMapBenchmark.cc
+//  Compare insertion and lookup of Map, HashMap and std::unordered_map
+//  with random integer keys at different sizes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
+#include <unordered_map>
+
+using namespace Oryol;
+
+class HashMapBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(HashMapBenchmarkApp);
+
+namespace {
+
+const int NumLookups = 1000000;
+
+//------------------------------------------------------------------------------
+// generate unique random keys (xorshift is a permutation of the non-zero values)
+Array<uint32_t>
+makeKeys(int num) {
+    Array<uint32_t> keys;
+    keys.Reserve(num);
+    uint32_t x = 2463534242;
+    for (int i = 0; i < num; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        keys.Add(x);
+    }
+    return keys;
+}
+
+//------------------------------------------------------------------------------
+// sum up looked up values, half of the lookups miss
+template<class MAP> int64_t
+lookup(const MAP& map, const Array<uint32_t>& keys) {
+    int64_t sum = 0;
+    const int num = keys.Size();
+    for (int i = 0; i < NumLookups; i++) {
+        const uint32_t key = keys[int((uint32_t(i) * 7919u) % uint32_t(num))];
+        if (i & 1) {
+            const int index = map.FindIndex(key);
+            if (InvalidIndex != index) {
+                sum += map.ValueAtIndex(index);
+            }
+        }
+        else {
+            const int index = map.FindIndex(key + 1);
+            if (InvalidIndex != index) {
+                sum += map.ValueAtIndex(index);
+            }
+        }
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+lookupStd(const std::unordered_map<uint32_t, int>& map, const Array<uint32_t>& keys) {
+    int64_t sum = 0;
+    const int num = keys.Size();
+    for (int i = 0; i < NumLookups; i++) {
+        const uint32_t key = keys[int((uint32_t(i) * 7919u) % uint32_t(num))];
+        auto it = map.find((i & 1) ? key : key + 1);
+        if (it != map.end()) {
+            sum += it->second;
+        }
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+void
+run(int num) {
+    const Array<uint32_t> keys = makeKeys(num);
+    Log::Info("  %d entries:\n", num);
+
+    // Map: random inserts are O(n), so use bulk mode which sorts once
+    {
+        TimePoint t = Clock::Now();
+        Map<uint32_t, int> map;
+        map.Reserve(num);
+        map.BeginBulk();
+        for (int i = 0; i < num; i++) {
+            map.AddBulk(keys[i], i);
+        }
+        map.EndBulk();
+        const double insertTime = Clock::LapTime(t).AsMilliSeconds();
+        const int64_t sum = lookup(map, keys);
+        const double lookupTime = Clock::LapTime(t).AsMilliSeconds();
+        Log::Info("    %-14s insert(bulk): %9.3f ms  lookup: %9.3f ms (%lld)\n",
+            "Map", insertTime, lookupTime, (long long)sum);
+    }
+    {
+        TimePoint t = Clock::Now();
+        HashMap<uint32_t, int> map;
+        for (int i = 0; i < num; i++) {
+            map.Add(keys[i], i);
+        }
+        const double insertTime = Clock::LapTime(t).AsMilliSeconds();
+        const int64_t sum = lookup(map, keys);
+        const double lookupTime = Clock::LapTime(t).AsMilliSeconds();
+        Log::Info("    %-14s insert:       %9.3f ms  lookup: %9.3f ms (%lld)\n",
+            "HashMap", insertTime, lookupTime, (long long)sum);
+    }
+    {
+        TimePoint t = Clock::Now();
+        std::unordered_map<uint32_t, int> map;
+        for (int i = 0; i < num; i++) {
+            map.emplace(keys[i], i);
+        }
+        const double insertTime = Clock::LapTime(t).AsMilliSeconds();
+        const int64_t sum = lookupStd(map, keys);
+        const double lookupTime = Clock::LapTime(t).AsMilliSeconds();
+        Log::Info("    %-14s insert:       %9.3f ms  lookup: %9.3f ms (%lld)\n",
+            "unordered_map", insertTime, lookupTime, (long long)sum);
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+HashMapBenchmarkApp::OnRunning() {
+    Log::Info("HashMapBenchmark (%d lookups per map):\n", NumLookups);
+    run(1000);
+    run(100000);
+    run(1000000);
+    return AppState::Cleanup;
+}
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  IOLatencyBenchmark.cc
+//  Measures the latency from IO::Put() until a request is handled by its
+//  file system, with the default once-per-frame dispatch and with
+//  IOSetup::ImmediateDispatch, at different request rates. The main
+//  thread simulates a 60 Hz frame loop (the runloop runs once per frame),
+//  and submits requests evenly spread over time. The test file system
+//  handles requests immediately, so only the dispatch latency is measured.
+//  Options: -workers N (default 4), -seconds N (per rate, default 1).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Core.h"
+#include "Core/Creator.h"
+#include "Core/RunLoop.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Algorithms.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Time/Clock.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include <thread>
+
+using namespace Oryol;
+
+class IOLatencyBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(IOLatencyBenchmarkApp);
+
+namespace {
+
+// time when a request was handled, indexed by IORead::StartOffset
+Array<TimePoint> handledTimes;
+
+class LatencyFileSystem : public FileSystemBase {
+    OryolClassDecl(LatencyFileSystem);
+    OryolClassCreator(LatencyFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        handledTimes[msg->StartOffset] = Clock::Now();
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+struct latencyResult {
+    String Name;
+    double MedianUs = 0.0;
+    double P99Us = 0.0;
+    double MaxUs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+latencyResult
+measure(const char* name, bool immediate, int numWorkers, int rate, double seconds) {
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = numWorkers;
+    ioSetup.ImmediateDispatch = immediate;
+    ioSetup.FileSystems.Add("lat", LatencyFileSystem::Creator());
+    IO::Setup(ioSetup);
+    Core::PreRunLoop()->Run();
+
+    const int numReqs = int(rate * seconds);
+    const Duration frameTime = Duration::FromSeconds(1.0 / 60.0);
+    handledTimes.Clear();
+    handledTimes.Reserve(numReqs);
+    for (int i = 0; i < numReqs; i++) {
+        handledTimes.Add();
+    }
+    Array<TimePoint> putTimes;
+    putTimes.Reserve(numReqs);
+    Array<Ptr<IORead>> reqs;
+    reqs.Reserve(numReqs);
+
+    // simulated frame loop, requests are put between the frames
+    const TimePoint start = Clock::Now();
+    TimePoint nextFrame = start;
+    int numPut = 0;
+    int numHandled = 0;
+    while (numHandled < numReqs) {
+        const TimePoint now = Clock::Now();
+        if (now >= nextFrame) {
+            Core::PreRunLoop()->Run();
+            nextFrame += frameTime;
+        }
+        while ((numPut < numReqs) && (Clock::Now() >= (start + Duration::FromSeconds(double(numPut) / rate)))) {
+            auto req = IORead::Create();
+            req->Url = "lat://bla/blub.bin";
+            req->StartOffset = numPut++;
+            putTimes.Add(Clock::Now());
+            IO::Put(req);
+            reqs.Add(req);
+        }
+        while ((numHandled < numPut) && reqs[numHandled]->Handled) {
+            numHandled++;
+        }
+        std::this_thread::yield();
+    }
+    reqs.Clear();
+    IO::Discard();
+
+    Array<double> latencies;
+    latencies.Reserve(numReqs);
+    for (int i = 0; i < numReqs; i++) {
+        latencies.Add((handledTimes[i] - putTimes[i]).AsMicroSeconds());
+    }
+    Algorithms::Sort(latencies.MakeSlice());
+    latencyResult result;
+    result.Name = name;
+    result.MedianUs = latencies[numReqs / 2];
+    result.P99Us = latencies[(numReqs * 99) / 100];
+    result.MaxUs = latencies.Back();
+    return result;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+IOLatencyBenchmarkApp::OnRunning() {
+    const int numWorkers = OryolArgs.GetInt("-workers", 4);
+    const double seconds = OryolArgs.GetInt("-seconds", 1);
+    const int rates[] = { 100, 1000, 10000, 100000 };
+
+    Log::Info("IOLatencyBenchmark: %d workers, 60 Hz frames, put-to-handled latency in us\n", numWorkers);
+    Log::Info("  %-28s %10s %10s %10s\n", "", "median", "p99", "max");
+    StringBuilder strBuilder;
+    for (const int rate : rates) {
+        for (int immediate = 0; immediate < 2; immediate++) {
+            strBuilder.Format(64, "%s.%dHz", immediate ? "Immediate" : "Deferred", rate);
+            const latencyResult res = measure(strBuilder.AsCStr(), 0 != immediate, numWorkers, rate, seconds);
+            Log::Info("  %-28s %10.1f %10.1f %10.1f\n", res.Name.AsCStr(), res.MedianUs, res.P99Us, res.MaxUs);
+        }
+    }
+    return AppState::Cleanup;
+}
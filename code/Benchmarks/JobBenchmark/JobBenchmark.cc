@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+//  JobBenchmark.cc
+//  Measure how the job system scales from 1 to N threads with a
+//  compute-bound ParallelFor and with many tiny jobs (scheduling overhead).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Jobs/Jobs.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#include <cmath>
+
+using namespace Oryol;
+
+class JobBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(JobBenchmarkApp);
+
+namespace {
+
+const int NumItems = 1 << 20;
+const int NumTinyJobs = 200000;
+const int NumRepeats = 8;
+
+//------------------------------------------------------------------------------
+// ParallelFor over a slice of floats, some math per item
+double
+parallelFor(Array<float>& items) {
+    TimePoint t = Clock::Now();
+    for (int i = 0; i < NumRepeats; i++) {
+        Jobs::ParallelFor(items.MakeSlice(), [](float& val) {
+            for (int j = 0; j < 16; j++) {
+                val = std::sqrt(val * val + 1.0f) * 0.5f;
+            }
+        });
+    }
+    return Clock::Since(t).AsMilliSeconds() / NumRepeats;
+}
+
+//------------------------------------------------------------------------------
+// start many tiny jobs from the main thread and wait for them
+double
+tinyJobs() {
+    TimePoint t = Clock::Now();
+    std::atomic<int> sum(0);
+    JobCounter counter;
+    for (int i = 0; i < NumTinyJobs; i++) {
+        Jobs::Run([&sum] {
+            sum.fetch_add(1, std::memory_order_relaxed);
+        }, &counter);
+    }
+    Jobs::Wait(&counter);
+    o_assert(NumTinyJobs == sum.load());
+    return Clock::Since(t).AsMilliSeconds();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+JobBenchmarkApp::OnRunning() {
+    Array<float> items;
+    items.Reserve(NumItems);
+    for (int i = 0; i < NumItems; i++) {
+        items.Add(float(i));
+    }
+
+    const int numCores = Jobs::DefaultNumWorkers() + 1;
+    const int origNumWorkers = Jobs::NumWorkers();
+    Log::Info("JobBenchmark (%d cores, %d items, %d tiny jobs):\n", numCores, NumItems, NumTinyJobs);
+    double baseTime = 0.0;
+    for (int numThreads = 1; numThreads <= numCores; numThreads++) {
+        Jobs::Discard();
+        Jobs::Setup(numThreads - 1);
+        const double forTime = parallelFor(items);
+        const double tinyTime = tinyJobs();
+        if (1 == numThreads) {
+            baseTime = forTime;
+        }
+        Log::Info("  %2d threads: ParallelFor %9.3f ms (%5.2fx), tiny jobs %9.3f ms (%6.1f ns/job)\n",
+            numThreads, forTime, baseTime / forTime, tinyTime, (tinyTime * 1000000.0) / NumTinyJobs);
+    }
+    Jobs::Discard();
+    Jobs::Setup(origNumWorkers);
+    return AppState::Cleanup;
+}
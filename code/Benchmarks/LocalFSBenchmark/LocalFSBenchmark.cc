@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+//  LocalFSBenchmark.cc
+//  Measures loading big files through the LocalFileSystem, copying into
+//  IORead::Data (IO::LoadFile) vs. memory-mapping (IO::MapFile). All
+//  files are loaded in parallel, and each byte of the loaded data is
+//  read once. Times are per KB, the files are in the page cache (they
+//  have just been written). On Linux, the resident anonymous and file
+//  memory while all files are loaded, and the peak RSS are printed too.
+//  Options: -files N (default 4), -mb N (file size, default 64),
+//  -runs N, -json path.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/IO.h"
+#include "LocalFS/LocalFileSystem.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace Oryol;
+
+class LocalFSBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(LocalFSBenchmarkApp);
+
+namespace {
+
+Array<URL> urls;
+Array<Ptr<IORead>> reads;
+
+//------------------------------------------------------------------------------
+void
+waitAll(const Array<Ptr<IORead>>& requests) {
+    for (const auto& req : requests) {
+        while (!req->Handled) {
+            Core::PreRunLoop()->Run();
+            std::this_thread::yield();
+        }
+        o_assert(IOStatus::OK == req->Status);
+    }
+}
+
+//------------------------------------------------------------------------------
+// start loading all files, and wait until they are loaded
+void
+loadAll(bool map) {
+    reads.Clear();
+    for (const URL& url : urls) {
+        reads.Add(map ? IO::MapFile(url) : IO::LoadFile(url));
+    }
+    waitAll(reads);
+}
+
+//------------------------------------------------------------------------------
+// read all loaded bytes
+uint64_t
+touchAll() {
+    uint64_t sum = 0;
+    for (const auto& req : reads) {
+        const uint8_t* ptr = req->View ? req->View->Data() : req->Data.Data();
+        const int size = req->View ? req->View->Size() : req->Data.Size();
+        for (int i = 0; i + 8 <= size; i += 8) {
+            uint64_t val;
+            std::memcpy(&val, ptr + i, sizeof(val));
+            sum += val;
+        }
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+// read a value in KB from /proc/self/status (Linux only)
+int
+procStatusKB(const char* key) {
+    int result = 0;
+    #if ORYOL_LINUX
+    FILE* fp = std::fopen("/proc/self/status", "r");
+    if (fp) {
+        char line[256];
+        const size_t keyLen = std::strlen(key);
+        while (std::fgets(line, sizeof(line), fp)) {
+            if ((0 == std::strncmp(line, key, keyLen)) && (':' == line[keyLen])) {
+                result = std::atoi(line + keyLen + 1);
+                break;
+            }
+        }
+        std::fclose(fp);
+    }
+    #endif
+    return result;
+}
+
+//------------------------------------------------------------------------------
+void
+printMemory(const char* name, bool map) {
+    const int anonBefore = procStatusKB("RssAnon");
+    const int fileBefore = procStatusKB("RssFile");
+    loadAll(map);
+    BenchmarkSuite::DoNotOptimize(touchAll());
+    const int anonLoaded = procStatusKB("RssAnon");
+    const int fileLoaded = procStatusKB("RssFile");
+    reads.Clear();
+    Log::Info("  %-24s RssAnon: %+8d KB  RssFile: %+8d KB  VmHWM: %8d KB\n",
+        name, anonLoaded - anonBefore, fileLoaded - fileBefore, procStatusKB("VmHWM"));
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+LocalFSBenchmarkApp::OnRunning() {
+    const int numFiles = OryolArgs.GetInt("-files", 4);
+    const int fileSize = OryolArgs.GetInt("-mb", 64) * 1024 * 1024;
+    const int numKB = int((int64_t(numFiles) * fileSize) / 1024);
+
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // write the test files
+    {
+        Buffer data;
+        uint8_t* ptr = data.Add(fileSize);
+        for (int i = 0; i < fileSize; i++) {
+            ptr[i] = uint8_t(i * 31 + (i >> 12));
+        }
+        Array<Ptr<IORead>> dummy;
+        StringBuilder strBuilder;
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, "root:localfs_bench_%d.bin", i);
+            urls.Add(URL(IO::ResolveAssigns(strBuilder.GetString())));
+            Ptr<IOWrite> write = IO::WriteFile(urls.Back(), data);
+            while (!write->Handled) {
+                Core::PreRunLoop()->Run();
+                std::this_thread::yield();
+            }
+            o_assert(IOStatus::OK == write->Status);
+        }
+    }
+
+    // memory usage while all files are loaded (map first, so that the
+    // peak RSS of the copy isn't included in the map result)
+    Log::Info("LocalFSBenchmark: %d files of %d MB\n", numFiles, fileSize / (1024 * 1024));
+    printMemory("IO.MapFile", true);
+    printMemory("IO.LoadFile", false);
+
+    BenchmarkSuite suite("LocalFSBenchmark");
+    suite.NumRuns = OryolArgs.GetInt("-runs", 11);
+    suite.NumWarmupRuns = 1;
+    suite.Run("IO.LoadFile", numKB, [] {
+        loadAll(false);
+        BenchmarkSuite::DoNotOptimize(touchAll());
+        reads.Clear();
+    });
+    suite.Run("IO.MapFile", numKB, [] {
+        loadAll(true);
+        BenchmarkSuite::DoNotOptimize(touchAll());
+        reads.Clear();
+    });
+    suite.PrintResults();
+    for (const auto& result : suite.Results()) {
+        Log::Info("  %-24s %8.1f MB/s\n", result.Name.AsCStr(), (1024.0 * 1000.0) / result.MedianNs);
+    }
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+
+    // delete the test files
+    for (const URL& url : urls) {
+        std::remove(url.Path().AsCStr());
+    }
+    urls.Clear();
+    IO::Discard();
+    return AppState::Cleanup;
+}
@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+//  LogBenchmark.cc
+//  Measure log calls per second from 1 to 8 threads with synchronous
+//  and asynchronous logging into a Logger which writes to a file.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Logger.h"
+#include <cstdio>
+#include <thread>
+
+using namespace Oryol;
+
+class LogBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(LogBenchmarkApp);
+
+namespace {
+
+const int MaxThreads = 8;
+const int NumMessagesPerThread = 20000;
+
+// a logger which writes and flushes each message to a file
+class fileLogger : public Logger {
+    OryolClassDecl(fileLogger);
+public:
+    fileLogger() {
+        this->file = std::tmpfile();
+    };
+    ~fileLogger() {
+        if (this->file) {
+            std::fclose(this->file);
+        }
+    };
+    virtual void VPrint(Log::Level /*l*/, const char* msg, va_list args) override {
+        if (this->file) {
+            std::vfprintf(this->file, msg, args);
+            std::fflush(this->file);
+        }
+    };
+    FILE* file = nullptr;
+};
+
+struct result {
+    double callsPerSec = 0.0;
+    double flushMs = 0.0;
+    int dropped = 0;
+};
+
+//------------------------------------------------------------------------------
+// log from numThreads threads, measure log calls per second and
+// the time to print the remaining messages
+result
+run(int numThreads) {
+    const int64_t dropped = Log::NumDropped();
+    TimePoint t = Clock::Now();
+    std::thread threads[MaxThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([i] {
+            for (int j = 0; j < NumMessagesPerThread; j++) {
+                Log::Info("thread %d: message %d, value=%f\n", i, j, j * 0.5f);
+            }
+        });
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+    const double callMs = Clock::LapTime(t).AsMilliSeconds();
+    Log::Flush();
+    result res;
+    res.flushMs = Clock::Since(t).AsMilliSeconds();
+    res.callsPerSec = (numThreads * NumMessagesPerThread) / (callMs / 1000.0);
+    res.dropped = int(Log::NumDropped() - dropped);
+    return res;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+LogBenchmarkApp::OnRunning() {
+    result sync[MaxThreads + 1];
+    result async[MaxThreads + 1];
+    Ptr<fileLogger> logger = fileLogger::Create();
+    Log::AddLogger(logger);
+    for (int numThreads = 1; numThreads <= MaxThreads; numThreads++) {
+        sync[numThreads] = run(numThreads);
+    }
+    Log::StartAsync(4096);
+    for (int numThreads = 1; numThreads <= MaxThreads; numThreads++) {
+        async[numThreads] = run(numThreads);
+    }
+    Log::StopAsync();
+    Log::RemoveLogger(logger);
+
+    Log::Info("LogBenchmark (%d messages per thread):\n", NumMessagesPerThread);
+    for (int numThreads = 1; numThreads <= MaxThreads; numThreads++) {
+        const result& s = sync[numThreads];
+        const result& a = async[numThreads];
+        Log::Info("  %d threads: sync %10.0f calls/s | async %10.0f calls/s, flush %7.3f ms, dropped %d\n",
+            numThreads, s.callsPerSec, a.callsPerSec, a.flushMs, a.dropped);
+    }
+    return AppState::Cleanup;
+}
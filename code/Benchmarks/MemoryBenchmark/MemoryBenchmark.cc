@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+//  MemoryBenchmark.cc
+//  Compare the SizeClassAllocator backend against std::malloc() on
+//  typical Oryol allocation mixes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Memory/SizeClassAllocator.h"
+#include "Core/Time/Clock.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace Oryol;
+
+class MemoryBenchmarkApp : public App {
+public:
+    MemoryBenchmarkApp();
+    AppState::Code OnRunning();
+};
+OryolMain(MemoryBenchmarkApp);
+
+namespace {
+
+struct mallocBackend {
+    static const char* name() { return "malloc"; }
+    static void* alloc(int n) { return std::malloc(n); }
+    static void* realloc(void* p, int n) { return std::realloc(p, n); }
+    static void free(void* p) { std::free(p); }
+};
+
+struct sizeClassBackend {
+    static const char* name() { return "SizeClass"; }
+    static void* alloc(int n) { return SizeClassAllocator::Instance()->Alloc(n); }
+    static void* realloc(void* p, int n) {
+        if (nullptr == p) {
+            return alloc(n);
+        }
+        else if (SizeClassAllocator::Instance()->Owns(p)) {
+            return SizeClassAllocator::Instance()->ReAlloc(p, n);
+        }
+        else {
+            return std::realloc(p, n);
+        }
+    }
+    static void free(void* p) {
+        if (SizeClassAllocator::Instance()->Owns(p)) {
+            SizeClassAllocator::Instance()->Free(p);
+        }
+        else {
+            std::free(p);
+        }
+    }
+};
+
+struct memoryBackend {
+    static const char* name() { return "Memory::Alloc"; }
+    static void* alloc(int n) { return Memory::Alloc(n); }
+    static void* realloc(void* p, int n) { return Memory::ReAlloc(p, n); }
+    static void free(void* p) { Memory::Free(p); }
+};
+
+// simple xorshift random number generator for reproducible alloc sizes
+struct rng {
+    uint32_t state = 0x12345678;
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+const int NumOps = 1000000;
+
+//------------------------------------------------------------------------------
+// short-lived small objects (Ptr<> objects, String data)
+template<class BACKEND> void
+smallObjects() {
+    void* live[16] = { };
+    rng r;
+    for (int i = 0; i < NumOps; i++) {
+        const int slot = i & 15;
+        if (live[slot]) {
+            BACKEND::free(live[slot]);
+        }
+        live[slot] = BACKEND::alloc(16 + (r.next() & 127));
+    }
+    for (void* p : live) {
+        BACKEND::free(p);
+    }
+}
+
+//------------------------------------------------------------------------------
+// random alloc/free churn with many live objects (resource and IO churn)
+template<class BACKEND> void
+churn(int numOps) {
+    const int numSlots = 4096;
+    void** live = (void**) std::calloc(numSlots, sizeof(void*));
+    rng r;
+    for (int i = 0; i < numOps; i++) {
+        const uint32_t rnd = r.next();
+        const int slot = rnd & (numSlots - 1);
+        if (live[slot]) {
+            BACKEND::free(live[slot]);
+        }
+        live[slot] = BACKEND::alloc(8 + ((rnd >> 12) & 1023));
+    }
+    for (int i = 0; i < numSlots; i++) {
+        if (live[i]) {
+            BACKEND::free(live[i]);
+        }
+    }
+    std::free(live);
+}
+
+//------------------------------------------------------------------------------
+// growing containers (elementBuffer and Buffer grow through ReAlloc)
+template<class BACKEND> void
+growArrays() {
+    for (int i = 0; i < NumOps / 64; i++) {
+        void* p = nullptr;
+        for (int size = 16; size <= 4096; size *= 2) {
+            p = BACKEND::realloc(p, size);
+        }
+        BACKEND::free(p);
+    }
+}
+
+//------------------------------------------------------------------------------
+// concurrent churn on 4 threads (the IO worker threads)
+template<class BACKEND> void
+threadedChurn() {
+    const int numThreads = 4;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([]() {
+            churn<BACKEND>(NumOps / 4);
+            SizeClassAllocator::Instance()->ReleaseThreadCache();
+        });
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class BACKEND> void
+runAll() {
+    TimePoint t = Clock::Now();
+    smallObjects<BACKEND>();
+    Log::Info("  %-14s smallObjects:  %8.3f ms\n", BACKEND::name(), Clock::LapTime(t).AsMilliSeconds());
+    churn<BACKEND>(NumOps);
+    Log::Info("  %-14s churn:         %8.3f ms\n", BACKEND::name(), Clock::LapTime(t).AsMilliSeconds());
+    growArrays<BACKEND>();
+    Log::Info("  %-14s growArrays:    %8.3f ms\n", BACKEND::name(), Clock::LapTime(t).AsMilliSeconds());
+    threadedChurn<BACKEND>();
+    Log::Info("  %-14s threadedChurn: %8.3f ms\n", BACKEND::name(), Clock::LapTime(t).AsMilliSeconds());
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+MemoryBenchmarkApp::MemoryBenchmarkApp() {
+    // install the size-class allocator as Memory::Alloc() backend
+    this->coreSetup.MemoryAllocator = SizeClassAllocator::Instance();
+}
+
+//------------------------------------------------------------------------------
+AppState::Code
+MemoryBenchmarkApp::OnRunning() {
+    Log::Info("MemoryBenchmark (%d ops per mix):\n", NumOps);
+    runAll<mallocBackend>();
+    runAll<sizeClassBackend>();
+    runAll<memoryBackend>();
+    return AppState::Cleanup;
+}
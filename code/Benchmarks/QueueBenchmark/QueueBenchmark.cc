@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+//  QueueBenchmark.cc
+//  Measure the throughput of passing elements between threads with
+//  a mutex-protected Queue, the SPSCQueue and the MPMCQueue, with
+//  single and batched enqueue/dequeue.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/MPMCQueue.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace Oryol;
+
+class QueueBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(QueueBenchmarkApp);
+
+namespace {
+
+const int NumElements = 4000000;
+const int Capacity = 1024;
+const int BatchSize = 32;
+
+// a mutex-protected Queue with the same interface as the lock-free queues
+class lockedQueue {
+public:
+    lockedQueue() {
+        this->queue.SetFixedCapacity(Capacity);
+    };
+    bool Enqueue(int val) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->queue.Size() == Capacity) {
+            return false;
+        }
+        this->queue.Enqueue(val);
+        return true;
+    };
+    int EnqueueBatch(int* vals, int num) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        int i = 0;
+        for (; (i < num) && (this->queue.Size() < Capacity); i++) {
+            this->queue.Enqueue(vals[i]);
+        }
+        return i;
+    };
+    bool Dequeue(int& outVal) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->queue.Empty()) {
+            return false;
+        }
+        this->queue.Dequeue(outVal);
+        return true;
+    };
+    int DequeueBatch(int* outVals, int maxNum) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        int i = 0;
+        for (; (i < maxNum) && !this->queue.Empty(); i++) {
+            this->queue.Dequeue(outVals[i]);
+        }
+        return i;
+    };
+    std::mutex mutex;
+    Queue<int> queue;
+};
+
+//------------------------------------------------------------------------------
+template<class QUEUE> void
+produce(QUEUE& queue, int first, int num, int batchSize) {
+    int batch[BatchSize];
+    int i = 0;
+    while (i < num) {
+        if (1 == batchSize) {
+            while (!queue.Enqueue(first + i)) {
+                std::this_thread::yield();
+            }
+            i++;
+        }
+        else {
+            int n = 0;
+            for (; (n < batchSize) && ((i + n) < num); n++) {
+                batch[n] = first + i + n;
+            }
+            int done = 0;
+            while (done < n) {
+                const int res = queue.EnqueueBatch(batch + done, n - done);
+                if (0 == res) {
+                    std::this_thread::yield();
+                }
+                done += res;
+            }
+            i += n;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class QUEUE> int64_t
+consume(QUEUE& queue, std::atomic<int>& numLeft, int batchSize) {
+    int64_t sum = 0;
+    int batch[BatchSize];
+    while (numLeft.load(std::memory_order_relaxed) > 0) {
+        const int n = queue.DequeueBatch(batch, batchSize);
+        if (0 == n) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            sum += batch[i];
+        }
+        numLeft -= n;
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+template<class QUEUE> void
+run(const char* name, QUEUE& queue, int numProducers, int numConsumers, int batchSize) {
+    TimePoint t = Clock::Now();
+    std::atomic<int> numLeft(NumElements);
+    std::atomic<int64_t> sum(0);
+    const int numPerProducer = NumElements / numProducers;
+    std::thread producers[4];
+    std::thread consumers[4];
+    for (int i = 0; i < numProducers; i++) {
+        producers[i] = std::thread([&queue, i, numPerProducer, batchSize] {
+            produce(queue, i * numPerProducer, numPerProducer, batchSize);
+        });
+    }
+    for (int i = 0; i < numConsumers; i++) {
+        consumers[i] = std::thread([&queue, &numLeft, &sum, batchSize] {
+            sum += consume(queue, numLeft, batchSize);
+        });
+    }
+    for (int i = 0; i < numProducers; i++) {
+        producers[i].join();
+    }
+    for (int i = 0; i < numConsumers; i++) {
+        consumers[i].join();
+    }
+    const double ms = Clock::Since(t).AsMilliSeconds();
+    Log::Info("  %-8s %dP%dC batch %2d: %9.3f ms (%6.1f ns/elm, sum %lld)\n",
+        name, numProducers, numConsumers, batchSize, ms, (ms * 1000000.0) / NumElements, (long long)sum.load());
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+QueueBenchmarkApp::OnRunning() {
+    Log::Info("QueueBenchmark (%d elements, capacity %d):\n", NumElements, Capacity);
+    for (int batchSize : { 1, BatchSize }) {
+        {
+            lockedQueue queue;
+            run("locked", queue, 1, 1, batchSize);
+        }
+        {
+            SPSCQueue<int> queue;
+            queue.Setup(Capacity);
+            run("SPSC", queue, 1, 1, batchSize);
+        }
+        {
+            MPMCQueue<int> queue;
+            queue.Setup(Capacity);
+            run("MPMC", queue, 1, 1, batchSize);
+        }
+        {
+            lockedQueue queue;
+            run("locked", queue, 4, 4, batchSize);
+        }
+        {
+            MPMCQueue<int> queue;
+            queue.Setup(Capacity);
+            run("MPMC", queue, 4, 4, batchSize);
+        }
+    }
+    return AppState::Cleanup;
+}
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//  SmallFilesBenchmark.cc
+//  Measures loading many small files through the LocalFileSystem in
+//  each LocalFileSystem::ReadMode: blocking reads on the IO worker
+//  threads (Sync, the old behaviour), a pread() thread pool, and batched
+//  io_uring reads (Linux only, falls back to the thread pool). All files
+//  are requested at once, times are per file. The files are in the
+//  page cache (they have just been written), unless -drop is given,
+//  which evicts them with posix_fadvise() before each run (Linux only).
+//  Options: -files N (default 4096), -kb N (file size, default 4),
+//  -runs N, -drop, -json path.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/IO.h"
+#include "LocalFS/LocalFileSystem.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include <cstdio>
+#include <thread>
+#if ORYOL_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Oryol;
+
+class SmallFilesBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(SmallFilesBenchmarkApp);
+
+namespace {
+
+Array<URL> urls;
+Array<Ptr<IORead>> reads;
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+waitAll(const Array<Ptr<TYPE>>& requests) {
+    for (const auto& req : requests) {
+        while (!req->Handled) {
+            Core::PreRunLoop()->Run();
+            std::this_thread::yield();
+        }
+        o_assert(IOStatus::OK == req->Status);
+    }
+}
+
+//------------------------------------------------------------------------------
+// evict the test files from the page cache
+void
+dropCaches() {
+    #if ORYOL_LINUX
+    for (const URL& url : urls) {
+        int fd = open(url.Path().AsCStr(), O_RDONLY);
+        if (fd >= 0) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+// start loading all files, and wait until they are loaded
+void
+loadAll() {
+    reads.Clear();
+    for (const URL& url : urls) {
+        reads.Add(IO::LoadFile(url));
+    }
+    waitAll(reads);
+    reads.Clear();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+SmallFilesBenchmarkApp::OnRunning() {
+    const int numFiles = OryolArgs.GetInt("-files", 4096);
+    const int fileSize = OryolArgs.GetInt("-kb", 4) * 1024;
+    const bool drop = OryolArgs.HasArg("-drop");
+    const LocalFileSystem::ReadMode::Code defaultMode = LocalFileSystem::GetReadMode();
+
+    // write the test files
+    {
+        LocalFileSystem::SetReadMode(LocalFileSystem::ReadMode::Sync);
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+        IO::Setup(ioSetup);
+        Buffer data;
+        uint8_t* ptr = data.Add(fileSize);
+        for (int i = 0; i < fileSize; i++) {
+            ptr[i] = uint8_t(i * 31);
+        }
+        Array<Ptr<IOWrite>> writes;
+        StringBuilder strBuilder;
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, "root:smallfiles_bench_%d.bin", i);
+            urls.Add(URL(IO::ResolveAssigns(strBuilder.GetString())));
+            writes.Add(IO::WriteFile(urls.Back(), data));
+        }
+        waitAll(writes);
+        IO::Discard();
+    }
+    Log::Info("SmallFilesBenchmark: %d files of %d KB%s\n", numFiles, fileSize / 1024, drop ? " (uncached)" : "");
+
+    BenchmarkSuite suite("SmallFilesBenchmark");
+    suite.NumRuns = OryolArgs.GetInt("-runs", 11);
+    suite.NumWarmupRuns = 1;
+    const struct {
+        const char* name;
+        LocalFileSystem::ReadMode::Code mode;
+    } modes[] = {
+        { "LoadFile.Sync", LocalFileSystem::ReadMode::Sync },
+        { "LoadFile.ThreadPool", LocalFileSystem::ReadMode::ThreadPool },
+        { "LoadFile.IOUring", LocalFileSystem::ReadMode::IOUring },
+    };
+    for (const auto& mode : modes) {
+        LocalFileSystem::SetReadMode(mode.mode);
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+        IO::Setup(ioSetup);
+        if (drop) {
+            suite.Run(mode.name, numFiles, dropCaches, loadAll);
+        }
+        else {
+            suite.Run(mode.name, numFiles, loadAll);
+        }
+        IO::Discard();
+    }
+    LocalFileSystem::SetReadMode(defaultMode);
+    suite.PrintResults();
+    for (const auto& result : suite.Results()) {
+        Log::Info("  %-24s %8.1f files/s\n", result.Name.AsCStr(), 1.0e9 / result.MedianNs);
+    }
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+
+    // delete the test files
+    for (const URL& url : urls) {
+        std::remove(url.Path().AsCStr());
+    }
+    urls.Clear();
+    return AppState::Cleanup;
+}
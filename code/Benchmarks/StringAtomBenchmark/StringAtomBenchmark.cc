@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+//  StringAtomBenchmark.cc
+//  Measure StringAtom creation (new strings) and lookup (existing
+//  strings) throughput while the atom table grows to 1M entries, and
+//  compare cross-thread operator== and memory use of the thread-local
+//  atom tables against the process-global atom table.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Memory/SizeClassAllocator.h"
+#include "Core/String/StringAtom.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace Oryol;
+
+namespace {
+
+// an allocator backend which tracks the number of live bytes, small
+// blocks come from the SizeClassAllocator, big blocks (which the
+// SizeClassAllocator forwards to malloc) are remembered in a map
+class trackingAllocator : public Allocator {
+public:
+    void* Alloc(int numBytes) override {
+        SizeClassAllocator* sca = SizeClassAllocator::Instance();
+        void* ptr = sca->Alloc(numBytes);
+        if (sca->Owns(ptr)) {
+            this->NumBytes += sca->BlockSize(ptr);
+        }
+        else {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->bigBlocks[ptr] = numBytes;
+            this->NumBytes += numBytes;
+        }
+        return ptr;
+    };
+    void* ReAlloc(void* ptr, int numBytes) override {
+        const int oldBytes = this->blockSize(ptr);
+        void* newPtr = this->Alloc(numBytes);
+        std::memcpy(newPtr, ptr, oldBytes < numBytes ? oldBytes : numBytes);
+        this->Free(ptr);
+        return newPtr;
+    };
+    void Free(void* ptr) override {
+        SizeClassAllocator* sca = SizeClassAllocator::Instance();
+        this->NumBytes -= this->blockSize(ptr);
+        if (sca->Owns(ptr)) {
+            sca->Free(ptr);
+        }
+        else {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->bigBlocks.erase(ptr);
+            std::free(ptr);
+        }
+    };
+    bool Owns(const void* ptr) const override {
+        if (SizeClassAllocator::Instance()->Owns(ptr)) {
+            return true;
+        }
+        std::lock_guard<std::mutex> guard(this->lock);
+        return this->bigBlocks.count(ptr) > 0;
+    };
+    void ReleaseThreadCache() override {
+        SizeClassAllocator::Instance()->ReleaseThreadCache();
+    };
+    std::atomic<int64_t> NumBytes{0};
+private:
+    int blockSize(const void* ptr) const {
+        SizeClassAllocator* sca = SizeClassAllocator::Instance();
+        if (sca->Owns(ptr)) {
+            return sca->BlockSize(ptr);
+        }
+        std::lock_guard<std::mutex> guard(this->lock);
+        return this->bigBlocks.find(ptr)->second;
+    };
+    mutable std::mutex lock;
+    std::unordered_map<const void*, int> bigBlocks;
+};
+trackingAllocator allocator;
+
+} // anonymous namespace
+
+class StringAtomBenchmarkApp : public App {
+public:
+    StringAtomBenchmarkApp() {
+        this->coreSetup.MemoryAllocator = &allocator;
+    };
+    AppState::Code OnRunning();
+};
+OryolMain(StringAtomBenchmarkApp);
+
+namespace {
+
+const int MaxAtoms = 1000000;
+const int NameLength = 16;
+const int NumLookups = 1000000;
+const int NumThreads = 4;
+const int NumSharedAtoms = 10000;
+const int NumCompareRounds = 100;
+
+//------------------------------------------------------------------------------
+// create atoms for names [first, last), returns number of non-empty atoms
+int
+create(const char* names, int first, int last) {
+    int num = 0;
+    for (int i = first; i < last; i++) {
+        StringAtom atom(&names[i * NameLength]);
+        num += atom.IsValid() ? 1 : 0;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+// create atoms from existing strings in random order
+int
+lookup(const char* names, int numNames) {
+    int num = 0;
+    for (int i = 0; i < NumLookups; i++) {
+        const int index = int((uint32_t(i) * 7919u) % uint32_t(numNames));
+        StringAtom atom(&names[index * NameLength]);
+        num += atom.IsValid() ? 1 : 0;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+// create the same atoms on the main thread and NumThreads other threads,
+// then compare the other threads' atoms against the main thread's atoms
+void
+crossThread(const char* label, const char* names, Array<StringAtom> (&atoms)[NumThreads + 1]) {
+    for (Array<StringAtom>& arr : atoms) {
+        arr.Reserve(NumSharedAtoms);
+    }
+    const int64_t bytes = allocator.NumBytes;
+    for (int i = 0; i < NumSharedAtoms; i++) {
+        atoms[0].Add(StringAtom(&names[i * NameLength]));
+    }
+    for (int t = 1; t <= NumThreads; t++) {
+        std::thread thread([&atoms, names, t] {
+            Core::EnterThread();
+            for (int i = 0; i < NumSharedAtoms; i++) {
+                atoms[t].Add(StringAtom(&names[i * NameLength]));
+            }
+            Core::LeaveThread();
+        });
+        thread.join();
+    }
+    const double kBytes = double(allocator.NumBytes - bytes) / 1024.0;
+
+    TimePoint t = Clock::Now();
+    int num = 0;
+    for (int round = 0; round < NumCompareRounds; round++) {
+        for (int i = 0; i < NumSharedAtoms; i++) {
+            num += (atoms[0][i] == atoms[1 + (i % NumThreads)][i]) ? 1 : 0;
+        }
+    }
+    const double eqTime = Clock::Since(t).AsMilliSeconds();
+    o_assert(num == NumCompareRounds * NumSharedAtoms);
+    Log::Info("  %-12s %d threads x %d atoms: memory %8.1f KB, cross-thread == %8.3f ms (%5.1f ns/op)\n",
+        label, NumThreads + 1, NumSharedAtoms, kBytes,
+        eqTime, (eqTime * 1000000.0) / num);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+StringAtomBenchmarkApp::OnRunning() {
+    char* names = (char*) Memory::Alloc(MaxAtoms * NameLength);
+    for (int i = 0; i < MaxAtoms; i++) {
+        std::snprintf(&names[i * NameLength], NameLength, "atom_%010d", i);
+    }
+
+    Log::Info("StringAtomBenchmark:\n");
+    const int steps[] = { 10000, 100000, 1000000 };
+    int numAtoms = 0;
+    for (int step : steps) {
+        TimePoint t = Clock::Now();
+        const int numCreated = create(names, numAtoms, step);
+        const double createTime = Clock::LapTime(t).AsMilliSeconds();
+        const int numFound = lookup(names, step);
+        const double lookupTime = Clock::LapTime(t).AsMilliSeconds();
+        Log::Info("  %7d atoms: create %7d: %9.3f ms (%6.1f ns/atom), lookup %d: %9.3f ms (%6.1f ns/atom)\n",
+            step,
+            numCreated, createTime, (createTime * 1000000.0) / numCreated,
+            numFound, lookupTime, (lookupTime * 1000000.0) / numFound);
+        numAtoms = step;
+    }
+
+    // cross-thread comparison with different (long-ish) strings, thread-local
+    // tables first, since atoms in the global table stay there
+    for (int i = 0; i < NumSharedAtoms; i++) {
+        std::snprintf(&names[i * NameLength], NameLength, "shared_%08d", i);
+    }
+    Array<StringAtom> localAtoms[NumThreads + 1];
+    crossThread("thread-local", names, localAtoms);
+    StringAtom::UseGlobalTable(true);
+    for (int i = 0; i < NumSharedAtoms; i++) {
+        std::snprintf(&names[i * NameLength], NameLength, "global_%08d", i);
+    }
+    Array<StringAtom> globalAtoms[NumThreads + 1];
+    crossThread("global", names, globalAtoms);
+    StringAtom::UseGlobalTable(false);
+    Memory::Free(names);
+    return AppState::Cleanup;
+}
@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+//  StringBenchmark.cc
+//  Measure time and number of heap allocations for typical short-string
+//  workloads: String creation and copies, URL parsing, and churning
+//  resource locators through a ResourceRegistry.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Time/Clock.h"
+#include "Core/Memory/SizeClassAllocator.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/IOTypes.h"
+#include "Resource/ResourceRegistry.h"
+#include <atomic>
+
+using namespace Oryol;
+
+namespace {
+
+// an allocator backend which counts allocations
+class countingAllocator : public Allocator {
+public:
+    void* Alloc(int numBytes) override {
+        this->NumAllocs++;
+        return SizeClassAllocator::Instance()->Alloc(numBytes);
+    };
+    void* ReAlloc(void* ptr, int numBytes) override {
+        this->NumAllocs++;
+        return SizeClassAllocator::Instance()->ReAlloc(ptr, numBytes);
+    };
+    void Free(void* ptr) override {
+        SizeClassAllocator::Instance()->Free(ptr);
+    };
+    bool Owns(const void* ptr) const override {
+        return SizeClassAllocator::Instance()->Owns(ptr);
+    };
+    void ReleaseThreadCache() override {
+        SizeClassAllocator::Instance()->ReleaseThreadCache();
+    };
+    std::atomic<int64_t> NumAllocs{0};
+};
+countingAllocator allocator;
+
+const int NumStrings = 1000;
+const int NumRounds = 200;
+
+//------------------------------------------------------------------------------
+// print time and allocations per operation since t/allocs
+void
+report(const char* name, TimePoint t, int64_t allocs, int numOps) {
+    const double ms = Clock::Since(t).AsMilliSeconds();
+    const double numAllocs = double(allocator.NumAllocs.load() - allocs);
+    Log::Info("  %-24s %9.3f ms (%6.1f ns/op, %5.2f allocs/op)\n",
+        name, ms, (ms * 1000000.0) / numOps, numAllocs / numOps);
+}
+
+} // anonymous namespace
+
+class StringBenchmarkApp : public App {
+public:
+    StringBenchmarkApp() {
+        this->coreSetup.MemoryAllocator = &allocator;
+    };
+    AppState::Code OnRunning();
+};
+OryolMain(StringBenchmarkApp);
+
+//------------------------------------------------------------------------------
+AppState::Code
+StringBenchmarkApp::OnRunning() {
+    Log::Info("StringBenchmark (String::InlineCapacity %d):\n", String::InlineCapacity);
+
+    // source strings
+    StringBuilder sb;
+    Array<StringAtom> shortNames;
+    Array<StringAtom> longNames;
+    Array<StringAtom> urls;
+    for (int i = 0; i < NumStrings; i++) {
+        sb.Format(64, "tex_%d", i);
+        shortNames.Add(StringAtom(sb.AsCStr()));
+        sb.Format(128, "data/textures/environment/tile_%04d_diffuse.dds", i);
+        longNames.Add(StringAtom(sb.AsCStr()));
+        sb.Format(128, "http://cdn%d.oryol.io:8080/tex/t%d.dds#lod%d", i % 8, i, i % 4);
+        urls.Add(StringAtom(sb.AsCStr()));
+    }
+
+    // String creation and copies
+    int64_t allocs = allocator.NumAllocs;
+    TimePoint t = Clock::Now();
+    int len = 0;
+    for (int round = 0; round < NumRounds; round++) {
+        for (const StringAtom& name : shortNames) {
+            String str(name);
+            String copy(str);
+            len += copy.Length();
+        }
+    }
+    report("short String + copy", t, allocs, NumRounds * NumStrings);
+    allocs = allocator.NumAllocs;
+    t = Clock::Now();
+    for (int round = 0; round < NumRounds; round++) {
+        for (const StringAtom& name : longNames) {
+            String str(name);
+            String copy(str);
+            len += copy.Length();
+        }
+    }
+    report("long String + copy", t, allocs, NumRounds * NumStrings);
+
+    // URL parsing (URL strings are already in the StringAtom table)
+    allocs = allocator.NumAllocs;
+    t = Clock::Now();
+    for (int round = 0; round < NumRounds; round++) {
+        for (const StringAtom& str : urls) {
+            URL url(str);
+            len += url.Scheme().Length();
+            len += url.Host().Length();
+            len += url.Port().Length();
+            len += url.Path().Length();
+            len += url.Fragment().Length();
+        }
+    }
+    report("URL parsing", t, allocs, NumRounds * NumStrings);
+
+    // Locator churn through a ResourceRegistry
+    ResourceRegistry registry;
+    registry.Setup(NumStrings);
+    allocs = allocator.NumAllocs;
+    t = Clock::Now();
+    for (int round = 0; round < NumRounds; round++) {
+        for (int i = 0; i < NumStrings; i++) {
+            sb.Format(64, "tex_%d", i);
+            const String name = sb.GetString();
+            registry.Add(Locator(name.AsCStr()), Id(uint32_t(round), uint16_t(i), 1), ResourceLabel(round));
+        }
+        for (int i = 0; i < NumStrings; i++) {
+            sb.Format(64, "tex_%d", i);
+            const String name = sb.GetString();
+            len += registry.Lookup(Locator(name.AsCStr())).IsValid() ? 1 : 0;
+        }
+        registry.Remove(ResourceLabel(round));
+        Core::PostRunLoop()->Run();
+    }
+    report("Locator churn", t, allocs, NumRounds * NumStrings * 2);
+    registry.Discard();
+    Log::Info("  (checksum %d)\n", len);
+
+    return AppState::Cleanup;
+}
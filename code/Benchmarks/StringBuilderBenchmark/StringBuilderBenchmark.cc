@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  StringBuilderBenchmark.cc
+//  Measures the StringBuilder search, substitute and tokenize functions
+//  on a multi-megabyte config-file-like text, with the C library
+//  functions as baseline. Times are per byte of input. Optionally writes
+//  the results as JSON (-json path), the number of timed runs can be
+//  changed with -runs N.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/String/StringBuilder.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+#include <cstring>
+
+#if ORYOL_WINDOWS
+#define o_strtok strtok_s
+#else
+#define o_strtok strtok_r
+#endif
+
+using namespace Oryol;
+
+class StringBuilderBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(StringBuilderBenchmarkApp);
+
+namespace {
+
+const int NumLines = 100000;
+
+StringBuilder text;
+StringBuilder work;
+
+//------------------------------------------------------------------------------
+// about 5 MByte of 'key = value' lines, with a single '#' and 'EOF' at the end
+void
+makeText() {
+    text.Clear();
+    for (int i = 0; i < NumLines; i++) {
+        text.AppendFormat(128, "section%d.key%d = root:textures/level%d/material_%d.dds\n",
+            i % 13, i, i % 7, i);
+    }
+    text.Append("# EOF\n");
+}
+
+//------------------------------------------------------------------------------
+void
+searchBenchmarks(BenchmarkSuite& suite) {
+    const int len = text.Length();
+    suite.Run("FindFirstOf.strcspn", len, [] {
+        BenchmarkSuite::DoNotOptimize(std::strcspn(text.AsCStr(), "#"));
+    });
+    suite.Run("FindFirstOf.1", len, [] {
+        BenchmarkSuite::DoNotOptimize(text.FindFirstOf(0, EndOfString, "#"));
+    });
+    suite.Run("FindFirstOf.4", len, [] {
+        BenchmarkSuite::DoNotOptimize(text.FindFirstOf(0, EndOfString, "#!;\t"));
+    });
+    suite.Run("FindFirstNotOf.strspn", len, [] {
+        BenchmarkSuite::DoNotOptimize(std::strspn(text.AsCStr(), "abcdefghijklmnopqrstuvwxyz0123456789_.:/= \n"));
+    });
+    suite.Run("FindFirstNotOf.1", len, [] {
+        BenchmarkSuite::DoNotOptimize(text.FindFirstNotOf(0, EndOfString, "abcdefghijklmnopqrstuvwxyz0123456789_.:/= \n"));
+    });
+    suite.Run("FindSubString.strstr", len, [] {
+        BenchmarkSuite::DoNotOptimize(std::strstr(text.AsCStr(), "# EOF"));
+    });
+    suite.Run("FindSubString", len, [] {
+        BenchmarkSuite::DoNotOptimize(text.FindSubString(0, EndOfString, "# EOF"));
+    });
+    suite.Run("FindSubString.long", len, [] {
+        BenchmarkSuite::DoNotOptimize(text.FindSubString(0, EndOfString, "material_99999.dds\n# EOF"));
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+substituteBenchmarks(BenchmarkSuite& suite) {
+    const int len = text.Length();
+    auto reset = [] {
+        work.Set(text.GetString());
+    };
+    suite.Run("SubstituteAll.grow", len, reset, [] {
+        BenchmarkSuite::DoNotOptimize(work.SubstituteAll("root:", "data:/shared/"));
+    });
+    suite.Run("SubstituteAll.shrink", len, reset, [] {
+        BenchmarkSuite::DoNotOptimize(work.SubstituteAll("textures/", "tex/"));
+    });
+    suite.Run("SubstituteAll.same", len, reset, [] {
+        BenchmarkSuite::DoNotOptimize(work.SubstituteAll(".dds", ".ktx"));
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+tokenizeBenchmarks(BenchmarkSuite& suite) {
+    const int len = text.Length();
+    static Array<String> tokens;
+    auto reset = [] {
+        work.Set(text.GetString());
+        tokens.Clear();
+    };
+    suite.Run("Tokenize.strtok", len, reset, [] {
+        char* context = nullptr;
+        char* ptr = const_cast<char*>(work.AsCStr());
+        const char* token;
+        while (nullptr != (token = o_strtok(ptr, " =\n", &context))) {
+            tokens.Add(token);
+            ptr = nullptr;
+        }
+        BenchmarkSuite::DoNotOptimize(tokens);
+    });
+    suite.Run("Tokenize", len, reset, [] {
+        work.Tokenize(" =\n", tokens);
+        BenchmarkSuite::DoNotOptimize(tokens);
+    });
+    suite.Run("Tokenize.lines", len, reset, [] {
+        work.Tokenize("\n", tokens);
+        BenchmarkSuite::DoNotOptimize(tokens);
+    });
+    suite.Run("Tokenize.fence", len, reset, [] {
+        work.Tokenize(" =\n", '"', tokens);
+        BenchmarkSuite::DoNotOptimize(tokens);
+    });
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+StringBuilderBenchmarkApp::OnRunning() {
+    BenchmarkSuite suite("StringBuilderBenchmark");
+    suite.NumWarmupRuns = 1;
+    suite.NumRuns = OryolArgs.GetInt("-runs", 11);
+    makeText();
+    Log::Info("input text: %d bytes\n", text.Length());
+    searchBenchmarks(suite);
+    substituteBenchmarks(suite);
+    tokenizeBenchmarks(suite);
+    suite.PrintResults();
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+    text.Clear();
+    work.Clear();
+    return AppState::Cleanup;
+}
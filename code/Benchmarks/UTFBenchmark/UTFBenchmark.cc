@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  UTFBenchmark.cc
+//  Measures the UTF-8 <=> wide string conversion of the StringConverter
+//  and String::NumChars() on an ASCII-heavy and a CJK-heavy text, with
+//  the previous ConvertUTF based implementation as baseline. Times are
+//  per byte of UTF-8 text. Optionally writes the results as JSON
+//  (-json path), the number of timed runs can be changed with -runs N.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/Memory/Memory.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/String/StringConverter.h"
+#include "Core/String/ConvertUTF.h"
+#include "Benchmarks/Benchmark/BenchmarkSuite.h"
+
+using namespace Oryol;
+
+class UTFBenchmarkApp : public App {
+public:
+    AppState::Code OnRunning();
+};
+OryolMain(UTFBenchmarkApp);
+
+namespace {
+
+const int NumLines = 40000;
+
+String text;
+WideString wide;
+
+//------------------------------------------------------------------------------
+// the previous StringConverter::UTF8ToWide(), converting one code point
+// at a time into an oversized buffer, and copying into the result
+WideString
+convertUTF8ToWide(const String& src) {
+    WideString result;
+    const int bufSize = (src.Length() + 1) * sizeof(wchar_t);
+    wchar_t* buf = (wchar_t*) Memory::Alloc(bufSize);
+    const UTF8* srcPtr = (const UTF8*) src.AsCStr();
+    UTF32* dstPtr = (UTF32*) buf;
+    if (conversionOK == ConvertUTF8toUTF32(&srcPtr, srcPtr + src.Length(), &dstPtr, (UTF32*) buf + src.Length(), strictConversion)) {
+        *dstPtr = 0;
+        result = buf;
+    }
+    Memory::Free(buf);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// the previous StringConverter::WideToUTF8()
+String
+convertWideToUTF8(const WideString& src) {
+    String result;
+    const int bufSize = (src.Length() * 6) + 1;
+    UTF8* buf = (UTF8*) Memory::Alloc(bufSize);
+    const UTF32* srcPtr = (const UTF32*) src.AsCStr();
+    UTF8* dstPtr = buf;
+    if (conversionOK == ConvertUTF32toUTF8(&srcPtr, srcPtr + src.Length(), &dstPtr, buf + bufSize - 1, strictConversion)) {
+        *dstPtr = 0;
+        result = (const char*) buf;
+    }
+    Memory::Free(buf);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// count UTF-8 characters one byte at a time
+int
+numCharsScalar(const String& str) {
+    int n = 0;
+    for (const char* ptr = str.AsCStr(); *ptr; ptr++) {
+        n += ((*ptr & 0xC0) != 0x80) ? 1 : 0;
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+void
+makeText(const char* line) {
+    StringBuilder builder;
+    for (int i = 0; i < NumLines; i++) {
+        builder.AppendFormat(256, "%d: %s\n", i, line);
+    }
+    text = builder.GetString();
+    wide = StringConverter::UTF8ToWide(text);
+    o_assert(!wide.Empty());
+}
+
+//------------------------------------------------------------------------------
+void
+runBenchmarks(BenchmarkSuite& suite, const char* name) {
+    const int len = text.Length();
+    StringBuilder label;
+    label.Format(64, "%s.UTF8ToWide.ConvertUTF", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(convertUTF8ToWide(text));
+    });
+    label.Format(64, "%s.UTF8ToWide", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(StringConverter::UTF8ToWide(text));
+    });
+    label.Format(64, "%s.WideToUTF8.ConvertUTF", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(convertWideToUTF8(wide));
+    });
+    label.Format(64, "%s.WideToUTF8", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(StringConverter::WideToUTF8(wide));
+    });
+    label.Format(64, "%s.NumChars.scalar", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(numCharsScalar(text));
+    });
+    label.Format(64, "%s.NumChars", name);
+    suite.Run(label.AsCStr(), len, [] {
+        BenchmarkSuite::DoNotOptimize(text.NumChars());
+    });
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+AppState::Code
+UTFBenchmarkApp::OnRunning() {
+    BenchmarkSuite suite("UTFBenchmark");
+    suite.NumWarmupRuns = 1;
+    suite.NumRuns = OryolArgs.GetInt("-runs", 11);
+    if (sizeof(wchar_t) != 4) {
+        Log::Warn("UTFBenchmark: the ConvertUTF baseline expects a 4-byte wchar_t\n");
+        return AppState::Cleanup;
+    }
+    makeText("The quick brown fox jumps over the lazy dog, sagte der B\xC3\xA4r zur Maus.");
+    Log::Info("ASCII-heavy text: %d bytes, %d chars\n", text.Length(), text.NumChars());
+    runBenchmarks(suite, "ascii");
+    makeText("\xE6\x95\x8F\xE6\x8D\xB7\xE7\x9A\x84\xE6\xA3\x95\xE8\x89\xB2\xE7\x8B\x90\xE7\x8B\xB8"
+             "\xE8\xB7\xB3\xE8\xBF\x87\xE4\xBA\x86\xE6\x87\x92\xE7\x8B\x97\xEF\xBC\x8C"
+             "\xE3\x81\x99\xE3\x81\xB0\xE3\x82\x84\xE3\x81\x84\xE8\x8C\xB6\xE8\x89\xB2\xE3\x81\xAE"
+             "\xE7\x8B\x90\xE3\x80\x82 v2.0");
+    Log::Info("CJK-heavy text: %d bytes, %d chars\n", text.Length(), text.NumChars());
+    runBenchmarks(suite, "cjk");
+    suite.PrintResults();
+    if (OryolArgs.HasArg("-json")) {
+        const String path = OryolArgs.GetString("-json");
+        if (!suite.WriteJSONFile(path.AsCStr())) {
+            Log::Warn("Failed to write '%s'\n", path.AsCStr());
+        }
+    }
+    text.Clear();
+    wide.Clear();
+    return AppState::Cleanup;
+}
@@ -18,7 +18,7 @@ MeshLoaderBase(setup_) {
 
 //------------------------------------------------------------------------------
 MeshLoader::MeshLoader(const MeshSetup& setup_, LoadedFunc loadedFunc_) :
-MeshLoaderBase(setup_, loadedFunc_) {
+MeshLoaderBase(setup_, std::move(loadedFunc_)) {
     // empty
 }
 
@@ -56,8 +56,10 @@ MeshLoader::Continue() {
         if (IOStatus::OK == this->ioRequest->Status) {
             // async loading has finished, use OmshParser to
             // create a MeshSetup object from the loaded data
-            const void* data = this->ioRequest->Data.Data();
-            const int numBytes = this->ioRequest->Data.Size();
+            // coalesced or mapped reads return their data in View
+            const auto& view = this->ioRequest->View;
+            const void* data = view ? view->Data() : this->ioRequest->Data.Data();
+            const int numBytes = view ? view->Size() : this->ioRequest->Data.Size();
 
             MeshSetup meshSetup = MeshSetup::FromData(this->setup);
             if (OmshParser::Parse(data, numBytes, meshSetup)) {
@@ -14,7 +14,7 @@
 namespace Oryol {
 
 class MeshLoader : public MeshLoaderBase {
-    OryolClassDecl(MeshLoader);
+    OryolClassPoolAllocDecl(MeshLoader);
 public:
     /// constructor without success-callback
     MeshLoader(const MeshSetup& setup);
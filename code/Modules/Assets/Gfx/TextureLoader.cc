@@ -19,7 +19,7 @@ TextureLoaderBase(setup_) {
 
 //------------------------------------------------------------------------------
 TextureLoader::TextureLoader(const TextureSetup& setup_, LoadedFunc loadedFunc_) :
-TextureLoaderBase(setup_, loadedFunc_) {
+TextureLoaderBase(setup_, std::move(loadedFunc_)) {
   // empty
 }
 
@@ -57,8 +57,10 @@ TextureLoader::Continue() {
         if (IOStatus::OK == this->ioRequest->Status) {
             // yeah, IO is done, let gliml parse the texture data
             // and create the texture resource
-            const uint8_t* data = this->ioRequest->Data.Data();
-            const int numBytes = this->ioRequest->Data.Size();
+            // coalesced or mapped reads return their data in View
+            const auto& view = this->ioRequest->View;
+            const uint8_t* data = view ? view->Data() : this->ioRequest->Data.Data();
+            const int numBytes = view ? view->Size() : this->ioRequest->Data.Size();
             
             gliml::context ctx;
             ctx.enable_dxt(true);
@@ -15,7 +15,7 @@ class context;
 namespace Oryol {
 
 class TextureLoader : public TextureLoaderBase {
-    OryolClassDecl(TextureLoader);
+    OryolClassPoolAllocDecl(TextureLoader);
 public:
     /// constructor without success-callback
     TextureLoader(const TextureSetup& setup);
@@ -67,7 +67,7 @@ App::~App() {
 void
 App::StartMainLoop() {
     o_assert(nullptr != self);
-    Core::Setup();
+    Core::Setup(this->coreSetup);
     Log::Info("=> App::StartMainLoop()\n");
     #if ORYOL_EMSCRIPTEN
         emscripten_set_main_loop(staticOnFrame, 0, 1);
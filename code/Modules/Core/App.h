@@ -33,6 +33,7 @@
     ```
 */
 #include "Core/Args.h"
+#include "Core/Core.h"
 #include "Core/AppState.h"
 #include "Core/Containers/Set.h"
 
@@ -84,6 +85,8 @@ public:
 
 protected:    
     static App* self;
+    /// Core module setup params, may be tweaked in the subclass constructor
+    CoreSetup coreSetup;
     AppState::Code curState;
     AppState::Code nextState;
     Set<AppState::Code> blockers;
@@ -31,6 +31,20 @@
 // does the platform have std::atomic support?
 #define ORYOL_HAS_ATOMIC (1)
 
+// does the platform have SSE2 intrinsics?
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_HAS_SSE2 (1)
+#else
+#define ORYOL_HAS_SSE2 (0)
+#endif
+
+// does the platform have NEON intrinsics?
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ORYOL_HAS_NEON (1)
+#else
+#define ORYOL_HAS_NEON (0)
+#endif
+
 // platform specific max-alignment
 #if ORYOL_EMSCRIPTEN
 #define ORYOL_MAX_PLATFORM_ALIGN (4)
@@ -39,6 +53,9 @@
 #define ORYOL_MAX_PLATFORM_ALIGN (16)
 #endif
 
+/// cache line size, used to keep data written by different threads apart
+#define ORYOL_CACHELINE_SIZE (64)
+
 /// memory debug fill pattern (byte)
 #define ORYOL_MEMORY_DEBUG_BYTE (0xBB)
 /// memory debug fill pattern (short)
@@ -0,0 +1,206 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Algorithms
+    @ingroup Core
+    @brief sort and search algorithms for Slices and Arrays
+
+    Sort() sorts with std::sort.
+
+    ParallelSort() is a parallel merge sort on the job system: the slice
+    is split into runs which are sorted in parallel with std::sort, then
+    neighbouring runs are merged in parallel (with std::inplace_merge)
+    until one sorted run is left. It isn't stable, and it must be called
+    explicitly: the elements are moved on the job worker threads, so
+    elements which are bound to a thread (like StringAtoms, which are
+    re-interned into the thread-local string atom table when moved
+    between threads) must not be sorted with it.
+
+    RadixSort() is a stable LSD radix sort with 8-bit digits for
+    elements with unsigned integer keys (the key is extracted with a
+    function object, e.g. the Value of a resource Id), or for integer
+    elements. Passes where all keys have the same digit are skipped. The
+    element type must be trivially copyable, since the elements are
+    copied between the slice and a temporary buffer.
+
+    FindIndex() is a linear search which compares integer, enum and
+    pointer elements with SIMD instructions where available.
+
+    ```cpp
+    Array<Id> ids = ...;
+    Algorithms::RadixSort(ids.MakeSlice(), [](const Id& id) {
+        return id.Value;
+    });
+
+    Array<int> values = ...;
+    Algorithms::Sort(values.MakeSlice());
+    int index = Algorithms::FindIndex(values.MakeSlice(), 42);
+    ```
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Containers/Slice.h"
+#include "Core/Containers/linearSearch.h"
+#include "Core/Jobs/Jobs.h"
+#include "Core/Memory/Memory.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace Oryol {
+
+class Algorithms {
+public:
+    /// min number of elements per run in ParallelSort()
+    static const int MinParallelSortRun = 8 * 1024;
+
+    /// sort a slice
+    template<class TYPE> static void Sort(Slice<TYPE> items);
+    /// sort a slice with a less-than function object
+    template<class TYPE, class LESS> static void Sort(Slice<TYPE> items, const LESS& less);
+    /// sort a slice with a parallel merge sort
+    template<class TYPE> static void ParallelSort(Slice<TYPE> items);
+    /// sort a slice with a less-than function object with a parallel merge sort
+    template<class TYPE, class LESS> static void ParallelSort(Slice<TYPE> items, const LESS& less);
+    /// stable radix sort by unsigned integer keys returned by keyFunc(const TYPE&)
+    template<class TYPE, class KEYFUNC> static void RadixSort(Slice<TYPE> items, const KEYFUNC& keyFunc);
+    /// stable radix sort of integer elements
+    template<class TYPE> static void RadixSort(Slice<TYPE> items);
+
+    /// find index of first element equal to val, or InvalidIndex
+    template<class TYPE> static int FindIndex(const Slice<TYPE>& items, const TYPE& val);
+
+private:
+    /// get start index of a run
+    static int runStart(int num, int numRuns, int run) {
+        return int((int64_t(num) * run) / numRuns);
+    };
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Algorithms::Sort(Slice<TYPE> items) {
+    Sort(items, std::less<TYPE>());
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class LESS> void
+Algorithms::Sort(Slice<TYPE> items, const LESS& less) {
+    std::sort(items.begin(), items.end(), less);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Algorithms::ParallelSort(Slice<TYPE> items) {
+    ParallelSort(items, std::less<TYPE>());
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class LESS> void
+Algorithms::ParallelSort(Slice<TYPE> items, const LESS& less) {
+    const int num = items.Size();
+    TYPE* base = items.begin();
+
+    // a power-of-2 number of runs, 2 per thread for better load balancing
+    const int numThreads = Jobs::NumWorkers() + 1;
+    int numRuns = 1;
+    while ((numRuns < (2 * numThreads)) && ((num / (numRuns * 2)) >= MinParallelSortRun)) {
+        numRuns *= 2;
+    }
+    if (1 == numRuns) {
+        std::sort(base, base + num, less);
+        return;
+    }
+
+    // sort the runs in parallel
+    Jobs::ParallelFor(numRuns, [base, num, numRuns, &less](int begin, int end) {
+        for (int run = begin; run < end; run++) {
+            std::sort(base + runStart(num, numRuns, run), base + runStart(num, numRuns, run + 1), less);
+        }
+    }, 1);
+
+    // merge neighbouring runs in parallel until one run is left
+    for (int width = 1; width < numRuns; width *= 2) {
+        Jobs::ParallelFor(numRuns / (2 * width), [base, num, numRuns, width, &less](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                const int first = runStart(num, numRuns, 2 * i * width);
+                const int middle = runStart(num, numRuns, (2 * i + 1) * width);
+                const int last = runStart(num, numRuns, (2 * i + 2) * width);
+                std::inplace_merge(base + first, base + middle, base + last, less);
+            }
+        }, 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEYFUNC> void
+Algorithms::RadixSort(Slice<TYPE> items, const KEYFUNC& keyFunc) {
+    typedef typename std::decay<decltype(keyFunc(*items.begin()))>::type KEY;
+    static_assert(std::is_unsigned<KEY>::value, "RadixSort: key must be an unsigned integer type");
+    static_assert(std::is_trivially_copyable<TYPE>::value, "RadixSort: element type must be trivially copyable");
+    const int NumDigits = int(sizeof(KEY));
+
+    const int num = items.Size();
+    if (num < 2) {
+        return;
+    }
+
+    // histograms of all digits in one pass
+    int counts[NumDigits][256] = { };
+    TYPE* src = items.begin();
+    for (int i = 0; i < num; i++) {
+        const KEY key = keyFunc(src[i]);
+        for (int d = 0; d < NumDigits; d++) {
+            counts[d][(key >> (d * 8)) & 0xFF]++;
+        }
+    }
+
+    const int64_t numBytes = int64_t(num) * int64_t(sizeof(TYPE));
+    o_assert(numBytes <= int64_t(std::numeric_limits<int>::max()));
+    TYPE* tmp = (TYPE*) Memory::Alloc(int(numBytes));
+    TYPE* dst = tmp;
+    for (int d = 0; d < NumDigits; d++) {
+        // skip the pass if all keys have the same digit
+        const int shift = d * 8;
+        const int digit = int((keyFunc(src[0]) >> shift) & 0xFF);
+        if (counts[d][digit] == num) {
+            continue;
+        }
+        int offsets[256];
+        int sum = 0;
+        for (int i = 0; i < 256; i++) {
+            offsets[i] = sum;
+            sum += counts[d][i];
+        }
+        for (int i = 0; i < num; i++) {
+            const int digit = int((keyFunc(src[i]) >> shift) & 0xFF);
+            dst[offsets[digit]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != items.begin()) {
+        Memory::Copy(src, items.begin(), int(numBytes));
+    }
+    Memory::Free(tmp);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Algorithms::RadixSort(Slice<TYPE> items) {
+    static_assert(std::is_integral<TYPE>::value, "RadixSort: element type must be an integer type");
+    typedef typename std::make_unsigned<TYPE>::type KEY;
+    // flip the sign bit of signed values, so that negative values sort first
+    const KEY flip = std::is_signed<TYPE>::value ? KEY(KEY(1) << (sizeof(KEY) * 8 - 1)) : KEY(0);
+    RadixSort(items, [flip](const TYPE& val) {
+        return KEY(KEY(val) ^ flip);
+    });
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+Algorithms::FindIndex(const Slice<TYPE>& items, const TYPE& val) {
+    return _priv::findIndexLinear(items.begin(), items.Size(), val);
+}
+
+} // namespace Oryol
@@ -25,6 +25,12 @@
     
     NOTE: An array growth operation will truncate any spare room
     at the front.
+
+    The element memory can be allocated through an optional Allocator
+    (see SetAllocator()), for instance Core::FrameAllocator() for
+    temporary arrays which only live until the end of the frame. A copy
+    will use the allocator of the destination array, a move will take
+    over the allocator of the source array.
     
     For sorting, iterating and sorted insertion, use the standard 
     algorithm stuff!
@@ -34,6 +40,7 @@
 #include "Core/Config.h"
 #include "Core/Containers/elementBuffer.h"
 #include "Core/Containers/Slice.h"
+#include "Core/Containers/linearSearch.h"
 #include <initializer_list>
 
 namespace Oryol {
@@ -58,6 +65,10 @@ public:
     
     /// set allocation strategy
     void SetAllocStrategy(int minGrow_, int maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// set an optional allocator (e.g. Core::FrameAllocator()), array must be empty
+    void SetAllocator(Allocator* allocator);
+    /// get the optional allocator (nullptr if default allocator)
+    Allocator* GetAllocator() const;
     /// initialize the array to a fixed capacity (guarantees that no re-allocs happen)
     void SetFixedCapacity(int fixedCapacity);
     /// get min grow value
@@ -121,7 +132,7 @@ public:
     /// erase a range of elements, keep element order
     void EraseRange(int index, int num);
     
-    /// find element index with slow linear search, return InvalidIndex if not found
+    /// find element index with linear search (SIMD for integer types), return InvalidIndex if not found
     int FindIndexLinear(const TYPE& elm, int startIndex=0, int endIndex=InvalidIndex) const;
     
     /// C++ conform begin
@@ -214,6 +225,19 @@ Array<TYPE>::SetAllocStrategy(int minGrow_, int maxGrow_) {
     this->maxGrow = maxGrow_;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::SetAllocator(Allocator* allocator) {
+    o_assert_dbg(nullptr == this->buffer.buf);
+    this->buffer.allocator = allocator;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> Allocator*
+Array<TYPE>::GetAllocator() const {
+    return this->buffer.allocator;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 Array<TYPE>::SetFixedCapacity(int fixedCapacity) {
@@ -302,7 +326,7 @@ Array<TYPE>::MakeSlice(int offset, int numItems) {
     if (numItems == EndOfRange) {
         numItems = this->buffer.size() - offset;
     }
-    return Slice<TYPE>(this->buffer.buf, this->buffer.size(), offset, numItems);
+    return Slice<TYPE>(this->buffer._begin(), this->buffer.size(), offset, numItems);
 }
 
 //------------------------------------------------------------------------------
@@ -434,11 +458,10 @@ Array<TYPE>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) cons
             o_assert_dbg(endIndex <= size);
         }
         o_assert_dbg(startIndex <= endIndex);
-        for (int i = startIndex; i < endIndex; i++) {
-            TYPE* ptr = &(this->buffer.buf[this->buffer.start + i]);
-            if (elm == *ptr) {
-                return i;
-            }
+        const TYPE* ptr = &(this->buffer.buf[this->buffer.start + startIndex]);
+        const int index = _priv::findIndexLinear(ptr, endIndex - startIndex, elm);
+        if (InvalidIndex != index) {
+            return startIndex + index;
         }
     }
     // fallthrough: not found
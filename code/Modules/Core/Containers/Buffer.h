@@ -4,10 +4,15 @@
     @class Oryol::Buffer
     @ingroup Core
     @brief growable memory buffer for raw data
+
+    The buffer memory can be allocated through an optional Allocator
+    (see SetAllocator()), a move transfers the allocator together with
+    the buffer memory.
 */
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
 
 namespace Oryol {
 
@@ -28,6 +33,10 @@ public:
     /// move-assignment
     void operator=(Buffer&& rhs);
 
+    /// set an optional allocator (e.g. Core::FrameAllocator()), buffer must be empty
+    void SetAllocator(Allocator* allocator);
+    /// get the optional allocator (nullptr if default allocator)
+    Allocator* GetAllocator() const;
     /// get number of bytes in buffer
     int Size() const;
     /// return true if empty
@@ -59,10 +68,13 @@ private:
     void destroy();
     /// append-copy content into currently allocated buffer, bump size
     void copy(const uint8_t* ptr, int numBytes);
+    /// free buffer memory through allocator or Memory::Free
+    void freeMem(uint8_t* ptr);
 
     int size;
     int capacity;
     uint8_t* data;
+    Allocator* allocator;
 };
 
 //------------------------------------------------------------------------------
@@ -70,7 +82,8 @@ inline
 Buffer::Buffer() :
 size(0),
 capacity(0),
-data(nullptr) {
+data(nullptr),
+allocator(nullptr) {
     // empty
 }
 
@@ -79,10 +92,12 @@ inline
 Buffer::Buffer(Buffer&& rhs) :
 size(rhs.size),
 capacity(rhs.capacity),
-data(rhs.data) {
+data(rhs.data),
+allocator(rhs.allocator) {
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
+    rhs.allocator = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -97,23 +112,34 @@ Buffer::alloc(int newCapacity) {
     o_assert_dbg(newCapacity > this->capacity);
     o_assert_dbg(newCapacity > this->size);
 
-    uint8_t* newBuf = (uint8_t*) Memory::Alloc(newCapacity);
+    uint8_t* newBuf = (uint8_t*) (this->allocator ? this->allocator->Alloc(newCapacity) : Memory::Alloc(newCapacity));
     if (this->size > 0) {
         o_assert_dbg(this->data);
         Memory::Copy(this->data, newBuf, this->size);
     }
     if (this->data) {
-        Memory::Free(this->data);
+        this->freeMem(this->data);
     }
     this->data = newBuf;
     this->capacity = newCapacity;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::freeMem(uint8_t* ptr) {
+    if (this->allocator) {
+        this->allocator->Free(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 inline void
 Buffer::destroy() {
     if (this->data) {
-        Memory::Free(this->data);
+        this->freeMem(this->data);
     }
     this->data = nullptr;
     this->size = 0;
@@ -137,9 +163,24 @@ Buffer::operator=(Buffer&& rhs) {
     this->size = rhs.size;
     this->capacity = rhs.capacity;
     this->data = rhs.data;
+    this->allocator = rhs.allocator;
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
+    rhs.allocator = nullptr;
+}
+
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetAllocator(Allocator* allocator_) {
+    o_assert_dbg(nullptr == this->data);
+    this->allocator = allocator_;
+}
+
+//------------------------------------------------------------------------------
+inline Allocator*
+Buffer::GetAllocator() const {
+    return this->allocator;
 }
 
 //------------------------------------------------------------------------------
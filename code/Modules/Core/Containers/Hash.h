@@ -0,0 +1,81 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Hash
+    @ingroup Core
+    @brief default hash functions for the hashed containers
+
+    Hash<TYPE> is a function object which returns a 32-bit hash for a
+    value, this is used as default HASHER by the HashMap and HashSet
+    containers. Hash functions for integer, enum and pointer types are
+    provided here, other types (like String and StringAtom) provide a
+    specialization in their own header, for instance:
+
+    ```cpp
+    namespace Oryol {
+    template<> struct Hash<MyType> {
+        uint32_t operator()(const MyType& val) const {
+            return Hash<uint64_t>()(val.Value);
+        };
+    };
+    }
+    ```
+
+    The low bits of the hash must be well distributed, since the hashed
+    containers use them to select a slot.
+
+    @see HashMap, HashSet
+*/
+#include "Core/Types.h"
+#include <type_traits>
+
+namespace Oryol {
+
+namespace _priv {
+/// scramble a 64-bit integer into a 32-bit hash (MurmurHash3 finalizer)
+inline uint32_t
+hashMix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return uint32_t(key);
+}
+
+/// hash a zero-terminated string (Bob Jenkins' one-at-a-time hash)
+inline uint32_t
+hashString(const char* str) {
+    // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
+    const char* p = str;
+    uint32_t h = 0;
+    char c;
+    while (0 != (c = *p++)) {
+        h += c;
+        h += (h << 10);
+        h ^= (h >> 6);
+    }
+    h += (h << 3);
+    h ^= (h >> 11);
+    h += (h << 15);
+    return h;
+}
+} // namespace _priv
+
+template<class TYPE, class ENABLE=void> struct Hash;
+
+/// hash function for integer and enum types
+template<class TYPE> struct Hash<TYPE, typename std::enable_if<std::is_integral<TYPE>::value || std::is_enum<TYPE>::value>::type> {
+    uint32_t operator()(TYPE val) const {
+        return _priv::hashMix(uint64_t(val));
+    };
+};
+
+/// hash function for pointers
+template<class TYPE> struct Hash<TYPE*, void> {
+    uint32_t operator()(const TYPE* ptr) const {
+        return _priv::hashMix(uint64_t(uintptr_t(ptr)));
+    };
+};
+
+} // namespace Oryol
@@ -0,0 +1,685 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief key-value map with hashed lookup
+
+    A key-value-pair container with the same interface as Map, but
+    with O(1) lookup, insertion and removal. Use a HashMap instead of
+    a Map when the map may grow big, or is on a hot path.
+
+    The key-value-pairs are stored in a dense array (in insertion
+    order, removing elements moves the last element into the gap), and
+    an open-addressing hash table with Robin Hood hashing maps keys to
+    array indices. Iteration, FindIndex() and the ...AtIndex() methods
+    work like in Map, but the elements are not sorted.
+
+    Differences to Map:
+
+    - keys must be unique, Add() asserts that the key doesn't exist yet
+    - elements are not sorted by key
+    - removing an element changes the index of the last element
+    - in bulk mode, the hash table is built in EndBulk()
+
+    The hash function is provided by the HASHER template argument,
+    which defaults to Oryol::Hash<KEY> (see Core/Containers/Hash.h).
+
+    @see Map, Hash, KeyValuePair
+*/
+#include "Core/Config.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/elementBuffer.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/Hash.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER=Hash<KEY>> class HashMap {
+public:
+    /// default constructor
+    HashMap();
+    /// copy constructor (truncates to actual size)
+    HashMap(const HashMap& rhs);
+    /// move constructor (same capacity and size)
+    HashMap(HashMap&& rhs);
+    /// destructor
+    ~HashMap();
+
+    /// copy-assignment operator (truncates to actual size)
+    void operator=(const HashMap& rhs);
+    /// move-assignment operator (same capacity and size)
+    void operator=(HashMap&& rhs);
+
+    /// set allocation strategy
+    void SetAllocStrategy(int minGrow_, int maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int GetMinGrow() const;
+    /// get max grow value
+    int GetMaxGrow() const;
+    /// get number of elements in map
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity of map
+    int Capacity() const;
+
+    /// read/write access single element
+    VALUE& operator[](const KEY& key);
+    /// read-only access single element
+    const VALUE& operator[](const KEY& key) const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// trim capacity to size (this involves a re-alloc)
+    void Trim();
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// add new element (key must not exist)
+    void Add(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element (key must not exist)
+    void Add(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move-semantics, return false if element with key already existed
+    bool AddUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// erase element matching key, does nothing if key not contained
+    void Erase(const KEY& key);
+
+    /// begin bulk-mode
+    void BeginBulk();
+    /// add element in bulk-mode (no lookups allowed until EndBulk)
+    void AddBulk(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add element in bulk-mode (no lookups allowed until EndBulk)
+    void AddBulk(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add element in bulk-mode (no lookups allowed until EndBulk)
+    void AddBulk(const KEY& key, const VALUE& value);
+    /// end bulk-mode (hash table is built here)
+    void EndBulk();
+    /// find an element, returns index, or InvalidIndex
+    int FindIndex(const KEY& key) const;
+    /// erase element at index (moves the last element to index)
+    void EraseIndex(int index);
+    /// get key at index
+    const KEY& KeyAtIndex(int index) const;
+    /// get value at index (read-only)
+    const VALUE& ValueAtIndex(int index) const;
+    /// get value at index (read/write)
+    VALUE& ValueAtIndex(int index);
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* begin();
+    /// C++ conform begin, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* begin() const;
+    /// C++ conform end,  MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* end();
+    /// C++ conform end, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* end() const;
+
+private:
+    /// a hash table slot, hash 0 means empty
+    struct slot {
+        uint32_t hash;
+        int32_t index;
+    };
+    /// compute hash for key (never 0)
+    static uint32_t hashOf(const KEY& key);
+    /// get number of hash table slots for an element capacity
+    static int numSlotsFor(int capacity);
+    /// find hash table slot index of key, or InvalidIndex
+    int findSlot(const KEY& key, uint32_t hash) const;
+    /// insert an element index into the hash table
+    void insertSlot(uint32_t hash, int index);
+    /// remove a hash table slot (backward-shift deletion)
+    void eraseSlot(int slotIndex);
+    /// erase element by its hash table slot
+    void eraseAt(int slotIndex);
+    /// re-build hash table with new number of slots
+    void rehash(int newNumSlots);
+    /// add element after uniqueness check
+    template<class KVP> void add(KVP&& kvp, uint32_t hash);
+    /// destroy content
+    void destroy();
+    /// copy content
+    void copy(const HashMap& rhs);
+    /// move content
+    void move(HashMap&& rhs);
+    /// reallocate with new capacity
+    void adjustCapacity(int newCapacity);
+    /// grow to make room
+    void grow();
+
+    _priv::elementBuffer<KeyValuePair<KEY,VALUE>> buffer;
+    slot* slots;
+    int numSlots;
+    int minGrow;
+    int maxGrow;
+    bool inBulkMode;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap() :
+slots(nullptr),
+numSlots(0),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW),
+inBulkMode(false) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(const HashMap& rhs) :
+slots(nullptr),
+numSlots(0) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(HashMap&& rhs) :
+slots(nullptr),
+numSlots(0) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::~HashMap() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(const HashMap& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(HashMap&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::GetMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::GetMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->buffer.size();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return this->buffer.size() == 0;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->buffer.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    o_assert_dbg(!this->inBulkMode);
+    const int slotIndex = this->findSlot(key, hashOf(key));
+    o_assert(InvalidIndex != slotIndex);    // not found if this triggers
+    return this->buffer[this->slots[slotIndex].index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    o_assert_dbg(!this->inBulkMode);
+    const int slotIndex = this->findSlot(key, hashOf(key));
+    o_assert_dbg(InvalidIndex != slotIndex);    // not found if this triggers
+    return this->buffer[this->slots[slotIndex].index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int numElements) {
+    int newCapacity = this->buffer.size() + numElements;
+    if (newCapacity > this->buffer.capacity()) {
+        this->adjustCapacity(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Trim() {
+    const int curSize = this->buffer.size();
+    if (curSize < this->buffer.capacity()) {
+        this->buffer.alloc(curSize, 0);
+        const int newNumSlots = numSlotsFor(curSize);
+        if (newNumSlots < this->numSlots) {
+            this->rehash(newNumSlots);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->buffer.clear();
+    if (this->slots) {
+        Memory::Clear(this->slots, this->numSlots * int(sizeof(slot)));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    o_assert_dbg(!this->inBulkMode);
+    return InvalidIndex != this->findSlot(key, hashOf(key));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class KVP> void
+HashMap<KEY, VALUE, HASHER>::add(KVP&& kvp, uint32_t hash) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(std::forward<KVP>(kvp));
+    this->insertSlot(hash, this->buffer.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
+    o_assert_dbg(!this->inBulkMode);
+    const uint32_t hash = hashOf(kvp.key);
+    o_assert_dbg(InvalidIndex == this->findSlot(kvp.key, hash));    // key already exists if this triggers
+    this->add(kvp, hash);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
+    o_assert_dbg(!this->inBulkMode);
+    const uint32_t hash = hashOf(kvp.key);
+    o_assert_dbg(InvalidIndex == this->findSlot(kvp.key, hash));    // key already exists if this triggers
+    this->add(std::move(kvp), hash);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->Add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KeyValuePair<KEY, VALUE>& kvp) {
+    o_assert(!this->inBulkMode);
+    const uint32_t hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findSlot(kvp.key, hash)) {
+        return false;
+    }
+    else {
+        this->add(kvp, hash);
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    o_assert(!this->inBulkMode);
+    const uint32_t hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findSlot(kvp.key, hash)) {
+        return false;
+    }
+    else {
+        this->add(std::move(kvp), hash);
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    return this->AddUnique(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    o_assert_dbg(!this->inBulkMode);
+    const int slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        this->eraseAt(slotIndex);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::BeginBulk() {
+    o_assert(!this->inBulkMode);
+    this->inBulkMode = true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::AddBulk(const KeyValuePair<KEY, VALUE>& kvp) {
+    o_assert(this->inBulkMode);
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(kvp);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::AddBulk(KeyValuePair<KEY, VALUE>&& kvp) {
+    o_assert(this->inBulkMode);
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(std::move(kvp));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::AddBulk(const KEY& key, const VALUE& value) {
+    this->AddBulk(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::EndBulk() {
+    o_assert(this->inBulkMode);
+    this->inBulkMode = false;
+    this->rehash(numSlotsFor(this->buffer.capacity()));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::FindIndex(const KEY& key) const {
+    o_assert(!this->inBulkMode);
+    const int slotIndex = this->findSlot(key, hashOf(key));
+    if (InvalidIndex != slotIndex) {
+        return this->slots[slotIndex].index;
+    }
+    else {
+        return InvalidIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::EraseIndex(int index) {
+    o_assert_dbg(!this->inBulkMode);
+    const KEY& key = this->buffer[index].key;
+    const int slotIndex = this->findSlot(key, hashOf(key));
+    o_assert_dbg(InvalidIndex != slotIndex);
+    this->eraseAt(slotIndex);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KEY&
+HashMap<KEY, VALUE, HASHER>::KeyAtIndex(int index) const {
+    return this->buffer[index].key;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int index) const {
+    return this->buffer[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int index) {
+    return this->buffer[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> uint32_t
+HashMap<KEY, VALUE, HASHER>::hashOf(const KEY& key) {
+    const uint32_t hash = HASHER()(key);
+    return hash ? hash : 1;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::numSlotsFor(int capacity) {
+    // power-of-2 number of slots, with a max load factor of 0.8
+    int num = 8;
+    while (((num * 4) / 5) < capacity) {
+        num <<= 1;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::findSlot(const KEY& key, uint32_t hash) const {
+    if (0 == this->numSlots) {
+        return InvalidIndex;
+    }
+    const uint32_t mask = uint32_t(this->numSlots - 1);
+    uint32_t pos = hash & mask;
+    for (uint32_t dist = 0; ; dist++) {
+        const slot& s = this->slots[pos];
+        if (0 == s.hash) {
+            return InvalidIndex;
+        }
+        // Robin Hood invariant: the key would have been placed before
+        // any element which is closer to its home slot
+        if (((pos - (s.hash & mask)) & mask) < dist) {
+            return InvalidIndex;
+        }
+        if ((s.hash == hash) && (this->buffer[s.index].key == key)) {
+            return int(pos);
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::insertSlot(uint32_t hash, int index) {
+    o_assert_dbg(this->numSlots > 0);
+    const uint32_t mask = uint32_t(this->numSlots - 1);
+    slot cur = { hash, index };
+    uint32_t pos = hash & mask;
+    uint32_t dist = 0;
+    for (;;) {
+        slot& s = this->slots[pos];
+        if (0 == s.hash) {
+            s = cur;
+            return;
+        }
+        // steal the slot from elements which are closer to their home slot
+        const uint32_t slotDist = (pos - (s.hash & mask)) & mask;
+        if (slotDist < dist) {
+            const slot tmp = s;
+            s = cur;
+            cur = tmp;
+            dist = slotDist;
+        }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::eraseSlot(int slotIndex) {
+    const uint32_t mask = uint32_t(this->numSlots - 1);
+    uint32_t pos = uint32_t(slotIndex);
+    uint32_t next = (pos + 1) & mask;
+    while ((0 != this->slots[next].hash) && (0 != ((next - (this->slots[next].hash & mask)) & mask))) {
+        this->slots[pos] = this->slots[next];
+        pos = next;
+        next = (next + 1) & mask;
+    }
+    this->slots[pos].hash = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::eraseAt(int slotIndex) {
+    const int index = this->slots[slotIndex].index;
+    const int lastIndex = this->buffer.size() - 1;
+    this->eraseSlot(slotIndex);
+    if (index != lastIndex) {
+        // the last element will be moved into the gap, fix its slot
+        const KEY& lastKey = this->buffer[lastIndex].key;
+        const int lastSlotIndex = this->findSlot(lastKey, hashOf(lastKey));
+        o_assert_dbg(InvalidIndex != lastSlotIndex);
+        this->slots[lastSlotIndex].index = index;
+    }
+    this->buffer.eraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::rehash(int newNumSlots) {
+    if (newNumSlots != this->numSlots) {
+        if (this->slots) {
+            Memory::Free(this->slots);
+        }
+        this->slots = (slot*) Memory::Alloc(newNumSlots * int(sizeof(slot)));
+        this->numSlots = newNumSlots;
+    }
+    Memory::Clear(this->slots, this->numSlots * int(sizeof(slot)));
+    const int size = this->buffer.size();
+    for (int i = 0; i < size; i++) {
+        const KEY& key = this->buffer[i].key;
+        const uint32_t hash = hashOf(key);
+        o_assert_dbg(InvalidIndex == this->findSlot(key, hash));    // duplicate key if this triggers
+        this->insertSlot(hash, i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::destroy() {
+    this->minGrow = 0;
+    this->maxGrow = 0;
+    this->buffer.destroy();
+    if (this->slots) {
+        Memory::Free(this->slots);
+        this->slots = nullptr;
+    }
+    this->numSlots = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::copy(const HashMap& rhs) {
+    o_assert_dbg(nullptr == this->slots);
+    this->minGrow    = rhs.minGrow;
+    this->maxGrow    = rhs.maxGrow;
+    this->inBulkMode = rhs.inBulkMode;
+    this->buffer     = rhs.buffer;
+    if (rhs.slots) {
+        this->numSlots = rhs.numSlots;
+        this->slots = (slot*) Memory::Alloc(this->numSlots * int(sizeof(slot)));
+        Memory::Copy(rhs.slots, this->slots, this->numSlots * int(sizeof(slot)));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::move(HashMap&& rhs) {
+    o_assert_dbg(!rhs.inBulkMode);
+    o_assert_dbg(nullptr == this->slots);
+    this->minGrow    = rhs.minGrow;
+    this->maxGrow    = rhs.maxGrow;
+    this->inBulkMode = rhs.inBulkMode;
+    this->buffer     = std::move(rhs.buffer);
+    this->slots      = rhs.slots;
+    this->numSlots   = rhs.numSlots;
+    rhs.slots = nullptr;
+    rhs.numSlots = 0;
+    // NOTE: don't reset minGrow/maxGrow, rhs is empty, but still a valid object!
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::adjustCapacity(int newCapacity) {
+    this->buffer.alloc(newCapacity, 0);
+    const int newNumSlots = numSlotsFor(newCapacity);
+    if (newNumSlots > this->numSlots) {
+        this->rehash(newNumSlots);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::grow() {
+    const int curCapacity = this->buffer.capacity();
+    int growBy = curCapacity >> 1;
+    if (growBy < minGrow) {
+        growBy = minGrow;
+    }
+    else if (growBy > maxGrow) {
+        growBy = maxGrow;
+    }
+    o_assert_dbg(growBy > 0);
+    int newCapacity = curCapacity + growBy;
+    this->adjustCapacity(newCapacity);
+}
+
+} // namespace Oryol
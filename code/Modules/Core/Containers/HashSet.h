@@ -4,18 +4,121 @@
     @class Oryol::HashSet
     @ingroup Core
     @brief a Set using hashing for fast access
-    
-    Implements a hash set with a fixed number of buckets, each
-    bucket is a binary-sorted set.
-    
-    @see Array, ArrayMap, Map, Set
+
+    A growable open-addressing hash set. The values are stored in a flat
+    slot array, and a separate array of 1-byte control values keeps
+    the state of each slot (empty, deleted or full), plus 7 bits of
+    the hash for full slots. Lookups compare 16 control bytes at once
+    (with SSE2 where available), so that usually only values with a
+    matching hash are compared.
+
+    The table grows by doubling when it is 7/8 full (deleted slots are
+    cleaned up when rehashing). Note that pointers to elements
+    returned by Find() are invalidated when the table grows.
+
+    The hash function is provided by the HASHER template argument,
+    which defaults to Oryol::Hash<VALUETYPE> (see Core/Containers/Hash.h).
+
+    @see Array, ArrayMap, HashMap, Map, Set
 */
 #include "Core/Config.h"
-#include "Core/Containers/Set.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Hash.h"
+#include "Core/bitOps.h"
+#include <utility>
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Oryol {
 
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> class HashSet {
+namespace _priv {
+
+/// a group of 16 control bytes of a HashSet
+class ctrlGroup {
+public:
+    /// number of control bytes in a group
+    static const int Width = 16;
+    /// control byte of an empty slot
+    static const int8_t Empty = -128;
+    /// control byte of a deleted slot
+    static const int8_t Deleted = -2;
+
+    /// load from (unaligned) control bytes
+    explicit ctrlGroup(const int8_t* ptr);
+    /// get bit mask of slots with matching 7-bit hash
+    uint32_t Match(int8_t h2) const;
+    /// get bit mask of empty slots
+    uint32_t MatchEmpty() const;
+    /// get bit mask of empty or deleted slots
+    uint32_t MatchEmptyOrDeleted() const;
+    /// get number of unset bits above the highest set bit (mask must not be 0)
+    static int LeadingZeros(uint32_t mask);
+
+private:
+    #if ORYOL_HAS_SSE2
+    __m128i ctrl;
+    #else
+    const int8_t* ctrl;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+inline
+ctrlGroup::ctrlGroup(const int8_t* ptr) {
+    #if ORYOL_HAS_SSE2
+    this->ctrl = _mm_loadu_si128((const __m128i*)ptr);
+    #else
+    this->ctrl = ptr;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+ctrlGroup::Match(int8_t h2) const {
+    #if ORYOL_HAS_SSE2
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->ctrl)));
+    #else
+    uint32_t mask = 0;
+    for (int i = 0; i < Width; i++) {
+        mask |= uint32_t(this->ctrl[i] == h2) << i;
+    }
+    return mask;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+ctrlGroup::MatchEmpty() const {
+    return this->Match(Empty);
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+ctrlGroup::MatchEmptyOrDeleted() const {
+    // empty and deleted are the only control bytes < -1
+    #if ORYOL_HAS_SSE2
+    return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), this->ctrl)));
+    #else
+    uint32_t mask = 0;
+    for (int i = 0; i < Width; i++) {
+        mask |= uint32_t(this->ctrl[i] < -1) << i;
+    }
+    return mask;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline int
+ctrlGroup::LeadingZeros(uint32_t mask) {
+    o_assert_dbg((0 != mask) && (mask < (1<<Width)));
+    return Width - 1 - highestBit(mask);
+}
+
+} // namespace _priv
+
+template<class VALUETYPE, class HASHER=Hash<VALUETYPE>> class HashSet {
 public:
     /// default constructor
     HashSet();
@@ -23,163 +126,450 @@ public:
     HashSet(const HashSet& rhs);
     /// move constructor
     HashSet(HashSet&& rhs);
+    /// destructor
+    ~HashSet();
     /// copy-assignment operator
     void operator=(const HashSet& rhs);
     /// move-assignment operator (same capacity and size)
     void operator=(HashSet&& rhs);
-    
-    /// set allocation strategy
+
+    /// set allocation strategy (minGrow is the initial capacity, the table grows by doubling)
     void SetAllocStrategy(int minGrow, int maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     /// get min grow value
     int GetMinGrow() const;
     /// get max grow value
     int GetMaxGrow() const;
-    /// get number of elements in array
+    /// get number of elements in set
     int Size() const;
     /// return true if empty
     bool Empty() const;
-    
+    /// get number of elements which fit into the set without rehashing
+    int Capacity() const;
+
+    /// make room for at least numElements more elements
+    void Reserve(int numElements);
+    /// remove all elements (keeps capacity)
+    void Clear();
+
     /// test if an element exists
     bool Contains(const VALUETYPE& val) const;
     /// find element
     const VALUETYPE* Find(const VALUETYPE& val) const;
-    /// add element
+    /// add element (must not exist)
     void Add(const VALUETYPE& val);
-    /// erase element
+    /// add element with move-semantics (must not exist)
+    void Add(VALUETYPE&& val);
+    /// erase element, does nothing if element doesn't exist
     void Erase(const VALUETYPE& val);
-    
+
 private:
-    /// get the bucket for a value
-    const Set<VALUETYPE>& findBucket(const VALUETYPE& val) const;
-    /// get the bucket for a value
-    Set<VALUETYPE>& findBucket(const VALUETYPE& val);
+    /// compute full hash of a value
+    static uint32_t hashOf(const VALUETYPE& val);
+    /// get max number of elements for a number of slots (7/8 load factor)
+    static int maxLoad(int slots);
+    /// find slot index of value, or InvalidIndex
+    int findSlot(const VALUETYPE& val, uint32_t hash) const;
+    /// find first empty or deleted slot in the probe sequence of a hash
+    int findFreeSlot(uint32_t hash) const;
+    /// set a control byte (also updates the mirrored control bytes)
+    void setCtrl(int slotIndex, int8_t c);
+    /// find a free slot for a new value, grows the table if necessary
+    int prepareInsert(const VALUETYPE& val, uint32_t hash);
+    /// allocate a new table and move the elements over
+    void rehash(int newNumSlots);
+    /// allocate an empty table
+    void alloc(int newNumSlots);
+    /// destroy content
+    void destroy();
+    /// copy content
+    void copy(const HashSet& rhs);
+    /// move content
+    void move(HashSet&& rhs);
 
+    VALUETYPE* slots;
+    int8_t* ctrl;
+    int numSlots;
     int size;
-    Set<VALUETYPE> buckets[NUMBUCKETS];
+    int growthLeft;
+    int minGrow;
+    int maxGrow;
 };
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() :
-size(0) {
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER>::HashSet() :
+slots(nullptr),
+ctrl(nullptr),
+numSlots(0),
+size(0),
+growthLeft(0),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
     // empty
-};
+}
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(const HashSet& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = rhs.buckets[i];
-    };
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER>::HashSet(const HashSet& rhs) :
+slots(nullptr),
+ctrl(nullptr),
+numSlots(0),
+size(0),
+growthLeft(0) {
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(HashSet&& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = std::move(rhs.buckets[i]);
-    }
-    rhs.size = 0;
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER>::HashSet(HashSet&& rhs) :
+slots(nullptr),
+ctrl(nullptr),
+numSlots(0),
+size(0),
+growthLeft(0) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+HashSet<VALUETYPE, HASHER>::~HashSet() {
+    this->destroy();
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::operator=(const HashSet& rhs) {
     if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = rhs.buckets[i];
-        }
+        this->destroy();
+        this->copy(rhs);
     }
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(HashSet&& rhs) {
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::operator=(HashSet&& rhs) {
     if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = std::move(rhs.buckets[i]);
-        }
-        rhs.size = 0;
+        this->destroy();
+        this->move(std::move(rhs));
     }
 }
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow, int maxGrow) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i].SetAllocStrategy(minGrow, maxGrow);
-    }
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMinGrow() const {
-    return this->buckets[0].GetMinGrow();
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::GetMinGrow() const {
+    return this->minGrow;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxGrow() const {
-    return this->buckets[0].GetMaxGrow();
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::GetMaxGrow() const {
+    return this->maxGrow;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Size() const {
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::Size() const {
     return this->size;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Empty() const {
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER>::Empty() const {
     return (0 == this->size);
 }
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Contains(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Contains(val);
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::Capacity() const {
+    return maxLoad(this->numSlots);
 }
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const VALUETYPE*
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Find(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Find(val);
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Reserve(int numElements) {
+    const int needed = this->size + numElements;
+    if (needed > this->Capacity()) {
+        int newNumSlots = this->numSlots > 0 ? this->numSlots : _priv::ctrlGroup::Width;
+        while (maxLoad(newNumSlots) < needed) {
+            newNumSlots <<= 1;
+        }
+        this->rehash(newNumSlots);
+    }
 }
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Add(const VALUETYPE& val) {
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Clear() {
+    for (int i = 0; i < this->numSlots; i++) {
+        if (this->ctrl[i] >= 0) {
+            this->slots[i].~VALUETYPE();
+        }
+    }
+    if (this->ctrl) {
+        Memory::Fill(this->ctrl, this->numSlots + _priv::ctrlGroup::Width, uint8_t(_priv::ctrlGroup::Empty));
+    }
+    this->size = 0;
+    this->growthLeft = maxLoad(this->numSlots);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER>::Contains(const VALUETYPE& val) const {
+    return InvalidIndex != this->findSlot(val, hashOf(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+HashSet<VALUETYPE, HASHER>::Find(const VALUETYPE& val) const {
+    const int slotIndex = this->findSlot(val, hashOf(val));
+    if (InvalidIndex != slotIndex) {
+        return &(this->slots[slotIndex]);
+    }
+    else {
+        return nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Add(const VALUETYPE& val) {
+    const uint32_t hash = hashOf(val);
+    const int slotIndex = this->prepareInsert(val, hash);
+    new(&(this->slots[slotIndex])) VALUETYPE(val);
+    this->setCtrl(slotIndex, int8_t(hash & 0x7F));
+    this->size++;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Add(VALUETYPE&& val) {
+    const uint32_t hash = hashOf(val);
+    const int slotIndex = this->prepareInsert(val, hash);
+    new(&(this->slots[slotIndex])) VALUETYPE(std::move(val));
+    this->setCtrl(slotIndex, int8_t(hash & 0x7F));
     this->size++;
-    auto& bucket = this->findBucket(val);
-    bucket.Add(val);
 }
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Erase(const VALUETYPE& val) {
-    o_assert_dbg(this->size > 0);
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Erase(const VALUETYPE& val) {
+    const int slotIndex = this->findSlot(val, hashOf(val));
+    if (InvalidIndex == slotIndex) {
+        return;
+    }
+    this->slots[slotIndex].~VALUETYPE();
     this->size--;
-    auto& bucket = this->findBucket(val);
-    bucket.Erase(val);
-};
-    
+
+    // if there was never a full group of 16 occupied slots around
+    // this slot, no probe sequence went past it, and the slot
+    // can be marked as empty instead of deleted
+    const int W = _priv::ctrlGroup::Width;
+    const int mask = this->numSlots - 1;
+    const uint32_t emptyBefore = _priv::ctrlGroup(this->ctrl + ((slotIndex - W) & mask)).MatchEmpty();
+    const uint32_t emptyAfter = _priv::ctrlGroup(this->ctrl + slotIndex).MatchEmpty();
+    if (emptyBefore && emptyAfter &&
+        ((_priv::ctrlGroup::LeadingZeros(emptyBefore) + _priv::lowestBit(emptyAfter)) < W)) {
+        this->setCtrl(slotIndex, _priv::ctrlGroup::Empty);
+        this->growthLeft++;
+    }
+    else {
+        this->setCtrl(slotIndex, _priv::ctrlGroup::Deleted);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> uint32_t
+HashSet<VALUETYPE, HASHER>::hashOf(const VALUETYPE& val) {
+    // scramble the hash, since the low 7 bits are stored in the
+    // control bytes, and the remaining bits select the slot
+    return _priv::hashMix(uint32_t(HASHER()(val)));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::maxLoad(int slots) {
+    return slots - (slots >> 3);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::findSlot(const VALUETYPE& val, uint32_t hash) const {
+    if (0 == this->size) {
+        return InvalidIndex;
+    }
+    // probe groups of 16 slots with triangular steps, this visits
+    // every group since the number of slots is a power of 2
+    const int8_t h2 = int8_t(hash & 0x7F);
+    const uint32_t mask = uint32_t(this->numSlots - 1);
+    uint32_t pos = (hash >> 7) & mask;
+    uint32_t step = 0;
+    for (;;) {
+        const _priv::ctrlGroup group(this->ctrl + pos);
+        uint32_t matches = group.Match(h2);
+        while (matches) {
+            const uint32_t slotIndex = (pos + _priv::lowestBit(matches)) & mask;
+            if (this->slots[slotIndex] == val) {
+                return int(slotIndex);
+            }
+            matches &= matches - 1;
+        }
+        if (group.MatchEmpty()) {
+            return InvalidIndex;
+        }
+        step += _priv::ctrlGroup::Width;
+        pos = (pos + step) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::findFreeSlot(uint32_t hash) const {
+    const uint32_t mask = uint32_t(this->numSlots - 1);
+    uint32_t pos = (hash >> 7) & mask;
+    uint32_t step = 0;
+    for (;;) {
+        const uint32_t free = _priv::ctrlGroup(this->ctrl + pos).MatchEmptyOrDeleted();
+        if (free) {
+            return int((pos + _priv::lowestBit(free)) & mask);
+        }
+        step += _priv::ctrlGroup::Width;
+        pos = (pos + step) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::setCtrl(int slotIndex, int8_t c) {
+    this->ctrl[slotIndex] = c;
+    // the first group is mirrored behind the last slot, so that
+    // a group can be loaded at any slot index
+    if (slotIndex < _priv::ctrlGroup::Width) {
+        this->ctrl[this->numSlots + slotIndex] = c;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::prepareInsert(const VALUETYPE& val, uint32_t hash) {
+    if (InvalidIndex != this->findSlot(val, hash)) {
+        o_error("Trying to insert duplicate element!\n");
+    }
+    if (0 == this->numSlots) {
+        this->Reserve(this->minGrow > 0 ? this->minGrow : 1);
+    }
+    int slotIndex = this->findFreeSlot(hash);
+    if (_priv::ctrlGroup::Deleted == this->ctrl[slotIndex]) {
+        // re-using a deleted slot doesn't reduce the free space
+        return slotIndex;
+    }
+    if (0 == this->growthLeft) {
+        // if many slots are deleted, rehash in place, otherwise grow
+        if (this->size <= (maxLoad(this->numSlots) / 2)) {
+            this->rehash(this->numSlots);
+        }
+        else {
+            this->rehash(this->numSlots * 2);
+        }
+        slotIndex = this->findFreeSlot(hash);
+    }
+    this->growthLeft--;
+    return slotIndex;
+}
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) const {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::alloc(int newNumSlots) {
+    o_assert_dbg((newNumSlots >= _priv::ctrlGroup::Width) && (0 == (newNumSlots & (newNumSlots - 1))));
+    // slots and control bytes live in the same memory block
+    const int slotBytes = newNumSlots * int(sizeof(VALUETYPE));
+    const int ctrlBytes = newNumSlots + _priv::ctrlGroup::Width;
+    uint8_t* ptr = (uint8_t*) Memory::Alloc(slotBytes + ctrlBytes);
+    this->slots = (VALUETYPE*) ptr;
+    this->ctrl = (int8_t*) (ptr + slotBytes);
+    Memory::Fill(this->ctrl, ctrlBytes, uint8_t(_priv::ctrlGroup::Empty));
+    this->numSlots = newNumSlots;
+    this->growthLeft = maxLoad(newNumSlots);
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::rehash(int newNumSlots) {
+    o_assert_dbg(maxLoad(newNumSlots) >= this->size);
+    VALUETYPE* oldSlots = this->slots;
+    int8_t* oldCtrl = this->ctrl;
+    const int oldNumSlots = this->numSlots;
+    this->alloc(newNumSlots);
+    for (int i = 0; i < oldNumSlots; i++) {
+        if (oldCtrl[i] >= 0) {
+            const uint32_t hash = hashOf(oldSlots[i]);
+            const int slotIndex = this->findFreeSlot(hash);
+            new(&(this->slots[slotIndex])) VALUETYPE(std::move(oldSlots[i]));
+            this->setCtrl(slotIndex, int8_t(hash & 0x7F));
+            oldSlots[i].~VALUETYPE();
+        }
+    }
+    this->growthLeft -= this->size;
+    if (oldSlots) {
+        Memory::Free(oldSlots);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::destroy() {
+    if (this->slots) {
+        this->Clear();
+        Memory::Free(this->slots);
+        this->slots = nullptr;
+        this->ctrl = nullptr;
+    }
+    this->numSlots = 0;
+    this->size = 0;
+    this->growthLeft = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::copy(const HashSet& rhs) {
+    o_assert_dbg(nullptr == this->slots);
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    if (rhs.slots) {
+        this->alloc(rhs.numSlots);
+        Memory::Copy(rhs.ctrl, this->ctrl, this->numSlots + _priv::ctrlGroup::Width);
+        for (int i = 0; i < this->numSlots; i++) {
+            if (this->ctrl[i] >= 0) {
+                new(&(this->slots[i])) VALUETYPE(rhs.slots[i]);
+            }
+        }
+        this->size = rhs.size;
+        this->growthLeft = rhs.growthLeft;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::move(HashSet&& rhs) {
+    o_assert_dbg(nullptr == this->slots);
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    this->slots = rhs.slots;
+    this->ctrl = rhs.ctrl;
+    this->numSlots = rhs.numSlots;
+    this->size = rhs.size;
+    this->growthLeft = rhs.growthLeft;
+    rhs.slots = nullptr;
+    rhs.ctrl = nullptr;
+    rhs.numSlots = 0;
+    rhs.size = 0;
+    rhs.growthLeft = 0;
 }
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
@@ -0,0 +1,307 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPMCQueue
+    @ingroup Core
+    @brief bounded lock-free multi-producer/multi-consumer FIFO queue
+
+    A fixed-capacity ring buffer which can be accessed by any number
+    of producer and consumer threads without locking (this is Dmitry
+    Vyukov's bounded MPMC queue). Each slot has a sequence number which
+    tells whether the slot is ready to be written or read in the
+    current lap around the ring. Producers and consumers claim slots
+    by bumping the shared write or read index with a compare-and-swap,
+    the two indices live on separate cache lines.
+
+    EnqueueBatch() and DequeueBatch() claim a run of consecutive ready
+    slots with a single compare-and-swap.
+
+    The capacity is rounded up to the next power of 2 and set once with
+    Setup(), Enqueue() returns false when the queue is full, Dequeue()
+    returns false when the queue is empty. Setup() and Discard() must
+    not be called while other threads access the queue.
+
+    @see SPSCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE> class MPMCQueue {
+public:
+    /// default constructor
+    MPMCQueue();
+    /// destructor
+    ~MPMCQueue();
+
+    /// setup the queue with a capacity (rounded up to power of 2)
+    void Setup(int capacity);
+    /// discard the queue (destroys remaining elements)
+    void Discard();
+    /// return true if the queue has been setup
+    bool IsValid() const;
+    /// get capacity of the queue
+    int Capacity() const;
+    /// get number of elements in the queue (only exact if the queue is idle)
+    int Size() const;
+    /// return true if the queue is empty (only exact if the queue is idle)
+    bool Empty() const;
+
+    /// copy-enqueue an element, return false if queue is full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element, return false if queue is full
+    bool Enqueue(TYPE&& elm);
+    /// move-enqueue up to num elements, return number of enqueued elements
+    int EnqueueBatch(TYPE* elms, int num);
+    /// dequeue an element, return false if queue is empty
+    bool Dequeue(TYPE& outElm);
+    /// dequeue up to maxNum elements, return number of dequeued elements
+    int DequeueBatch(TYPE* outElms, int maxNum);
+
+private:
+    /// not copyable
+    MPMCQueue(const MPMCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const MPMCQueue& rhs) = delete;
+    /// claim up to num slots for writing, returns first claimed position
+    uint32_t claimWrite(uint32_t num, uint32_t& outNum);
+    /// claim up to num slots for reading, returns first claimed position
+    uint32_t claimRead(uint32_t num, uint32_t& outNum);
+
+    struct cell {
+        std::atomic<uint32_t> seq;
+        typename std::aligned_storage<sizeof(TYPE), alignof(TYPE)>::type storage;
+        TYPE* elm() {
+            return (TYPE*) &this->storage;
+        };
+    };
+
+    // shared, read-only after Setup()
+    cell* cells;
+    uint32_t mask;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32_t> tail;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32_t> head;
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::MPMCQueue() :
+cells(nullptr),
+mask(0),
+tail(0),
+head(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::~MPMCQueue() {
+    if (this->IsValid()) {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+MPMCQueue<TYPE>::Setup(int capacity) {
+    o_assert_dbg(!this->IsValid());
+    o_assert_dbg((capacity > 0) && (capacity <= (1<<30)));
+    uint32_t num = 2;
+    while (num < uint32_t(capacity)) {
+        num <<= 1;
+    }
+    this->cells = (cell*) Memory::Alloc(int(num * sizeof(cell)));
+    for (uint32_t i = 0; i < num; i++) {
+        new(&this->cells[i].seq) std::atomic<uint32_t>(i);
+    }
+    this->mask = num - 1;
+    this->tail.store(0, std::memory_order_relaxed);
+    this->head.store(0, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+MPMCQueue<TYPE>::Discard() {
+    o_assert_dbg(this->IsValid());
+    const uint32_t t = this->tail.load(std::memory_order_acquire);
+    for (uint32_t h = this->head.load(std::memory_order_relaxed); h != t; h++) {
+        this->cells[h & this->mask].elm()->~TYPE();
+    }
+    Memory::Free(this->cells);
+    this->cells = nullptr;
+    this->mask = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::IsValid() const {
+    return nullptr != this->cells;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Capacity() const {
+    return this->cells ? int(this->mask + 1) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Size() const {
+    const uint32_t h = this->head.load(std::memory_order_acquire);
+    const uint32_t t = this->tail.load(std::memory_order_acquire);
+    const int num = int(t - h);
+    return num > 0 ? num : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+MPMCQueue<TYPE>::claimWrite(uint32_t num, uint32_t& outNum) {
+    uint32_t pos = this->tail.load(std::memory_order_relaxed);
+    for (;;) {
+        // count the consecutive slots which are free in this lap
+        uint32_t n = 0;
+        while (n < num) {
+            const uint32_t seq = this->cells[(pos + n) & this->mask].seq.load(std::memory_order_acquire);
+            if (seq != (pos + n)) {
+                break;
+            }
+            n++;
+        }
+        if (0 == n) {
+            const uint32_t seq = this->cells[pos & this->mask].seq.load(std::memory_order_acquire);
+            if (int32_t(seq - pos) < 0) {
+                // slot still holds an element from the previous lap: full
+                outNum = 0;
+                return pos;
+            }
+            // another producer was faster, retry
+            pos = this->tail.load(std::memory_order_relaxed);
+        }
+        else if (this->tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+            outNum = n;
+            return pos;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+MPMCQueue<TYPE>::claimRead(uint32_t num, uint32_t& outNum) {
+    uint32_t pos = this->head.load(std::memory_order_relaxed);
+    for (;;) {
+        // count the consecutive slots which have been written in this lap
+        uint32_t n = 0;
+        while (n < num) {
+            const uint32_t seq = this->cells[(pos + n) & this->mask].seq.load(std::memory_order_acquire);
+            if (seq != (pos + n + 1)) {
+                break;
+            }
+            n++;
+        }
+        if (0 == n) {
+            const uint32_t seq = this->cells[pos & this->mask].seq.load(std::memory_order_acquire);
+            if (int32_t(seq - (pos + 1)) < 0) {
+                // slot hasn't been written yet: empty
+                outNum = 0;
+                return pos;
+            }
+            // another consumer was faster, retry
+            pos = this->head.load(std::memory_order_relaxed);
+        }
+        else if (this->head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+            outNum = n;
+            return pos;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    o_assert_dbg(this->IsValid());
+    uint32_t n;
+    const uint32_t pos = this->claimWrite(1, n);
+    if (0 == n) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    new(c.elm()) TYPE(elm);
+    c.seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    o_assert_dbg(this->IsValid());
+    uint32_t n;
+    const uint32_t pos = this->claimWrite(1, n);
+    if (0 == n) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    new(c.elm()) TYPE(std::move(elm));
+    c.seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::EnqueueBatch(TYPE* elms, int num) {
+    o_assert_dbg(this->IsValid() && elms && (num >= 0));
+    uint32_t n = 0;
+    const uint32_t pos = (num > 0) ? this->claimWrite(uint32_t(num), n) : 0;
+    for (uint32_t i = 0; i < n; i++) {
+        cell& c = this->cells[(pos + i) & this->mask];
+        new(c.elm()) TYPE(std::move(elms[i]));
+        c.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    return int(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    o_assert_dbg(this->IsValid());
+    uint32_t n;
+    const uint32_t pos = this->claimRead(1, n);
+    if (0 == n) {
+        return false;
+    }
+    cell& c = this->cells[pos & this->mask];
+    outElm = std::move(*c.elm());
+    c.elm()->~TYPE();
+    c.seq.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::DequeueBatch(TYPE* outElms, int maxNum) {
+    o_assert_dbg(this->IsValid() && outElms && (maxNum >= 0));
+    uint32_t n = 0;
+    const uint32_t pos = (maxNum > 0) ? this->claimRead(uint32_t(maxNum), n) : 0;
+    for (uint32_t i = 0; i < n; i++) {
+        cell& c = this->cells[(pos + i) & this->mask];
+        outElms[i] = std::move(*c.elm());
+        c.elm()->~TYPE();
+        c.seq.store(pos + i + this->mask + 1, std::memory_order_release);
+    }
+    return int(n);
+}
+
+} // namespace Oryol
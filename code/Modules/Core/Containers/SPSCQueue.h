@@ -0,0 +1,265 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SPSCQueue
+    @ingroup Core
+    @brief bounded lock-free single-producer/single-consumer FIFO queue
+
+    A fixed-capacity ring buffer which can be used to pass elements
+    from exactly one producer thread to exactly one consumer thread
+    without locking. The capacity is rounded up to the next power of 2
+    and set once with Setup(), Enqueue() returns false when the queue
+    is full, and Dequeue() returns false when the queue is empty.
+
+    The read and write indices live on separate cache lines, and each
+    side keeps a cached copy of the other side's index, so that the
+    shared indices are only read when the cached copy says the queue
+    is full (or empty).
+
+    EnqueueBatch() and DequeueBatch() move several elements with a
+    single index update.
+
+    Setup() and Discard() must not be called while other threads
+    access the queue.
+
+    @see MPMCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE> class SPSCQueue {
+public:
+    /// default constructor
+    SPSCQueue();
+    /// destructor
+    ~SPSCQueue();
+
+    /// setup the queue with a capacity (rounded up to power of 2)
+    void Setup(int capacity);
+    /// discard the queue (destroys remaining elements)
+    void Discard();
+    /// return true if the queue has been setup
+    bool IsValid() const;
+    /// get capacity of the queue
+    int Capacity() const;
+    /// get number of elements in the queue (only exact if the queue is idle)
+    int Size() const;
+    /// return true if the queue is empty (only exact if the queue is idle)
+    bool Empty() const;
+
+    /// copy-enqueue an element (producer thread), return false if queue is full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element (producer thread), return false if queue is full
+    bool Enqueue(TYPE&& elm);
+    /// move-enqueue up to num elements (producer thread), return number of enqueued elements
+    int EnqueueBatch(TYPE* elms, int num);
+    /// dequeue an element (consumer thread), return false if queue is empty
+    bool Dequeue(TYPE& outElm);
+    /// dequeue up to maxNum elements (consumer thread), return number of dequeued elements
+    int DequeueBatch(TYPE* outElms, int maxNum);
+
+private:
+    /// not copyable
+    SPSCQueue(const SPSCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const SPSCQueue& rhs) = delete;
+    /// get number of free slots for the producer
+    uint32_t freeSlots(uint32_t tail);
+    /// get number of filled slots for the consumer
+    uint32_t filledSlots(uint32_t head);
+
+    // shared, read-only after Setup()
+    TYPE* buffer;
+    uint32_t mask;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    // written by producer
+    std::atomic<uint32_t> tail;
+    uint32_t cachedHead;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    // written by consumer
+    std::atomic<uint32_t> head;
+    uint32_t cachedTail;
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::SPSCQueue() :
+buffer(nullptr),
+mask(0),
+tail(0),
+cachedHead(0),
+head(0),
+cachedTail(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::~SPSCQueue() {
+    if (this->IsValid()) {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SPSCQueue<TYPE>::Setup(int capacity) {
+    o_assert_dbg(!this->IsValid());
+    o_assert_dbg((capacity > 0) && (capacity <= (1<<30)));
+    uint32_t num = 2;
+    while (num < uint32_t(capacity)) {
+        num <<= 1;
+    }
+    this->buffer = (TYPE*) Memory::Alloc(int(num * sizeof(TYPE)));
+    this->mask = num - 1;
+    this->tail.store(0, std::memory_order_relaxed);
+    this->head.store(0, std::memory_order_relaxed);
+    this->cachedHead = 0;
+    this->cachedTail = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SPSCQueue<TYPE>::Discard() {
+    o_assert_dbg(this->IsValid());
+    const uint32_t t = this->tail.load(std::memory_order_acquire);
+    for (uint32_t h = this->head.load(std::memory_order_relaxed); h != t; h++) {
+        this->buffer[h & this->mask].~TYPE();
+    }
+    Memory::Free(this->buffer);
+    this->buffer = nullptr;
+    this->mask = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::IsValid() const {
+    return nullptr != this->buffer;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Capacity() const {
+    return this->buffer ? int(this->mask + 1) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Size() const {
+    const uint32_t h = this->head.load(std::memory_order_acquire);
+    const uint32_t t = this->tail.load(std::memory_order_acquire);
+    return int(t - h);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+SPSCQueue<TYPE>::freeSlots(uint32_t t) {
+    uint32_t num = (this->mask + 1) - (t - this->cachedHead);
+    if (0 == num) {
+        // only look at the consumer's index if the cached copy says 'full'
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        num = (this->mask + 1) - (t - this->cachedHead);
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+SPSCQueue<TYPE>::filledSlots(uint32_t h) {
+    uint32_t num = this->cachedTail - h;
+    if (0 == num) {
+        // only look at the producer's index if the cached copy says 'empty'
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        num = this->cachedTail - h;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    o_assert_dbg(this->IsValid());
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    if (0 == this->freeSlots(t)) {
+        return false;
+    }
+    new(&this->buffer[t & this->mask]) TYPE(elm);
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    o_assert_dbg(this->IsValid());
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    if (0 == this->freeSlots(t)) {
+        return false;
+    }
+    new(&this->buffer[t & this->mask]) TYPE(std::move(elm));
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::EnqueueBatch(TYPE* elms, int num) {
+    o_assert_dbg(this->IsValid() && elms && (num >= 0));
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    uint32_t n = this->freeSlots(t);
+    if (n > uint32_t(num)) {
+        n = uint32_t(num);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        new(&this->buffer[(t + i) & this->mask]) TYPE(std::move(elms[i]));
+    }
+    this->tail.store(t + n, std::memory_order_release);
+    return int(n);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    o_assert_dbg(this->IsValid());
+    const uint32_t h = this->head.load(std::memory_order_relaxed);
+    if (0 == this->filledSlots(h)) {
+        return false;
+    }
+    TYPE& elm = this->buffer[h & this->mask];
+    outElm = std::move(elm);
+    elm.~TYPE();
+    this->head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::DequeueBatch(TYPE* outElms, int maxNum) {
+    o_assert_dbg(this->IsValid() && outElms && (maxNum >= 0));
+    const uint32_t h = this->head.load(std::memory_order_relaxed);
+    uint32_t n = this->filledSlots(h);
+    if (n > uint32_t(maxNum)) {
+        n = uint32_t(maxNum);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        TYPE& elm = this->buffer[(h + i) & this->mask];
+        outElms[i] = std::move(elm);
+        elm.~TYPE();
+    }
+    this->head.store(h + n, std::memory_order_release);
+    return int(n);
+}
+
+} // namespace Oryol
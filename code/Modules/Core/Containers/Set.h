@@ -7,6 +7,10 @@
 
     The Set class provides a dynamic array of binary-sorted values similar
     to the std::set class. 
+
+    When adding large numbers of values, consider using the bulk
+    methods, these append unsorted values, which are sorted (and
+    duplicates removed) in EndBulk().
      
     @see Array, ArrayMap, Map
 */
@@ -51,6 +55,13 @@ public:
     void Add(const VALUE& val);
     /// erase element
     void Erase(const VALUE& val);
+
+    /// begin bulk-adding elements
+    void BeginBulk();
+    /// add element in bulk mode (destroys sorting until EndBulk)
+    void AddBulk(const VALUE& val);
+    /// end bulk-adding, sort elements and remove duplicates
+    void EndBulk();
     /// get value at index
     const VALUE& ValueAtIndex(int index) const;
     
@@ -65,33 +76,39 @@ public:
     
 private:
     Array<VALUE> valueArray;
+    bool inBulkMode;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUE>
-Set<VALUE>::Set() {
+Set<VALUE>::Set() :
+inBulkMode(false) {
     // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(const Set& rhs) :
-valueArray(rhs.valueArray) {
-    // empty
+valueArray(rhs.valueArray),
+inBulkMode(false) {
+    o_assert_dbg(!rhs.inBulkMode);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(Set&& rhs) :
-valueArray(std::move(rhs.valueArray)) {
-    // empty
+valueArray(std::move(rhs.valueArray)),
+inBulkMode(rhs.inBulkMode) {
+    rhs.inBulkMode = false;
 }
     
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::operator=(const Set& rhs) {
+    o_assert_dbg(!rhs.inBulkMode);
     if (&rhs != this) {
         this->valueArray = rhs.valueArray;
+        this->inBulkMode = false;
     }
 }
 
@@ -100,6 +117,8 @@ template<class VALUE> void
 Set<VALUE>::operator=(Set&& rhs) {
     if (&rhs != this) {
         this->valueArray = std::move(rhs.valueArray);
+        this->inBulkMode = rhs.inBulkMode;
+        rhs.inBulkMode = false;
     }
 }
     
@@ -148,12 +167,14 @@ Set<VALUE>::Clear() {
 //------------------------------------------------------------------------------
 template<class VALUE> bool
 Set<VALUE>::Contains(const VALUE& val) const {
+    o_assert_dbg(!this->inBulkMode);
     return std::binary_search(this->valueArray.begin(), this->valueArray.end(), val);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE*
 Set<VALUE>::Find(const VALUE& val) const {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* ptr = std::lower_bound(this->valueArray.begin(), this->valueArray.end(), val);
     if (ptr != this->valueArray.end() && val == *ptr) {
         return ptr;
@@ -166,6 +187,7 @@ Set<VALUE>::Find(const VALUE& val) const {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Add(const VALUE& val) {
+    o_assert(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
     const VALUE* ptr = std::lower_bound(begin, end, val);
@@ -181,6 +203,7 @@ Set<VALUE>::Add(const VALUE& val) {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Erase(const VALUE& val) {
+    o_assert(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
     const VALUE* ptr = std::lower_bound(begin, end, val);
@@ -190,6 +213,35 @@ Set<VALUE>::Erase(const VALUE& val) {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::BeginBulk() {
+    o_assert(!this->inBulkMode);
+    this->inBulkMode = true;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::AddBulk(const VALUE& val) {
+    o_assert(this->inBulkMode);
+    this->valueArray.Add(val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::EndBulk() {
+    o_assert(this->inBulkMode);
+    this->inBulkMode = false;
+    if (this->valueArray.Size() > 1) {
+        std::sort(this->valueArray.begin(), this->valueArray.end());
+        VALUE* newEnd = std::unique(this->valueArray.begin(), this->valueArray.end());
+        const int numDuplicates = int(this->valueArray.end() - newEnd);
+        if (numDuplicates > 0) {
+            this->valueArray.EraseRange(this->valueArray.Size() - numDuplicates, numDuplicates);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE&
 Set<VALUE>::ValueAtIndex(int index) const {
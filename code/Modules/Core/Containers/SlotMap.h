@@ -0,0 +1,457 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SlotMap
+    @ingroup Core
+    @brief fixed-capacity container with generation-counted handles
+
+    A SlotMap stores elements in a dense array (for fast iteration), and
+    hands out handles which stay valid until the element is erased, even
+    though elements are moved around in the dense array. Add(), Erase()
+    and Find() are O(1).
+
+    A handle consists of a slot index (lower half of the HANDLE type)
+    and the slot's generation counter (upper half). Each slot stores its
+    generation counter and the dense index of its element, free slots
+    are linked into an intrusive FIFO free list through the index field,
+    so that slots are reused as late as possible. Add() and Erase() bump
+    the generation counter of the slot, so that used slots have an even
+    and free slots an odd generation, and stale handles are detected
+    (until the 16-bit generation counter of a 32-bit handle wraps
+    around). The generation counter of a handle is never 0, so a handle
+    is never 0 (InvalidHandle). The generation counters continue after
+    Discard() and Setup(), so handles from before Discard() stay
+    invalid.
+
+    Use 32-bit handles (the default) for up to 64K-1 elements, and
+    64-bit handles for more elements or if generation counters must not
+    wrap around.
+
+    Erase() moves the last element into the erased element's place,
+    so the element order changes, and pointers to elements must not
+    be held across Add() and Erase() calls.
+
+    @code
+    SlotMap<Particle> particles;
+    particles.Setup(1024);
+    SlotMap<Particle>::Handle h = particles.Add(Particle());
+    particles.Find(h)->pos = 1.0f;
+    for (Particle& p : particles) { ... }
+    particles.Erase(h);
+    @endcode
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <type_traits>
+#include <limits>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE, class HANDLE=uint32_t> class SlotMap {
+    static_assert(std::is_same<HANDLE, uint32_t>::value || std::is_same<HANDLE, uint64_t>::value,
+        "SlotMap: HANDLE must be uint32_t or uint64_t");
+    /// slot index and generation counter type (half of the handle)
+    typedef typename std::conditional<sizeof(HANDLE) == 8, uint32_t, uint16_t>::type halfT;
+public:
+    /// handle type
+    typedef HANDLE Handle;
+    /// invalid handle constant
+    static const Handle InvalidHandle = 0;
+    /// max capacity
+    static const int MaxCapacity = sizeof(HANDLE) == 8 ? (1<<30) : 0xFFFF;
+
+    /// default constructor
+    SlotMap();
+    /// destructor
+    ~SlotMap();
+
+    /// setup with a fixed capacity
+    void Setup(int capacity);
+    /// discard the slot map (destroys remaining elements)
+    void Discard();
+    /// return true if the slot map has been setup
+    bool IsValid() const;
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements
+    int Size() const;
+    /// return true if no elements
+    bool Empty() const;
+    /// return true if no free slots are left
+    bool Full() const;
+
+    /// copy-add an element, return its handle
+    Handle Add(const TYPE& elm);
+    /// move-add an element, return its handle
+    Handle Add(TYPE&& elm);
+    /// emplace-add an element, return its handle
+    template<class... ARGS> Handle Add(ARGS&&... args);
+    /// erase an element by handle (handle must be valid)
+    void Erase(Handle handle);
+    /// erase all elements (invalidates all handles)
+    void Clear();
+
+    /// return true if the handle refers to an element
+    bool Contains(Handle handle) const;
+    /// get pointer to element, or nullptr if the handle is stale
+    TYPE* Find(Handle handle);
+    /// get const pointer to element, or nullptr if the handle is stale
+    const TYPE* Find(Handle handle) const;
+    /// access element by handle (handle must be valid)
+    TYPE& operator[](Handle handle);
+    /// read-only access element by handle (handle must be valid)
+    const TYPE& operator[](Handle handle) const;
+
+    /// access element at dense index
+    TYPE& ValueAtIndex(int index);
+    /// read-only access element at dense index
+    const TYPE& ValueAtIndex(int index) const;
+    /// get handle of element at dense index
+    Handle HandleAtIndex(int index) const;
+
+    /// C++ begin (dense elements)
+    TYPE* begin();
+    /// C++ const begin
+    const TYPE* begin() const;
+    /// C++ end
+    TYPE* end();
+    /// C++ const end
+    const TYPE* end() const;
+
+private:
+    /// not copyable
+    SlotMap(const SlotMap& rhs) = delete;
+    /// not copyable
+    void operator=(const SlotMap& rhs) = delete;
+
+    /// a sparse slot
+    struct slot {
+        /// current generation counter
+        halfT generation;
+        /// dense index if used, next free slot if free
+        halfT index;
+    };
+    /// list terminator for the free list
+    static const halfT invalidSlot = halfT(~halfT(0));
+
+    /// get slot index from handle
+    static int slotIndex(Handle handle);
+    /// get generation counter from handle
+    static halfT generation(Handle handle);
+    /// return true if a slot generation counter marks a used slot
+    static bool isUsed(halfT generation);
+    /// pop a slot from the free list, and point it to the next dense index
+    Handle alloc();
+    /// lookup dense index of a handle, or InvalidIndex
+    int lookup(Handle handle) const;
+
+    TYPE* values;
+    Handle* handles;
+    slot* slots;
+    int capacity;
+    int size;
+    halfT freeHead;
+    halfT freeTail;
+    halfT setupGeneration;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE>
+SlotMap<TYPE, HANDLE>::SlotMap() :
+values(nullptr),
+handles(nullptr),
+slots(nullptr),
+capacity(0),
+size(0),
+freeHead(invalidSlot),
+freeTail(invalidSlot),
+setupGeneration(1) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE>
+SlotMap<TYPE, HANDLE>::~SlotMap() {
+    if (this->IsValid()) {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> void
+SlotMap<TYPE, HANDLE>::Setup(int cap) {
+    o_assert_dbg(!this->IsValid());
+    o_assert_dbg((cap > 0) && (cap <= MaxCapacity));
+    o_assert((int64_t(cap) * int64_t(sizeof(TYPE))) <= int64_t(std::numeric_limits<int>::max()));
+    this->values = (TYPE*) Memory::Alloc(int(cap * sizeof(TYPE)));
+    this->handles = (Handle*) Memory::Alloc(int(cap * sizeof(Handle)));
+    this->slots = (slot*) Memory::Alloc(int(cap * sizeof(slot)));
+    this->capacity = cap;
+    this->size = 0;
+    // all slots are in the free list, in order
+    for (int i = 0; i < cap; i++) {
+        this->slots[i].generation = this->setupGeneration;
+        this->slots[i].index = halfT(i + 1);
+    }
+    this->slots[cap - 1].index = invalidSlot;
+    this->freeHead = 0;
+    this->freeTail = halfT(cap - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> void
+SlotMap<TYPE, HANDLE>::Discard() {
+    o_assert_dbg(this->IsValid());
+    for (int i = 0; i < this->size; i++) {
+        this->values[i].~TYPE();
+    }
+    // the next Setup() continues after the highest generation counter (as odd free generation)
+    for (int i = 0; i < this->capacity; i++) {
+        if (this->slots[i].generation > this->setupGeneration) {
+            this->setupGeneration = this->slots[i].generation;
+        }
+    }
+    this->setupGeneration |= 1;
+    Memory::Free(this->values);
+    Memory::Free(this->handles);
+    Memory::Free(this->slots);
+    this->values = nullptr;
+    this->handles = nullptr;
+    this->slots = nullptr;
+    this->capacity = 0;
+    this->size = 0;
+    this->freeHead = invalidSlot;
+    this->freeTail = invalidSlot;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> bool
+SlotMap<TYPE, HANDLE>::IsValid() const {
+    return nullptr != this->slots;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> int
+SlotMap<TYPE, HANDLE>::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> int
+SlotMap<TYPE, HANDLE>::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> bool
+SlotMap<TYPE, HANDLE>::Empty() const {
+    return 0 == this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> bool
+SlotMap<TYPE, HANDLE>::Full() const {
+    return this->size == this->capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> int
+SlotMap<TYPE, HANDLE>::slotIndex(Handle handle) {
+    return int(handle & Handle(halfT(~halfT(0))));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> typename SlotMap<TYPE, HANDLE>::halfT
+SlotMap<TYPE, HANDLE>::generation(Handle handle) {
+    return halfT(handle >> (sizeof(halfT) * 8));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> bool
+SlotMap<TYPE, HANDLE>::isUsed(halfT generation) {
+    return 0 == (generation & 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> HANDLE
+SlotMap<TYPE, HANDLE>::alloc() {
+    o_assert_dbg(this->IsValid());
+    o_assert(this->size < this->capacity);
+    const halfT slotIndex = this->freeHead;
+    slot& s = this->slots[slotIndex];
+    this->freeHead = s.index;
+    if (invalidSlot == this->freeHead) {
+        this->freeTail = invalidSlot;
+    }
+    // bump the generation counter to an even value (skipping 0)
+    if (0 == ++s.generation) {
+        s.generation = 2;
+    }
+    s.index = halfT(this->size);
+    const Handle handle = (Handle(s.generation) << (sizeof(halfT) * 8)) | Handle(slotIndex);
+    this->handles[this->size] = handle;
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> HANDLE
+SlotMap<TYPE, HANDLE>::Add(const TYPE& elm) {
+    const Handle handle = this->alloc();
+    new(&this->values[this->size++]) TYPE(elm);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> HANDLE
+SlotMap<TYPE, HANDLE>::Add(TYPE&& elm) {
+    const Handle handle = this->alloc();
+    new(&this->values[this->size++]) TYPE(std::move(elm));
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE>
+template<class... ARGS> HANDLE
+SlotMap<TYPE, HANDLE>::Add(ARGS&&... args) {
+    const Handle handle = this->alloc();
+    new(&this->values[this->size++]) TYPE(std::forward<ARGS>(args)...);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> void
+SlotMap<TYPE, HANDLE>::Erase(Handle handle) {
+    const int index = this->lookup(handle);
+    o_assert(InvalidIndex != index);
+
+    // move the last element into the hole
+    const int last = this->size - 1;
+    if (index != last) {
+        this->values[index] = std::move(this->values[last]);
+        this->handles[index] = this->handles[last];
+        this->slots[slotIndex(this->handles[index])].index = halfT(index);
+    }
+    this->values[last].~TYPE();
+    this->size--;
+
+    // bump the generation counter to an odd value and append the slot to the free list
+    const halfT slotIndex = halfT(SlotMap::slotIndex(handle));
+    slot& s = this->slots[slotIndex];
+    s.generation++;
+    s.index = invalidSlot;
+    if (invalidSlot == this->freeTail) {
+        this->freeHead = slotIndex;
+    }
+    else {
+        this->slots[this->freeTail].index = slotIndex;
+    }
+    this->freeTail = slotIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> void
+SlotMap<TYPE, HANDLE>::Clear() {
+    while (this->size > 0) {
+        this->Erase(this->handles[this->size - 1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> int
+SlotMap<TYPE, HANDLE>::lookup(Handle handle) const {
+    const int slotIndex = SlotMap::slotIndex(handle);
+    // NOTE: free slots have an odd generation, which is never handed out
+    if (slotIndex < this->capacity) {
+        const slot& s = this->slots[slotIndex];
+        if (isUsed(s.generation) && (s.generation == generation(handle))) {
+            return s.index;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> bool
+SlotMap<TYPE, HANDLE>::Contains(Handle handle) const {
+    return InvalidIndex != this->lookup(handle);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> TYPE*
+SlotMap<TYPE, HANDLE>::Find(Handle handle) {
+    const int index = this->lookup(handle);
+    return (InvalidIndex != index) ? &this->values[index] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> const TYPE*
+SlotMap<TYPE, HANDLE>::Find(Handle handle) const {
+    const int index = this->lookup(handle);
+    return (InvalidIndex != index) ? &this->values[index] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> TYPE&
+SlotMap<TYPE, HANDLE>::operator[](Handle handle) {
+    const int index = this->lookup(handle);
+    o_assert_dbg(InvalidIndex != index);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> const TYPE&
+SlotMap<TYPE, HANDLE>::operator[](Handle handle) const {
+    const int index = this->lookup(handle);
+    o_assert_dbg(InvalidIndex != index);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> TYPE&
+SlotMap<TYPE, HANDLE>::ValueAtIndex(int index) {
+    o_assert_range_dbg(index, this->size);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> const TYPE&
+SlotMap<TYPE, HANDLE>::ValueAtIndex(int index) const {
+    o_assert_range_dbg(index, this->size);
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> HANDLE
+SlotMap<TYPE, HANDLE>::HandleAtIndex(int index) const {
+    o_assert_range_dbg(index, this->size);
+    return this->handles[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> TYPE*
+SlotMap<TYPE, HANDLE>::begin() {
+    return this->values;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> const TYPE*
+SlotMap<TYPE, HANDLE>::begin() const {
+    return this->values;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> TYPE*
+SlotMap<TYPE, HANDLE>::end() {
+    return this->values + this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class HANDLE> const TYPE*
+SlotMap<TYPE, HANDLE>::end() const {
+    return this->values + this->size;
+}
+
+} // namespace Oryol
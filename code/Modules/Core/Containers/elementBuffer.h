@@ -22,6 +22,7 @@
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/Allocator.h"
 
 //------------------------------------------------------------------------------
 namespace Oryol {
@@ -69,6 +70,10 @@ public:
     
     /// allocate, grow or shrink the elementBuffer
     void alloc(int capacity, int frontSpare);
+    /// allocate raw memory through allocator or Memory::Alloc
+    void* allocMem(int numBytes) const;
+    /// free raw memory through allocator or Memory::Free
+    void freeMem(void* ptr) const;
     /// destroy all
     void destroy();
     /// destroy element at pointer
@@ -141,6 +146,7 @@ public:
     int cap;            // buffer capacity (num elements)
     int start;          // index of first valid element in buffer
     int end;            // index of one-past-last valid element in buffer
+    Allocator* allocator;   // optional allocator (nullptr: use Memory::Alloc)
 };
 
 //------------------------------------------------------------------------------
@@ -149,7 +155,8 @@ elementBuffer<TYPE>::elementBuffer() :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+allocator(nullptr)
 {
     // empty
 }
@@ -160,7 +167,8 @@ elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+allocator(nullptr)
 {
     if (rhs.buf) {
         this->alloc(rhs.size(), 0);
@@ -180,13 +188,15 @@ elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
 buf(rhs.buf),
 cap(rhs.cap),
 start(rhs.start),
-end(rhs.end)
+end(rhs.end),
+allocator(rhs.allocator)
 {
     // reset rhs to default-constructed state
     rhs.buf = nullptr;
     rhs.cap = 0;
     rhs.start = 0;
     rhs.end = 0;
+    rhs.allocator = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -224,10 +234,12 @@ elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
         this->cap   = rhs.cap;
         this->start = rhs.start;
         this->end   = rhs.end;
+        this->allocator = rhs.allocator;
         rhs.buf   = nullptr;
         rhs.cap   = 0;
         rhs.start = 0;
         rhs.end   = 0;
+        rhs.allocator = nullptr;
     }
 }
 
@@ -323,7 +335,7 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
 
     // allocate new buffer
     const int newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    TYPE* newBuffer = (TYPE*) this->allocMem(newBufSize);
     TYPE* newElmStart = newBuffer + newStart;
     
     // need to move any elements?
@@ -342,7 +354,7 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     
     // need to free old buffer?
     if (nullptr != this->buf) {
-        Memory::Free(this->buf);
+        this->freeMem(this->buf);
     }
     
     // replace pointers
@@ -352,6 +364,28 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     this->end   = newStart + curSize;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void*
+elementBuffer<TYPE>::allocMem(int numBytes) const {
+    if (this->allocator) {
+        return this->allocator->Alloc(numBytes);
+    }
+    else {
+        return Memory::Alloc(numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::freeMem(void* ptr) const {
+    if (this->allocator) {
+        this->allocator->Free(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::destroy() {
@@ -361,7 +395,7 @@ elementBuffer<TYPE>::destroy() {
             o_assert_range_dbg(i, this->cap);
             this->buf[i].~TYPE();
         }
-        Memory::Free(this->buf);
+        this->freeMem(this->buf);
     }
     this->buf = nullptr;
     this->cap = 0;
@@ -0,0 +1,115 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::linearSearch
+    @ingroup _priv
+    @brief SIMD linear search over contiguous elements
+
+    Private helper for Array::FindIndexLinear() and Algorithms::FindIndex().
+    Integer, enum and pointer elements of 1, 2, 4 or 8 bytes are compared
+    with SSE2 (64 bytes per loop iteration) where available, since those
+    types compare equal exactly if their bits are equal. All other element
+    types (including floating point types) use a plain loop with
+    operator==.
+*/
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include <cstring>
+#include <type_traits>
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+/// true if the element type can be compared bitwise
+template<class TYPE> struct isBitwiseSearchable : std::integral_constant<bool,
+    (std::is_integral<TYPE>::value || std::is_enum<TYPE>::value || std::is_pointer<TYPE>::value) &&
+    ((sizeof(TYPE) == 1) || (sizeof(TYPE) == 2) || (sizeof(TYPE) == 4) || (sizeof(TYPE) == 8))> { };
+
+#if ORYOL_HAS_SSE2
+/// SSE2 compare helpers per element size
+template<int SIZE> struct simdCompare;
+template<> struct simdCompare<1> {
+    static __m128i splat(uint64_t v) { return _mm_set1_epi8(char(v)); };
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); };
+};
+template<> struct simdCompare<2> {
+    static __m128i splat(uint64_t v) { return _mm_set1_epi16(short(v)); };
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); };
+};
+template<> struct simdCompare<4> {
+    static __m128i splat(uint64_t v) { return _mm_set1_epi32(int(v)); };
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); };
+};
+template<> struct simdCompare<8> {
+    static __m128i splat(uint64_t v) {
+        return _mm_set_epi32(int(v >> 32), int(v), int(v >> 32), int(v));
+    };
+    static __m128i equal(__m128i a, __m128i b) {
+        // SSE2 has no 64-bit compare, both 32-bit halves must be equal
+        const __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    };
+};
+#endif
+
+//------------------------------------------------------------------------------
+/// find first element equal to val with operator==, return index or InvalidIndex
+template<class TYPE> int
+findIndexLinear(const TYPE* ptr, int num, const TYPE& val, std::false_type /*bitwise*/) {
+    for (int i = 0; i < num; i++) {
+        if (val == ptr[i]) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/// find first element bitwise equal to val, return index or InvalidIndex
+template<class TYPE> int
+findIndexLinear(const TYPE* ptr, int num, const TYPE& val, std::true_type /*bitwise*/) {
+    int i = 0;
+    #if ORYOL_HAS_SSE2
+    const int numPerVec = 16 / int(sizeof(TYPE));
+    uint64_t bits = 0;
+    std::memcpy(&bits, &val, sizeof(TYPE));
+    const __m128i v = simdCompare<sizeof(TYPE)>::splat(bits);
+    for (; (i + 4 * numPerVec) <= num; i += 4 * numPerVec) {
+        const __m128i* p = (const __m128i*) (ptr + i);
+        const __m128i e0 = simdCompare<sizeof(TYPE)>::equal(_mm_loadu_si128(p + 0), v);
+        const __m128i e1 = simdCompare<sizeof(TYPE)>::equal(_mm_loadu_si128(p + 1), v);
+        const __m128i e2 = simdCompare<sizeof(TYPE)>::equal(_mm_loadu_si128(p + 2), v);
+        const __m128i e3 = simdCompare<sizeof(TYPE)>::equal(_mm_loadu_si128(p + 3), v);
+        const __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3));
+        if (0 != _mm_movemask_epi8(any)) {
+            // the hit is somewhere in this block
+            break;
+        }
+    }
+    for (; (i + numPerVec) <= num; i += numPerVec) {
+        const __m128i e = simdCompare<sizeof(TYPE)>::equal(_mm_loadu_si128((const __m128i*) (ptr + i)), v);
+        if (0 != _mm_movemask_epi8(e)) {
+            break;
+        }
+    }
+    #endif
+    for (; i < num; i++) {
+        if (val == ptr[i]) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/// find first element equal to val, return index or InvalidIndex
+template<class TYPE> int
+findIndexLinear(const TYPE* ptr, int num, const TYPE& val) {
+    return findIndexLinear(ptr, num, val, isBitwiseSearchable<TYPE>());
+}
+
+} // namespace _priv
+} // namespace Oryol
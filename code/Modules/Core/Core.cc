@@ -4,6 +4,11 @@
 #include "Pre.h"
 #include "Core.h"
 #include "Core/RunLoop.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/String.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Logger.h"
 #include "Core/Threading/ThreadLocalPtr.h"
 #include "Core/Trace.h"
 #include <thread>
@@ -13,25 +18,79 @@ namespace Oryol {
 namespace {
     ORYOL_THREADLOCAL_PTR(RunLoop) threadPreRunLoop = nullptr;
     ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop = nullptr;
+    ORYOL_THREADLOCAL_PTR(FrameArena) threadFrameArena = nullptr;
     struct _state {
         std::thread::id mainThreadId;
-        #if ORYOL_PROFILING
+        int frameArenaSize = 0;
+        bool globalStringAtomTable = false;
+        #if ORYOL_PROFILING || ORYOL_TRACE_JSON
         Trace trace;
         #endif
+        #if ORYOL_TRACE_JSON
+        String traceFile;
+        #endif
     };
     _state* state = nullptr;
 }
 
+//------------------------------------------------------------------------------
+static void
+createThreadFrameArena(int size) {
+    if (size > 0) {
+        // the arena is reset by the thread's post-runloop at end of frame
+        FrameArena* arena = Memory::New<FrameArena>(size);
+        threadFrameArena = arena;
+        threadPostRunLoop->Add([arena]() {
+            arena->Reset();
+        }, RunLoop::DefaultPriority, "frameArena");
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+destroyThreadFrameArena() {
+    if (threadFrameArena) {
+        Memory::Delete<FrameArena>(threadFrameArena);
+        threadFrameArena = nullptr;
+    }
+}
+
 //------------------------------------------------------------------------------
 void
-Core::Setup() {
+Core::Setup(const CoreSetup& setup) {
     o_assert_dbg(!IsValid());
     o_assert_dbg(nullptr == threadPreRunLoop);
     o_assert_dbg(nullptr == threadPostRunLoop);
+    if (setup.MemoryAllocator) {
+        Memory::SetAllocator(setup.MemoryAllocator);
+    }
+    o_memory_scope(Core);
+    MemoryTracker::SetThreadName("main");
     state = Memory::New<_state>();
     state->mainThreadId = std::this_thread::get_id();
+    state->frameArenaSize = setup.FrameArenaSize;
+    #if ORYOL_TRACE_JSON
+    state->traceFile = setup.TraceFile;
+    #endif
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    createThreadFrameArena(state->frameArenaSize);
+    threadPostRunLoop->Add([]() {
+        Metrics::NextFrame();
+    }, RunLoop::DefaultPriority, "metrics");
+    threadPreRunLoop->SetTimingEnabled(setup.RunLoopTiming);
+    threadPostRunLoop->SetTimingEnabled(setup.RunLoopTiming);
+    if (setup.MetricsDumpInterval > 0) {
+        Metrics::SetDumpInterval(setup.MetricsDumpInterval, nullptr);
+    }
+    if (setup.GlobalStringAtomTable) {
+        StringAtom::UseGlobalTable(true);
+        state->globalStringAtomTable = true;
+    }
+    if (setup.AsyncLogging) {
+        Log::StartAsync(setup.AsyncLogQueueSize);
+    }
+    Jobs::Setup(setup.NumJobWorkers < 0 ? Jobs::DefaultNumWorkers() : setup.NumJobWorkers);
 }
 
 //------------------------------------------------------------------------------
@@ -40,8 +99,23 @@ Core::Discard() {
     o_assert(IsValid());
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
+    Jobs::Discard();
+    Metrics::SetDumpInterval(0, nullptr);
+    Log::StopAsync();
+    if (state->globalStringAtomTable) {
+        // atoms which have been created from the global table stay valid
+        StringAtom::UseGlobalTable(false);
+    }
+    destroyThreadFrameArena();
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
+    #if ORYOL_TRACE_JSON
+    if (!state->traceFile.Empty()) {
+        if (!TraceRecorder::WriteFile(state->traceFile.AsCStr())) {
+            Log::Warn("Core::Discard(): failed to write trace file '%s'\n", state->traceFile.AsCStr());
+        }
+    }
+    #endif
     Memory::Delete(state);
     threadPreRunLoop = nullptr;
     threadPostRunLoop = nullptr;
@@ -71,6 +145,12 @@ Core::PostRunLoop() {
     return threadPostRunLoop;
 }
 
+//------------------------------------------------------------------------------
+FrameArena*
+Core::FrameAllocator() {
+    return threadFrameArena;
+}
+
 //------------------------------------------------------------------------------
 bool
 Core::IsMainThread() {
@@ -90,6 +170,7 @@ Core::EnterThread() {
     o_assert(nullptr == threadPostRunLoop);
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    createThreadFrameArena(state ? state->frameArenaSize : 0);
     #endif
 }
 
@@ -99,6 +180,7 @@ Core::LeaveThread() {
     #if ORYOL_HAS_THREADS
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
+    destroyThreadFrameArena();
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
     threadPreRunLoop = nullptr;
@@ -106,6 +188,15 @@ Core::LeaveThread() {
 
     // do NOT destroy the thread-local string atom table to
     // ensure that string atom data pointers still point to valid data
+
+    // hand cached memory blocks back to the allocator backend
+    Memory::ReleaseThreadCache();
+
+    // hand the metric value slots over to the next thread
+    Metrics::ReleaseThreadSlots();
+
+    // ...and the memory tracking counters
+    MemoryTracker::ReleaseThreadCounters();
     #endif
 }
 
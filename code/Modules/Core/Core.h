@@ -9,14 +9,48 @@
     @brief Core module facade
 */
 #include "Core/Types.h"
+#include "Core/Log.h"
 #include "Core/RunLoop.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Jobs/Jobs.h"
+#include "Core/Metrics/Metrics.h"
 
 namespace Oryol {
 
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::CoreSetup
+    @ingroup Core
+    @brief setup parameters for the Core module
+*/
+class CoreSetup {
+public:
+    /// optional allocator backend for Memory::Alloc() (e.g. SizeClassAllocator::Instance())
+    Allocator* MemoryAllocator = nullptr;
+    /// size of the per-thread FrameArena in bytes (0 to disable)
+    int FrameArenaSize = 64 * 1024;
+    /// number of job system worker threads (0: no workers, -1: one per CPU core minus the main thread)
+    int NumJobWorkers = 0;
+    /// intern StringAtoms in a process-global table until Core::Discard() (see StringAtom::UseGlobalTable())
+    bool GlobalStringAtomTable = false;
+    /// print log messages on a background thread (see Log::StartAsync())
+    bool AsyncLogging = false;
+    /// number of queued messages for asynchronous logging
+    int AsyncLogQueueSize = Log::DefaultAsyncQueueSize;
+    /// file to write recorded trace events to at Core::Discard() (only with ORYOL_TRACE_JSON)
+    const char* TraceFile = nullptr;
+    /// dump the metrics to the Log every N frames (0 to disable, see Metrics::SetDumpInterval())
+    int MetricsDumpInterval = 0;
+    /// time the main thread's runloop callbacks into 'runloop.[name]' metrics (see RunLoop::SetTimingEnabled())
+    bool RunLoopTiming = false;
+};
+
+//------------------------------------------------------------------------------
 class Core {
 public:
     /// setup the Core module
-    static void Setup();
+    static void Setup(const CoreSetup& setup = CoreSetup());
     /// discard the Core module
     static void Discard();
     /// check if Core module has been setup
@@ -26,6 +60,8 @@ public:
     static class RunLoop* PreRunLoop();
     /// get pointer to the per-thread 'after-frame' runloop
     static class RunLoop* PostRunLoop();
+    /// get pointer to the per-thread frame arena (reset by the PostRunLoop, may be nullptr)
+    static class FrameArena* FrameAllocator();
 
     /// called when a thread is entered
     static void EnterThread();
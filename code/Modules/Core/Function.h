@@ -0,0 +1,232 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Function
+    @ingroup Core
+    @brief move-only callable object with inline storage for small captures
+
+    Function<RET(ARGS...), INLINE_BYTES> is a replacement for std::function
+    in callbacks. Callable objects (lambdas, function objects and function
+    pointers) of up to INLINE_BYTES bytes are stored inside the Function
+    object, bigger callables are allocated with Memory::New(). Functions can't be copied,
+    only moved, so that moving a callback around never allocates.
+
+    @code
+    Function<void(int)> func = [this](int val) { this->sum += val; };
+    func(1);
+    Function<void(int)> other(std::move(func));
+    @endcode
+
+    Calling an empty Function is an error (asserts in debug mode), use
+    the bool operator to check if a Function is set.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Oryol {
+
+template<class SIGNATURE, int INLINE_BYTES=32> class Function;
+
+template<class RET, class... ARGS, int INLINE_BYTES>
+class Function<RET(ARGS...), INLINE_BYTES> {
+public:
+    /// size of the inline storage
+    static const int InlineBytes = INLINE_BYTES;
+
+    /// default constructor, creates empty function
+    Function() { };
+    /// construct empty function from nullptr
+    Function(std::nullptr_t) { };
+    /// construct from callable object
+    template<class FUNC, class = typename std::enable_if<!std::is_same<typename std::decay<FUNC>::type, Function>::value>::type>
+    Function(FUNC&& func);
+    /// move constructor
+    Function(Function&& rhs);
+    /// copy constructor is deleted
+    Function(const Function& rhs) = delete;
+    /// destructor
+    ~Function();
+
+    /// move-assignment
+    Function& operator=(Function&& rhs);
+    /// copy-assignment is deleted
+    Function& operator=(const Function& rhs) = delete;
+    /// assign nullptr, destroys the callable
+    Function& operator=(std::nullptr_t);
+    /// assign callable object
+    template<class FUNC, class = typename std::enable_if<!std::is_same<typename std::decay<FUNC>::type, Function>::value>::type>
+    Function& operator=(FUNC&& func);
+
+    /// return true if a callable is set
+    explicit operator bool() const;
+    /// call the callable
+    RET operator()(ARGS... args) const;
+    /// return true if the callable is stored inline (no allocation)
+    bool IsInline() const;
+
+private:
+    /// per-callable-type functions
+    struct vtable {
+        RET (*invoke)(const Function* self, ARGS&&... args);
+        /// move-construct src into dst and destroy src, or only destroy src if dst is nullptr
+        void (*manage)(Function* dst, Function* src);
+        bool isInline;
+    };
+    /// vtable implementation for one callable type
+    template<class FUNC> struct impl {
+        /// NOTE: Oryol is compiled without exceptions, so move constructors don't need to be noexcept
+        static const bool isInline = (sizeof(FUNC) <= INLINE_BYTES) &&
+            (alignof(FUNC) <= alignof(std::max_align_t));
+        static FUNC* get(const Function* self) {
+            return isInline ? (FUNC*) self->buf : (FUNC*) self->ptr;
+        };
+        static RET invoke(const Function* self, ARGS&&... args) {
+            return (*get(self))(std::forward<ARGS>(args)...);
+        };
+        static void manage(Function* dst, Function* src) {
+            if (isInline) {
+                if (dst) {
+                    new(dst->buf) FUNC(std::move(*get(src)));
+                }
+                get(src)->~FUNC();
+            }
+            else if (dst) {
+                dst->ptr = src->ptr;
+            }
+            else {
+                Memory::Delete(get(src));
+            }
+        };
+        static const vtable* table() {
+            static const vtable t = { &invoke, &manage, isInline };
+            return &t;
+        };
+    };
+
+    /// test for null function pointers
+    template<class FUNC> static bool isNull(const FUNC&) {
+        return false;
+    };
+    template<class R, class... A> static bool isNull(R (*func)(A...)) {
+        return nullptr == func;
+    };
+    /// initialize from callable object (must be empty)
+    template<class FUNC> void init(FUNC&& func);
+    /// take content of other function (must be empty)
+    void take(Function& rhs);
+    /// destroy the callable
+    void reset();
+
+    const vtable* vt = nullptr;
+    union {
+        alignas(std::max_align_t) mutable uint8_t buf[INLINE_BYTES];
+        void* ptr;
+    };
+};
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES>
+template<class FUNC, class> inline
+Function<RET(ARGS...), INLINE_BYTES>::Function(FUNC&& func) {
+    this->init(std::forward<FUNC>(func));
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline
+Function<RET(ARGS...), INLINE_BYTES>::Function(Function&& rhs) {
+    this->take(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline
+Function<RET(ARGS...), INLINE_BYTES>::~Function() {
+    this->reset();
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline Function<RET(ARGS...), INLINE_BYTES>&
+Function<RET(ARGS...), INLINE_BYTES>::operator=(Function&& rhs) {
+    if (this != &rhs) {
+        this->reset();
+        this->take(rhs);
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline Function<RET(ARGS...), INLINE_BYTES>&
+Function<RET(ARGS...), INLINE_BYTES>::operator=(std::nullptr_t) {
+    this->reset();
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES>
+template<class FUNC, class> inline Function<RET(ARGS...), INLINE_BYTES>&
+Function<RET(ARGS...), INLINE_BYTES>::operator=(FUNC&& func) {
+    this->reset();
+    this->init(std::forward<FUNC>(func));
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline
+Function<RET(ARGS...), INLINE_BYTES>::operator bool() const {
+    return nullptr != this->vt;
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline RET
+Function<RET(ARGS...), INLINE_BYTES>::operator()(ARGS... args) const {
+    o_assert_dbg(this->vt);
+    return this->vt->invoke(this, std::forward<ARGS>(args)...);
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline bool
+Function<RET(ARGS...), INLINE_BYTES>::IsInline() const {
+    return this->vt && this->vt->isInline;
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES>
+template<class FUNC> inline void
+Function<RET(ARGS...), INLINE_BYTES>::init(FUNC&& func) {
+    typedef typename std::decay<FUNC>::type type;
+    o_assert_dbg(nullptr == this->vt);
+    if (!isNull(func)) {
+        if (impl<type>::isInline) {
+            new(this->buf) type(std::forward<FUNC>(func));
+        }
+        else {
+            this->ptr = Memory::New<type>(std::forward<FUNC>(func));
+        }
+        this->vt = impl<type>::table();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline void
+Function<RET(ARGS...), INLINE_BYTES>::take(Function& rhs) {
+    o_assert_dbg(nullptr == this->vt);
+    if (rhs.vt) {
+        this->vt = rhs.vt;
+        this->vt->manage(this, &rhs);
+        rhs.vt = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class RET, class... ARGS, int INLINE_BYTES> inline void
+Function<RET(ARGS...), INLINE_BYTES>::reset() {
+    if (this->vt) {
+        this->vt->manage(nullptr, this);
+        this->vt = nullptr;
+    }
+}
+
+} // namespace Oryol
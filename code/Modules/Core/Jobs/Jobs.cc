@@ -0,0 +1,496 @@
+//------------------------------------------------------------------------------
+//  Jobs.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Jobs.h"
+#include "Core/Core.h"
+#include "Core/Jobs/jobDeque.h"
+#include "Core/Memory/ClassPool.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Trace.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+using namespace _priv;
+
+namespace _priv {
+/// job system internals which need access to JobCounter
+class jobSystem {
+public:
+    /// allocate a job which calls a function
+    static job* newJob(std::function<void()>&& func, JobCounter* counter);
+    /// allocate a job which calls a range function
+    static job* newRangeJob(void (*rangeFunc)(void*, int, int), void* ctx, int begin, int end, JobCounter* counter);
+    /// lock the dependent-job list of a counter
+    static void lockWaiters(JobCounter* counter);
+    /// unlock the dependent-job list of a counter
+    static void unlockWaiters(JobCounter* counter);
+    /// decrement the counter of a finished job, and schedule dependent jobs
+    static void finish(JobCounter* counter);
+};
+} // namespace _priv
+
+namespace {
+    // number of failed job searches before a worker goes to sleep
+    const int NumIdleSpins = 64;
+    // capacity of the queue for jobs started on non-job-system threads
+    const int InjectQueueCapacity = 4096;
+
+    #if ORYOL_HAS_THREADS
+    struct _state {
+        int numWorkers = 0;
+        // deques[0] is owned by the main thread, deques[i+1] by worker i
+        jobDeque* deques[Jobs::MaxWorkers + 1] = { };
+        std::thread threads[Jobs::MaxWorkers];
+        MPMCQueue<job*> injectQueue;
+        std::atomic<bool> stopRequested{false};
+        std::atomic<int> numSleeping{0};
+        std::atomic<uint32_t> wakeCount{0};
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondVar;
+    };
+    _state* state = nullptr;
+    ORYOL_THREADLOCAL_PTR(jobDeque) threadDeque = nullptr;
+    #else
+    bool valid = false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+JobCounter::JobCounter() :
+count(0),
+lock(0),
+waiters(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+JobCounter::~JobCounter() {
+    o_assert_dbg(0 == this->count.load(std::memory_order_relaxed));
+    o_assert_dbg(nullptr == this->waiters);
+}
+
+//------------------------------------------------------------------------------
+int
+JobCounter::Value() const {
+    return (this->count.load(std::memory_order_acquire) + 1) >> 1;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobCounter::IsDone() const {
+    return 0 == this->count.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+job*
+jobSystem::newJob(std::function<void()>&& func, JobCounter* counter) {
+    job* j = new(ClassPool<job>::Alloc()) job();
+    j->func = std::move(func);
+    j->counter = counter;
+    if (counter) {
+        counter->count.fetch_add(2, std::memory_order_relaxed);
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+job*
+jobSystem::newRangeJob(void (*rangeFunc)(void*, int, int), void* ctx, int begin, int end, JobCounter* counter) {
+    job* j = new(ClassPool<job>::Alloc()) job();
+    j->rangeFunc = rangeFunc;
+    j->ctx = ctx;
+    j->begin = begin;
+    j->end = end;
+    j->counter = counter;
+    counter->count.fetch_add(2, std::memory_order_relaxed);
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+jobSystem::lockWaiters(JobCounter* counter) {
+    int expected = 0;
+    while (!counter->lock.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        expected = 0;
+        #if ORYOL_HAS_THREADS
+        std::this_thread::yield();
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+jobSystem::unlockWaiters(JobCounter* counter) {
+    counter->lock.store(0, std::memory_order_release);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+static void
+wakeWorkers(bool all) {
+    // pairs with the fence in waitForJob(): either the sleeping worker sees
+    // the new job, or we see the sleeping worker
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state->numSleeping.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(state->wakeMutex);
+            state->wakeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (all) {
+            state->wakeCondVar.notify_all();
+        }
+        else {
+            state->wakeCondVar.notify_one();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+static job*
+findJob(jobDeque* own) {
+    job* j = own ? own->Pop() : nullptr;
+    if (j) {
+        return j;
+    }
+    if (state->injectQueue.Dequeue(j)) {
+        return j;
+    }
+    // try to steal from the other deques, starting at a random victim
+    const int numDeques = state->numWorkers + 1;
+    const int start = own ? int(own->Random() % uint32_t(numDeques)) : 0;
+    for (int i = 0; i < numDeques; i++) {
+        jobDeque* victim = state->deques[(start + i) % numDeques];
+        if ((victim != own) && !victim->Empty()) {
+            j = victim->Steal();
+            if (j) {
+                return j;
+            }
+        }
+    }
+    return nullptr;
+}
+#endif
+
+//------------------------------------------------------------------------------
+static void execute(job* j);
+
+//------------------------------------------------------------------------------
+/// push a job to the calling thread's deque or the shared queue, returns
+/// false if the job had to be executed immediately
+static bool
+schedule(job* j) {
+    #if ORYOL_HAS_THREADS
+    if (state && (state->numWorkers > 0)) {
+        if ((threadDeque && threadDeque->Push(j)) || state->injectQueue.Enqueue(j)) {
+            return true;
+        }
+    }
+    #endif
+    execute(j);
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+jobSystem::finish(JobCounter* counter) {
+    int c = counter->count.load(std::memory_order_relaxed);
+    for (;;) {
+        o_assert_dbg(c >= 2);
+        if (2 == c) {
+            // last job: go into the 'scheduling dependent jobs' state,
+            // so that Wait() doesn't return while we still touch the counter
+            if (counter->count.compare_exchange_weak(c, 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (counter->count.compare_exchange_weak(c, c - 2, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    lockWaiters(counter);
+    job* waiters = counter->waiters;
+    counter->waiters = nullptr;
+    unlockWaiters(counter);
+    // from here on the counter may be destroyed by a waiting thread
+    counter->count.fetch_sub(1, std::memory_order_release);
+    bool scheduled = false;
+    while (waiters) {
+        job* next = waiters->next;
+        waiters->next = nullptr;
+        scheduled |= schedule(waiters);
+        waiters = next;
+    }
+    #if ORYOL_HAS_THREADS
+    if (scheduled) {
+        wakeWorkers(false);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+static void
+execute(job* j) {
+    if (j->rangeFunc) {
+        j->rangeFunc(j->ctx, j->begin, j->end);
+    }
+    else {
+        j->func();
+    }
+    JobCounter* counter = j->counter;
+    j->~job();
+    ClassPool<job>::Free(j);
+    if (counter) {
+        jobSystem::finish(counter);
+    }
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+static void
+waitForJob(jobDeque* own) {
+    const uint32_t wakeCount = state->wakeCount.load(std::memory_order_relaxed);
+    state->numSleeping.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    job* j = findJob(own);
+    if (j) {
+        state->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        execute(j);
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(state->wakeMutex);
+        state->wakeCondVar.wait(lock, [wakeCount] {
+            return (wakeCount != state->wakeCount.load(std::memory_order_relaxed)) ||
+                   state->stopRequested.load(std::memory_order_relaxed);
+        });
+    }
+    state->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+static void
+workerFunc(int index) {
+    Core::EnterThread();
+    MemoryTracker::SetThreadName("jobWorker");
+    o_trace_thread_name("jobWorker");
+    jobDeque* own = state->deques[index + 1];
+    threadDeque = own;
+
+    Core::PreRunLoop()->Run();
+    int numSpins = 0;
+    for (;;) {
+        job* j = findJob(own);
+        if (j) {
+            execute(j);
+            numSpins = 0;
+        }
+        else if (state->stopRequested.load(std::memory_order_acquire)) {
+            break;
+        }
+        else if (++numSpins < NumIdleSpins) {
+            std::this_thread::yield();
+        }
+        else {
+            // end of this burst of work, run the per-thread runloops around sleeping
+            Core::PostRunLoop()->Run();
+            waitForJob(own);
+            Core::PreRunLoop()->Run();
+            numSpins = 0;
+        }
+    }
+    Core::PostRunLoop()->Run();
+
+    threadDeque = nullptr;
+    Core::LeaveThread();
+}
+#endif
+
+//------------------------------------------------------------------------------
+void
+Jobs::Setup(int numWorkers) {
+    o_assert_dbg(!IsValid());
+    o_assert_dbg((numWorkers >= 0) && (numWorkers <= MaxWorkers));
+    #if ORYOL_HAS_THREADS
+    o_memory_scope(Core);
+    state = Memory::New<_state>();
+    state->numWorkers = numWorkers;
+    for (int i = 0; i <= numWorkers; i++) {
+        state->deques[i] = Memory::New<jobDeque>(i);
+    }
+    state->injectQueue.Setup(InjectQueueCapacity);
+    threadDeque = state->deques[0];
+    for (int i = 0; i < numWorkers; i++) {
+        state->threads[i] = std::thread(workerFunc, i);
+    }
+    #else
+    valid = true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Jobs::Discard() {
+    o_assert_dbg(IsValid());
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->wakeMutex);
+        state->stopRequested.store(true, std::memory_order_release);
+    }
+    state->wakeCondVar.notify_all();
+    for (int i = 0; i < state->numWorkers; i++) {
+        state->threads[i].join();
+    }
+    // run jobs which are still pending (started by other jobs after the workers stopped)
+    job* j = nullptr;
+    while (nullptr != (j = state->deques[0]->Pop()) || state->injectQueue.Dequeue(j)) {
+        execute(j);
+    }
+    o_assert_dbg(threadDeque == state->deques[0]);
+    threadDeque = nullptr;
+    for (int i = 0; i <= state->numWorkers; i++) {
+        o_assert_dbg(state->deques[i]->Empty());
+        Memory::Delete(state->deques[i]);
+    }
+    Memory::Delete(state);
+    state = nullptr;
+    #else
+    valid = false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+Jobs::IsValid() {
+    #if ORYOL_HAS_THREADS
+    return nullptr != state;
+    #else
+    return valid;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+Jobs::NumWorkers() {
+    #if ORYOL_HAS_THREADS
+    return state ? state->numWorkers : 0;
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+Jobs::DefaultNumWorkers() {
+    #if ORYOL_HAS_THREADS
+    const int numCores = int(std::thread::hardware_concurrency());
+    if (numCores <= 1) {
+        return 0;
+    }
+    return numCores - 1 < MaxWorkers ? numCores - 1 : MaxWorkers;
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Jobs::Run(std::function<void()> func, JobCounter* counter) {
+    if (schedule(jobSystem::newJob(std::move(func), counter))) {
+        #if ORYOL_HAS_THREADS
+        wakeWorkers(false);
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Jobs::RunAfter(JobCounter* dependency, std::function<void()> func, JobCounter* counter) {
+    o_assert_dbg(dependency && (dependency != counter));
+    job* j = jobSystem::newJob(std::move(func), counter);
+    for (;;) {
+        jobSystem::lockWaiters(dependency);
+        const int c = dependency->count.load(std::memory_order_acquire);
+        if (c & 1) {
+            // the last job of the dependency is just finishing, let it complete
+            jobSystem::unlockWaiters(dependency);
+            #if ORYOL_HAS_THREADS
+            std::this_thread::yield();
+            #endif
+            continue;
+        }
+        if (0 == c) {
+            jobSystem::unlockWaiters(dependency);
+            if (schedule(j)) {
+                #if ORYOL_HAS_THREADS
+                wakeWorkers(false);
+                #endif
+            }
+        }
+        else {
+            j->next = dependency->waiters;
+            dependency->waiters = j;
+            jobSystem::unlockWaiters(dependency);
+        }
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Jobs::Wait(JobCounter* counter) {
+    o_assert_dbg(counter);
+    #if ORYOL_HAS_THREADS
+    while (0 != counter->count.load(std::memory_order_acquire)) {
+        job* j = state ? findJob(threadDeque) : nullptr;
+        if (j) {
+            execute(j);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    #else
+    o_assert(counter->IsDone());
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Jobs::parallelRange(int num, int batchSize, void (*rangeFunc)(void*, int, int), void* ctx) {
+    if (num <= 0) {
+        return;
+    }
+    const int numThreads = NumWorkers() + 1;
+    if (batchSize <= 0) {
+        // a few batches per thread to balance uneven work
+        const int numBatches = numThreads * 4;
+        batchSize = (num + numBatches - 1) / numBatches;
+    }
+    if ((1 == numThreads) || (batchSize >= num)) {
+        rangeFunc(ctx, 0, num);
+        return;
+    }
+    // push all batches but the first, process the first batch on this thread
+    JobCounter counter;
+    bool scheduled = false;
+    for (int begin = batchSize; begin < num; begin += batchSize) {
+        const int end = (num - begin) > batchSize ? begin + batchSize : num;
+        scheduled |= schedule(jobSystem::newRangeJob(rangeFunc, ctx, begin, end, &counter));
+    }
+    #if ORYOL_HAS_THREADS
+    if (scheduled) {
+        wakeWorkers(true);
+    }
+    #endif
+    rangeFunc(ctx, 0, batchSize);
+    Wait(&counter);
+}
+
+} // namespace Oryol
@@ -0,0 +1,157 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Jobs
+    @ingroup Core
+    @brief work-stealing job system
+
+    A fixed pool of worker threads which is created by Core::Setup()
+    (see CoreSetup::NumJobWorkers, by default there are no workers, -1
+    creates one worker per CPU core minus the main thread) and destroyed by Core::Discard(). Each worker
+    thread is entered with Core::EnterThread(), so it has its own RunLoops,
+    FrameArena and thread-local StringAtom table. A worker's 'frame' is
+    a burst of work: its PreRunLoop runs when it wakes up, and its
+    PostRunLoop (which also resets its FrameArena) runs before it goes
+    back to sleep.
+
+    The main thread and each worker own a work-stealing deque, jobs
+    started on those threads are pushed to the own deque, idle threads
+    steal jobs from the other deques. Jobs started on other threads
+    (e.g. the IO threads) go into a shared lock-free queue.
+
+    Completion is tracked with JobCounter objects, a counter is
+    incremented when a job is started and decremented when the job has
+    finished. Wait() on a counter executes other jobs on the calling
+    thread until the counter reaches zero. RunAfter() starts a job once
+    a counter has reached zero without blocking any thread:
+
+    ```cpp
+    JobCounter loaded, built;
+    Jobs::Run([&] { loadData(); }, &loaded);
+    Jobs::RunAfter(&loaded, [&] { buildMesh(); }, &built);
+    ...
+    Jobs::Wait(&built);
+    ```
+
+    ParallelFor() splits a Slice (or an index range) into batches which
+    are processed by all threads, the calling thread helps and returns
+    when all items have been processed:
+
+    ```cpp
+    Jobs::ParallelFor(vertices.MakeSlice(), [](Vertex& v) {
+        v.pos = transform(v.pos);
+    });
+    ```
+
+    If there are no worker threads (ORYOL_HAS_THREADS is 0, or
+    NumJobWorkers is 0, the default), jobs run immediately on the calling thread.
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Slice.h"
+#include <atomic>
+#include <functional>
+
+namespace Oryol {
+
+namespace _priv {
+struct job;
+class jobSystem;
+}
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobCounter
+    @ingroup Core
+    @brief tracks completion of a group of jobs
+
+    A JobCounter must not be destroyed while jobs referencing it are
+    still running, call Jobs::Wait() on it first. Jobs which have been
+    started with RunAfter() on a counter run when the counter next reaches
+    zero.
+*/
+class JobCounter {
+public:
+    /// constructor
+    JobCounter();
+    /// destructor
+    ~JobCounter();
+
+    /// get number of unfinished jobs
+    int Value() const;
+    /// return true if all jobs have finished
+    bool IsDone() const;
+
+private:
+    /// not copyable
+    JobCounter(const JobCounter& rhs) = delete;
+    /// not copyable
+    void operator=(const JobCounter& rhs) = delete;
+
+    friend class Jobs;
+    friend class _priv::jobSystem;
+    /// 2 per unfinished job, plus 1 while the last job is scheduling dependent jobs
+    std::atomic<int> count;
+    /// spinlock protecting the dependent-job list
+    std::atomic<int> lock;
+    /// jobs which run when the counter reaches zero
+    _priv::job* waiters;
+};
+
+//------------------------------------------------------------------------------
+class Jobs {
+public:
+    /// max number of worker threads
+    static const int MaxWorkers = 63;
+    /// setup the job system with a number of worker threads (called by Core::Setup())
+    static void Setup(int numWorkers);
+    /// discard the job system, runs all pending jobs (called by Core::Discard())
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get number of worker threads (not counting the main thread)
+    static int NumWorkers();
+    /// get default number of worker threads (number of CPU cores minus 1)
+    static int DefaultNumWorkers();
+
+    /// start a job, optional counter is incremented until the job has finished
+    static void Run(std::function<void()> func, JobCounter* counter = nullptr);
+    /// start a job when the dependency counter reaches zero
+    static void RunAfter(JobCounter* dependency, std::function<void()> func, JobCounter* counter = nullptr);
+    /// run jobs on the calling thread until the counter reaches zero
+    static void Wait(JobCounter* counter);
+
+    /// call func(TYPE& item) for each item of the slice, in parallel batches
+    template<class TYPE, class FUNC> static void ParallelFor(Slice<TYPE> items, const FUNC& func, int batchSize = 0);
+    /// call func(int begin, int end) for batches of the range [0, num), in parallel
+    template<class FUNC> static void ParallelFor(int num, const FUNC& func, int batchSize = 0);
+
+private:
+    /// split [0, num) into batches and run rangeFunc on them in parallel
+    static void parallelRange(int num, int batchSize, void (*rangeFunc)(void* ctx, int begin, int end), void* ctx);
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, class FUNC> void
+Jobs::ParallelFor(Slice<TYPE> items, const FUNC& func, int batchSize) {
+    struct context {
+        Slice<TYPE>* items;
+        const FUNC* func;
+    };
+    context ctx = { &items, &func };
+    parallelRange(items.Size(), batchSize, [](void* ptr, int begin, int end) {
+        context* ctx = (context*) ptr;
+        for (int i = begin; i < end; i++) {
+            (*ctx->func)((*ctx->items)[i]);
+        }
+    }, &ctx);
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+Jobs::ParallelFor(int num, const FUNC& func, int batchSize) {
+    parallelRange(num, batchSize, [](void* ptr, int begin, int end) {
+        (*(const FUNC*)ptr)(begin, end);
+    }, (void*) &func);
+}
+
+} // namespace Oryol
@@ -0,0 +1,166 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::jobDeque
+    @ingroup _priv
+    @brief per-thread work-stealing deque of the job system
+
+    A fixed-capacity Chase-Lev deque (in the C11 formulation of Le, Pop,
+    Cohen and Nardelli, "Correct and Efficient Work-Stealing for Weak
+    Memory Models"). The owner thread pushes and pops jobs at the bottom
+    end (LIFO, so that the most recent and cache-hot jobs run first),
+    other threads steal the oldest jobs from the top end.
+
+    Push() returns false if the deque is full, Pop() and Steal() return
+    nullptr if the deque is empty, Steal() also returns nullptr if it
+    lost a race against another thief or the owner.
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include <atomic>
+#include <functional>
+
+namespace Oryol {
+
+class JobCounter;
+
+namespace _priv {
+
+/// a job item, allocated from a ClassPool
+struct job {
+    /// the job function (if rangeFunc is not set)
+    std::function<void()> func;
+    /// alternatively a function which processes the range [begin, end)
+    void (*rangeFunc)(void* ctx, int begin, int end) = nullptr;
+    /// context pointer for rangeFunc
+    void* ctx = nullptr;
+    /// range begin for rangeFunc
+    int begin = 0;
+    /// range end for rangeFunc
+    int end = 0;
+    /// optional counter which is decremented when the job has finished
+    JobCounter* counter = nullptr;
+    /// next dependent job waiting on the same counter
+    job* next = nullptr;
+};
+
+class jobDeque {
+public:
+    /// max number of jobs in the deque
+    static const int Capacity = 4096;
+
+    /// constructor with index of the deque in the job system
+    jobDeque(int index);
+
+    /// push a job at the bottom (owner thread only), false if full
+    bool Push(job* j);
+    /// pop a job from the bottom (owner thread only)
+    job* Pop();
+    /// steal a job from the top (any thread)
+    job* Steal();
+    /// return true if deque looks empty (only a hint)
+    bool Empty() const;
+
+    /// get pseudo-random number for picking steal victims (owner thread only)
+    uint32_t Random();
+    /// index of the deque in the job system
+    const int Index;
+
+private:
+    static const int64_t Mask = Capacity - 1;
+
+    std::atomic<int64_t> top;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<int64_t> bottom;
+    uint32_t seed;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    std::atomic<job*> buffer[Capacity];
+};
+
+//------------------------------------------------------------------------------
+inline
+jobDeque::jobDeque(int index) :
+Index(index),
+top(0),
+bottom(0),
+seed(0x9E3779B9u * uint32_t(index + 1)) {
+    for (int i = 0; i < Capacity; i++) {
+        this->buffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline bool
+jobDeque::Push(job* j) {
+    o_assert_dbg(j);
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    const int64_t t = this->top.load(std::memory_order_acquire);
+    if ((b - t) >= Capacity) {
+        return false;
+    }
+    this->buffer[b & Mask].store(j, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+inline job*
+jobDeque::Pop() {
+    const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // deque was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    job* j = this->buffer[b & Mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last item, race against thieves
+        if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            j = nullptr;
+        }
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+inline job*
+jobDeque::Steal() {
+    int64_t t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    job* j = this->buffer[t & Mask].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+jobDeque::Empty() const {
+    const int64_t t = this->top.load(std::memory_order_relaxed);
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    return t >= b;
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+jobDeque::Random() {
+    // xorshift32
+    uint32_t x = this->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    this->seed = x;
+    return x;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -17,6 +17,13 @@
 
 #if ORYOL_HAS_THREADS
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Metrics/Metrics.h"
 static std::mutex lockMutex;
 #define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
 #else
@@ -35,6 +42,279 @@ using namespace std;
 static Log::Level curLogLevel = Log::Level::Dbg;
 static Array<Ptr<Logger>> loggers;
 
+#if ORYOL_HAS_THREADS
+namespace {
+
+// a formatted message in the async log queue
+struct logMessage {
+    Log::Level level;
+    char text[Log::MaxAsyncMessageLength];
+};
+
+// async logging state, created by Log::StartAsync()
+struct asyncLogState {
+    MPMCQueue<logMessage> queue;
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCond;
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopRequested{false};
+    int64_t numReportedDropped = 0;     // protected by lockMutex
+};
+asyncLogState* asyncLog = nullptr;             // protected by lockMutex, see asyncActive
+std::atomic<bool> asyncActive{false};
+std::atomic<int> numProducers{0};               // threads which are in enqueueAsync()
+std::atomic<int64_t> numDropped{0};
+
+// max number of messages printed by the log thread with the lock held
+const int MaxDrainBatch = 64;
+
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    Print a message synchronously to the loggers, or to the default
+    output if no loggers are attached. Must be called with the lock held.
+*/
+static void
+dispatch(Log::Level lvl, const char* msg, va_list args) {
+    if (loggers.Empty()) {
+        #if ORYOL_ANDROID
+            android_LogPriority pri = ANDROID_LOG_DEFAULT;
+            switch (lvl) {
+                case Log::Level::Error: pri = ANDROID_LOG_ERROR; break;
+                case Log::Level::Warn:  pri = ANDROID_LOG_WARN; break;
+                case Log::Level::Info:  pri = ANDROID_LOG_INFO; break;
+                case Log::Level::Dbg:   pri = ANDROID_LOG_DEBUG; break;
+                default:                pri = ANDROID_LOG_DEFAULT; break;
+            }
+            __android_log_vprint(pri, "oryol", msg, args);
+        #else
+            #if ORYOL_WINDOWS
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            #endif
+
+            // do the vprintf, this will destroy the original
+            // va_list, so we made a copy before if necessary
+            std::vprintf(msg, args);
+
+            #if ORYOL_WINDOWS
+                char buf[LogBufSize];
+                std::vsnprintf(buf, sizeof(buf), msg, argsCopy);
+                #if ORYOL_WINDOWS
+                    buf[LogBufSize - 1] = 0;
+                    OutputDebugStringA(buf);
+                #endif
+            #endif
+        #endif
+    }
+    else {
+        for (auto l : loggers) {
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            l->VPrint(lvl, msg, argsCopy);
+            va_end(argsCopy);
+        }
+    }
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+static void
+dispatchf(Log::Level lvl, const char* msg, ...) __attribute__((format(printf, 2, 3)));
+static void
+dispatchf(Log::Level lvl, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    dispatch(lvl, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Print up to maxNum queued async messages, returns number of printed
+    messages. Must be called with the lock held.
+*/
+static int
+drainAsync(int maxNum) {
+    if (nullptr == asyncLog) {
+        return 0;
+    }
+    int num = 0;
+    logMessage msg;
+    while ((num < maxNum) && asyncLog->queue.Dequeue(msg)) {
+        dispatchf(msg.level, "%s", msg.text);
+        num++;
+    }
+    const int64_t dropped = numDropped.load(std::memory_order_relaxed);
+    if (dropped != asyncLog->numReportedDropped) {
+        dispatchf(Log::Level::Warn, "Log: %d messages dropped (async log queue full)\n",
+            int(dropped - asyncLog->numReportedDropped));
+        asyncLog->numReportedDropped = dropped;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+static void
+asyncLogThread(asyncLogState* state) {
+    while (!state->stopRequested.load()) {
+        int num = 0;
+        {
+            SCOPED_LOCK;
+            num = drainAsync(MaxDrainBatch);
+        }
+        if (0 == num) {
+            // go to sleep until wakeAsyncLogThread() or StopAsync() is called
+            std::unique_lock<std::mutex> lock(state->wakeMutex);
+            state->sleeping = true;
+            // pairs with the fence in wakeAsyncLogThread(): either the
+            // producer sees 'sleeping', or we see the new message
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (state->queue.Empty() && !state->stopRequested) {
+                state->wakeCond.wait(lock, [state] {
+                    return !state->sleeping || state->stopRequested;
+                });
+            }
+            state->sleeping = false;
+        }
+    }
+    // the loggers may allocate memory and record metrics on this thread
+    Memory::ReleaseThreadCache();
+    Metrics::ReleaseThreadSlots();
+    MemoryTracker::ReleaseThreadCounters();
+}
+
+//------------------------------------------------------------------------------
+static void
+wakeAsyncLogThread(asyncLogState* state) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state->sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(state->wakeMutex);
+        state->sleeping = false;
+        state->wakeCond.notify_one();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Try to put a message into the async queue, returns false if the
+    message must be printed synchronously.
+*/
+static bool
+enqueueAsync(Log::Level lvl, const char* msg, va_list args) {
+    // StopAsync() waits for all producers before it destroys the state
+    numProducers.fetch_add(1);
+    if (!asyncActive.load()) {
+        numProducers.fetch_sub(1);
+        return false;
+    }
+    asyncLogState* state = asyncLog;
+    logMessage logMsg;
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    const int len = std::vsnprintf(logMsg.text, sizeof(logMsg.text), msg, argsCopy);
+    va_end(argsCopy);
+    bool queued = false;
+    if ((len >= 0) && (len < int(sizeof(logMsg.text)))) {
+        logMsg.level = lvl;
+        if (state->queue.Enqueue(logMsg)) {
+            wakeAsyncLogThread(state);
+        }
+        else {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        queued = true;
+    }
+    numProducers.fetch_sub(1);
+    return queued;
+}
+#endif
+
+//------------------------------------------------------------------------------
+void
+Log::StartAsync(int queueSize) {
+    #if ORYOL_HAS_THREADS
+    o_assert(nullptr == asyncLog);
+    o_assert(queueSize > 0);
+    asyncLogState* state = Memory::New<asyncLogState>();
+    state->queue.Setup(queueSize);
+    state->numReportedDropped = numDropped.load();
+    state->thread = std::thread(asyncLogThread, state);
+    {
+        SCOPED_LOCK;
+        asyncLog = state;
+    }
+    asyncActive.store(true);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::StopAsync() {
+    #if ORYOL_HAS_THREADS
+    asyncLogState* state = nullptr;
+    {
+        SCOPED_LOCK;
+        state = asyncLog;
+    }
+    if (state) {
+        // new messages are printed synchronously, wait until the threads
+        // which are already putting a message into the queue are done
+        asyncActive.store(false);
+        while (numProducers.load() > 0) {
+            std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->wakeMutex);
+            state->stopRequested.store(true);
+            state->wakeCond.notify_one();
+        }
+        state->thread.join();
+        {
+            SCOPED_LOCK;
+            drainAsync(state->queue.Capacity());
+            asyncLog = nullptr;
+        }
+        state->queue.Discard();
+        Memory::Delete(state);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    #if ORYOL_HAS_THREADS
+    return asyncActive.load(std::memory_order_relaxed);
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::Flush() {
+    #if ORYOL_HAS_THREADS
+    SCOPED_LOCK;
+    if (asyncLog) {
+        drainAsync(asyncLog->queue.Capacity());
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Log::NumDropped() {
+    #if ORYOL_HAS_THREADS
+    return numDropped.load(std::memory_order_relaxed);
+    #else
+    return 0;
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 Log::AddLogger(const Ptr<Logger>& l) {
@@ -44,6 +324,16 @@ Log::AddLogger(const Ptr<Logger>& l) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::RemoveLogger(const Ptr<Logger>& l) {
+    SCOPED_LOCK;
+    const int index = loggers.FindIndexLinear(l);
+    if (InvalidIndex != index) {
+        loggers.Erase(index);
+    }
+}
+
 //------------------------------------------------------------------------------
 int
 Log::GetNumLoggers() {
@@ -147,49 +437,34 @@ Log::VError(const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
-    SCOPED_LOCK;
-    if (loggers.Empty()) {
-        #if ORYOL_ANDROID
-            android_LogPriority pri = ANDROID_LOG_DEFAULT;
-            switch (lvl) {
-                case Level::Error: pri = ANDROID_LOG_ERROR; break;
-                case Level::Warn:  pri = ANDROID_LOG_WARN; break;
-                case Level::Info:  pri = ANDROID_LOG_INFO; break;
-                case Level::Dbg:   pri = ANDROID_LOG_DEBUG; break;
-                default:           pri = ANDROID_LOG_DEFAULT; break;
-            }
-            __android_log_vprint(pri, "oryol", msg, args);
-        #else
-            #if ORYOL_WINDOWS
-            va_list argsCopy;
-            va_copy(argsCopy, args);
-            #endif
-
-            // do the vprintf, this will destroy the original
-            // va_list, so we made a copy before if necessary
-            std::vprintf(msg, args);
-
-            #if ORYOL_WINDOWS
-                char buf[LogBufSize];
-                std::vsnprintf(buf, sizeof(buf), msg, argsCopy);
-                #if ORYOL_WINDOWS
-                    buf[LogBufSize - 1] = 0;
-                    OutputDebugStringA(buf);
-                #endif
-            #endif
-        #endif
-    }
-    else {
-        for (auto l : loggers) {
-            l->VPrint(lvl, msg, args);
+    #if ORYOL_HAS_THREADS
+    // errors are always printed synchronously, so they show up before
+    // the program is stopped by o_error()
+    if (asyncActive.load(std::memory_order_acquire) && (Level::Error != lvl)) {
+        if (enqueueAsync(lvl, msg, args)) {
+            return;
         }
     }
+    #endif
+    SCOPED_LOCK;
+    #if ORYOL_HAS_THREADS
+    // print pending async messages first to preserve message order
+    if (asyncLog) {
+        drainAsync(asyncLog->queue.Capacity());
+    }
+    #endif
+    dispatch(lvl, msg, args);
 }
 
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
     SCOPED_LOCK;
+    #if ORYOL_HAS_THREADS
+    if (asyncLog) {
+        drainAsync(asyncLog->queue.Capacity());
+    }
+    #endif
     if (loggers.Empty()) {
         char callstack[4096];
         StackTrace::Dump(callstack, sizeof(callstack));
@@ -9,6 +9,17 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
+    By default, log messages are printed synchronously (Logger objects
+    are called on the logging thread under a global lock). After
+    StartAsync() (see also CoreSetup::AsyncLogging), messages are
+    formatted on the logging thread into a bounded lock-free queue and
+    printed by a background thread, so that logging threads never
+    wait for each other or for slow Loggers. If the queue is full,
+    messages are dropped (see NumDropped()). Errors, asserts and
+    messages longer than MaxAsyncMessageLength flush the queue and are
+    printed synchronously, so that nothing is lost before o_error()
+    or o_assert() stop the program.
+
     @see Logger
 */
 #include <cstdarg>
@@ -36,6 +47,8 @@ public:
 
     /// add a logger object
     static void AddLogger(const Ptr<Logger>& p);
+    /// remove a logger object
+    static void RemoveLogger(const Ptr<Logger>& p);
     /// get number of loggers
     static int GetNumLoggers();
     /// get logger at index
@@ -64,6 +77,21 @@ public:
     /// print an assert message
     static void AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func);
 
+    /// max length of an asynchronous message (longer messages are printed synchronously)
+    static const int MaxAsyncMessageLength = 248;
+    /// default number of queued asynchronous messages
+    static const int DefaultAsyncQueueSize = 1024;
+    /// start asynchronous logging (don't call while other threads are logging)
+    static void StartAsync(int queueSize = DefaultAsyncQueueSize);
+    /// stop asynchronous logging, prints pending messages (other threads may keep logging)
+    static void StopAsync();
+    /// return true if asynchronous logging is active
+    static bool IsAsync();
+    /// print all pending asynchronous messages on the calling thread
+    static void Flush();
+    /// get number of asynchronous messages dropped because the queue was full
+    static int64_t NumDropped();
+
 private:
     /// generic vprint-style method
     static void vprint(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
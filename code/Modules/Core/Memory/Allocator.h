@@ -0,0 +1,45 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Allocator
+    @ingroup Core
+    @brief pluggable allocator interface
+
+    Allocator objects can be handed to the Array, Buffer and StringBuilder
+    containers (see FrameArena), or serve as backend for Memory::Alloc().
+
+    An allocator backend is installed once at Core::Setup() time through
+    the CoreSetup::MemoryAllocator member (or directly with
+    Memory::SetAllocator()), after which Memory::Alloc(),
+    Memory::ReAlloc() and Memory::Free() will be routed through it.
+
+    Memory which has been allocated before the backend was installed
+    (for instance by static initializers) is still freed through
+    std::free(), this is why an allocator backend must be able to tell
+    whether a pointer belongs to it (see Owns()). Installed backends can't
+    be uninstalled, since memory allocated through them may still be
+    alive after Core::Discard().
+
+    @see SizeClassAllocator, FrameArena
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class Allocator {
+public:
+    /// destructor
+    virtual ~Allocator() { };
+    /// allocate a chunk of memory (must be ORYOL_MAX_PLATFORM_ALIGN aligned)
+    virtual void* Alloc(int numBytes) = 0;
+    /// re-allocate a chunk of memory owned by this allocator
+    virtual void* ReAlloc(void* ptr, int numBytes) = 0;
+    /// free a chunk of memory owned by this allocator
+    virtual void Free(void* ptr) = 0;
+    /// return true if a pointer has been allocated by this allocator
+    virtual bool Owns(const void* ptr) const = 0;
+    /// release per-thread resources (called from Core::LeaveThread())
+    virtual void ReleaseThreadCache() { };
+};
+
+} // namespace Oryol
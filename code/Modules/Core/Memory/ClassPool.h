@@ -0,0 +1,236 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ClassPool
+    @ingroup Core
+    @brief thread-safe, lock-free object pool for one class
+
+    This is the pool behind the OryolClassPoolAllocDecl() class annotation
+    macro. A ClassPool hands out uninitialized memory for one object of
+    TYPE. Each thread keeps a small cache of free objects which is
+    refilled from (and flushed to) a shared lock-free free-list in
+    batches, so that most Alloc() and Free() calls don't touch any
+    shared state. When the shared free-list is empty, a new chunk of
+    ChunkSize objects is allocated (this is the only place where a
+    spin-lock is taken). Chunks are never released, so the pool will
+    stay at its high-water-mark.
+
+    Each object slot has a small header in front of the object which
+    holds the slot index and the free-list link, the free-list head is
+    a 64-bit atomic of slot index and a tag which is bumped on every
+    operation to protect against the ABA problem.
+
+    NOTE: objects which sit in the cache of a thread when the thread
+    exits are not returned to the pool (at most ThreadCacheSize objects
+    per thread and class).
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+
+namespace Oryol {
+
+template<class TYPE> class ClassPool {
+public:
+    /// number of objects in a chunk
+    static const int ChunkSize = 64;
+    /// max number of chunks
+    static const int MaxChunks = 4096;
+    /// max number of free objects in a thread's cache
+    static const int ThreadCacheSize = 32;
+    /// number of objects moved from the shared free-list into a thread cache
+    static const int BatchSize = 16;
+
+    /// allocate memory for one object (not constructed)
+    static void* Alloc();
+    /// free memory of an already destructed object
+    static void Free(void* ptr);
+    /// get number of object slots in the pool
+    static int Capacity();
+
+private:
+    static const uint32_t InvalidIndex = 0xFFFFFFFF;
+    static const int HeaderSize = alignof(TYPE) > 8 ? alignof(TYPE) : 8;
+    static const int SlotAlign = alignof(TYPE) > 8 ? alignof(TYPE) : 8;
+    static const int SlotSize = ((HeaderSize + int(sizeof(TYPE))) + (SlotAlign - 1)) & ~(SlotAlign - 1);
+
+    struct header {
+        uint32_t index;
+        std::atomic<uint32_t> next;
+    };
+    /// get slot header by slot index
+    static header* slot(uint32_t index);
+    /// get object pointer of a slot
+    static void* object(header* hdr);
+    /// get number of slots in the thread cache (stored in the free object)
+    static int cacheCount(header* hdr);
+    /// set number of slots in the thread cache
+    static void setCacheCount(header* hdr, int count);
+    /// move a batch of slots from the shared free-list into the thread cache
+    static void refill();
+    /// allocate a new chunk and push its slots to the shared free-list
+    static void grow(uint64_t seenHead);
+    /// push a chain of slots to the shared free-list
+    static void push(uint32_t first, header* last);
+
+    static std::atomic<uint64_t> head;
+    static std::atomic<int> numChunks;
+    static std::atomic<int> growLock;
+    static std::atomic<uint8_t*> chunks[MaxChunks];
+    static ORYOL_THREADLOCAL_PTR(header) cache;
+    static_assert(sizeof(TYPE) >= sizeof(int), "ClassPool: object too small!");
+};
+
+template<class TYPE> std::atomic<uint64_t> ClassPool<TYPE>::head(InvalidIndex);
+template<class TYPE> std::atomic<int> ClassPool<TYPE>::numChunks(0);
+template<class TYPE> std::atomic<int> ClassPool<TYPE>::growLock(0);
+template<class TYPE> std::atomic<uint8_t*> ClassPool<TYPE>::chunks[MaxChunks];
+template<class TYPE> ORYOL_THREADLOCAL_PTR(typename ClassPool<TYPE>::header) ClassPool<TYPE>::cache = nullptr;
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename ClassPool<TYPE>::header*
+ClassPool<TYPE>::slot(uint32_t index) {
+    uint8_t* chunk = chunks[index / ChunkSize].load(std::memory_order_acquire);
+    o_assert_dbg(chunk);
+    return (header*) (chunk + (index % ChunkSize) * SlotSize);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void*
+ClassPool<TYPE>::object(header* hdr) {
+    return ((uint8_t*)hdr) + HeaderSize;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+ClassPool<TYPE>::cacheCount(header* hdr) {
+    return *(int*)object(hdr);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+ClassPool<TYPE>::setCacheCount(header* hdr, int count) {
+    *(int*)object(hdr) = count;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+ClassPool<TYPE>::push(uint32_t first, header* last) {
+    uint64_t oldHead = head.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        last->next.store(uint32_t(oldHead), std::memory_order_relaxed);
+        newHead = (((oldHead >> 32) + 1) << 32) | first;
+    }
+    while (!head.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+ClassPool<TYPE>::grow(uint64_t seenHead) {
+    while (growLock.exchange(1, std::memory_order_acquire)) {
+        // spin
+    }
+    // only grow if no other thread has pushed slots in the meantime
+    if (head.load(std::memory_order_acquire) == seenHead) {
+        const int chunkIndex = numChunks.load(std::memory_order_relaxed);
+        o_assert2(chunkIndex < MaxChunks, "ClassPool: too many objects!\n");
+        uint8_t* chunk = (uint8_t*) Memory::Alloc(ChunkSize * SlotSize);
+        const uint32_t firstIndex = uint32_t(chunkIndex * ChunkSize);
+        for (int i = 0; i < ChunkSize; i++) {
+            header* hdr = (header*) (chunk + i * SlotSize);
+            hdr->index = firstIndex + i;
+            hdr->next.store(firstIndex + i + 1, std::memory_order_relaxed);
+        }
+        chunks[chunkIndex].store(chunk, std::memory_order_release);
+        numChunks.store(chunkIndex + 1, std::memory_order_release);
+        push(firstIndex, (header*) (chunk + (ChunkSize - 1) * SlotSize));
+    }
+    growLock.store(0, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+ClassPool<TYPE>::refill() {
+    uint64_t oldHead = head.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t index = uint32_t(oldHead);
+        if (InvalidIndex == index) {
+            grow(oldHead);
+            oldHead = head.load(std::memory_order_acquire);
+            continue;
+        }
+        // walk a batch of slots, if another thread modifies the free-list
+        // in the meantime the tag will have changed and the CAS fails
+        header* first = slot(index);
+        header* last = first;
+        int count = 1;
+        uint32_t next = last->next.load(std::memory_order_relaxed);
+        while ((count < BatchSize) && (InvalidIndex != next)) {
+            last = slot(next);
+            next = last->next.load(std::memory_order_relaxed);
+            count++;
+        }
+        const uint64_t newHead = (((oldHead >> 32) + 1) << 32) | next;
+        if (head.compare_exchange_weak(oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            setCacheCount(first, count);
+            cache = first;
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void*
+ClassPool<TYPE>::Alloc() {
+    header* hdr = cache;
+    if (nullptr == hdr) {
+        refill();
+        hdr = cache;
+    }
+    const int count = cacheCount(hdr);
+    if (count > 1) {
+        header* next = slot(hdr->next.load(std::memory_order_relaxed));
+        setCacheCount(next, count - 1);
+        cache = next;
+    }
+    else {
+        cache = nullptr;
+    }
+    return object(hdr);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+ClassPool<TYPE>::Free(void* ptr) {
+    o_assert_dbg(ptr);
+    header* hdr = (header*) (((uint8_t*)ptr) - HeaderSize);
+    header* first = cache;
+    int count = 0;
+    if (nullptr != first) {
+        count = cacheCount(first);
+        if (count >= ThreadCacheSize) {
+            // thread cache is full, give it back to the shared free-list
+            header* last = first;
+            for (int i = 1; i < count; i++) {
+                last = slot(last->next.load(std::memory_order_relaxed));
+            }
+            push(first->index, last);
+            first = nullptr;
+            count = 0;
+        }
+    }
+    hdr->next.store(first ? first->index : InvalidIndex, std::memory_order_relaxed);
+    setCacheCount(hdr, count + 1);
+    cache = hdr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+ClassPool<TYPE>::Capacity() {
+    return numChunks.load(std::memory_order_relaxed) * ChunkSize;
+}
+
+} // namespace Oryol
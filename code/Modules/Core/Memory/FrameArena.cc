@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  FrameArena.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameArena.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+FrameArena::FrameArena(int capacity_) :
+buf(nullptr),
+capacity(capacity_),
+top(0),
+lastAlloc(-1),
+lastAllocGeneration(0),
+generation(0),
+overflowBytes(0),
+highWaterMark(0),
+numOverflows(0) {
+    o_assert_dbg(capacity_ >= 0);
+    #if ORYOL_HAS_THREADS
+    this->ownerThreadId = std::this_thread::get_id();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+FrameArena::~FrameArena() {
+    if (this->buf) {
+        Memory::Free(this->buf);
+        this->buf = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameArena::isOwnerThread() const {
+    #if ORYOL_HAS_THREADS
+        return std::this_thread::get_id() == this->ownerThreadId;
+    #else
+        return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameArena::isLastAlloc(const void* ptr) const {
+    // lastAlloc is only valid in the frame it was recorded in, a stale
+    // pointer from a previous frame must not free a live allocation
+    return (this->lastAllocGeneration == this->generation) &&
+           (this->lastAlloc >= 0) &&
+           (ptr == this->buf + this->lastAlloc);
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameArena::Alloc(int numBytes) {
+    o_assert_dbg(this->isOwnerThread());
+    o_assert_dbg(numBytes >= 0);
+    const int size = Memory::RoundUp(numBytes > 0 ? numBytes : 1, ORYOL_MAX_PLATFORM_ALIGN);
+    if ((this->top + size) > this->capacity) {
+        // arena is full, fall back to the heap
+        this->overflowBytes += size;
+        this->numOverflows++;
+        return Memory::Alloc(numBytes);
+    }
+    if (nullptr == this->buf) {
+        this->buf = (uint8_t*) Memory::Alloc(this->capacity);
+    }
+    this->lastAlloc = this->top;
+    this->lastAllocGeneration = this->generation;
+    this->top += size;
+    return this->buf + this->lastAlloc;
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameArena::ReAlloc(void* ptr, int numBytes) {
+    o_assert_dbg(this->isOwnerThread());
+    if (nullptr == ptr) {
+        return this->Alloc(numBytes);
+    }
+    if (!this->Owns(ptr)) {
+        return Memory::ReAlloc(ptr, numBytes);
+    }
+    const int offset = int((uint8_t*)ptr - this->buf);
+    o_assert_dbg(offset < this->top);
+    const bool wasLastAlloc = this->isLastAlloc(ptr);
+    if (wasLastAlloc) {
+        // most recent allocation, try to grow in place
+        const int size = Memory::RoundUp(numBytes > 0 ? numBytes : 1, ORYOL_MAX_PLATFORM_ALIGN);
+        if ((offset + size) <= this->capacity) {
+            this->top = offset + size;
+            return ptr;
+        }
+    }
+    // the size of the old allocation isn't known, but everything up to
+    // the arena top is valid memory, so copying too much is harmless
+    const int maxCopy = offset < this->top ? this->top - offset : 0;
+    void* newPtr = this->Alloc(numBytes);
+    Memory::Copy(ptr, newPtr, numBytes < maxCopy ? numBytes : maxCopy);
+    if (wasLastAlloc && !this->Owns(newPtr)) {
+        // moved to the heap, the old block can be reclaimed
+        this->top = offset;
+        this->lastAlloc = -1;
+    }
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::Free(void* ptr) {
+    o_assert_dbg(this->isOwnerThread());
+    if (this->Owns(ptr)) {
+        if (this->isLastAlloc(ptr)) {
+            this->top = this->lastAlloc;
+            this->lastAlloc = -1;
+        }
+    }
+    else if (nullptr != ptr) {
+        Memory::Free(ptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::Reset() {
+    o_assert_dbg(this->isOwnerThread());
+    const int used = this->Used();
+    if (used > this->highWaterMark) {
+        this->highWaterMark = used;
+    }
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    if (this->buf && (this->top > 0)) {
+        Memory::Fill(this->buf, this->top, ORYOL_MEMORY_DEBUG_BYTE);
+    }
+    #endif
+    this->top = 0;
+    this->lastAlloc = -1;
+    this->generation++;
+    this->overflowBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameArena::ResetStats() {
+    this->highWaterMark = 0;
+    this->numOverflows = 0;
+}
+
+} // namespace Oryol
@@ -0,0 +1,119 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameArena
+    @ingroup Core
+    @brief linear allocator for transient per-frame data
+
+    A FrameArena hands out memory by bumping a pointer in a fixed-size
+    memory block, and Reset() throws away all allocations at once. Each
+    thread which has been setup through Core::Setup() or Core::EnterThread()
+    owns a FrameArena (see Core::FrameAllocator()), which is reset by
+    the thread's PostRunLoop, so memory allocated from it is only valid
+    until the end of the current frame!
+
+    Free() only gives memory back if it was the most recent allocation
+    since the last Reset(), otherwise it is a no-op. A FrameArena must
+    only be used by the thread which created it. If the arena runs out of space, allocations
+    fall back to Memory::Alloc() and count as overflows. Use the
+    HighWaterMark() stats to size the arena through CoreSetup::FrameArenaSize.
+
+    Containers which can take an allocator:
+
+    ```cpp
+    Array<Id> ids;
+    ids.SetAllocator(Core::FrameAllocator());
+    ```
+
+    @see Allocator, Array, Buffer, StringBuilder
+*/
+#include "Core/Config.h"
+#include "Core/Memory/Allocator.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+
+class FrameArena : public Allocator {
+public:
+    /// constructor, memory is allocated on first use
+    FrameArena(int capacity);
+    /// destructor
+    ~FrameArena();
+
+    /// allocate memory, falls back to Memory::Alloc() if arena is full
+    virtual void* Alloc(int numBytes) override;
+    /// re-allocate memory, grows in place if ptr is the most recent allocation of this frame
+    virtual void* ReAlloc(void* ptr, int numBytes) override;
+    /// free memory (only reclaimed if ptr is the most recent allocation of this frame)
+    virtual void Free(void* ptr) override;
+    /// return true if ptr is inside the arena
+    virtual bool Owns(const void* ptr) const override;
+
+    /// throw away all allocations (called at end of frame)
+    void Reset();
+
+    /// get arena capacity in bytes
+    int Capacity() const;
+    /// get number of bytes allocated in current frame (including overflows)
+    int Used() const;
+    /// get max number of bytes allocated in a frame (including overflows)
+    int HighWaterMark() const;
+    /// get number of allocations which didn't fit into the arena
+    int NumOverflows() const;
+    /// reset the high-water-mark and overflow stats
+    void ResetStats();
+
+private:
+    /// return true if ptr is the most recent allocation of the current frame
+    bool isLastAlloc(const void* ptr) const;
+    /// return true if called on the thread which created the arena
+    bool isOwnerThread() const;
+
+    uint8_t* buf;
+    int capacity;
+    int top;
+    int lastAlloc;
+    int lastAllocGeneration;
+    int generation;
+    int overflowBytes;
+    int highWaterMark;
+    int numOverflows;
+    #if ORYOL_HAS_THREADS
+    std::thread::id ownerThreadId;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+inline bool
+FrameArena::Owns(const void* ptr) const {
+    return (ptr >= this->buf) && (ptr < (this->buf + this->capacity));
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameArena::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameArena::Used() const {
+    return this->top + this->overflowBytes;
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameArena::HighWaterMark() const {
+    const int used = this->Used();
+    return used > this->highWaterMark ? used : this->highWaterMark;
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameArena::NumOverflows() const {
+    return this->numOverflows;
+}
+
+} // namespace Oryol
@@ -5,16 +5,79 @@
 #include <cstdlib>
 #include <cstring>
 #include "Memory.h"
+#include "Allocator.h"
+#include "MemoryTracker.h"
+#include "Core/Assertion.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
+
+static Allocator* allocator = nullptr;
+
+//------------------------------------------------------------------------------
+static void*
+rawAlloc(int numBytes) {
+    return allocator ? allocator->Alloc(numBytes) : std::malloc(numBytes);
+}
+
+//------------------------------------------------------------------------------
+static void*
+rawReAlloc(void* ptr, int numBytes) {
+    if (allocator) {
+        if (nullptr == ptr) {
+            return allocator->Alloc(numBytes);
+        }
+        else if (allocator->Owns(ptr)) {
+            return allocator->ReAlloc(ptr, numBytes);
+        }
+    }
+    // allocated before the allocator backend was installed
+    return std::realloc(ptr, numBytes);
+}
+
+//------------------------------------------------------------------------------
+static void
+rawFree(void* ptr) {
+    if (allocator && allocator->Owns(ptr)) {
+        allocator->Free(ptr);
+    }
+    else {
+        std::free(ptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::SetAllocator(Allocator* a) {
+    o_assert(a);
+    o_assert2((nullptr == allocator) || (a == allocator), "Memory::SetAllocator(): can't replace installed allocator!\n");
+    allocator = a;
+}
+
+//------------------------------------------------------------------------------
+Allocator*
+Memory::GetAllocator() {
+    return allocator;
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::ReleaseThreadCache() {
+    if (allocator) {
+        allocator->ReleaseThreadCache();
+    }
+}
     
 //------------------------------------------------------------------------------
 void*
 Memory::Alloc(int numBytes) {
-    void* ptr = std::malloc(numBytes);
+    #if ORYOL_MEMORY_TRACKING
+    void* ptr = MemoryTracker::onAlloc(rawAlloc(numBytes + MemoryTracker::HeaderSize), numBytes, MemoryTracker::Category());
+    #else
+    void* ptr = rawAlloc(numBytes);
+    #endif
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
@@ -31,13 +94,27 @@ Memory::Fill(void* ptr, int numBytes, uint8_t value) {
 void*
 Memory::ReAlloc(void* ptr, int s) {
     /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+    #if ORYOL_MEMORY_TRACKING
+    // a re-allocation keeps the category of the original allocation
+    MemoryCategory::Code cat = MemoryTracker::Category();
+    void* base = ptr ? MemoryTracker::onFree(ptr, cat) : nullptr;
+    return MemoryTracker::onAlloc(rawReAlloc(base, s + MemoryTracker::HeaderSize), s, cat);
+    #else
+    return rawReAlloc(ptr, s);
+    #endif
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+    #if ORYOL_MEMORY_TRACKING
+    if (p) {
+        MemoryCategory::Code cat;
+        rawFree(MemoryTracker::onFree(p, cat));
+    }
+    #else
+    rawFree(p);
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -9,8 +9,14 @@
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
     
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+    By default this simply calls malloc()/free(), an optional allocator
+    backend can be installed with SetAllocator() (usually through
+    CoreSetup::MemoryAllocator at Core::Setup() time).
+
+    If ORYOL_MEMORY_TRACKING is enabled, all allocations are tracked by
+    category and thread (see MemoryTracker).
+
+    @see Allocator, SizeClassAllocator, MemoryTracker
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
@@ -18,9 +24,18 @@
 #include <utility>
 
 namespace Oryol {
+
+class Allocator;
     
 class Memory {
 public:
+    /// install an allocator backend (can only be done once)
+    static void SetAllocator(Allocator* allocator);
+    /// get the installed allocator backend (nullptr if none installed)
+    static Allocator* GetAllocator();
+    /// release the current thread's allocator cache (called from Core::LeaveThread)
+    static void ReleaseThreadCache();
+
     /// allocate a raw chunk of memory
     static void* Alloc(int numBytes);
     /// re-allocate a raw chunk of memory
@@ -66,4 +81,4 @@ Memory::RoundUp(int val, int roundTo) {
     return (val + (roundTo - 1)) & ~(roundTo - 1);
 }
     
-} // namespace oryol
\ No newline at end of file
+} // namespace oryol
\ No newline at end of file
@@ -0,0 +1,338 @@
+//------------------------------------------------------------------------------
+//  MemoryTracker.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MemoryTracker.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include <cstring>
+#if ORYOL_MEMORY_TRACKING
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#endif
+
+namespace Oryol {
+
+#if ORYOL_MEMORY_TRACKING
+namespace {
+    // the counters of one thread and category, the 'local' counters are
+    // only written by the owning thread (so they don't need atomic
+    // read-modify-write), memory freed by other threads is counted
+    // in the 'remote' counters
+    struct cell {
+        std::atomic<int64_t> allocBytes;
+        std::atomic<int64_t> numAllocs;
+        std::atomic<int64_t> freeBytes;
+        std::atomic<int64_t> numFrees;
+        std::atomic<int64_t> peakBytes;
+        std::atomic<int64_t> remoteFreeBytes;
+        std::atomic<int64_t> remoteNumFrees;
+    };
+    // the last row is shared by all threads which don't fit into the table,
+    // the other rows are owned by one thread at a time and are reused
+    // after MemoryTracker::ReleaseThreadCounters()
+    struct threadRow {
+        cell cells[MemoryCategory::NumCategories];
+        char name[MemorySnapshot::MaxThreadNameLength];
+        std::atomic<bool> inUse;
+    };
+    // the header in front of each tracked allocation
+    struct header {
+        int32_t size;
+        uint16_t category;
+        uint16_t row;
+    };
+    static_assert(sizeof(header) <= MemoryTracker::HeaderSize, "MemoryTracker: header too big");
+
+    threadRow rows[MemorySnapshot::MaxThreads];
+    std::atomic<int> numRows(0);
+    ORYOL_THREADLOCAL_PTR(threadRow) curRow = nullptr;
+    // the thread-local category is stored as pointer into this table,
+    // nullptr means MemoryCategory::General
+    const MemoryCategory::Code categories[MemoryCategory::NumCategories] = {
+        MemoryCategory::General,
+        MemoryCategory::Core,
+        MemoryCategory::StringAtom,
+        MemoryCategory::IO,
+        MemoryCategory::Resource,
+        MemoryCategory::Gfx,
+        MemoryCategory::App,
+    };
+    ORYOL_THREADLOCAL_PTR(const MemoryCategory::Code) curCategory = nullptr;
+}
+
+//------------------------------------------------------------------------------
+static bool
+isSharedRow(const threadRow* row) {
+    return row == &rows[MemorySnapshot::MaxThreads - 1];
+}
+
+//------------------------------------------------------------------------------
+static void
+add(std::atomic<int64_t>& counter, int64_t val, bool exclusive) {
+    if (exclusive) {
+        counter.store(counter.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+    }
+    else {
+        counter.fetch_add(val, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+static int64_t
+liveBytes(const cell& c) {
+    return c.allocBytes.load(std::memory_order_relaxed) -
+        c.freeBytes.load(std::memory_order_relaxed) -
+        c.remoteFreeBytes.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+static threadRow*
+threadRowPtr() {
+    threadRow* row = curRow;
+    if (nullptr == row) {
+        // take the first row which isn't owned by another thread, the
+        // acquire pairs with the release in ReleaseThreadCounters()
+        row = &rows[MemorySnapshot::MaxThreads - 1];
+        for (int i = 0; i < (MemorySnapshot::MaxThreads - 1); i++) {
+            bool expected = false;
+            if (rows[i].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                row = &rows[i];
+                break;
+            }
+        }
+        // numRows is the number of rows which have ever been used
+        const int num = int(row - rows) + 1;
+        int cur = numRows.load(std::memory_order_relaxed);
+        while ((cur < num) && !numRows.compare_exchange_weak(cur, num, std::memory_order_relaxed)) {
+            // retry
+        }
+        curRow = row;
+    }
+    return row;
+}
+#endif
+
+//------------------------------------------------------------------------------
+#define _TOSTRING(c) case c: return #c
+const char*
+MemoryCategory::ToString(Code c) {
+    switch (c) {
+        _TOSTRING(General);
+        _TOSTRING(Core);
+        _TOSTRING(StringAtom);
+        _TOSTRING(IO);
+        _TOSTRING(Resource);
+        _TOSTRING(Gfx);
+        _TOSTRING(App);
+        default: return "InvalidCategory";
+    }
+}
+
+//------------------------------------------------------------------------------
+MemoryCategory::Code
+MemoryTracker::SetCategory(MemoryCategory::Code cat) {
+    #if ORYOL_MEMORY_TRACKING
+    o_assert_range_dbg(cat, MemoryCategory::NumCategories);
+    const MemoryCategory::Code prev = Category();
+    curCategory = &categories[cat];
+    return prev;
+    #else
+    return MemoryCategory::General;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+MemoryCategory::Code
+MemoryTracker::Category() {
+    #if ORYOL_MEMORY_TRACKING
+    const MemoryCategory::Code* cat = curCategory;
+    return cat ? *cat : MemoryCategory::General;
+    #else
+    return MemoryCategory::General;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryTracker::SetThreadName(const char* name) {
+    o_assert_dbg(name);
+    #if ORYOL_MEMORY_TRACKING
+    threadRow* row = threadRowPtr();
+    if (!isSharedRow(row)) {
+        std::strncpy(row->name, name, sizeof(row->name) - 1);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryTracker::ReleaseThreadCounters() {
+    #if ORYOL_MEMORY_TRACKING
+    threadRow* row = curRow;
+    if (row) {
+        curRow = nullptr;
+        if (!isSharedRow(row)) {
+            // the counters stay in the row, memory which is still
+            // allocated is freed as 'remote' free by other threads
+            std::memset(row->name, 0, sizeof(row->name));
+            row->inUse.store(false, std::memory_order_release);
+        }
+    }
+    #endif
+}
+
+#if ORYOL_MEMORY_TRACKING
+//------------------------------------------------------------------------------
+void*
+MemoryTracker::onAlloc(void* base, int numBytes, MemoryCategory::Code cat) {
+    if (nullptr == base) {
+        return nullptr;
+    }
+    threadRow* row = threadRowPtr();
+    header* hdr = (header*) base;
+    hdr->size = numBytes;
+    hdr->category = uint16_t(cat);
+    hdr->row = uint16_t(row - rows);
+    cell& c = row->cells[cat];
+    const bool exclusive = !isSharedRow(row);
+    add(c.allocBytes, numBytes, exclusive);
+    add(c.numAllocs, 1, exclusive);
+    const int64_t live = liveBytes(c);
+    if (live > c.peakBytes.load(std::memory_order_relaxed)) {
+        c.peakBytes.store(live, std::memory_order_relaxed);
+    }
+    return ((uint8_t*)base) + HeaderSize;
+}
+
+//------------------------------------------------------------------------------
+void*
+MemoryTracker::onFree(void* ptr, MemoryCategory::Code& outCat) {
+    o_assert_dbg(ptr);
+    uint8_t* base = ((uint8_t*)ptr) - HeaderSize;
+    const header* hdr = (const header*) base;
+    o_assert_dbg((hdr->category < MemoryCategory::NumCategories) && (hdr->row < MemorySnapshot::MaxThreads));
+    threadRow* row = &rows[hdr->row];
+    cell& c = row->cells[hdr->category];
+    if ((row == curRow) && !isSharedRow(row)) {
+        add(c.freeBytes, hdr->size, true);
+        add(c.numFrees, 1, true);
+    }
+    else {
+        add(c.remoteFreeBytes, hdr->size, false);
+        add(c.remoteNumFrees, 1, false);
+    }
+    outCat = (MemoryCategory::Code) hdr->category;
+    return base;
+}
+#endif
+
+//------------------------------------------------------------------------------
+MemorySnapshot
+MemoryTracker::TakeSnapshot() {
+    MemorySnapshot snapshot;
+    #if ORYOL_MEMORY_TRACKING
+    snapshot.NumThreads = numRows.load(std::memory_order_relaxed);
+    for (int threadIndex = 0; threadIndex < snapshot.NumThreads; threadIndex++) {
+        const threadRow& row = rows[threadIndex];
+        if (isSharedRow(&row)) {
+            std::strcpy(snapshot.ThreadNames[threadIndex], "other");
+        }
+        else {
+            std::memcpy(snapshot.ThreadNames[threadIndex], row.name, sizeof(row.name));
+        }
+        for (int catIndex = 0; catIndex < MemoryCategory::NumCategories; catIndex++) {
+            const cell& c = row.cells[catIndex];
+            MemorySnapshot::Counters& dst = snapshot.Threads[threadIndex][catIndex];
+            dst.LiveBytes = liveBytes(c);
+            dst.PeakBytes = c.peakBytes.load(std::memory_order_relaxed);
+            dst.NumAllocs = c.numAllocs.load(std::memory_order_relaxed);
+            dst.NumLiveAllocs = dst.NumAllocs -
+                c.numFrees.load(std::memory_order_relaxed) -
+                c.remoteNumFrees.load(std::memory_order_relaxed);
+            MemorySnapshot::Counters& sum = snapshot.Categories[catIndex];
+            sum.LiveBytes += dst.LiveBytes;
+            sum.PeakBytes += dst.PeakBytes;
+            sum.NumLiveAllocs += dst.NumLiveAllocs;
+            sum.NumAllocs += dst.NumAllocs;
+        }
+    }
+    #endif
+    return snapshot;
+}
+
+//------------------------------------------------------------------------------
+MemorySnapshot::Counters
+MemorySnapshot::Total() const {
+    Counters total;
+    for (const Counters& c : this->Categories) {
+        total.LiveBytes += c.LiveBytes;
+        total.PeakBytes += c.PeakBytes;
+        total.NumLiveAllocs += c.NumLiveAllocs;
+        total.NumAllocs += c.NumAllocs;
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------
+static MemorySnapshot::Counters
+diffCounters(const MemorySnapshot::Counters& newer, const MemorySnapshot::Counters& older) {
+    MemorySnapshot::Counters c;
+    c.LiveBytes = newer.LiveBytes - older.LiveBytes;
+    c.PeakBytes = newer.PeakBytes;
+    c.NumLiveAllocs = newer.NumLiveAllocs - older.NumLiveAllocs;
+    c.NumAllocs = newer.NumAllocs - older.NumAllocs;
+    return c;
+}
+
+//------------------------------------------------------------------------------
+MemorySnapshot
+MemorySnapshot::Diff(const MemorySnapshot& older) const {
+    MemorySnapshot diff;
+    diff.NumThreads = this->NumThreads;
+    std::memcpy(diff.ThreadNames, this->ThreadNames, sizeof(this->ThreadNames));
+    for (int catIndex = 0; catIndex < MemoryCategory::NumCategories; catIndex++) {
+        diff.Categories[catIndex] = diffCounters(this->Categories[catIndex], older.Categories[catIndex]);
+        for (int threadIndex = 0; threadIndex < this->NumThreads; threadIndex++) {
+            diff.Threads[threadIndex][catIndex] = diffCounters(this->Threads[threadIndex][catIndex], older.Threads[threadIndex][catIndex]);
+        }
+    }
+    return diff;
+}
+
+//------------------------------------------------------------------------------
+static void
+dumpCounters(const char* indent, const char* name, const MemorySnapshot::Counters& c) {
+    Log::Info("%s%-12s %12lld %12lld %10lld %10lld\n",
+        indent, name,
+        (long long) c.LiveBytes,
+        (long long) c.PeakBytes,
+        (long long) c.NumLiveAllocs,
+        (long long) c.NumAllocs);
+}
+
+//------------------------------------------------------------------------------
+void
+MemorySnapshot::Dump() const {
+    Log::Info("  %-12s %12s %12s %10s %10s\n", "category", "live bytes", "peak bytes", "live", "allocs");
+    for (int catIndex = 0; catIndex < MemoryCategory::NumCategories; catIndex++) {
+        dumpCounters("  ", MemoryCategory::ToString((MemoryCategory::Code)catIndex), this->Categories[catIndex]);
+    }
+    dumpCounters("  ", "Total", this->Total());
+    for (int threadIndex = 0; threadIndex < this->NumThreads; threadIndex++) {
+        if (this->ThreadNames[threadIndex][0]) {
+            Log::Info("  thread %d (%s):\n", threadIndex, this->ThreadNames[threadIndex]);
+        }
+        else {
+            Log::Info("  thread %d:\n", threadIndex);
+        }
+        for (int catIndex = 0; catIndex < MemoryCategory::NumCategories; catIndex++) {
+            const Counters& c = this->Threads[threadIndex][catIndex];
+            if (c.NumAllocs != 0 || c.NumLiveAllocs != 0) {
+                dumpCounters("    ", MemoryCategory::ToString((MemoryCategory::Code)catIndex), c);
+            }
+        }
+    }
+}
+
+} // namespace Oryol
@@ -0,0 +1,173 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryTracker
+    @ingroup Core
+    @brief track Memory::Alloc() allocations by category and thread
+
+    Memory tracking is enabled at compile time with the cmake option
+    ORYOL_MEMORY_TRACKING (which defines ORYOL_MEMORY_TRACKING=1). When
+    enabled, every allocation through Memory::Alloc() gets a small header
+    which records the size, the memory category and the allocating
+    thread, and the live bytes, peak bytes and allocation counts are
+    updated with relaxed atomics in a per-thread counter table. When
+    disabled, Memory::Alloc() is unchanged, the o_memory_scope() macro
+    compiles to nothing, and TakeSnapshot() returns an empty snapshot.
+
+    The memory category of an allocation is taken from the current
+    thread's category, which is set with the o_memory_scope() macro:
+
+    ```cpp
+    {
+        o_memory_scope(IO);
+        Buffer buf;
+        buf.Reserve(1024);  // tracked in the IO category
+    }
+    ```
+
+    Memory is always charged to the thread and category which allocated
+    it, even if it is freed on a different thread. There are counters
+    for MaxThreads threads, threads which don't fit into the table
+    share the last counters (shown as 'other'). Threads should call
+    ReleaseThreadCounters() before they exit (Core::LeaveThread() does
+    this), so that their counters can be reused by later threads.
+    Reused counters keep the numbers of their previous threads. Snapshots can be taken
+    at any time, and two snapshots can be diffed to find out where memory
+    has been allocated in between.
+
+    NOTE: the peak bytes of a category are the sum of the per-thread
+    peaks, and thus an upper bound of the real category peak.
+
+    @see Memory, MemorySnapshot
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryCategory
+    @ingroup Core
+    @brief memory categories for the MemoryTracker
+*/
+class MemoryCategory {
+public:
+    /// category enum
+    enum Code {
+        General = 0,    ///< untagged allocations (mostly containers)
+        Core,           ///< Core module internals
+        StringAtom,     ///< StringAtom tables
+        IO,             ///< IO requests and data buffers
+        Resource,       ///< resource loaders and registries
+        Gfx,            ///< Gfx resources and staging data
+        App,            ///< application allocations
+
+        NumCategories,
+        InvalidCategory,
+    };
+    /// convert category to string
+    static const char* ToString(Code c);
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemorySnapshot
+    @ingroup Core
+    @brief a copy of the MemoryTracker counters
+*/
+class MemorySnapshot {
+public:
+    /// max number of separately tracked running threads
+    static const int MaxThreads = 16;
+    /// max length of a thread name (including terminating 0)
+    static const int MaxThreadNameLength = 16;
+
+    /// allocation counters
+    struct Counters {
+        int64_t LiveBytes = 0;
+        int64_t PeakBytes = 0;
+        int64_t NumLiveAllocs = 0;
+        int64_t NumAllocs = 0;
+    };
+    /// counters per category (summed over all threads)
+    Counters Categories[MemoryCategory::NumCategories];
+    /// counters per thread and category
+    Counters Threads[MaxThreads][MemoryCategory::NumCategories];
+    /// thread names (set with MemoryTracker::SetThreadName())
+    char ThreadNames[MaxThreads][MaxThreadNameLength] = { };
+    /// number of valid threads
+    int NumThreads = 0;
+
+    /// get counters summed over all categories
+    Counters Total() const;
+    /// difference to an older snapshot (peak bytes are taken from this snapshot)
+    MemorySnapshot Diff(const MemorySnapshot& older) const;
+    /// dump snapshot to the log
+    void Dump() const;
+};
+
+//------------------------------------------------------------------------------
+class MemoryTracker {
+public:
+    /// size of the header in front of tracked allocations
+    static const int HeaderSize = ORYOL_MAX_PLATFORM_ALIGN > 8 ? ORYOL_MAX_PLATFORM_ALIGN : 8;
+
+    /// return true if memory tracking is compiled in
+    static bool IsEnabled();
+    /// set the current thread's memory category, returns previous category
+    static MemoryCategory::Code SetCategory(MemoryCategory::Code cat);
+    /// get the current thread's memory category
+    static MemoryCategory::Code Category();
+    /// set a name for the current thread (shown in snapshot dumps)
+    static void SetThreadName(const char* name);
+    /// release the current thread's counters for reuse, call before a thread exits
+    static void ReleaseThreadCounters();
+    /// take a snapshot of the counters
+    static MemorySnapshot TakeSnapshot();
+
+private:
+    friend class Memory;
+    /// track a new allocation, base points to numBytes + HeaderSize bytes, returns user pointer
+    static void* onAlloc(void* base, int numBytes, MemoryCategory::Code cat);
+    /// untrack an allocation, returns base pointer and category
+    static void* onFree(void* ptr, MemoryCategory::Code& outCat);
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryScope
+    @ingroup Core
+    @brief set the memory category of the current thread for a scope
+
+    Use the o_memory_scope() macro instead of using this class directly.
+*/
+class MemoryScope {
+public:
+    /// constructor, sets new category
+    MemoryScope(MemoryCategory::Code cat) : prev(MemoryTracker::SetCategory(cat)) { };
+    /// destructor, restores previous category
+    ~MemoryScope() {
+        MemoryTracker::SetCategory(this->prev);
+    };
+private:
+    MemoryCategory::Code prev;
+};
+
+#if ORYOL_MEMORY_TRACKING
+#define o_memory_scope(cat) Oryol::MemoryScope _o_memory_scope(Oryol::MemoryCategory::cat)
+#else
+#define o_memory_scope(cat) ((void)0)
+#endif
+
+//------------------------------------------------------------------------------
+inline bool
+MemoryTracker::IsEnabled() {
+    #if ORYOL_MEMORY_TRACKING
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+} // namespace Oryol
@@ -0,0 +1,320 @@
+//------------------------------------------------------------------------------
+//  SizeClassAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "SizeClassAllocator.h"
+#include "Core/Assertion.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#define SCOPED_LOCK(m) std::lock_guard<std::mutex> lock(m)
+#else
+#define SCOPED_LOCK(m)
+#endif
+
+namespace Oryol {
+
+namespace {
+
+const int classSizes[SizeClassAllocator::NumSizeClasses] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024
+};
+
+// a free block, the next-pointer lives in the block memory itself
+struct block {
+    block* next;
+};
+
+// per-thread cache, one free-list per size class
+struct threadCache {
+    struct bin {
+        block* head;
+        int num;
+    } bins[SizeClassAllocator::NumSizeClasses];
+};
+ORYOL_THREADLOCAL_PTR(threadCache) threadCachePtr = nullptr;
+std::atomic<int> numThreadCaches(0);
+
+// central free-list and current span of a size class
+struct centralList {
+    #if ORYOL_HAS_THREADS
+    std::mutex lock;
+    #endif
+    block* head = nullptr;
+    uint8_t* spanCur = nullptr;
+    uint8_t* spanEnd = nullptr;
+};
+centralList central[SizeClassAllocator::NumSizeClasses];
+
+// spans are carved from regions allocated with std::malloc()
+const int spansPerRegion = 16;
+#if ORYOL_HAS_THREADS
+std::mutex regionLock;
+#endif
+uint8_t* regionCur = nullptr;
+uint8_t* regionEnd = nullptr;
+
+// the page-map maps span addresses to (size class + 1), 0 means 'not owned',
+// the top level is indexed by the upper 32 address bits (48-bit address
+// space on 64-bit platforms), the leafs by the span index in the lower 32 bits,
+// leafs are published with release/acquire, the leaf entries are relaxed
+// atomics since Owns() may look up pointers while another thread adds a span
+const int spanShift = 16;
+const int pageMapTopSize = sizeof(void*) == 8 ? (1<<16) : 1;
+const int pageMapLeafSize = 1<<16;
+typedef std::atomic<uint8_t> pageMapEntry;
+static_assert(sizeof(pageMapEntry) == 1, "SizeClassAllocator: page-map leafs are allocated with calloc()");
+std::atomic<pageMapEntry*> pageMap[pageMapTopSize];
+
+// storage for the allocator instance, this is never destroyed since
+// memory may be freed during static destruction
+alignas(SizeClassAllocator) uint8_t instanceStorage[sizeof(SizeClassAllocator)];
+
+//------------------------------------------------------------------------------
+inline int
+lookupSizeClass(const void* ptr) {
+    const uint64_t addr = (uint64_t)(uintptr_t)ptr;
+    const uint64_t top = addr >> 32;
+    if (top >= uint64_t(pageMapTopSize)) {
+        return -1;
+    }
+    const pageMapEntry* leaf = pageMap[top].load(std::memory_order_acquire);
+    if (nullptr == leaf) {
+        return -1;
+    }
+    return int(leaf[(addr >> spanShift) & (pageMapLeafSize - 1)].load(std::memory_order_relaxed)) - 1;
+}
+
+//------------------------------------------------------------------------------
+inline int
+batchSize(int sizeClass) {
+    // number of blocks moved between thread-cache and central free-list
+    int num = 8192 / classSizes[sizeClass];
+    if (num < 8) {
+        num = 8;
+    }
+    else if (num > 64) {
+        num = 64;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+inline threadCache*
+getThreadCache() {
+    threadCache* cache = threadCachePtr;
+    if (nullptr == cache) {
+        cache = (threadCache*) std::calloc(1, sizeof(threadCache));
+        o_assert(cache);
+        threadCachePtr = cache;
+        numThreadCaches.fetch_add(1, std::memory_order_relaxed);
+    }
+    return cache;
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+allocSpan(int sizeClass) {
+    SCOPED_LOCK(regionLock);
+    if (regionCur == regionEnd) {
+        // allocate one span more than needed so the spans can be aligned
+        uint8_t* mem = (uint8_t*) std::malloc(SizeClassAllocator::SpanSize * (spansPerRegion + 1));
+        o_assert(mem);
+        const uintptr_t mask = uintptr_t(SizeClassAllocator::SpanSize - 1);
+        regionCur = (uint8_t*) ((uintptr_t(mem) + mask) & ~mask);
+        regionEnd = regionCur + SizeClassAllocator::SpanSize * spansPerRegion;
+    }
+    uint8_t* span = regionCur;
+    regionCur += SizeClassAllocator::SpanSize;
+
+    // register the span in the page-map
+    const uint64_t addr = (uint64_t)(uintptr_t)span;
+    const uint64_t top = addr >> 32;
+    o_assert(top < uint64_t(pageMapTopSize));
+    pageMapEntry* leaf = pageMap[top].load(std::memory_order_relaxed);
+    if (nullptr == leaf) {
+        leaf = (pageMapEntry*) std::calloc(pageMapLeafSize, sizeof(pageMapEntry));
+        o_assert(leaf);
+        pageMap[top].store(leaf, std::memory_order_release);
+    }
+    leaf[(addr >> spanShift) & (pageMapLeafSize - 1)].store(uint8_t(sizeClass + 1), std::memory_order_relaxed);
+    return span;
+}
+
+//------------------------------------------------------------------------------
+void
+fillBin(int sizeClass, threadCache::bin& bin) {
+    centralList& list = central[sizeClass];
+    const int size = classSizes[sizeClass];
+    const int num = batchSize(sizeClass);
+    SCOPED_LOCK(list.lock);
+    for (int i = 0; i < num; i++) {
+        block* b = list.head;
+        if (b) {
+            list.head = b->next;
+        }
+        else {
+            if ((list.spanCur + size) > list.spanEnd) {
+                list.spanCur = allocSpan(sizeClass);
+                list.spanEnd = list.spanCur + SizeClassAllocator::SpanSize;
+            }
+            b = (block*) list.spanCur;
+            list.spanCur += size;
+        }
+        b->next = bin.head;
+        bin.head = b;
+        bin.num++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+releaseBlocks(int sizeClass, threadCache::bin& bin, int num) {
+    o_assert_dbg((num > 0) && (num <= bin.num));
+    block* first = bin.head;
+    block* last = first;
+    for (int i = 1; i < num; i++) {
+        last = last->next;
+    }
+    bin.head = last->next;
+    bin.num -= num;
+
+    centralList& list = central[sizeClass];
+    SCOPED_LOCK(list.lock);
+    last->next = list.head;
+    list.head = first;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+SizeClassAllocator::SizeClassAllocator() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+SizeClassAllocator*
+SizeClassAllocator::Instance() {
+    static SizeClassAllocator* instance = new(instanceStorage) SizeClassAllocator();
+    return instance;
+}
+
+//------------------------------------------------------------------------------
+int
+SizeClassAllocator::ClassSize(int sizeClass) {
+    o_assert_range_dbg(sizeClass, NumSizeClasses);
+    return classSizes[sizeClass];
+}
+
+//------------------------------------------------------------------------------
+int
+SizeClassAllocator::SizeClass(int numBytes) {
+    o_assert_dbg((numBytes >= 0) && (numBytes <= MaxSize));
+    if (numBytes <= 128) {
+        // 16-byte steps
+        return numBytes > 0 ? ((numBytes + 15) >> 4) - 1 : 0;
+    }
+    else {
+        // 4 steps per power-of-two
+        int shift = 7;
+        while ((2 << shift) < numBytes) {
+            shift++;
+        }
+        const int step = 1 << (shift - 2);
+        return 8 + (shift - 7) * 4 + ((numBytes - 1 - (1 << shift)) / step);
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+SizeClassAllocator::Alloc(int numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    if (numBytes > MaxSize) {
+        return std::malloc(numBytes);
+    }
+    const int sizeClass = SizeClass(numBytes);
+    threadCache::bin& bin = getThreadCache()->bins[sizeClass];
+    if (nullptr == bin.head) {
+        fillBin(sizeClass, bin);
+    }
+    block* b = bin.head;
+    bin.head = b->next;
+    bin.num--;
+    return b;
+}
+
+//------------------------------------------------------------------------------
+void
+SizeClassAllocator::Free(void* ptr) {
+    const int sizeClass = lookupSizeClass(ptr);
+    o_assert_dbg(sizeClass >= 0);
+    threadCache::bin& bin = getThreadCache()->bins[sizeClass];
+    block* b = (block*) ptr;
+    b->next = bin.head;
+    bin.head = b;
+    bin.num++;
+    const int num = batchSize(sizeClass);
+    if (bin.num > (2 * num)) {
+        releaseBlocks(sizeClass, bin, num);
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+SizeClassAllocator::ReAlloc(void* ptr, int numBytes) {
+    const int curSize = this->BlockSize(ptr);
+    if (numBytes <= curSize) {
+        return ptr;
+    }
+    void* newPtr = this->Alloc(numBytes);
+    std::memcpy(newPtr, ptr, curSize);
+    this->Free(ptr);
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+bool
+SizeClassAllocator::Owns(const void* ptr) const {
+    return lookupSizeClass(ptr) >= 0;
+}
+
+//------------------------------------------------------------------------------
+int
+SizeClassAllocator::BlockSize(const void* ptr) const {
+    const int sizeClass = lookupSizeClass(ptr);
+    o_assert_dbg(sizeClass >= 0);
+    return classSizes[sizeClass];
+}
+
+//------------------------------------------------------------------------------
+int
+SizeClassAllocator::NumThreadCaches() {
+    return numThreadCaches.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+SizeClassAllocator::ReleaseThreadCache() {
+    threadCache* cache = threadCachePtr;
+    if (cache) {
+        for (int sizeClass = 0; sizeClass < NumSizeClasses; sizeClass++) {
+            threadCache::bin& bin = cache->bins[sizeClass];
+            if (bin.num > 0) {
+                releaseBlocks(sizeClass, bin, bin.num);
+            }
+        }
+        std::free(cache);
+        threadCachePtr = nullptr;
+        numThreadCaches.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Oryol
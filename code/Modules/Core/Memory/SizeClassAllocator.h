@@ -0,0 +1,76 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SizeClassAllocator
+    @ingroup Core
+    @brief built-in size-class allocator with thread-local caches
+
+    Small allocations (up to MaxSize bytes) are rounded up to one of
+    NumSizeClasses size classes and served from a per-thread cache
+    without any locking. When a thread cache runs empty (or grows too big),
+    a batch of blocks is moved from (or to) a central free-list which is
+    protected by a per-size-class lock. Blocks are carved from 64 KByte
+    spans, each span only holds blocks of a single size class, and a
+    page-map from span addresses to size classes is used to find the size
+    class of a pointer and to implement Owns().
+
+    Allocations bigger than MaxSize are forwarded to std::malloc(). Memory
+    taken from the system is never given back, blocks are only recycled
+    through the free-lists.
+
+    Install the allocator at Core::Setup() time like this:
+
+    ```cpp
+    CoreSetup coreSetup;
+    coreSetup.MemoryAllocator = SizeClassAllocator::Instance();
+    Core::Setup(coreSetup);
+    ```
+
+    Threads which have been started with Core::EnterThread() hand their
+    cached blocks back in Core::LeaveThread(), engine threads which don't
+    call Core::EnterThread() (like the IO worker threads) call
+    Memory::ReleaseThreadCache() before they exit. The cache of any other
+    thread (and the blocks in it) is lost when the thread exits.
+*/
+#include "Core/Memory/Allocator.h"
+
+namespace Oryol {
+
+class SizeClassAllocator : public Allocator {
+public:
+    /// get the global size-class allocator
+    static SizeClassAllocator* Instance();
+
+    /// max allocation size handled by the size classes
+    static const int MaxSize = 1024;
+    /// number of size classes
+    static const int NumSizeClasses = 20;
+    /// size of a span in bytes (spans are aligned to their size)
+    static const int SpanSize = (1<<16);
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr) override;
+    /// return true if ptr has been allocated from a size class
+    virtual bool Owns(const void* ptr) const override;
+    /// give the current thread's cached blocks back to the central free-lists
+    virtual void ReleaseThreadCache() override;
+
+    /// get the usable size of an owned memory block
+    int BlockSize(const void* ptr) const;
+    /// get number of thread caches which haven't been released
+    static int NumThreadCaches();
+    /// get the block size of a size class
+    static int ClassSize(int sizeClass);
+    /// get the size class for an allocation size (must be <= MaxSize)
+    static int SizeClass(int numBytes);
+
+private:
+    /// constructor is private, use Instance()
+    SizeClassAllocator();
+};
+
+} // namespace Oryol
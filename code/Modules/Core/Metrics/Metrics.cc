@@ -0,0 +1,433 @@
+//------------------------------------------------------------------------------
+//  Metrics.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Metrics.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Logger.h"
+#include "Core/Ptr.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstring>
+
+#if ORYOL_HAS_THREADS
+#include <mutex>
+static std::mutex lockMutex;
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+
+namespace {
+
+// histogram slot layout: sample count, sample sum, buckets
+const int HistogramCountSlot = 0;
+const int HistogramSumSlot = 1;
+const int HistogramBucketSlot = 2;
+const int HistogramNumSlots = HistogramBucketSlot + MetricsSnapshot::NumBuckets;
+
+// a registered metric (protected by lockMutex)
+struct metricInfo {
+    char name[Metrics::MaxNameLength];
+    MetricType::Code type;
+    int slot;
+};
+
+// per-thread value slots, only written by the owner thread, read by
+// NextFrame() and Snapshot() with relaxed loads; slot blocks are never
+// freed, since their values are part of the totals, blocks of threads
+// which have called ReleaseThreadSlots() are reused by new threads
+struct threadSlots {
+    std::atomic<int64_t> values[Metrics::MaxSlots];
+    threadSlots* next;          // next in allSlots list
+    threadSlots* nextFree;      // next in freeSlots list
+};
+
+metricInfo metrics[Metrics::MaxMetrics];
+int numMetrics = 0;
+int numSlots = 0;
+int numGauges = 0;
+std::atomic<int64_t> gauges[Metrics::MaxMetrics];
+
+threadSlots* allSlots = nullptr;        // protected by lockMutex
+threadSlots* freeSlots = nullptr;       // protected by lockMutex
+ORYOL_THREADLOCAL_PTR(threadSlots) curThreadSlots = nullptr;
+
+// frame rollover state (protected by lockMutex)
+int64_t frameIndex = 0;
+int64_t frameBase[Metrics::MaxSlots] = { };
+int64_t lastFrame[Metrics::MaxSlots] = { };
+int64_t lastFrameGauges[Metrics::MaxMetrics] = { };
+int dumpInterval = 0;
+Ptr<Logger> dumpLogger;
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+static threadSlots*
+createThreadSlots() {
+    SCOPED_LOCK;
+    threadSlots* slots = freeSlots;
+    if (slots) {
+        freeSlots = slots->nextFree;
+    }
+    else {
+        slots = (threadSlots*) Memory::Alloc(int(sizeof(threadSlots)));
+        for (int i = 0; i < Metrics::MaxSlots; i++) {
+            new(&slots->values[i]) std::atomic<int64_t>(0);
+        }
+        slots->next = allSlots;
+        slots->nextFree = nullptr;
+        allSlots = slots;
+    }
+    curThreadSlots = slots;
+    return slots;
+}
+
+//------------------------------------------------------------------------------
+static inline void
+addToSlot(int slot, int64_t val) {
+    threadSlots* slots = curThreadSlots;
+    if (nullptr == slots) {
+        slots = createThreadSlots();
+    }
+    // only the owner thread writes, no need for an atomic add
+    std::atomic<int64_t>& v = slots->values[slot];
+    v.store(v.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+static int64_t
+slotTotal(int slot) {
+    // must be called with the lock held
+    int64_t total = 0;
+    for (const threadSlots* slots = allSlots; slots; slots = slots->next) {
+        total += slots->values[slot].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------
+static int
+findMetric(const char* name) {
+    // must be called with the lock held
+    for (int i = 0; i < numMetrics; i++) {
+        if (0 == std::strcmp(metrics[i].name, name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+static Metric
+makeHandle(int index) {
+    Metric m;
+    m.Index = int16_t(index);
+    m.Slot = int16_t(metrics[index].slot);
+    m.Type = metrics[index].type;
+    return m;
+}
+
+//------------------------------------------------------------------------------
+static Metric
+registerMetric(const char* name, MetricType::Code type) {
+    o_assert_dbg(name);
+    o_assert(std::strlen(name) < size_t(Metrics::MaxNameLength));
+    SCOPED_LOCK;
+    int index = findMetric(name);
+    if (index >= 0) {
+        o_assert2(metrics[index].type == type, "Metric registered with different type!\n");
+        return makeHandle(index);
+    }
+    o_assert2(numMetrics < Metrics::MaxMetrics, "Too many metrics!\n");
+    index = numMetrics;
+    metricInfo& info = metrics[index];
+    std::strncpy(info.name, name, sizeof(info.name));
+    info.type = type;
+    if (MetricType::Gauge == type) {
+        info.slot = numGauges++;
+        gauges[info.slot].store(0, std::memory_order_relaxed);
+        lastFrameGauges[info.slot] = 0;
+    }
+    else {
+        const int num = (MetricType::Histogram == type) ? HistogramNumSlots : 1;
+        o_assert2((numSlots + num) <= Metrics::MaxSlots, "Too many metric slots!\n");
+        info.slot = numSlots;
+        numSlots += num;
+    }
+    numMetrics++;
+    return makeHandle(index);
+}
+
+//------------------------------------------------------------------------------
+Metric
+Metrics::Counter(const char* name) {
+    return registerMetric(name, MetricType::Counter);
+}
+
+//------------------------------------------------------------------------------
+Metric
+Metrics::Gauge(const char* name) {
+    return registerMetric(name, MetricType::Gauge);
+}
+
+//------------------------------------------------------------------------------
+Metric
+Metrics::Histogram(const char* name) {
+    return registerMetric(name, MetricType::Histogram);
+}
+
+//------------------------------------------------------------------------------
+Metric
+Metrics::Lookup(const char* name) {
+    o_assert_dbg(name);
+    SCOPED_LOCK;
+    const int index = findMetric(name);
+    return index >= 0 ? makeHandle(index) : Metric();
+}
+
+//------------------------------------------------------------------------------
+int
+Metrics::NumMetrics() {
+    SCOPED_LOCK;
+    return numMetrics;
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Add(const Metric& m, int64_t val) {
+    o_assert_dbg(m.IsValid());
+    if (MetricType::Gauge == m.Type) {
+        gauges[m.Slot].fetch_add(val, std::memory_order_relaxed);
+    }
+    else {
+        o_assert_dbg(MetricType::Counter == m.Type);
+        addToSlot(m.Slot, val);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Set(const Metric& m, int64_t val) {
+    o_assert_dbg(m.IsValid() && (MetricType::Gauge == m.Type));
+    gauges[m.Slot].store(val, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Record(const Metric& m, int64_t val) {
+    o_assert_dbg(m.IsValid() && (MetricType::Histogram == m.Type));
+    addToSlot(m.Slot + HistogramCountSlot, 1);
+    addToSlot(m.Slot + HistogramSumSlot, val);
+    addToSlot(m.Slot + HistogramBucketSlot + MetricsSnapshot::BucketIndex(val), 1);
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Record(const Metric& m, Duration d) {
+    Record(m, int64_t(d.AsMicroSeconds()));
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::ReleaseThreadSlots() {
+    threadSlots* slots = curThreadSlots;
+    if (slots) {
+        // the values stay part of the totals, the next thread which
+        // takes over the block continues to accumulate into it
+        SCOPED_LOCK;
+        slots->nextFree = freeSlots;
+        freeSlots = slots;
+        curThreadSlots = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+Metrics::NumThreadSlots() {
+    SCOPED_LOCK;
+    int num = 0;
+    for (const threadSlots* slots = allSlots; slots; slots = slots->next) {
+        num++;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::NextFrame() {
+    bool dump = false;
+    Ptr<Logger> logger;
+    {
+        SCOPED_LOCK;
+        for (int slot = 0; slot < numSlots; slot++) {
+            const int64_t total = slotTotal(slot);
+            lastFrame[slot] = total - frameBase[slot];
+            frameBase[slot] = total;
+        }
+        for (int i = 0; i < numGauges; i++) {
+            lastFrameGauges[i] = gauges[i].load(std::memory_order_relaxed);
+        }
+        frameIndex++;
+        if ((dumpInterval > 0) && (0 == (frameIndex % dumpInterval))) {
+            dump = true;
+            logger = dumpLogger;
+        }
+    }
+    if (dump) {
+        Dump(logger);
+    }
+}
+
+//------------------------------------------------------------------------------
+MetricsSnapshot
+Metrics::Snapshot() {
+    MetricsSnapshot snapshot;
+    SCOPED_LOCK;
+    snapshot.FrameIndex = frameIndex;
+    snapshot.Values.Reserve(numMetrics);
+    for (int i = 0; i < numMetrics; i++) {
+        const metricInfo& info = metrics[i];
+        MetricsSnapshot::Value& val = snapshot.Values.Add();
+        val.Name = info.name;
+        val.Type = info.type;
+        val.Buckets.Fill(0);
+        val.LastFrameBuckets.Fill(0);
+        switch (info.type) {
+            case MetricType::Counter:
+                val.Total = slotTotal(info.slot);
+                val.LastFrame = lastFrame[info.slot];
+                break;
+            case MetricType::Gauge:
+                val.Total = gauges[info.slot].load(std::memory_order_relaxed);
+                val.LastFrame = lastFrameGauges[info.slot];
+                break;
+            case MetricType::Histogram:
+                val.Total = slotTotal(info.slot + HistogramCountSlot);
+                val.LastFrame = lastFrame[info.slot + HistogramCountSlot];
+                val.Sum = slotTotal(info.slot + HistogramSumSlot);
+                val.LastFrameSum = lastFrame[info.slot + HistogramSumSlot];
+                for (int b = 0; b < MetricsSnapshot::NumBuckets; b++) {
+                    val.Buckets[b] = slotTotal(info.slot + HistogramBucketSlot + b);
+                    val.LastFrameBuckets[b] = lastFrame[info.slot + HistogramBucketSlot + b];
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return snapshot;
+}
+
+//------------------------------------------------------------------------------
+static void
+dumpLine(const Ptr<Logger>& logger, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    if (logger) {
+        logger->VPrint(Log::Level::Info, msg, args);
+    }
+    else {
+        Log::VInfo(msg, args);
+    }
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Dump(const Ptr<Logger>& logger) {
+    const MetricsSnapshot snapshot = Snapshot();
+    dumpLine(logger, "Metrics (frame %lld):\n", (long long) snapshot.FrameIndex);
+    for (const MetricsSnapshot::Value& val : snapshot.Values) {
+        switch (val.Type) {
+            case MetricType::Counter:
+                dumpLine(logger, "  %-32s total=%lld frame=%lld\n",
+                    val.Name, (long long) val.Total, (long long) val.LastFrame);
+                break;
+            case MetricType::Gauge:
+                dumpLine(logger, "  %-32s value=%lld\n", val.Name, (long long) val.Total);
+                break;
+            case MetricType::Histogram:
+                dumpLine(logger, "  %-32s n=%lld frame=%lld mean=%.1f p50<%lld p90<%lld p99<%lld\n",
+                    val.Name, (long long) val.Total, (long long) val.LastFrame, val.Mean(),
+                    (long long) val.Percentile(0.5),
+                    (long long) val.Percentile(0.9),
+                    (long long) val.Percentile(0.99));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::SetDumpInterval(int numFrames, const Ptr<Logger>& logger) {
+    o_assert_dbg(numFrames >= 0);
+    SCOPED_LOCK;
+    dumpInterval = numFrames;
+    dumpLogger = logger;
+}
+
+//------------------------------------------------------------------------------
+int
+MetricsSnapshot::BucketIndex(int64_t val) {
+    // bucket 0: val < 1, bucket i: 2^(i-1) <= val < 2^i,
+    // the last bucket also collects all bigger values
+    int index = 0;
+    while ((val > 0) && (index < (NumBuckets - 1))) {
+        val >>= 1;
+        index++;
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+MetricsSnapshot::BucketUpperBound(int bucketIndex) {
+    o_assert_range_dbg(bucketIndex, NumBuckets);
+    return int64_t(1) << bucketIndex;
+}
+
+//------------------------------------------------------------------------------
+double
+MetricsSnapshot::Value::Mean() const {
+    return this->Total > 0 ? double(this->Sum) / double(this->Total) : 0.0;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+MetricsSnapshot::Value::Percentile(double p) const {
+    if (this->Total <= 0) {
+        return 0;
+    }
+    const double target = p * double(this->Total);
+    int64_t num = 0;
+    for (int b = 0; b < NumBuckets; b++) {
+        num += this->Buckets[b];
+        if (double(num) >= target) {
+            return BucketUpperBound(b);
+        }
+    }
+    return BucketUpperBound(NumBuckets - 1);
+}
+
+//------------------------------------------------------------------------------
+const MetricsSnapshot::Value*
+MetricsSnapshot::Find(const char* name) const {
+    o_assert_dbg(name);
+    for (const Value& val : this->Values) {
+        if (0 == std::strcmp(val.Name, name)) {
+            return &val;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Oryol
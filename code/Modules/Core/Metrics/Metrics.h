@@ -0,0 +1,195 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Metrics
+    @ingroup Core
+    @brief a registry of named counters, gauges and latency histograms
+
+    Metrics are registered by name and return a small Metric handle,
+    registering the same name twice returns the same handle, so
+    callers usually register once and keep the handle around (e.g.
+    in a function-local static or in the module state):
+
+    @code
+    static const Metric bytesRead = Metrics::Counter("io.bytesRead");
+    Metrics::Add(bytesRead, numBytes);
+    @endcode
+
+    There are 3 metric types:
+
+    * **Counter**: a monotonically growing sum (Add())
+    * **Gauge**: a current value which can go up and down (Set(), Add())
+    * **Histogram**: a distribution of sample values in fixed power-of-2
+      buckets (Record()), mostly used for latencies in microseconds
+
+    Counters and histograms are accumulated in per-thread slot blocks
+    which are only written by their owner thread, so that updating a
+    metric doesn't need locks or atomic read-modify-write operations.
+    Gauges are a single global atomic value.
+
+    Metrics::NextFrame() rolls the metrics over into a new frame, after
+    that, the snapshot contains the values accumulated during the
+    last frame next to the running totals. Core::Setup() registers
+    NextFrame() with the main thread's PostRunLoop. Snapshot() returns
+    the current values of all metrics, Dump() prints them to a Logger
+    (or to the Log), and SetDumpInterval() enables a periodic dump
+    every N frames.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/Time/Duration.h"
+
+namespace Oryol {
+
+class Logger;
+template<class TYPE> class Ptr;
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MetricType
+    @ingroup Core
+    @brief the type of a Metric
+*/
+class MetricType {
+public:
+    /// type codes
+    enum Code : uint8_t {
+        Counter,        ///< a monotonically growing sum
+        Gauge,          ///< a value which can go up and down
+        Histogram,      ///< a distribution of sample values
+
+        NumMetricTypes,
+        InvalidMetricType,
+    };
+
+    /// convert metric type to string
+    static const char* ToString(Code c) {
+        switch (c) {
+            case Counter:   return "Counter";
+            case Gauge:     return "Gauge";
+            case Histogram: return "Histogram";
+            default:        return "InvalidMetricType";
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Metric
+    @ingroup Core
+    @brief a handle to a registered metric
+*/
+class Metric {
+public:
+    /// default constructor, creates invalid handle
+    Metric() : Index(-1), Slot(-1), Type(MetricType::InvalidMetricType) { };
+    /// return true if the handle is valid
+    bool IsValid() const {
+        return this->Index >= 0;
+    };
+
+    /// index in the metrics registry
+    int16_t Index;
+    /// first value slot (counters and histograms) or gauge index
+    int16_t Slot;
+    /// the metric type
+    MetricType::Code Type;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MetricsSnapshot
+    @ingroup Core
+    @brief the values of all registered metrics at one point in time
+*/
+class MetricsSnapshot {
+public:
+    /// number of histogram buckets
+    static const int NumBuckets = 20;
+
+    /// the values of one metric
+    struct Value {
+        /// name of the metric
+        const char* Name = nullptr;
+        /// the metric type
+        MetricType::Code Type = MetricType::InvalidMetricType;
+        /// counter: running total, gauge: current value, histogram: number of samples
+        int64_t Total = 0;
+        /// counter: sum of last frame, gauge: value at end of last frame, histogram: samples in last frame
+        int64_t LastFrame = 0;
+        /// histogram: sum of all sample values
+        int64_t Sum = 0;
+        /// histogram: sum of sample values in last frame
+        int64_t LastFrameSum = 0;
+        /// histogram: number of samples per bucket (since start)
+        StaticArray<int64_t, NumBuckets> Buckets;
+        /// histogram: number of samples per bucket in last frame
+        StaticArray<int64_t, NumBuckets> LastFrameBuckets;
+
+        /// histogram: mean sample value (0 if no samples)
+        double Mean() const;
+        /// histogram: approximate percentile (0.0..1.0) as bucket upper bound
+        int64_t Percentile(double p) const;
+    };
+
+    /// frame index of the last Metrics::NextFrame()
+    int64_t FrameIndex = 0;
+    /// values of all registered metrics in registration order
+    Array<Value> Values;
+
+    /// find value by metric name, return nullptr if not found
+    const Value* Find(const char* name) const;
+
+    /// get histogram bucket index for a sample value
+    static int BucketIndex(int64_t val);
+    /// get (exclusive) upper bound of a histogram bucket
+    static int64_t BucketUpperBound(int bucketIndex);
+};
+
+//------------------------------------------------------------------------------
+class Metrics {
+public:
+    /// max number of registered metrics
+    static const int MaxMetrics = 256;
+    /// max number of per-thread value slots (a counter needs 1, a histogram NumBuckets+2)
+    static const int MaxSlots = 1024;
+    /// max length of a metric name (including 0-terminator)
+    static const int MaxNameLength = 48;
+
+    /// register (or lookup) a counter
+    static Metric Counter(const char* name);
+    /// register (or lookup) a gauge
+    static Metric Gauge(const char* name);
+    /// register (or lookup) a histogram
+    static Metric Histogram(const char* name);
+    /// lookup a metric by name, returns invalid handle if not registered
+    static Metric Lookup(const char* name);
+    /// get number of registered metrics
+    static int NumMetrics();
+
+    /// add to a counter or gauge
+    static void Add(const Metric& m, int64_t val);
+    /// set a gauge value
+    static void Set(const Metric& m, int64_t val);
+    /// record a histogram sample
+    static void Record(const Metric& m, int64_t val);
+    /// record a histogram sample in microseconds
+    static void Record(const Metric& m, Duration d);
+
+    /// release the current thread's value slots (called from Core::LeaveThread())
+    static void ReleaseThreadSlots();
+    /// get number of per-thread value slot blocks (released blocks are reused)
+    static int NumThreadSlots();
+
+    /// roll metrics over into a new frame (called from the main thread's PostRunLoop)
+    static void NextFrame();
+    /// get current values of all metrics
+    static MetricsSnapshot Snapshot();
+    /// print current values to a logger (print to Log if logger is invalid)
+    static void Dump(const Ptr<Logger>& logger);
+    /// periodically dump the metrics in NextFrame() (numFrames == 0 to disable)
+    static void SetDumpInterval(int numFrames, const Ptr<Logger>& logger);
+};
+
+} // namespace Oryol
@@ -55,7 +55,9 @@ RefCounted::addRef() {
 inline void
 RefCounted::release() {
     #if ORYOL_HAS_ATOMIC
-    if (1 == this->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+    // acq_rel: the thread which destroys the object must see all writes
+    // of the threads which released their references before
+    if (1 == this->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
     #else
     if (1 == this->refCount--) {
     #endif
@@ -3,39 +3,61 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Time/Clock.h"
+#include <algorithm>
+#include <cstdio>
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
-RunLoop::RunLoop() :
-curId(InvalidId)
-{
+RunLoop::RunLoop() {
     // empty
 }
 
 //------------------------------------------------------------------------------
 RunLoop::~RunLoop() {
-    // empty
+    o_assert_dbg(!this->inRun);
 }
 
 //------------------------------------------------------------------------------
 void
 RunLoop::Run() {
-    this->remCallbacks();
-    this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
+    o_assert_dbg(!this->inRun);
+    this->update();
+    this->inRun = true;
+    // callbacks added during the loop go into the pending array, and
+    // removed callbacks are only invalidated, so the items array doesn't change
+    const int num = this->items.Size();
+    for (int i = 0; i < num; i++) {
+        item& cur = this->items[i];
+        if (InvalidId != cur.id) {
+            if (this->timingEnabled) {
+                this->callTimed(cur);
+            }
+            else {
+                cur.func();
+            }
         }
     }
-    this->remCallbacks();
-    this->addCallbacks();
+    this->inRun = false;
+    this->update();
 }
 
 //------------------------------------------------------------------------------
-bool
-RunLoop::HasCallback(Id id) const {
-    return this->callbacks.Contains(id) || this->toAdd.Contains(id);
+void
+RunLoop::callTimed(item& cur) {
+    const TimePoint start = Clock::Now();
+    cur.func();
+    // NOTE: the callback may have removed itself
+    cur.lastDuration = Clock::Since(start);
+    if (cur.name) {
+        if (!cur.metric.IsValid()) {
+            char metricName[Metrics::MaxNameLength];
+            std::snprintf(metricName, sizeof(metricName), "runloop.%s", cur.name);
+            cur.metric = Metrics::Histogram(metricName);
+        }
+        Metrics::Record(cur.metric, cur.lastDuration);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -44,47 +66,143 @@ RunLoop::HasCallback(Id id) const {
  start or end of the Run function.
 */
 RunLoop::Id
-RunLoop::Add(Func func) {
-    Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
-    return newId;
+RunLoop::Add(Func func, int priority, const char* name) {
+    o_assert_dbg(func);
+    Id id = this->allocId();
+    item& newItem = this->pending.Add();
+    newItem.func = std::move(func);
+    newItem.id = id;
+    newItem.priority = priority;
+    newItem.name = name;
+    return id;
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::allocId() {
+    int slotIndex;
+    if (InvalidIndex != this->freeSlot) {
+        slotIndex = this->freeSlot;
+        this->freeSlot = this->slots[slotIndex].index;
+    }
+    else {
+        o_assert(this->slots.Size() < MaxCallbacks);
+        slotIndex = this->slots.Size();
+        this->slots.Add();
+    }
+    slot& s = this->slots[slotIndex];
+    s.pending = true;
+    s.index = this->pending.Size();
+    this->numCallbacks++;
+    return (Id(s.generation) << 16) | Id(slotIndex);
+}
+
+//------------------------------------------------------------------------------
+RunLoop::item&
+RunLoop::lookup(Id id) {
+    o_assert_dbg(this->HasCallback(id));
+    const slot& s = this->slots[id & 0xFFFF];
+    return s.pending ? this->pending[s.index] : this->items[s.index];
+}
+
+//------------------------------------------------------------------------------
+bool
+RunLoop::HasCallback(Id id) const {
+    const int slotIndex = int(id & 0xFFFF);
+    return (InvalidId != id) &&
+           (slotIndex < this->slots.Size()) &&
+           (this->slots[slotIndex].generation == (id >> 16));
 }
 
 //------------------------------------------------------------------------------
 /**
- NOTE: the callback function not be removed immediately, but at the 
- start or end of the Run function.
+ NOTE: the callback function will not be called anymore, but it will
+ only be destroyed at the start or end of the Run function.
 */
 void
 RunLoop::Remove(Id id) {
-    o_assert_dbg(!this->toRemove.Contains(id));
-    o_assert_dbg(this->callbacks.Contains(id) || this->toAdd.Contains(id));
-    this->toRemove.Add(id);
+    o_assert(this->HasCallback(id));
+    this->lookup(id).id = InvalidId;
+    this->numRemoved++;
+    this->numCallbacks--;
+
+    // bump the generation counter (skipping 0, so that Ids are never 0)
+    // and put the slot into the free list
+    const int slotIndex = int(id & 0xFFFF);
+    slot& s = this->slots[slotIndex];
+    if (0 == ++s.generation) {
+        s.generation = 1;
+    }
+    s.index = this->freeSlot;
+    this->freeSlot = slotIndex;
 }
 
 //------------------------------------------------------------------------------
-void
-RunLoop::addCallbacks() {
-    for (auto& entry : this->toAdd) {
-        item& item = entry.Value();
-        item.valid = true;
-        this->callbacks.Add(entry.Key(), item);
-    }
-    this->toAdd.Clear();
+int
+RunLoop::NumCallbacks() const {
+    return this->numCallbacks;
 }
 
 //------------------------------------------------------------------------------
 void
-RunLoop::remCallbacks() {
-    for (Id id : this->toRemove) {
-        if (this->callbacks.Contains(id)) {
-            this->callbacks.Erase(id);
+RunLoop::update() {
+    if (this->numRemoved > 0) {
+        // compact the items array, keeping the order
+        int dst = 0;
+        const int num = this->items.Size();
+        for (int src = 0; src < num; src++) {
+            if (InvalidId != this->items[src].id) {
+                if (dst != src) {
+                    this->items[dst] = std::move(this->items[src]);
+                    this->slots[this->items[dst].id & 0xFFFF].index = dst;
+                }
+                dst++;
+            }
         }
-        else if (this->toAdd.Contains(id)) {
-            this->toAdd.Erase(id);
+        if (dst < num) {
+            this->items.EraseRange(dst, num - dst);
         }
+        this->numRemoved = 0;
     }
-    this->toRemove.Clear();
+    if (!this->pending.Empty()) {
+        // merge added callbacks into the items array, behind items with the same priority
+        for (item& add : this->pending) {
+            if (InvalidId != add.id) {
+                const int priority = add.priority;
+                const item* pos = std::upper_bound(this->items.begin(), this->items.end(), priority,
+                    [](int pri, const item& elm) {
+                        return pri < elm.priority;
+                    });
+                this->items.Insert(int(pos - this->items.begin()), std::move(add));
+            }
+        }
+        this->pending.Clear();
+        for (int i = 0; i < this->items.Size(); i++) {
+            slot& s = this->slots[this->items[i].id & 0xFFFF];
+            s.pending = false;
+            s.index = i;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::SetTimingEnabled(bool b) {
+    this->timingEnabled = b;
+}
+
+//------------------------------------------------------------------------------
+bool
+RunLoop::IsTimingEnabled() const {
+    return this->timingEnabled;
+}
+
+//------------------------------------------------------------------------------
+Duration
+RunLoop::LastDuration(Id id) const {
+    o_assert_dbg(this->HasCallback(id));
+    const slot& s = this->slots[id & 0xFFFF];
+    return s.pending ? Duration() : this->items[s.index].lastDuration;
 }
 
 } // namespace Oryol
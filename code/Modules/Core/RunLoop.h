@@ -4,70 +4,124 @@
     @class Oryol::RunLoop
     @ingroup Core
     @brief universal run-loop object for on-frame callbacks
-    
-    A runloop object manages a priority-sorted array of callback 
+
+    A runloop object manages a priority-sorted array of callback
     functions which are called per-frame. By default, each thread
     has a RunLoop object which can be configured through the Core facade
     singleton. Runloops can be nested by adding the Run() function
     of one runloop to another runloop. NOTE that priority values are
-    inverted, lower values are called first).
-    
+    inverted, lower values are called first, callbacks with the same
+    priority are called in the order they have been added.
+
     Examples for constructing callbacks:
-    
+
     1. from C function myFunc():
 
-        Callback("name", pri, std::function<void()>(&myFunc);
+        runLoop->Add(&myFunc);
     2. from an object's method (careful, object must not go out-of-scope
        as long as the callback is added to the RunLoop!
 
         MyClass myObj;<br>
-        Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+        runLoop->Add([&myObj]() { myObj.MyMethod(); }, 0, "MyClass");
+
+    Callbacks are stored in a RunLoop::Func (see Function), lambdas
+    with up to InlineCallbackBytes bytes of captures don't allocate
+    memory. Add() and Remove() are O(1), added callbacks are merged into
+    the sorted callback array, and removed callbacks are compacted away
+    at the start and end of Run(). A removed callback will not be called
+    anymore, even if it is removed in the middle of Run().
+
+    The returned Id contains a generation counter, so that a stale Id
+    of a removed callback never refers to a newer callback.
+
+    With SetTimingEnabled(true), each callback call is timed, the
+    duration of the last call can be queried with LastDuration(), and
+    callbacks which have a name record their durations in a
+    "runloop.[name]" Metrics histogram.
 */
-#include <functional>
-#include "Core/Containers/Map.h"
-#include "Core/Containers/Set.h"
+#include "Core/Types.h"
+#include "Core/Function.h"
+#include "Core/Containers/Array.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Time/Duration.h"
 
 namespace Oryol {
 
 class RunLoop {
 public:
-    /// runloop Id
-    typedef int Id;
+    /// runloop Id (16 bits generation counter, 16 bits slot index)
+    typedef uint32_t Id;
     /// invalid runloop Id const
     static const Id InvalidId = 0;
+    /// default callback priority
+    static const int DefaultPriority = 0;
+    /// max number of callbacks in one runloop
+    static const int MaxCallbacks = 0xFFFF;
+    /// size of inline storage for callbacks, bigger callables are heap-allocated
+    static const int InlineCallbackBytes = 32;
     /// runloop function typedef
-    typedef std::function<void()> Func;
+    typedef Function<void(), InlineCallbackBytes> Func;
 
     /// constructor
     RunLoop();
     /// destructor
     ~RunLoop();
-    
+
     /// run one frame
     void Run();
-    
-    /// add a callback to the run loop, higher priorities run earlier, slow!
-    Id Add(Func func);
-    /// remove a callback, slow!
-    void Remove(Id);
-    /// test if a callback has been attached, slow!
-    bool HasCallback(Id) const;
-    
+
+    /// add a callback to the run loop, lower priorities run earlier, name must be a static string
+    Id Add(Func func, int priority = DefaultPriority, const char* name = nullptr);
+    /// remove a callback
+    void Remove(Id id);
+    /// test if a callback has been attached
+    bool HasCallback(Id id) const;
+    /// get number of attached callbacks
+    int NumCallbacks() const;
+
+    /// enable or disable timing of callbacks
+    void SetTimingEnabled(bool b);
+    /// return true if timing of callbacks is enabled
+    bool IsTimingEnabled() const;
+    /// get duration of the last call of a callback (zero if timing is disabled)
+    Duration LastDuration(Id id) const;
+
 private:
-    /// add new callbacks that have been added (called at beginning of Run())
-    void addCallbacks();
-    /// remove callbacks that have been removed (called at end of Run())
-    void remCallbacks();
-    
+    /// a callback entry
     struct item {
         Func func;
-        bool valid;
+        Id id = InvalidId;
+        int priority = DefaultPriority;
+        const char* name = nullptr;
+        Duration lastDuration;
+        Metric metric;
+    };
+
+    /// slot in the Id lookup table
+    struct slot {
+        uint16_t generation = 1;
+        bool pending = false;
+        /// index in items or pending array, or next free slot
+        int index = InvalidIndex;
     };
-    
-    Id curId;
-    Map<Id, item> callbacks;
-    Map<Id, item> toAdd;
-    Set<Id> toRemove;
+
+    /// allocate a slot and its Id for a new pending item
+    Id allocId();
+    /// get the item of a valid Id
+    item& lookup(Id id);
+    /// compact removed callbacks and merge added callbacks (called at start and end of Run())
+    void update();
+    /// call a callback and measure its duration
+    void callTimed(item& cur);
+
+    Array<item> items;
+    Array<item> pending;
+    Array<slot> slots;
+    int freeSlot = InvalidIndex;
+    int numCallbacks = 0;
+    int numRemoved = 0;
+    bool timingEnabled = false;
+    bool inRun = false;
 };
-    
+
 } // namespace Oryol
@@ -5,10 +5,11 @@
 #include <cstring>
 #include "String.h"
 #include "StringAtom.h"
+#include "utf.h"
 
 namespace Oryol {
 
-const char* String::emptyString = "";
+static_assert(sizeof(String) == String::InlineCapacity + 2, "String size must match its inline buffer");
 
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
@@ -22,16 +23,13 @@ String::String(const char* str) {
         this->create(str, int(std::strlen(str)));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
-String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
+String::String() {
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -66,13 +64,10 @@ String::String(const char* ptr, int startIndex, int endIndex) {
 //------------------------------------------------------------------------------
 void
 String::Assign(const char* ptr, int startIndex, int endIndex) {
-    o_assert(nullptr != ptr);
+    // ptr may point into our own inline buffer, so create a new string first
+    String tmp(ptr, startIndex, endIndex);
     this->release();
-    if (EndOfString == endIndex) {
-        endIndex = int(std::strlen(ptr));
-    }
-    o_assert(startIndex < endIndex);
-    this->create(ptr + startIndex, endIndex - startIndex);
+    this->take(tmp);
 }
 
 //------------------------------------------------------------------------------
@@ -92,23 +87,23 @@ String::AsStringAtom() const {
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
-    o_assert(0 == this->data->refCount);
-    this->data->~StringData();
-    Memory::Free(this->data);
-    this->data = nullptr;
-    this->strPtr = nullptr;
+    o_assert(!this->IsInline());
+    o_assert(0 == this->heap.data->refCount);
+    this->heap.data->~StringData();
+    Memory::Free(this->heap.data);
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
 void
 String::alloc(int len) {
-    o_assert(len > 0);
-    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
-    new(this->data) StringData();
+    o_assert(len > InlineCapacity);
+    this->heap.data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
+    new(this->heap.data) StringData();
+    this->buf[TagIndex] = char(HeapTag);
     this->addRef();
-    this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
+    this->heap.data->length = len;
+    this->heap.strPtr = (const char*) &(this->heap.data[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -116,43 +111,90 @@ void
 String::create(const char* ptr, int len) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+        char* dst;
+        if (len <= InlineCapacity) {
+            // short string, store inline
+            dst = this->buf;
+            this->buf[TagIndex] = char(len);
+        }
+        else {
+            this->alloc(len);
+            dst = (char*) this->heap.strPtr;
+        }
+        Memory::Copy(ptr, dst, len);
+        dst[len] = 0;
     }
     else {
         // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
+//------------------------------------------------------------------------------
+char*
+String::prepare(int len) {
+    o_assert(this->IsInline() && (0 == this->buf[TagIndex]) && (len > 0));
+    char* dst;
+    if (len <= InlineCapacity) {
+        dst = this->buf;
+        this->buf[TagIndex] = char(len);
+    }
+    else {
+        this->alloc(len);
+        dst = (char*) this->heap.strPtr;
+    }
+    dst[len] = 0;
+    return dst;
+}
+
+//------------------------------------------------------------------------------
+void
+String::setEmpty() {
+    this->buf[0] = 0;
+    this->buf[TagIndex] = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+String::copy(const String& rhs) {
+    Memory::Copy(rhs.buf, this->buf, sizeof(this->buf));
+    if (!this->IsInline()) {
+        this->addRef();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+String::take(String& rhs) {
+    Memory::Copy(rhs.buf, this->buf, sizeof(this->buf));
+    rhs.setEmpty();
+}
+
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(!this->IsInline());
     #if ORYOL_HAS_ATOMIC
-    this->data->refCount.fetch_add(1, std::memory_order_relaxed);
+    this->heap.data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
-    this->data->refCount++;
+    this->heap.data->refCount++;
     #endif
 }
 
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (!this->IsInline()) {
         #if ORYOL_HAS_ATOMIC
-        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+        if (1 == this->heap.data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
         #else
-        if (1 == this->data->refCount--) {
+        if (1 == this->heap.data->refCount--) {
         #endif
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
     }
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -162,30 +204,31 @@ String::release() {
  */
 void
 String::Assign(const String& rhs, int startIndex, int endIndex) {
-    this->release();
     if (EndOfString == endIndex) {
         endIndex = rhs.Length();
     }
     o_assert((startIndex >= 0) && (startIndex < endIndex));
     o_assert(endIndex <= rhs.Length());
-    this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    if (this == &rhs) {
+        // the source string may live in our own inline buffer
+        String tmp(rhs, startIndex, endIndex);
+        this->release();
+        this->take(tmp);
+    }
+    else {
+        this->release();
+        this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    }
 }
     
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
-        this->addRef();
-    }
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    this->take(rhs);
 }
 
 //------------------------------------------------------------------------------
@@ -196,10 +239,10 @@ String::~String() {
 //------------------------------------------------------------------------------
 void
 String::operator=(const char* str) {
+    // str may point into our own inline buffer, so create a new string first
+    String tmp(str);
     this->release();
-    if (nullptr != str) {
-        this->create(str, int(std::strlen(str)));
-    }
+    this->take(tmp);
 }
 
 //------------------------------------------------------------------------------
@@ -207,11 +250,7 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
-            this->addRef();
-        }
+        this->copy(rhs);
     }
 }
 
@@ -220,22 +259,16 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        this->take(rhs);
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sharesData(rhs)) {
         return true;
     }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
-        return false;
-    }
     else {
         return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
     }
@@ -250,7 +283,7 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sharesData(rhs)) {
         return false;
     }
     else {
@@ -261,7 +294,7 @@ String::operator<(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sharesData(rhs)) {
         return false;
     }
     else {
@@ -272,7 +305,7 @@ String::operator>(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sharesData(rhs)) {
         return true;
     }
     else {
@@ -283,7 +316,7 @@ String::operator<=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sharesData(rhs)) {
         return true;
     }
     else {
@@ -294,22 +327,28 @@ String::operator>=(const String& rhs) const {
 //------------------------------------------------------------------------------
 int
 String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->IsInline()) {
+        return uint8_t(this->buf[TagIndex]);
     }
     else {
-        return this->data->length;
+        return this->heap.data->length;
     }
 }
 
+//------------------------------------------------------------------------------
+int
+String::NumChars() const {
+    return _priv::utf8NumChars((const uint8_t*) this->AsCStr(), this->Length());
+}
+
 //------------------------------------------------------------------------------
 const char*
 String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
+    if (this->IsInline()) {
+        return this->buf;
     }
     else {
-        return this->strPtr;
+        return this->heap.strPtr;
     }
 }
 
@@ -334,36 +373,50 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int
 String::RefCount() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->IsInline()) {
+        return this->buf[TagIndex] != 0 ? 1 : 0;
     }
     else {
-        return this->data->refCount;
+        return this->heap.data->refCount;
     }
 }
 
 //------------------------------------------------------------------------------
-char
-String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+bool
+String::IsInline() const {
+    return uint8_t(this->buf[TagIndex]) != HeapTag;
+}
+
+//------------------------------------------------------------------------------
+bool
+String::sharesData(const String& rhs) const {
+    if (this->IsInline() || rhs.IsInline()) {
+        // only empty strings are trivially identical
+        return (this->buf[TagIndex] == 0) && (rhs.buf[TagIndex] == 0);
     }
     else {
-        return 0;
+        return this->heap.data == rhs.heap.data;
     }
 }
 
 //------------------------------------------------------------------------------
 char
-String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
+String::Back() const {
+    const int len = this->Length();
+    if (len > 0) {
+        return this->AsCStr()[len - 1];
     }
     else {
         return 0;
     }
 }
 
+//------------------------------------------------------------------------------
+char
+String::Front() const {
+    return this->AsCStr()[0];
+}
+
 //------------------------------------------------------------------------------
 bool operator==(const String& s0, const StringAtom& s1) {
     return std::strcmp(s0.AsCStr(), s1.AsCStr()) == 0;
@@ -5,12 +5,18 @@
     @ingroup Core
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
-    when creating or assigning from non-String objects (const char*,
-    StringAtoms). When assigning from another string,
-    only a pointer to the original string data is copied, and a 
-    refcount is maintained. The last String pointing to the string
-    data frees the string data.
+    An immutable, shared UTF-8 String class. Short strings of up to
+    InlineCapacity bytes are stored directly in the String object and
+    never allocate, copying a short string copies its bytes. Memory is
+    only allocated when creating or assigning a longer string from 
+    non-String objects (const char*, StringAtoms). When assigning from 
+    another long string, only a pointer to the original string data 
+    is copied, and a refcount is maintained. The last String pointing 
+    to the string data frees the string data.
+    
+    NOTE: since short strings live inside the String object, the pointer
+    returned by AsCStr() is only valid as long as the String object
+    isn't moved or destroyed.
     
     To manipulate string data, use the StringUtil class.
     
@@ -30,6 +36,7 @@
 #endif
 #include "Core/Types.h"
 #include "Core/Assertion.h"
+#include "Core/Containers/Hash.h"
 
 namespace Oryol {
 
@@ -37,6 +44,9 @@ class StringAtom;
 
 class String {
 public:
+    /// max number of bytes stored inline without allocating
+    static const int InlineCapacity = 22;
+
     /// default constructor
     String();
     /// construct from C string (allocates!)
@@ -93,16 +103,22 @@ public:
     
     /// get string length in number of bytes
     int Length() const;
+    /// get number of UTF-8 characters up to the first 0-byte
+    int NumChars() const;
     /// return true if contains a non-empty string
     bool IsValid() const;
     /// return true if empty
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (inline strings are always 1)
     int RefCount() const;
+    /// return true if the string is stored inline (short or empty string)
+    bool IsInline() const;
     
 private:
+    friend class StringConverter;
+
     /// shared string data header, this is followed by the actual string
     struct StringData {
         #if ORYOL_HAS_ATOMIC
@@ -113,20 +129,42 @@ private:
         int length;
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// pointers to a shared string data block
+    struct heapRef {
+        StringData* data;
+        const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
+    };
+    /// value of the tag byte for strings with a shared string data block
+    static const uint8_t HeapTag = 0xFF;
+    /// index of the tag byte (inline length or HeapTag)
+    static const int TagIndex = InlineCapacity + 1;
+
+    /// create new string (inline or shared data block), numBytes does not include the terminating 0
     void create(const char* ptr, int len);
     /// private alloc function for len
     void alloc(int len);
+    /// setup empty string with storage for len bytes (plus terminating 0), return pointer to fill in
+    char* prepare(int len);
     /// destroy shared string data block
     void destroy();
     /// increment refcount
     void addRef();
     /// decrement refcount, call destroy if 0
     void release();
-    
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    /// set to the empty inline string
+    void setEmpty();
+    /// copy content from other string (adds a reference to shared data)
+    void copy(const String& rhs);
+    /// take content from other string, and leave other string empty
+    void take(String& rhs);
+    /// return true if both strings are empty or point to the same shared data
+    bool sharesData(const String& rhs) const;
+
+    union {
+        heapRef heap;
+        /// inline string bytes, terminating 0 and tag byte
+        char buf[InlineCapacity + 2];
+    };
 };
 
 //------------------------------------------------------------------------------
@@ -155,5 +193,12 @@ bool operator>(const StringAtom& s0, const String& s1);
 bool operator<=(const StringAtom& s0, const String& s1);
 bool operator>=(const StringAtom& s0, const String& s1);
 
+/// hash function for String (same hash as StringAtom)
+template<> struct Hash<String, void> {
+    uint32_t operator()(const String& str) const {
+        return _priv::hashString(str.AsCStr());
+    };
+};
+
 } // namespace Oryol
 
@@ -5,10 +5,29 @@
 #include <cstring>
 #include "StringAtom.h"
 #include "String.h"
+#include "stringAtomGlobalTable.h"
+#include <atomic>
 
 namespace Oryol {
 const char* StringAtom::emptyString = "";
 
+namespace {
+// if set, new atoms are interned in the process-global table
+std::atomic<stringAtomGlobalTable*> globalTable{nullptr};
+}
+
+//------------------------------------------------------------------------------
+void
+StringAtom::UseGlobalTable(bool b) {
+    globalTable.store(b ? stringAtomGlobalTable::Instance() : nullptr, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+bool
+StringAtom::IsUsingGlobalTable() {
+    return nullptr != globalTable.load(std::memory_order_relaxed);
+}
+
 //------------------------------------------------------------------------------
 StringAtom::StringAtom(const String& rhs) {
     this->setupFromCString(rhs.AsCStr());
@@ -35,10 +54,11 @@ StringAtom::AsString() const {
 //------------------------------------------------------------------------------
 void
 StringAtom::copy(const StringAtom& rhs) {
-    // check if rhs is from our thread, if yes the copy is quick,
-    // if no we need to transfer it into this thread's string atom table
+    // check if rhs is from the global table or from our thread, if yes
+    // the copy is quick, if no we need to transfer it into this thread's
+    // string atom table (or into the global table)
     if (rhs.data) {
-        if (rhs.data->table == stringAtomTable::threadLocalPtr()) {
+        if (stringAtomGlobalTable::Owns(rhs.data) || (rhs.data->table == stringAtomTable::threadLocalPtr())) {
             this->data = rhs.data;
         }
         else {
@@ -57,11 +77,18 @@ void
 StringAtom::setupFromCString(const char* str) {
 
     if ((0 != str) && (str[0] != 0)) {
-        // get my thread-local string atom table
-        stringAtomTable* table = stringAtomTable::threadLocalPtr();
-        
         // get hash of string
         int32_t hash = stringAtomTable::HashForString(str);
+
+        // use the global table if enabled (lock-free if the string exists)
+        stringAtomGlobalTable* global = globalTable.load(std::memory_order_acquire);
+        if (global) {
+            this->data = global->FindOrAdd(hash, str);
+            return;
+        }
+
+        // get my thread-local string atom table
+        stringAtomTable* table = stringAtomTable::threadLocalPtr();
         
         // check if string already exists in table
         this->data = table->Find(hash, str);
@@ -8,6 +8,14 @@
     A unique string, relatively slow on creation, but fast for comparison.
     String atoms are stored in thread-local stringAtomTables and comparison
     is fastest in the creator thread.
+
+    Alternatively, all threads can intern their atoms in a single
+    process-global table (see UseGlobalTable() and
+    CoreSetup::GlobalStringAtomTable), lookups of existing strings in
+    the global table are lock-free, and atoms from different threads
+    compare by pointer. Enable the global table before any atoms are
+    created, atoms from a thread-local table and the global table can
+    be compared for equality, but not with operator<.
     
     @see String
 */
@@ -78,6 +86,13 @@ public:
     const char* AsCStr() const;
     /// get String (slow because string object must be constructed)
     String AsString() const;
+    /// get the string's hash value (FAST, 0 if empty)
+    int32_t HashValue() const;
+
+    /// intern new atoms in the process-global table instead of thread-local tables
+    static void UseGlobalTable(bool b);
+    /// return true if the process-global table is used
+    static bool IsUsingGlobalTable();
 
 private:
     /// copy content
@@ -177,6 +192,7 @@ inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
     if (rhs.data && this->data) {
         // it is forbidden to compare string from different threads!
+        // (atoms from the global table all share the same table)
         o_assert(this->data->table == rhs.data->table);
     }
     return this->data < rhs.data;
@@ -228,4 +244,18 @@ StringAtom::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+inline int32_t
+StringAtom::HashValue() const {
+    return this->data ? this->data->hash : 0;
+}
+
+//------------------------------------------------------------------------------
+/// hash function for StringAtom (precomputed)
+template<> struct Hash<StringAtom, void> {
+    uint32_t operator()(const StringAtom& atom) const {
+        return uint32_t(atom.HashValue());
+    };
+};
+
 } // namespace Oryol
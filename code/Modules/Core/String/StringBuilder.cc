@@ -5,21 +5,17 @@
 #include <cstring>
 #include <cstdio>
 #include "StringBuilder.h"
+#include "stringSearch.h"
 #include "Core/Memory/Memory.h"
 
-#if ORYOL_WINDOWS
-#define o_strtok strtok_s
-#else
-#define o_strtok strtok_r
-#endif
-
 namespace Oryol {
     
 //------------------------------------------------------------------------------
 StringBuilder::StringBuilder() :
 buffer(0),
 capacity(0),
-size(0) {
+size(0),
+allocator(nullptr) {
     // empty
 }
 
@@ -62,13 +58,31 @@ StringBuilder() {
 //------------------------------------------------------------------------------
 StringBuilder::~StringBuilder() {
     if (0 != this->buffer) {
-        Memory::Free(this->buffer);
+        if (this->allocator) {
+            this->allocator->Free(this->buffer);
+        }
+        else {
+            Memory::Free(this->buffer);
+        }
     }
     this->buffer = 0;
     this->capacity = 0;
     this->size = 0;
 }
 
+//------------------------------------------------------------------------------
+void
+StringBuilder::SetAllocator(Allocator* allocator_) {
+    o_assert_dbg(0 == this->buffer);
+    this->allocator = allocator_;
+}
+
+//------------------------------------------------------------------------------
+Allocator*
+StringBuilder::GetAllocator() const {
+    return this->allocator;
+}
+
 //------------------------------------------------------------------------------
 void
 StringBuilder::ensureRoom(int numBytes) {
@@ -81,7 +95,7 @@ StringBuilder::ensureRoom(int numBytes) {
         // need to make room
         int growBy = (numBytes < minGrowSize) ? minGrowSize : numBytes;
         const int newCapacity = this->capacity + growBy;
-        char* newBuffer = (char*) Memory::Alloc(newCapacity);
+        char* newBuffer = (char*) (this->allocator ? this->allocator->Alloc(newCapacity) : Memory::Alloc(newCapacity));
         if (this->buffer) {
             // copy over old content and free old buffer
             #if ORYOL_WINDOWS
@@ -90,7 +104,12 @@ StringBuilder::ensureRoom(int numBytes) {
             #else
             std::strcpy(newBuffer, this->buffer);
             #endif
-            Memory::Free(this->buffer);
+            if (this->allocator) {
+                this->allocator->Free(this->buffer);
+            }
+            else {
+                Memory::Free(this->buffer);
+            }
             this->buffer = 0;
         }
         else {
@@ -364,12 +383,64 @@ StringBuilder::SubstituteAll(const char* match, const char* subst) {
 
     int numSubst = 0;
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
         const int matchLen = int(std::strlen(match));
         const int substLen = int(std::strlen(subst));
-        while (nullptr != (ptr = std::strstr(ptr, match))) {
-            this->substituteCommon(ptr, matchLen, substLen, subst);
-            numSubst++;
+        if (substLen <= matchLen) {
+            // result isn't longer, compact in place in a single pass
+            int readPos = 0;
+            int writePos = 0;
+            int index;
+            while (InvalidIndex != (index = _priv::findSubString(this->buffer + readPos, this->size - readPos, match, matchLen))) {
+                if (writePos != readPos) {
+                    std::memmove(this->buffer + writePos, this->buffer + readPos, index);
+                }
+                writePos += index;
+                std::memcpy(this->buffer + writePos, subst, substLen);
+                writePos += substLen;
+                readPos += index + matchLen;
+                numSubst++;
+            }
+            if (numSubst > 0) {
+                const int tailLen = this->size - readPos;
+                std::memmove(this->buffer + writePos, this->buffer + readPos, tailLen);
+                this->size = writePos + tailLen;
+                this->buffer[this->size] = 0;
+            }
+        }
+        else {
+            // result grows, count matches first, then build the result in a new buffer
+            int pos = 0;
+            int index;
+            while (InvalidIndex != (index = _priv::findSubString(this->buffer + pos, this->size - pos, match, matchLen))) {
+                pos += index + matchLen;
+                numSubst++;
+            }
+            if (numSubst > 0) {
+                const int newSize = this->size + numSubst * (substLen - matchLen);
+                const int newCapacity = this->capacity + (newSize - this->size);
+                char* newBuffer = (char*) (this->allocator ? this->allocator->Alloc(newCapacity) : Memory::Alloc(newCapacity));
+                int readPos = 0;
+                int writePos = 0;
+                for (int i = 0; i < numSubst; i++) {
+                    index = _priv::findSubString(this->buffer + readPos, this->size - readPos, match, matchLen);
+                    std::memcpy(newBuffer + writePos, this->buffer + readPos, index);
+                    writePos += index;
+                    std::memcpy(newBuffer + writePos, subst, substLen);
+                    writePos += substLen;
+                    readPos += index + matchLen;
+                }
+                std::memcpy(newBuffer + writePos, this->buffer + readPos, this->size - readPos);
+                newBuffer[newSize] = 0;
+                if (this->allocator) {
+                    this->allocator->Free(this->buffer);
+                }
+                else {
+                    Memory::Free(this->buffer);
+                }
+                this->buffer = newBuffer;
+                this->capacity = newCapacity;
+                this->size = newSize;
+            }
         }
     }
     return numSubst;
@@ -388,11 +459,11 @@ StringBuilder::SubstituteFirst(const char* match, const char* subst) {
     o_assert(match[0] != 0);
     
     if (nullptr != this->buffer) {
-        char* occur = std::strstr(this->buffer, match);
-        if (nullptr != occur) {
-            const int matchLen = int(std::strlen(match));
+        const int matchLen = int(std::strlen(match));
+        const int index = _priv::findSubString(this->buffer, this->size, match, matchLen);
+        if (InvalidIndex != index) {
             const int substLen = int(std::strlen(subst));
-            this->substituteCommon(occur, matchLen, substLen, subst);
+            this->substituteCommon(this->buffer + index, matchLen, substLen, subst);
             return true;
         }
         else {
@@ -415,14 +486,14 @@ StringBuilder::SubstituteFirst(const String& match, const String& subst) {
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    const int index = (const int)std::strcspn(ptr, delims) + startIndex;
-    if (((endIndex != EndOfString) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int index = _priv::findFirstOf(str + startIndex, endIndex - startIndex, _priv::charSet(delims));
+    return (InvalidIndex == index) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -471,16 +542,11 @@ StringBuilder::findLastOf(const char* str, int strLen, int startIndex, int endIn
     else {
         ptr = str + endIndex;
     }
+    const _priv::charSet set(delims);
     while (ptr > startPtr) {
-        const char c = *--ptr;
-        const char* delimPtr = delims;
-        char sc;
-        do {
-            if ((sc = *delimPtr++) == c) {
-                return int(ptr - startPtr);
-            }
+        if (set.Contains(*--ptr)) {
+            return int(ptr - startPtr);
         }
-        while (sc != 0);
     }
     // not found
     return InvalidIndex;
@@ -497,9 +563,9 @@ StringBuilder::findLastNotOf(const char* str, int strLen, int startIndex, int en
     else {
         ptr = str + endIndex;
     }
+    const _priv::charSet set(delims);
     while (ptr > startPtr) {
-        const char c = *--ptr;
-        if (nullptr == strchr(delims, c)) {
+        if (!set.Contains(*--ptr)) {
             return int(ptr - startPtr);
         }
     }
@@ -560,14 +626,14 @@ StringBuilder::FindLastNotOf(int startIndex, int endIndex, const char* delims) c
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    int index = int(std::strspn(ptr, delims)) + startIndex;
-    if (((EndOfString != endIndex) && (index >= endIndex)) || (index >= strLen)) {
-        return InvalidIndex;
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
     }
-    else {
-        return index;
+    if (startIndex >= endIndex) {
+        return InvalidIndex;
     }
+    const int index = _priv::findFirstNotOf(str + startIndex, endIndex - startIndex, _priv::charSet(delims));
+    return (InvalidIndex == index) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -607,21 +673,21 @@ StringBuilder::FindFirstNotOf(int startIndex, int endIndex, const char* delims)
 
 //------------------------------------------------------------------------------
 int
-StringBuilder::findSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
-    const char* ptr = str + startIndex;
-    const char* occur = std::strstr(ptr, subStr);
-    if (nullptr == occur) {
-        return InvalidIndex;
+StringBuilder::findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr) {
+    const int subLen = int(std::strlen(subStr));
+    if (0 == subLen) {
+        return ((EndOfString != endIndex) && (startIndex >= endIndex)) ? InvalidIndex : startIndex;
     }
-    else {
-        int index = int(occur - ptr) + startIndex;
-        if ((EndOfString != endIndex) && (index >= endIndex)) {
-            return InvalidIndex;
-        }
-        else {
-            return index;
-        }
+    // a match must start before endIndex, but may extend beyond it
+    int searchEnd = strLen;
+    if ((EndOfString != endIndex) && ((endIndex + subLen - 1) < strLen)) {
+        searchEnd = endIndex + subLen - 1;
     }
+    if (startIndex >= searchEnd) {
+        return InvalidIndex;
+    }
+    const int index = _priv::findSubString(str + startIndex, searchEnd - startIndex, subStr, subLen);
+    return (InvalidIndex == index) ? InvalidIndex : index + startIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -633,8 +699,10 @@ StringBuilder::findSubString(const char* str, int startIndex, int endIndex, cons
 int
 StringBuilder::FindSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
     o_assert(0 != subStr);
+    o_assert(str);
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
-    return findSubString(str, startIndex, endIndex, subStr);
+    const int strLen = int(std::strlen(str));
+    return findSubString(str, strLen, startIndex, endIndex, subStr);
 }
     
 //------------------------------------------------------------------------------
@@ -649,7 +717,7 @@ StringBuilder::FindSubString(int startIndex, int endIndex, const char* subStr) c
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     if (nullptr != this->buffer) {
         o_assert(startIndex < this->size);
-        return findSubString(this->buffer, startIndex, endIndex, subStr);
+        return findSubString(this->buffer, this->size, startIndex, endIndex, subStr);
     }
     else {
         // no content
@@ -681,12 +749,19 @@ StringBuilder::Tokenize(const char* delims, Array<String>& outTokens) {
     
     outTokens.Clear();
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        const char* token;
-        char* contextPtr = 0;
-        while (0 != (token = o_strtok(ptr, delims, &contextPtr))) {
-            outTokens.Add(token);
-            ptr = 0;
+        const _priv::charSet set(delims);
+        int pos = 0;
+        while (pos < this->size) {
+            // skip delimiters
+            const int start = _priv::findFirstNotOf(this->buffer + pos, this->size - pos, set);
+            if (InvalidIndex == start) {
+                break;
+            }
+            pos += start;
+            const int len = _priv::findFirstOf(this->buffer + pos, this->size - pos, set);
+            const int end = (InvalidIndex == len) ? this->size : pos + len;
+            outTokens.Add(String(this->buffer, pos, end));
+            pos = end;
         }
     }
     this->Clear();
@@ -701,38 +776,38 @@ int
 StringBuilder::Tokenize(const char* delims, char fence, Array<String>& outTokens) {
     outTokens.Clear();
     if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        char* end = ptr + this->size;
-        while (ptr < end)
-        {
-            char* c;
-            
+        const _priv::charSet set(delims);
+        const int size = this->size;
+        int pos = 0;
+        while (pos < size) {
             // skip white space
-            while (*ptr && std::strchr(delims, *ptr))
-            {
-                ptr++;
+            const int start = _priv::findFirstNotOf(this->buffer + pos, size - pos, set);
+            if (InvalidIndex == start) {
+                break;
             }
-            if (*ptr)
-            {
-                // check for fenced area
-                if ((fence == *ptr) && (0 != (c = std::strchr(++ptr, fence))))
-                {
-                    *c++ = 0;
-                    outTokens.Add(ptr);
-                    ptr = c;
-                }
-                else if (0 != (c = std::strpbrk(ptr, delims)))
-                {
-                    *c++ = 0;
-                    outTokens.Add(ptr);
-                    ptr = c;
-                }
-                else
-                {
-                    outTokens.Add(ptr);
-                    break;
+            pos += start;
+
+            // check for fenced area
+            int end = InvalidIndex;
+            if (fence == this->buffer[pos]) {
+                pos++;
+                const char* c = (const char*) std::memchr(this->buffer + pos, fence, size - pos);
+                if (c) {
+                    end = int(c - this->buffer);
                 }
             }
+            if (InvalidIndex == end) {
+                const int len = _priv::findFirstOf(this->buffer + pos, size - pos, set);
+                end = (InvalidIndex == len) ? size : pos + len;
+            }
+            if (end > pos) {
+                outTokens.Add(String(this->buffer, pos, end));
+            }
+            else {
+                outTokens.Add(String());
+            }
+            // skip the closing fence or delimiter
+            pos = end + 1;
         }
     }
     this->Clear();
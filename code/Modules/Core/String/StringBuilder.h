@@ -8,10 +8,14 @@
     Use the StringBuilder methods to build, manipulate and inspect
     string data. Internally a StringBuilder object has a dynamic
     buffer which grows as needed, but never shrinks.
+
+    The buffer can be allocated through an optional Allocator, for
+    instance to build temporary strings in Core::FrameAllocator().
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
 #include "Core/Containers/Array.h"
+#include "Core/Memory/Allocator.h"
 
 namespace Oryol {
     
@@ -34,6 +38,10 @@ public:
     /// destructor
     ~StringBuilder();
     
+    /// set an optional allocator for the string buffer (must be called before content is added)
+    void SetAllocator(Allocator* allocator);
+    /// get the optional allocator (nullptr if default allocator)
+    Allocator* GetAllocator() const;
     /// reserve space (numBytes excludes the terminating 0 byte)
     void Reserve(int numBytes);
     /// get capacity
@@ -86,7 +94,7 @@ public:
     /// append a list of strings with delimiter
     void Append(char delim, std::initializer_list<String> list);
     
-    /// substitute all occurrences of a string, return number of substitutions
+    /// substitute all (non-overlapping) occurrences of a string in one pass, return number of substitutions
     int SubstituteAll(const char* match, const char* subst);
     /// substitute all, with String objects
     int SubstituteAll(const String& match, const String& subst);
@@ -152,7 +160,7 @@ private:
     /// helper function for FindLastNotOf functions
     static int findLastNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims);
     /// helper function for FindSubString functions
-    static int findSubString(const char* str, int startIndex, int endIndex, const char* subStr);
+    static int findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr);
     /// internal formatting method
     bool format(int maxLength, bool append, const char* fmt, va_list args);
     
@@ -160,6 +168,7 @@ private:
     char* buffer;
     int capacity;
     int size;
+    Allocator* allocator;
 };
     
 } // namespace Oryol
@@ -4,120 +4,123 @@
 #include "Pre.h"
 #include "Core/Assertion.h"
 #include "StringConverter.h"
-#include "ConvertUTF.h"
+#include "utf.h"
 #include <cstdlib>
 #include <cstring>
 #include <cwchar>
 
 namespace Oryol {
 
+namespace {
+
+//------------------------------------------------------------------------------
+// wchar_t is UTF-16 on Windows and UTF-32 everywhere else
+inline int
+utf8ToWideLength(const unsigned char* src, int srcNumBytes) {
+    if (2 == sizeof(wchar_t)) {
+        return _priv::utf8ToUTF16Length(src, srcNumBytes);
+    }
+    else {
+        return _priv::utf8ToUTF32Length(src, srcNumBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+utf8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst) {
+    if (2 == sizeof(wchar_t)) {
+        _priv::utf8ToUTF16(src, srcNumBytes, (uint16_t*) dst);
+    }
+    else {
+        _priv::utf8ToUTF32(src, srcNumBytes, (uint32_t*) dst);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int
+wideToUTF8Length(const wchar_t* src, int srcNumChars) {
+    if (2 == sizeof(wchar_t)) {
+        return _priv::utf16ToUTF8Length((const uint16_t*) src, srcNumChars);
+    }
+    else {
+        return _priv::utf32ToUTF8Length((const uint32_t*) src, srcNumChars);
+    }
+}
+
 //------------------------------------------------------------------------------
-static void
-DumpWarning(ConversionResult convRes) {
-    const char* err = "";
-    if (sourceExhausted == convRes) err = "sourceExhausted";
-    else if (targetExhausted == convRes) err = "targetExhausted";
-    else if (sourceIllegal == convRes) err = "sourceIllegal";
-    o_warn("StringConverter: conversion failed with '%s'\n", err);
+inline void
+wideToUTF8(const wchar_t* src, int srcNumChars, unsigned char* dst) {
+    if (2 == sizeof(wchar_t)) {
+        _priv::utf16ToUTF8((const uint16_t*) src, srcNumChars, dst);
+    }
+    else {
+        _priv::utf32ToUTF8((const uint32_t*) src, srcNumChars, dst);
+    }
 }
 
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 int
 StringConverter::UTF8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst, int dstMaxBytes) {
     o_assert((0 != src) && (0 != dst));
-    int result = 0;
-    const UTF8* srcPtr = src;
 
     // need to keep 1 wchar_t for the terminating 0
-    ConversionResult convRes = conversionOK;
-    wchar_t* dstEndPtr = dst + ((dstMaxBytes / sizeof(wchar_t)) - 1);
-    o_assert(dstEndPtr > dst);
-    if (sizeof(wchar_t) == 4) {
-        UTF32* dstPtr = (UTF32*)dst;
-        convRes = ConvertUTF8toUTF32(&srcPtr, src + srcNumBytes, &dstPtr, (UTF32*) dstEndPtr, strictConversion);
-        o_assert(dstPtr < (UTF32*) (dst + (dstMaxBytes / sizeof(wchar_t))));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - (UTF32*)dst) + 1;
-        }
-    } 
-    else {
-        o_assert(2 == sizeof(wchar_t));
-        UTF16* dstPtr = (UTF16*) dst;
-        convRes = ConvertUTF8toUTF16(&srcPtr, src + srcNumBytes, &dstPtr, (UTF16*) dstEndPtr, strictConversion);
-        o_assert(dstPtr < (UTF16*) (dst + (dstMaxBytes / sizeof(wchar_t))));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - (UTF16*)dst) + 1;
-        }
+    const int dstMaxChars = dstMaxBytes / int(sizeof(wchar_t));
+    o_assert(dstMaxChars > 1);
+    dst[0] = 0;
+    const int len = utf8ToWideLength(src, srcNumBytes);
+    if (InvalidIndex == len) {
+        o_warn("StringConverter::UTF8ToWide: invalid UTF-8 input\n");
+        return 0;
     }
-    if (conversionOK != convRes) {
-        DumpWarning(convRes);
+    if (len >= dstMaxChars) {
+        o_warn("StringConverter::UTF8ToWide: destination buffer too small\n");
         return 0;
     }
-    return result;
+    utf8ToWide(src, srcNumBytes, dst);
+    dst[len] = 0;
+    return len + 1;
 }
 
 //------------------------------------------------------------------------------
 int
 StringConverter::WideToUTF8(const wchar_t* src, int srcNumChars, unsigned char* dst, int dstMaxBytes) {
     o_assert((0 != src) && (0 != dst));
-    int result = 0;
-    UTF8* dstPtr = dst;
 
     // need to keep 1 char free for 0-termination
-    ConversionResult convRes = conversionOK;
-    UTF8* dstEnd = (dst + dstMaxBytes) - 1;
-    o_assert(dstEnd > dst);
-    if (sizeof(wchar_t) == 4) {
-        o_assert(4 == sizeof(wchar_t));
-        const UTF32* srcPtr = (const UTF32*) src;
-        const UTF32* srcEndPtr = (UTF32*) src + srcNumChars;
-        convRes = ConvertUTF32toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
-        o_assert(dstPtr < (dst + dstMaxBytes));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - dst) + 1;
-        }
-    }
-    else {
-        o_assert(2 == sizeof(wchar_t));
-        const UTF16* srcPtr = (UTF16*) src;
-        const UTF16* srcEndPtr = (UTF16*) src + srcNumChars;
-        convRes = ConvertUTF16toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
-        o_assert(dstPtr < (dst + dstMaxBytes));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - dst) + 1;
-        }
+    o_assert(dstMaxBytes > 1);
+    dst[0] = 0;
+    const int len = wideToUTF8Length(src, srcNumChars);
+    if (InvalidIndex == len) {
+        o_warn("StringConverter::WideToUTF8: invalid wide string input\n");
+        return 0;
     }
-    if (conversionOK != convRes) {
-        DumpWarning(convRes);
+    if (len >= dstMaxBytes) {
+        o_warn("StringConverter::WideToUTF8: destination buffer too small\n");
         return 0;
     }
-    return result;
+    wideToUTF8(src, srcNumChars, dst);
+    dst[len] = 0;
+    return len + 1;
 }
 
 //------------------------------------------------------------------------------
+/**
+    The UTF-8 length is computed (and the input validated) first, so that
+    the result is converted directly into its exactly sized string storage.
+*/
 String
 StringConverter::WideToUTF8(const wchar_t* wide, int numWideChars) {
     String converted;
     o_assert(0 != wide);
-    if (numWideChars > 0) {
-        if (numWideChars < MaxInternalBufferWChars) {
-            unsigned char dstBuf[(MaxInternalBufferWChars + 1) * MaxUTF8Size];
-            if (0 < StringConverter::WideToUTF8(wide, numWideChars, dstBuf, (int)sizeof(dstBuf))) {
-                converted = (char*) dstBuf;
-            }
+    if ((numWideChars > 0) && (0 != wide[0])) {
+        const int len = wideToUTF8Length(wide, numWideChars);
+        if (InvalidIndex != len) {
+            wideToUTF8(wide, numWideChars, (unsigned char*) converted.prepare(len));
         }
         else {
-            int dstBufSize = (numWideChars * MaxUTF8Size) + 1;
-            unsigned char* dstBuf = (unsigned char*) Memory::Alloc(dstBufSize);
-            if (0 < StringConverter::WideToUTF8(wide, numWideChars, dstBuf, dstBufSize)) {
-                converted = (char*) dstBuf;
-            }
-            Memory::Free(dstBuf);
-            return converted;
+            o_warn("StringConverter::WideToUTF8: invalid wide string input\n");
         }
     }
     return converted;
@@ -138,30 +141,21 @@ StringConverter::WideToUTF8(const WideString& wide) {
 }
 
 //------------------------------------------------------------------------------
+/**
+    See WideToUTF8(), the input is validated and measured first, and
+    converted directly into the WideString storage.
+*/
 WideString
 StringConverter::UTF8ToWide(const unsigned char* src, int srcNumBytes) {
     o_assert(0 != src);
     WideString result;
-    if (srcNumBytes > 0) {
-        // use a char array as buffer (note, even though String::Length() returns the
-        // number of bytes in the string, not the number of UTF-8 characters, this is a valid
-        // check, since the NumBytes is always >= NumChars!
-        if (srcNumBytes < MaxInternalBufferWChars) {
-            wchar_t dstBuf[MaxInternalBufferWChars];
-            bool success = (0 < StringConverter::UTF8ToWide(src, srcNumBytes, dstBuf, sizeof(dstBuf)));
-            if (success) {
-                result = dstBuf;
-            }
+    if ((srcNumBytes > 0) && (0 != src[0])) {
+        const int len = utf8ToWideLength(src, srcNumBytes);
+        if (InvalidIndex != len) {
+            utf8ToWide(src, srcNumBytes, result.prepare(len));
         }
         else {
-            // use buffer 
-            int bufferSize = (srcNumBytes + 1) * sizeof(wchar_t);
-            wchar_t* dstBuf = (wchar_t*) Memory::Alloc(bufferSize);
-            bool success = (0 < StringConverter::UTF8ToWide(src, srcNumBytes, dstBuf, bufferSize));
-            if (success) {
-                result = dstBuf;
-            }
-            Memory::Free((void*) dstBuf);
+            o_warn("StringConverter::UTF8ToWide: invalid UTF-8 input\n");
         }
     }
     return result;
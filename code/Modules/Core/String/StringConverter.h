@@ -43,10 +43,6 @@ public:
     static WideString UTF8ToWide(const unsigned char* src);
     /// convert UTF8 string object to wide string object
     static WideString UTF8ToWide(const String& src);
-
-private:
-    static const int MaxInternalBufferWChars = 128;
-    static const int MaxUTF8Size = 6;
 };
 
 //------------------------------------------------------------------------------
@@ -41,6 +41,20 @@ WideString::create(const wchar_t* ptr, int numChars) {
     }
 }
 
+//------------------------------------------------------------------------------
+wchar_t*
+WideString::prepare(int numChars) {
+    o_assert((nullptr == this->data) && (numChars > 0));
+    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + ((numChars + 1) * sizeof(wchar_t)));
+    new(this->data) StringData();
+    this->addRef();
+    this->data->length = numChars;
+    wchar_t* dst = (wchar_t*) &(this->data[1]);
+    this->strPtr = dst;
+    dst[numChars] = 0;
+    return dst;
+}
+
 //------------------------------------------------------------------------------
 void
 WideString::addRef() {
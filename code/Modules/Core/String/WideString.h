@@ -81,6 +81,8 @@ public:
     int RefCount() const;
     
 private:
+    friend class StringConverter;
+
     /// shared string data header, this is followed by the actual string
     struct StringData {
         #if ORYOL_HAS_ATOMIC
@@ -93,6 +95,8 @@ private:
         
     /// create new string data block, len is number of characters (excluding 0 terminator
     void create(const wchar_t* ptr, int len);
+    /// setup empty string with storage for len characters (plus terminating 0), return pointer to fill in
+    wchar_t* prepare(int len);
     /// destroy shared string data block
     void destroy();
     /// increment refcount
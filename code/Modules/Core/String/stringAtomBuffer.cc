@@ -34,7 +34,7 @@ stringAtomBuffer::allocChunk() {
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32_t hash, const char* str) {
+stringAtomBuffer::AddString(const void* table, int32_t hash, const char* str) {
     o_assert(nullptr != table);
     o_assert(nullptr != str);
     
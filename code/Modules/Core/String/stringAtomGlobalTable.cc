@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//  stringAtomGlobalTable.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "stringAtomGlobalTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Assertion.h"
+#if ORYOL_USE_VLD
+#include "vld.h"
+#endif
+
+namespace Oryol {
+
+std::atomic<stringAtomGlobalTable*> stringAtomGlobalTable::instance{nullptr};
+
+//------------------------------------------------------------------------------
+stringAtomGlobalTable*
+stringAtomGlobalTable::Instance() {
+    // NOTE: like the thread-local tables, the global table is never
+    // released because StringAtoms point into its string buffers
+    stringAtomGlobalTable* table = instance.load(std::memory_order_acquire);
+    if (nullptr == table) {
+        o_memory_scope(StringAtom);
+        #if ORYOL_USE_VLD
+        VLDDisable();
+        #endif
+        stringAtomGlobalTable* newTable = Memory::New<stringAtomGlobalTable>();
+        #if ORYOL_USE_VLD
+        VLDEnable();
+        #endif
+        if (instance.compare_exchange_strong(table, newTable, std::memory_order_acq_rel)) {
+            table = newTable;
+        }
+        else {
+            // another thread was faster
+            Memory::Delete(newTable);
+        }
+    }
+    return table;
+}
+
+//------------------------------------------------------------------------------
+bool
+stringAtomGlobalTable::Owns(const stringAtomBuffer::Header* header) {
+    // relaxed is fine: whoever handed over the header has seen the instance
+    return header->table == instance.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+stringAtomGlobalTable::mixHash(int32_t hash) {
+    // the stripe index is taken from the top bits, the slot index from
+    // the low bits of the mixed hash
+    uint32_t h = uint32_t(hash) * 0x9E3779B1;
+    return h ^ (h >> 16);
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::find(const slotArray* arr, uint32_t h, int32_t hash, const char* str) {
+    if (nullptr == arr) {
+        return nullptr;
+    }
+    uint32_t index = h & arr->mask;
+    for (;;) {
+        const stringAtomBuffer::Header* header = arr->slots[index].load(std::memory_order_acquire);
+        if (nullptr == header) {
+            return nullptr;
+        }
+        if ((header->hash == hash) && (0 == std::strcmp(header->str, str))) {
+            return header;
+        }
+        index = (index + 1) & arr->mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+stringAtomGlobalTable::slotArray*
+stringAtomGlobalTable::allocSlots(int num) {
+    o_assert_dbg((num & (num - 1)) == 0);
+    const int size = int(sizeof(slotArray)) + (num - 1) * int(sizeof(slotArray::slots[0]));
+    slotArray* arr = (slotArray*) Memory::Alloc(size);
+    arr->mask = uint32_t(num - 1);
+    arr->prev = nullptr;
+    for (int i = 0; i < num; i++) {
+        new(&arr->slots[i]) std::atomic<const stringAtomBuffer::Header*>(nullptr);
+    }
+    return arr;
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomGlobalTable::insert(slotArray* arr, uint32_t h, const stringAtomBuffer::Header* header) {
+    uint32_t index = h & arr->mask;
+    while (nullptr != arr->slots[index].load(std::memory_order_relaxed)) {
+        index = (index + 1) & arr->mask;
+    }
+    // release: the header and string must be visible before the slot
+    arr->slots[index].store(header, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+stringAtomGlobalTable::slotArray*
+stringAtomGlobalTable::grow(stripe& s) {
+    slotArray* oldArr = s.slots.load(std::memory_order_relaxed);
+    const int num = oldArr ? int(oldArr->mask + 1) * 2 : InitialSlots;
+    slotArray* newArr = allocSlots(num);
+    newArr->prev = oldArr;
+    if (oldArr) {
+        for (uint32_t i = 0; i <= oldArr->mask; i++) {
+            const stringAtomBuffer::Header* header = oldArr->slots[i].load(std::memory_order_relaxed);
+            if (header) {
+                insert(newArr, mixHash(header->hash), header);
+            }
+        }
+    }
+    // readers which still probe the old array will find all entries
+    // which existed before the grow, the old array is never freed
+    s.slots.store(newArr, std::memory_order_release);
+    return newArr;
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::Find(int32_t hash, const char* str) const {
+    const uint32_t h = mixHash(hash);
+    const stripe& s = this->stripes[h >> 28];
+    return find(s.slots.load(std::memory_order_acquire), h, hash, str);
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::FindOrAdd(int32_t hash, const char* str) {
+    static_assert(NumStripes == 16, "stripe index is taken from the top 4 hash bits");
+    o_assert_dbg(nullptr != str);
+
+    // fast path: lock-free lookup
+    const uint32_t h = mixHash(hash);
+    stripe& s = this->stripes[h >> 28];
+    const stringAtomBuffer::Header* header = find(s.slots.load(std::memory_order_acquire), h, hash, str);
+    if (header) {
+        return header;
+    }
+
+    // slow path: lock the stripe, check again and add the string
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> guard(s.lock);
+    #endif
+    slotArray* arr = s.slots.load(std::memory_order_relaxed);
+    header = find(arr, h, hash, str);
+    if (nullptr == header) {
+        #if ORYOL_USE_VLD
+        VLDDisable();
+        #endif
+        o_memory_scope(StringAtom);
+        const int numEntries = s.numEntries.load(std::memory_order_relaxed) + 1;
+        if ((nullptr == arr) || (numEntries * 2 > int(arr->mask + 1))) {
+            arr = grow(s);
+        }
+        header = this->addString(hash, str);
+        insert(arr, h, header);
+        s.numEntries.store(numEntries, std::memory_order_relaxed);
+        #if ORYOL_USE_VLD
+        VLDEnable();
+        #endif
+    }
+    return header;
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomGlobalTable::addString(int32_t hash, const char* str) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> guard(this->bufferLock);
+    #endif
+    return this->buffer.AddString(this, hash, str);
+}
+
+//------------------------------------------------------------------------------
+int
+stringAtomGlobalTable::Size() const {
+    int size = 0;
+    for (const stripe& s : this->stripes) {
+        size += s.numEntries.load(std::memory_order_relaxed);
+    }
+    return size;
+}
+
+} // namespace Oryol
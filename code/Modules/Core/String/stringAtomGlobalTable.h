@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    The optional process-global StringAtom table (see
+    StringAtom::UseGlobalTable()). All threads intern their atoms into
+    this table, so that atoms from different threads compare by pointer.
+
+    The table is split into stripes by hash value. Each stripe has an
+    open-addressing slot array which is read without locking, and a lock
+    which is only taken to insert a new string (after a lock-free lookup
+    didn't find it). The string data of all stripes goes into one
+    shared stringAtomBuffer (with its own short-held lock), so the global
+    table doesn't need more string memory than a single thread-local
+    table. When a slot array grows, the new array is published
+    atomically and the old array is kept alive, since readers may still
+    be probing it (like the atom strings themselves, the table's memory
+    is never released).
+*/
+#include "Core/Types.h"
+#include "Core/String/stringAtomBuffer.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+class stringAtomGlobalTable {
+public:
+    /// number of stripes (power of 2)
+    static const int NumStripes = 16;
+    /// initial number of slots per stripe (power of 2)
+    static const int InitialSlots = 64;
+
+    /// access to the global table (created on demand)
+    static stringAtomGlobalTable* Instance();
+    /// return true if the header belongs to the global table
+    static bool Owns(const stringAtomBuffer::Header* header);
+    /// find a matching buffer header without locking
+    const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
+    /// find a matching buffer header, or add the string
+    const stringAtomBuffer::Header* FindOrAdd(int32_t hash, const char* str);
+    /// get number of strings in the table
+    int Size() const;
+
+private:
+    /// a slot array, allocated with the slots following the header
+    struct slotArray {
+        uint32_t mask;
+        slotArray* prev;                        // old array, kept alive for readers
+        std::atomic<const stringAtomBuffer::Header*> slots[1];
+    };
+    /// one stripe of the table
+    struct stripe {
+        std::atomic<slotArray*> slots{nullptr};
+        std::atomic<int> numEntries{0};
+        #if ORYOL_HAS_THREADS
+        std::mutex lock;
+        #endif
+        uint8_t pad[ORYOL_CACHELINE_SIZE];
+    };
+
+    /// mix the atom hash for stripe and slot selection
+    static uint32_t mixHash(int32_t hash);
+    /// lookup in a slot array
+    static const stringAtomBuffer::Header* find(const slotArray* arr, uint32_t h, int32_t hash, const char* str);
+    /// allocate a slot array
+    static slotArray* allocSlots(int num);
+    /// insert into a slot array (stripe must be locked)
+    static void insert(slotArray* arr, uint32_t h, const stringAtomBuffer::Header* header);
+    /// grow the slot array of a stripe (stripe must be locked)
+    static slotArray* grow(stripe& s);
+
+    /// add string to the shared string buffer
+    const stringAtomBuffer::Header* addString(int32_t hash, const char* str);
+
+    stripe stripes[NumStripes];
+    #if ORYOL_HAS_THREADS
+    std::mutex bufferLock;
+    #endif
+    stringAtomBuffer buffer;
+    static std::atomic<stringAtomGlobalTable*> instance;
+};
+
+} // namespace Oryol
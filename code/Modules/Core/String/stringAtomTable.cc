@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include <cstring>
 #include "stringAtomTable.h"
+#include "Core/Memory/MemoryTracker.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
@@ -20,6 +21,7 @@ stringAtomTable::threadLocalPtr() {
     // leak detectors will complain about these allocations on program
     // exit
     if (!ptr) {
+        o_memory_scope(StringAtom);
         #if ORYOL_USE_VLD
         VLDDisable();
         #endif
@@ -58,6 +60,7 @@ stringAtomTable::Add(int32_t hash, const char* str) {
     #if ORYOL_USE_VLD
     VLDDisable();
     #endif
+    o_memory_scope(StringAtom);
 
     // add new string to the string buffer
     const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
@@ -75,21 +78,7 @@ stringAtomTable::Add(int32_t hash, const char* str) {
 //------------------------------------------------------------------------------
 int32_t
 stringAtomTable::HashForString(const char* str) {
-
-    // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
-    const char* p = str;
-    uint32_t h = 0;
-    char c;
-    while (0 != (c = *p++))
-    {
-        h += c;
-        h += (h << 10);
-        h ^= (h >> 6);
-    }
-    h += (h << 3);
-    h ^= (h >> 11);
-    h += (h << 15);
-    return h;
+    return int32_t(_priv::hashString(str));
 }
 
 //------------------------------------------------------------------------------
@@ -25,7 +25,7 @@ public:
     
     static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
 
-    /// a bucket entry
+    /// a table entry
     struct Entry {
         /// default constructor
         Entry() : header(0) { };
@@ -39,14 +39,14 @@ public:
         const stringAtomBuffer::Header* header;
     };
     
-    /// hash function for bucket entry
+    /// hash function for table entry
     struct Hasher {
         int32_t operator()(const Entry& e) const {
             return e.header->hash;
         };
     };
     stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+    HashSet<Entry, Hasher> table;
 };
 
 } // namespace Oryol
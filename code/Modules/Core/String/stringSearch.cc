@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+//  stringSearch.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "stringSearch.h"
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/bitOps.h"
+#include <cstring>
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#elif ORYOL_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#define ORYOL_STRINGSEARCH_SIMD (ORYOL_HAS_SSE2 || ORYOL_HAS_NEON)
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+#if ORYOL_HAS_SSE2
+// one mask bit per byte
+typedef __m128i vec;
+const int maskShift = 0;
+const uint64_t byteMask = 0x1;
+const uint64_t fullMask = 0xFFFF;
+inline vec load(const char* ptr) { return _mm_loadu_si128((const __m128i*) ptr); }
+inline vec splat(char c) { return _mm_set1_epi8(c); }
+inline vec equal(vec a, vec b) { return _mm_cmpeq_epi8(a, b); }
+inline vec either(vec a, vec b) { return _mm_or_si128(a, b); }
+inline vec both(vec a, vec b) { return _mm_and_si128(a, b); }
+inline uint64_t mask(vec v) { return uint64_t(_mm_movemask_epi8(v)); }
+#elif ORYOL_HAS_NEON
+// NEON has no movemask, narrowing the compare result gives 4 mask bits per byte
+typedef uint8x16_t vec;
+const int maskShift = 2;
+const uint64_t byteMask = 0xF;
+const uint64_t fullMask = ~uint64_t(0);
+inline vec load(const char* ptr) { return vld1q_u8((const uint8_t*) ptr); }
+inline vec splat(char c) { return vdupq_n_u8(uint8_t(c)); }
+inline vec equal(vec a, vec b) { return vceqq_u8(a, b); }
+inline vec either(vec a, vec b) { return vorrq_u8(a, b); }
+inline vec both(vec a, vec b) { return vandq_u8(a, b); }
+inline uint64_t mask(vec v) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+}
+#endif
+
+#if ORYOL_STRINGSEARCH_SIMD
+//------------------------------------------------------------------------------
+// mask of bytes in a 16-byte block which are in the char set
+inline uint64_t
+matchMask(vec block, const vec* chars, int numChars) {
+    vec eq = equal(block, chars[0]);
+    for (int i = 1; i < numChars; i++) {
+        eq = either(eq, equal(block, chars[i]));
+    }
+    return mask(eq);
+}
+
+//------------------------------------------------------------------------------
+// SIMD scan for a small char set, invert selects first-of vs first-not-of
+template<bool INVERT> bool
+scanSimd(const char* str, int len, const charSet& set, int& outIndex) {
+    vec chars[charSet::MaxSimdChars];
+    for (int i = 0; i < set.numChars; i++) {
+        chars[i] = splat(set.chars[i]);
+    }
+    int i = 0;
+    for (; (i + 32) <= len; i += 32) {
+        uint64_t m0 = matchMask(load(str + i), chars, set.numChars);
+        uint64_t m1 = matchMask(load(str + i + 16), chars, set.numChars);
+        if (INVERT) {
+            m0 = ~m0 & fullMask;
+            m1 = ~m1 & fullMask;
+        }
+        if (0 != (m0 | m1)) {
+            outIndex = (0 != m0) ? i + (lowestBit(m0) >> maskShift) : i + 16 + (lowestBit(m1) >> maskShift);
+            return true;
+        }
+    }
+    for (; (i + 16) <= len; i += 16) {
+        uint64_t m = matchMask(load(str + i), chars, set.numChars);
+        if (INVERT) {
+            m = ~m & fullMask;
+        }
+        if (0 != m) {
+            outIndex = i + (lowestBit(m) >> maskShift);
+            return true;
+        }
+    }
+    outIndex = i;
+    return false;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// scan with the lookup table, 4 characters per iteration
+template<bool INVERT> int
+scanTable(const char* str, int len, const charSet& set, int i) {
+    const uint8_t* t = set.table;
+    const uint8_t* s = (const uint8_t*) str;
+    const uint8_t x = INVERT ? 1 : 0;
+    for (; (i + 4) <= len; i += 4) {
+        if (((t[s[i]] ^ x) | (t[s[i + 1]] ^ x) | (t[s[i + 2]] ^ x) | (t[s[i + 3]] ^ x)) != 0) {
+            break;
+        }
+    }
+    for (; i < len; i++) {
+        if ((t[s[i]] ^ x) != 0) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+charSet::charSet(const char* chars) :
+numChars(0) {
+    o_assert_dbg(chars);
+    std::memset(this->table, 0, sizeof(this->table));
+    for (const char* ptr = chars; *ptr; ptr++) {
+        if (!this->Contains(*ptr)) {
+            this->table[uint8_t(*ptr)] = 1;
+            if (this->numChars < MaxSimdChars) {
+                this->chars[this->numChars] = *ptr;
+            }
+            this->numChars++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstOf(const char* str, int len, const charSet& set) {
+    o_assert_dbg(str || (0 == len));
+    if (0 == set.numChars) {
+        return InvalidIndex;
+    }
+    int i = 0;
+    #if ORYOL_STRINGSEARCH_SIMD
+    if (set.numChars <= charSet::MaxSimdChars) {
+        if (scanSimd<false>(str, len, set, i)) {
+            return i;
+        }
+    }
+    #endif
+    return scanTable<false>(str, len, set, i);
+}
+
+//------------------------------------------------------------------------------
+int
+findFirstNotOf(const char* str, int len, const charSet& set) {
+    o_assert_dbg(str || (0 == len));
+    int i = 0;
+    #if ORYOL_STRINGSEARCH_SIMD
+    if ((set.numChars > 0) && (set.numChars <= charSet::MaxSimdChars)) {
+        if (scanSimd<true>(str, len, set, i)) {
+            return i;
+        }
+    }
+    #endif
+    return scanTable<true>(str, len, set, i);
+}
+
+//------------------------------------------------------------------------------
+/**
+    The SIMD path compares the first and last character of subStr at 16
+    positions at once, and only compares the characters in between for
+    positions where both match (see Wojciech Muła, "SIMD-friendly algorithms
+    for substring searching").
+*/
+int
+findSubString(const char* str, int len, const char* subStr, int subLen) {
+    o_assert_dbg((str || (0 == len)) && subStr && (subLen > 0));
+    if (subLen > len) {
+        return InvalidIndex;
+    }
+    if (1 == subLen) {
+        const char* occur = (const char*) std::memchr(str, subStr[0], len);
+        return occur ? int(occur - str) : InvalidIndex;
+    }
+    // last possible start index of a match
+    const int lastStart = len - subLen;
+    int i = 0;
+    #if ORYOL_STRINGSEARCH_SIMD
+    const vec first = splat(subStr[0]);
+    const vec last = splat(subStr[subLen - 1]);
+    for (; (i + 15) <= lastStart; i += 16) {
+        const vec eqFirst = equal(load(str + i), first);
+        const vec eqLast = equal(load(str + i + subLen - 1), last);
+        uint64_t m = mask(both(eqFirst, eqLast));
+        while (0 != m) {
+            const int bit = lowestBit(m);
+            const int pos = i + (bit >> maskShift);
+            if (0 == std::memcmp(str + pos + 1, subStr + 1, subLen - 2)) {
+                return pos;
+            }
+            // clear all mask bits of this byte
+            m &= ~(byteMask << bit);
+        }
+    }
+    #endif
+    for (; i <= lastStart; i++) {
+        if ((str[i] == subStr[0]) && (0 == std::memcmp(str + i + 1, subStr + 1, subLen - 1))) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+} // namespace _priv
+} // namespace Oryol
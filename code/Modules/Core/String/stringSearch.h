@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private header, do not use
+
+    Search functions for the StringBuilder which compare 16 bytes at a time
+    with SSE2 or NEON (with a scalar fallback). All functions work on
+    a byte range [0, len) and never read outside of it, the range doesn't
+    need to be zero-terminated.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+/// a set of characters for delimiter searches
+class charSet {
+public:
+    /// construct from zero-terminated string of characters
+    charSet(const char* chars);
+    /// test if the set contains a character
+    bool Contains(char c) const {
+        return 0 != this->table[uint8_t(c)];
+    };
+
+    /// max number of characters searched with SIMD (bigger sets use the lookup table)
+    static const int MaxSimdChars = 8;
+    uint8_t table[256];
+    int numChars;
+    char chars[MaxSimdChars];
+};
+
+/// find index of first character in set, or InvalidIndex
+int findFirstOf(const char* str, int len, const charSet& set);
+/// find index of first character not in set, or InvalidIndex
+int findFirstNotOf(const char* str, int len, const charSet& set);
+/// find index of first occurrence of subStr, or InvalidIndex
+int findSubString(const char* str, int len, const char* subStr, int subLen);
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,447 @@
+//------------------------------------------------------------------------------
+//  utf.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "utf.h"
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/bitOps.h"
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#elif ORYOL_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+#if ORYOL_HAS_SSE2
+// one mask bit per byte
+typedef __m128i vec;
+const int maskShift = 0;
+inline vec load(const uint8_t* ptr) { return _mm_loadu_si128((const __m128i*) ptr); }
+// mask of bytes >= 0x80
+inline uint64_t nonAsciiMask(vec v) { return uint64_t(_mm_movemask_epi8(v)); }
+// mask of bytes which are not UTF-8 continuation bytes (0x80..0xBF)
+inline uint64_t leadMask(vec v) { return uint64_t(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65)))); }
+// mask of 0 bytes
+inline uint64_t zeroMask(vec v) { return uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()))); }
+#elif ORYOL_HAS_NEON
+// NEON has no movemask, narrowing the compare result gives 4 mask bits per byte
+typedef int8x16_t vec;
+const int maskShift = 2;
+inline vec load(const uint8_t* ptr) { return vreinterpretq_s8_u8(vld1q_u8(ptr)); }
+inline uint64_t mask(uint8x16_t v) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+}
+inline uint64_t nonAsciiMask(vec v) { return mask(vcltq_s8(v, vdupq_n_s8(0))); }
+inline uint64_t leadMask(vec v) { return mask(vcgtq_s8(v, vdupq_n_s8(-65))); }
+inline uint64_t zeroMask(vec v) { return mask(vceqq_s8(v, vdupq_n_s8(0))); }
+#endif
+
+#if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+//------------------------------------------------------------------------------
+inline int
+popCount(uint64_t m) {
+    m = m - ((m >> 1) & 0x5555555555555555ULL);
+    m = (m & 0x3333333333333333ULL) + ((m >> 2) & 0x3333333333333333ULL);
+    m = (m + (m >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return int((m * 0x0101010101010101ULL) >> 56);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// decode one UTF-8 character, return its length, or 0 if invalid
+inline int
+decodeUTF8(const uint8_t* s, int numBytes, uint32_t& outCodePoint) {
+    const uint32_t b0 = s[0];
+    if (b0 < 0x80) {
+        outCodePoint = b0;
+        return 1;
+    }
+    else if (b0 < 0xC2) {
+        // continuation byte, or overlong 2-byte sequence
+        return 0;
+    }
+    else if (b0 < 0xE0) {
+        if ((numBytes < 2) || ((s[1] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        outCodePoint = ((b0 & 0x1F) << 6) | (s[1] & 0x3F);
+        return 2;
+    }
+    else if (b0 < 0xF0) {
+        if (numBytes < 3) {
+            return 0;
+        }
+        // reject overlong sequences and surrogates
+        const uint32_t b1 = s[1];
+        const uint32_t lo = (0xE0 == b0) ? 0xA0 : 0x80;
+        const uint32_t hi = (0xED == b0) ? 0x9F : 0xBF;
+        if ((b1 < lo) || (b1 > hi) || ((s[2] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        outCodePoint = ((b0 & 0x0F) << 12) | ((b1 & 0x3F) << 6) | (s[2] & 0x3F);
+        return 3;
+    }
+    else if (b0 < 0xF5) {
+        if (numBytes < 4) {
+            return 0;
+        }
+        // reject overlong sequences and code points above U+10FFFF
+        const uint32_t b1 = s[1];
+        const uint32_t lo = (0xF0 == b0) ? 0x90 : 0x80;
+        const uint32_t hi = (0xF4 == b0) ? 0x8F : 0xBF;
+        if ((b1 < lo) || (b1 > hi) || ((s[2] & 0xC0) != 0x80) || ((s[3] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        outCodePoint = ((b0 & 0x07) << 18) | ((b1 & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+        return 4;
+    }
+    else {
+        return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// encode one valid code point as UTF-8, return number of bytes written
+inline int
+encodeUTF8(uint32_t cp, uint8_t* dst) {
+    if (cp < 0x80) {
+        dst[0] = uint8_t(cp);
+        return 1;
+    }
+    else if (cp < 0x800) {
+        dst[0] = uint8_t(0xC0 | (cp >> 6));
+        dst[1] = uint8_t(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    else if (cp < 0x10000) {
+        dst[0] = uint8_t(0xE0 | (cp >> 12));
+        dst[1] = uint8_t(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = uint8_t(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    else {
+        dst[0] = uint8_t(0xF0 | (cp >> 18));
+        dst[1] = uint8_t(0x80 | ((cp >> 12) & 0x3F));
+        dst[2] = uint8_t(0x80 | ((cp >> 6) & 0x3F));
+        dst[3] = uint8_t(0x80 | (cp & 0x3F));
+        return 4;
+    }
+}
+
+//------------------------------------------------------------------------------
+// validate UTF-8 and count UTF-16 or UTF-32 code units
+template<bool UTF16> int
+utf8Length(const uint8_t* src, int numBytes) {
+    o_assert_dbg(src || (0 == numBytes));
+    int i = 0;
+    int n = 0;
+    while (i < numBytes) {
+        const int numAscii = asciiPrefixLength(src + i, numBytes - i);
+        i += numAscii;
+        n += numAscii;
+        // non-ASCII characters until the next ASCII character
+        while ((i < numBytes) && (src[i] >= 0x80)) {
+            uint32_t cp;
+            const int len = decodeUTF8(src + i, numBytes - i, cp);
+            if (0 == len) {
+                return InvalidIndex;
+            }
+            i += len;
+            n += (UTF16 && (cp >= 0x10000)) ? 2 : 1;
+        }
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+// copy a run of ASCII characters into a wider type, return number of chars copied
+template<class TYPE> int
+widenAscii(const uint8_t* src, int numBytes, TYPE* dst) {
+    int i = 0;
+    #if ORYOL_HAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; (i + 16) <= numBytes; i += 16) {
+        const __m128i v = load(src + i);
+        if (0 != _mm_movemask_epi8(v)) {
+            break;
+        }
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i* d = (__m128i*) (dst + i);
+        if (2 == sizeof(TYPE)) {
+            _mm_storeu_si128(d + 0, lo);
+            _mm_storeu_si128(d + 1, hi);
+        }
+        else {
+            _mm_storeu_si128(d + 0, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+    #endif
+    for (; (i < numBytes) && (src[i] < 0x80); i++) {
+        dst[i] = TYPE(src[i]);
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+// copy a run of ASCII characters from a wider type to bytes, return number of chars copied
+template<class TYPE> int
+narrowAscii(const TYPE* src, int numUnits, uint8_t* dst) {
+    int i = 0;
+    #if ORYOL_HAS_SSE2
+    const __m128i highBits = (2 == sizeof(TYPE)) ? _mm_set1_epi16(short(0xFF80)) : _mm_set1_epi32(int(0xFFFFFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; (i + 8) <= numUnits; i += 8) {
+        __m128i v;
+        if (2 == sizeof(TYPE)) {
+            v = _mm_loadu_si128((const __m128i*) (src + i));
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, highBits), zero))) {
+                break;
+            }
+        }
+        else {
+            const __m128i v0 = _mm_loadu_si128((const __m128i*) (src + i));
+            const __m128i v1 = _mm_loadu_si128((const __m128i*) (src + i + 4));
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(v0, v1), highBits), zero))) {
+                break;
+            }
+            v = _mm_packs_epi32(v0, v1);
+        }
+        _mm_storel_epi64((__m128i*) (dst + i), _mm_packus_epi16(v, v));
+    }
+    #endif
+    for (; (i < numUnits) && (src[i] < 0x80); i++) {
+        dst[i] = uint8_t(src[i]);
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+// get length of the leading run of ASCII characters in a wider type
+template<class TYPE> int
+wideAsciiPrefixLength(const TYPE* src, int numUnits) {
+    int i = 0;
+    #if ORYOL_HAS_SSE2
+    const __m128i highBits = (2 == sizeof(TYPE)) ? _mm_set1_epi16(short(0xFF80)) : _mm_set1_epi32(int(0xFFFFFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; (i + 8) <= numUnits; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (src + i));
+        if (4 == sizeof(TYPE)) {
+            v = _mm_or_si128(v, _mm_loadu_si128((const __m128i*) (src + i + 4)));
+        }
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, highBits), zero))) {
+            break;
+        }
+    }
+    #endif
+    while ((i < numUnits) && (uint32_t(src[i]) < 0x80)) {
+        i++;
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+// validate UTF-16 or UTF-32 and count UTF-8 bytes
+template<class TYPE> int
+wideToUTF8Length(const TYPE* src, int numUnits) {
+    o_assert_dbg(src || (0 == numUnits));
+    int i = 0;
+    int n = 0;
+    while (i < numUnits) {
+        const int numAscii = wideAsciiPrefixLength(src + i, numUnits - i);
+        i += numAscii;
+        n += numAscii;
+        // non-ASCII characters until the next ASCII character
+        while ((i < numUnits) && (uint32_t(src[i]) >= 0x80)) {
+            const uint32_t u = uint32_t(src[i++]);
+            if (u < 0x800) {
+                n += 2;
+            }
+            else if ((u >= 0xD800) && (u <= 0xDFFF)) {
+                // only a high surrogate followed by a low surrogate is valid in UTF-16
+                if ((2 != sizeof(TYPE)) || (u > 0xDBFF) || (i >= numUnits) ||
+                    (uint32_t(src[i]) < 0xDC00) || (uint32_t(src[i]) > 0xDFFF)) {
+                    return InvalidIndex;
+                }
+                i++;
+                n += 4;
+            }
+            else if (u < 0x10000) {
+                n += 3;
+            }
+            else if (u <= 0x10FFFF) {
+                n += 4;
+            }
+            else {
+                return InvalidIndex;
+            }
+        }
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+// convert valid UTF-16 or UTF-32 to UTF-8
+template<class TYPE> int
+wideToUTF8(const TYPE* src, int numUnits, uint8_t* dst) {
+    int i = 0;
+    uint8_t* ptr = dst;
+    while (i < numUnits) {
+        const int numAscii = narrowAscii(src + i, numUnits - i, ptr);
+        i += numAscii;
+        ptr += numAscii;
+        while ((i < numUnits) && (uint32_t(src[i]) >= 0x80)) {
+            uint32_t cp = uint32_t(src[i++]);
+            if ((2 == sizeof(TYPE)) && (cp >= 0xD800) && (cp <= 0xDBFF)) {
+                o_assert_dbg(i < numUnits);
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (uint32_t(src[i++]) - 0xDC00);
+            }
+            ptr += encodeUTF8(cp, ptr);
+        }
+    }
+    return int(ptr - dst);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int
+asciiPrefixLength(const uint8_t* src, int numBytes) {
+    int i = 0;
+    #if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+    for (; (i + 16) <= numBytes; i += 16) {
+        const uint64_t m = nonAsciiMask(load(src + i));
+        if (0 != m) {
+            return i + (lowestBit(m) >> maskShift);
+        }
+    }
+    #endif
+    while ((i < numBytes) && (src[i] < 0x80)) {
+        i++;
+    }
+    return i;
+}
+
+//------------------------------------------------------------------------------
+bool
+utf8Validate(const uint8_t* src, int numBytes) {
+    return InvalidIndex != utf8Length<false>(src, numBytes);
+}
+
+//------------------------------------------------------------------------------
+int
+utf8NumChars(const uint8_t* src, int numBytes) {
+    o_assert_dbg(src || (0 == numBytes));
+    int i = 0;
+    int n = 0;
+    #if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+    for (; (i + 16) <= numBytes; i += 16) {
+        const vec v = load(src + i);
+        uint64_t lead = leadMask(v);
+        const uint64_t zero = zeroMask(v);
+        if (0 != zero) {
+            // only count characters before the first 0 byte
+            lead &= (zero & (~zero + 1)) - 1;
+            return n + (popCount(lead) >> maskShift);
+        }
+        n += popCount(lead) >> maskShift;
+    }
+    #endif
+    for (; (i < numBytes) && (0 != src[i]); i++) {
+        n += ((src[i] & 0xC0) != 0x80) ? 1 : 0;
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+int
+utf8ToUTF16Length(const uint8_t* src, int numBytes) {
+    return utf8Length<true>(src, numBytes);
+}
+
+//------------------------------------------------------------------------------
+int
+utf8ToUTF32Length(const uint8_t* src, int numBytes) {
+    return utf8Length<false>(src, numBytes);
+}
+
+//------------------------------------------------------------------------------
+int
+utf8ToUTF16(const uint8_t* src, int numBytes, uint16_t* dst) {
+    int i = 0;
+    uint16_t* ptr = dst;
+    while (i < numBytes) {
+        const int numAscii = widenAscii(src + i, numBytes - i, ptr);
+        i += numAscii;
+        ptr += numAscii;
+        while ((i < numBytes) && (src[i] >= 0x80)) {
+            uint32_t cp = 0;
+            const int len = decodeUTF8(src + i, numBytes - i, cp);
+            o_assert_dbg(len > 0);
+            i += len;
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                *ptr++ = uint16_t(0xD800 + (cp >> 10));
+                *ptr++ = uint16_t(0xDC00 + (cp & 0x3FF));
+            }
+            else {
+                *ptr++ = uint16_t(cp);
+            }
+        }
+    }
+    return int(ptr - dst);
+}
+
+//------------------------------------------------------------------------------
+int
+utf8ToUTF32(const uint8_t* src, int numBytes, uint32_t* dst) {
+    int i = 0;
+    uint32_t* ptr = dst;
+    while (i < numBytes) {
+        const int numAscii = widenAscii(src + i, numBytes - i, ptr);
+        i += numAscii;
+        ptr += numAscii;
+        while ((i < numBytes) && (src[i] >= 0x80)) {
+            const int len = decodeUTF8(src + i, numBytes - i, *ptr);
+            o_assert_dbg(len > 0);
+            i += len;
+            ptr++;
+        }
+    }
+    return int(ptr - dst);
+}
+
+//------------------------------------------------------------------------------
+int
+utf16ToUTF8Length(const uint16_t* src, int numUnits) {
+    return wideToUTF8Length(src, numUnits);
+}
+
+//------------------------------------------------------------------------------
+int
+utf32ToUTF8Length(const uint32_t* src, int numUnits) {
+    return wideToUTF8Length(src, numUnits);
+}
+
+//------------------------------------------------------------------------------
+int
+utf16ToUTF8(const uint16_t* src, int numUnits, uint8_t* dst) {
+    return wideToUTF8(src, numUnits, dst);
+}
+
+//------------------------------------------------------------------------------
+int
+utf32ToUTF8(const uint32_t* src, int numUnits, uint8_t* dst) {
+    return wideToUTF8(src, numUnits, dst);
+}
+
+} // namespace _priv
+} // namespace Oryol
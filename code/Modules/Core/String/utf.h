@@ -0,0 +1,52 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private header, do not use
+
+    UTF-8, UTF-16 and UTF-32 validation and conversion for the
+    StringConverter and String classes. ASCII runs are detected 16 bytes
+    at a time with SSE2 or NEON and also converted 16 bytes at a time with
+    SSE2 (with a scalar fallback), other characters are decoded one at a
+    time.
+
+    The *Length() functions validate the input and return the exact
+    number of code units of the converted string (excluding a terminating
+    0), or InvalidIndex if the input isn't valid. The conversion functions
+    expect valid input and a destination buffer of the exact length.
+
+    Validation is strict: overlong UTF-8 sequences, surrogate code
+    points, unpaired UTF-16 surrogates and code points above U+10FFFF
+    are invalid.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+/// get length of the leading run of ASCII bytes
+int asciiPrefixLength(const uint8_t* src, int numBytes);
+/// validate UTF-8
+bool utf8Validate(const uint8_t* src, int numBytes);
+/// get number of code points in UTF-8 before the first 0 byte (doesn't validate)
+int utf8NumChars(const uint8_t* src, int numBytes);
+
+/// validate UTF-8 and get number of UTF-16 code units, or InvalidIndex
+int utf8ToUTF16Length(const uint8_t* src, int numBytes);
+/// validate UTF-8 and get number of UTF-32 code units, or InvalidIndex
+int utf8ToUTF32Length(const uint8_t* src, int numBytes);
+/// convert valid UTF-8 to UTF-16, return number of code units written
+int utf8ToUTF16(const uint8_t* src, int numBytes, uint16_t* dst);
+/// convert valid UTF-8 to UTF-32, return number of code units written
+int utf8ToUTF32(const uint8_t* src, int numBytes, uint32_t* dst);
+
+/// validate UTF-16 and get number of UTF-8 bytes, or InvalidIndex
+int utf16ToUTF8Length(const uint16_t* src, int numUnits);
+/// validate UTF-32 and get number of UTF-8 bytes, or InvalidIndex
+int utf32ToUTF8Length(const uint32_t* src, int numUnits);
+/// convert valid UTF-16 to UTF-8, return number of bytes written
+int utf16ToUTF8(const uint16_t* src, int numUnits, uint8_t* dst);
+/// convert valid UTF-32 to UTF-8, return number of bytes written
+int utf32ToUTF8(const uint32_t* src, int numUnits, uint8_t* dst);
+
+} // namespace _priv
+} // namespace Oryol
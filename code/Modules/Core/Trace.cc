@@ -1,7 +1,7 @@
 //------------------------------------------------------------------------------
 //  Trace.cc
 //------------------------------------------------------------------------------
-#if ORYOL_PROFILING
+#if ORYOL_PROFILING || ORYOL_TRACE_JSON
 #include "Pre.h"
 #include "Trace.h"
 
@@ -9,7 +9,10 @@ namespace Oryol {
 
 //------------------------------------------------------------------------------
 Trace::Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACEJSON
+    TraceRecorder::Setup();
+    TraceRecorder::SetThreadName("main");
+    #elif ORYOL_USE_REMOTERY
     rmt_CreateGlobalInstance(&this->rmt);
     rmt_SetCurrentThreadName("MainThread");
     #elif ORYOL_USE_EMSCTRACE
@@ -19,7 +22,9 @@ Trace::Trace() {
 
 //------------------------------------------------------------------------------
 Trace::~Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACEJSON
+    TraceRecorder::Discard();
+    #elif ORYOL_USE_REMOTERY
     rmt_DestroyGlobalInstance(this->rmt);
     this->rmt = nullptr;
     #elif ORYOL_USE_EMSCTRACE
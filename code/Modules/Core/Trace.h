@@ -1,21 +1,29 @@
 #pragma once
-#if ORYOL_PROFILING
+#if ORYOL_PROFILING || ORYOL_TRACE_JSON
 //------------------------------------------------------------------------------
 /**
     @class Oryol::Trace
-    @brief tracing support when ORYOL_PROFILING is enabled
+    @brief tracing support when ORYOL_PROFILING or ORYOL_TRACE_JSON is enabled
 
     This file implements various macros that hook Oryol into
-    profiling/tracing tools.
+    profiling/tracing tools. With ORYOL_TRACE_JSON, trace events are
+    recorded by the built-in TraceRecorder and written as Chrome Trace
+    Event JSON (no network or external viewer needed), otherwise
+    Remotery or the emscripten tracing API are used.
  */
 #include "Core/Types.h"
-#if ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
+#if ORYOL_TRACE_JSON
+#define ORYOL_USE_TRACEJSON (1)
+#elif ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
 #define ORYOL_USE_REMOTERY (1)
-#endif
-#if ORYOL_EMSCRIPTEN
+#elif ORYOL_EMSCRIPTEN
 #define ORYOL_USE_EMSCTRACE (1)
 #endif
 
+#if ORYOL_USE_TRACEJSON
+#include "Core/TraceRecorder.h"
+#endif
+
 #if ORYOL_USE_REMOTERY
 #include "Remotery.h"
 #endif
@@ -50,24 +58,34 @@ struct emscScopedTrace {
 #endif
     
 // trace macros
-#if ORYOL_USE_REMOTERY
+#if ORYOL_USE_TRACEJSON
+#define o_trace_begin_frame() Oryol::TraceRecorder::BeginFrame()
+#define o_trace_end_frame() Oryol::TraceRecorder::EndFrame()
+#define o_trace_begin(name) Oryol::TraceRecorder::Begin(#name)
+#define o_trace_end() Oryol::TraceRecorder::End()
+#define o_trace_scoped(name) Oryol::TraceRecorder::Scope oryolTraceScope##name(#name)
+#define o_trace_thread_name(name) Oryol::TraceRecorder::SetThreadName(name)
+#elif ORYOL_USE_REMOTERY
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) rmt_BeginCPUSample(name)
 #define o_trace_end() rmt_EndCPUSample()
 #define o_trace_scoped(name) rmt_ScopedCPUSample(name)
+#define o_trace_thread_name(name) rmt_SetCurrentThreadName(name)
 #elif ORYOL_USE_EMSCTRACE
 #define o_trace_begin_frame() emscripten_trace_record_frame_start()
 #define o_trace_end_frame() emscripten_trace_record_frame_end()
 #define o_trace_begin(name) emscripten_trace_enter_context(#name)
 #define o_trace_end(name) emscripten_trace_exit_context()
 #define o_trace_scoped(name) emscScopedTrace emscScopedTrace##name(#name)
+#define o_trace_thread_name(name) ((void)0)
 #else
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
 
 } // namespace Oryol
@@ -77,4 +95,5 @@ struct emscScopedTrace {
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
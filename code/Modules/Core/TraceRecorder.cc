@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------------
+//  TraceRecorder.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TraceRecorder.h"
+#include "Core/Assertion.h"
+#include "Core/Time/Clock.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if ORYOL_HAS_THREADS
+#include <mutex>
+static std::mutex lockMutex;
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+
+namespace {
+
+enum eventType {
+    BeginEvent,
+    EndEvent,
+};
+
+struct traceEvent {
+    const char* name;
+    TimePoint time;
+    int type;
+};
+
+// per-thread event buffer, only written by its owner thread, the
+// owner publishes new events by bumping numEvents
+struct threadBuffer {
+    int tid = 0;
+    int generation = 0;
+    char name[32] = { 0 };          // protected by lockMutex
+    traceEvent* events = nullptr;
+    int capacity = 0;
+    int depth = 0;                  // number of open recorded events
+    int droppedDepth = 0;           // number of open dropped events
+    std::atomic<int> numEvents{0};
+    std::atomic<int> numDropped{0};
+};
+
+// all thread buffers ever created (protected by lockMutex), the buffer
+// structs are never released since threads keep pointers to them,
+// the event arrays are released in Discard()
+Array<threadBuffer*> buffers;
+std::atomic<bool> valid{false};
+int generation = 0;
+int eventsPerThread = 0;
+TimePoint startTime;
+ORYOL_THREADLOCAL_PTR(threadBuffer) threadBuf = nullptr;
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+static threadBuffer*
+getThreadBuffer() {
+    threadBuffer* buf = threadBuf;
+    if (buf && (buf->generation == generation)) {
+        return buf;
+    }
+    SCOPED_LOCK;
+    if (nullptr == buf) {
+        buf = Memory::New<threadBuffer>();
+        buf->tid = buffers.Size() + 1;
+        std::snprintf(buf->name, sizeof(buf->name), "thread%d", buf->tid);
+        buffers.Add(buf);
+        threadBuf = buf;
+    }
+    // first event of this thread since Setup()
+    buf->events = (traceEvent*) Memory::Alloc(eventsPerThread * int(sizeof(traceEvent)));
+    buf->capacity = eventsPerThread;
+    buf->depth = 0;
+    buf->droppedDepth = 0;
+    buf->numEvents.store(0, std::memory_order_relaxed);
+    buf->numDropped.store(0, std::memory_order_relaxed);
+    buf->generation = generation;
+    return buf;
+}
+
+//------------------------------------------------------------------------------
+static void
+record(threadBuffer* buf, const char* name, int type) {
+    const int num = buf->numEvents.load(std::memory_order_relaxed);
+    o_assert_dbg(num < buf->capacity);
+    traceEvent& e = buf->events[num];
+    e.name = name;
+    e.time = Clock::Now();
+    e.type = type;
+    buf->numEvents.store(num + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Setup(int numEventsPerThread) {
+    o_assert(!IsValid());
+    o_assert(numEventsPerThread > 0);
+    SCOPED_LOCK;
+    eventsPerThread = numEventsPerThread;
+    generation++;
+    startTime = Clock::Now();
+    valid.store(true, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Discard() {
+    o_assert(IsValid());
+    valid.store(false, std::memory_order_release);
+    SCOPED_LOCK;
+    for (threadBuffer* buf : buffers) {
+        if (buf->events) {
+            Memory::Free(buf->events);
+            buf->events = nullptr;
+        }
+        buf->capacity = 0;
+        buf->numEvents.store(0, std::memory_order_relaxed);
+        buf->numDropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+TraceRecorder::IsValid() {
+    return valid.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::SetThreadName(const char* name) {
+    o_assert_dbg(name);
+    if (IsValid()) {
+        threadBuffer* buf = getThreadBuffer();
+        SCOPED_LOCK;
+        std::strncpy(buf->name, name, sizeof(buf->name) - 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Begin(const char* name) {
+    if (IsValid()) {
+        threadBuffer* buf = getThreadBuffer();
+        // keep room for the end events of all open events
+        const int num = buf->numEvents.load(std::memory_order_relaxed);
+        if ((0 == buf->droppedDepth) && ((num + buf->depth + 2) <= buf->capacity)) {
+            record(buf, name, BeginEvent);
+            buf->depth++;
+        }
+        else {
+            buf->droppedDepth++;
+            buf->numDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::End() {
+    if (IsValid()) {
+        threadBuffer* buf = getThreadBuffer();
+        if (buf->droppedDepth > 0) {
+            buf->droppedDepth--;
+            buf->numDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (buf->depth > 0) {
+            record(buf, nullptr, EndEvent);
+            buf->depth--;
+        }
+        // an End() without matching Begin() (e.g. begun before Setup()) is ignored
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::BeginFrame() {
+    Begin("Frame");
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::EndFrame() {
+    End();
+}
+
+//------------------------------------------------------------------------------
+int
+TraceRecorder::NumEvents() {
+    SCOPED_LOCK;
+    int num = 0;
+    for (const threadBuffer* buf : buffers) {
+        if (buf->generation == generation) {
+            num += buf->numEvents.load(std::memory_order_acquire);
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+int
+TraceRecorder::NumDropped() {
+    SCOPED_LOCK;
+    int num = 0;
+    for (const threadBuffer* buf : buffers) {
+        if (buf->generation == generation) {
+            num += buf->numDropped.load(std::memory_order_relaxed);
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+static void
+appendJSONString(StringBuilder& builder, const char* str) {
+    builder.Append('"');
+    for (const char* p = str; *p; p++) {
+        const char c = *p;
+        if (('"' == c) || ('\\' == c)) {
+            builder.Append('\\');
+            builder.Append(c);
+        }
+        else if (uint8_t(c) < 0x20) {
+            builder.AppendFormat(8, "\\u%04x", int(c));
+        }
+        else {
+            builder.Append(c);
+        }
+    }
+    builder.Append('"');
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::WriteJSON(StringBuilder& builder) {
+    SCOPED_LOCK;
+    builder.Append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const threadBuffer* buf : buffers) {
+        if (buf->generation != generation) {
+            continue;
+        }
+        if (!first) {
+            builder.Append(",\n");
+        }
+        first = false;
+        builder.AppendFormat(128, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buf->tid);
+        appendJSONString(builder, buf->name);
+        builder.Append("}}");
+
+        // the owner thread may still record, only write the published events
+        const int num = buf->numEvents.load(std::memory_order_acquire);
+        for (int i = 0; i < num; i++) {
+            const traceEvent& e = buf->events[i];
+            const double ts = (e.time - startTime).AsMicroSeconds();
+            if (BeginEvent == e.type) {
+                builder.Append(",\n{\"name\":");
+                appendJSONString(builder, e.name);
+                builder.AppendFormat(128, ",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", buf->tid, ts);
+            }
+            else {
+                builder.AppendFormat(128, ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", buf->tid, ts);
+            }
+        }
+    }
+    builder.Append("\n]}\n");
+}
+
+//------------------------------------------------------------------------------
+bool
+TraceRecorder::WriteFile(const char* path) {
+    o_assert_dbg(path);
+    StringBuilder builder;
+    WriteJSON(builder);
+    #if ORYOL_WINDOWS
+    FILE* fp = nullptr;
+    if (0 != fopen_s(&fp, path, "wb")) {
+        fp = nullptr;
+    }
+    #else
+    FILE* fp = std::fopen(path, "wb");
+    #endif
+    if (nullptr == fp) {
+        return false;
+    }
+    const size_t len = size_t(builder.Length());
+    const bool success = (len == std::fwrite(builder.AsCStr(), 1, len, fp));
+    std::fclose(fp);
+    return success;
+}
+
+} // namespace Oryol
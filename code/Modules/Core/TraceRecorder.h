@@ -0,0 +1,79 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TraceRecorder
+    @ingroup Core
+    @brief records trace events and writes them as Chrome Trace Event JSON
+
+    A self-contained tracing backend which doesn't need a network
+    connection or a running viewer. Each thread records begin/end events
+    with Clock::Now() timestamps into its own fixed-size event buffer
+    (without locking, the buffers are only written by their owner
+    thread). The recorded events can be written at any time as
+    Chrome Trace Event JSON, which can be loaded into chrome://tracing
+    or ui.perfetto.dev.
+
+    If Oryol is compiled with ORYOL_TRACE_JSON=1, the o_trace macros
+    record into the TraceRecorder, Core::Setup() sets up the recorder,
+    and Core::Discard() writes the events to CoreSetup::TraceFile (if
+    set). Threads are named with o_trace_thread_name(), frames recorded
+    with o_trace_begin_frame() / o_trace_end_frame() show up as 'Frame'
+    events.
+
+    When a thread's event buffer is full, new events of that thread are
+    dropped (see NumDropped()). Setup() and Discard() must not be called
+    while other threads are recording.
+
+    @see Trace.h
+*/
+#include "Core/Types.h"
+#include "Core/Time/TimePoint.h"
+
+namespace Oryol {
+
+class StringBuilder;
+
+class TraceRecorder {
+public:
+    /// default number of events per thread
+    static const int DefaultEventsPerThread = 64 * 1024;
+
+    /// setup the recorder
+    static void Setup(int eventsPerThread = DefaultEventsPerThread);
+    /// discard the recorder and all recorded events
+    static void Discard();
+    /// return true if the recorder has been setup
+    static bool IsValid();
+
+    /// set the name of the calling thread
+    static void SetThreadName(const char* name);
+    /// begin a named event on the calling thread (name must have static lifetime)
+    static void Begin(const char* name);
+    /// end the last begun event on the calling thread
+    static void End();
+    /// mark begin of a frame
+    static void BeginFrame();
+    /// mark end of a frame
+    static void EndFrame();
+
+    /// get number of recorded events (over all threads)
+    static int NumEvents();
+    /// get number of dropped events (over all threads)
+    static int NumDropped();
+    /// append the recorded events as Chrome Trace Event JSON
+    static void WriteJSON(StringBuilder& builder);
+    /// write the recorded events as Chrome Trace Event JSON to a file
+    static bool WriteFile(const char* path);
+
+    /// scoped begin/end helper
+    struct Scope {
+        Scope(const char* name) {
+            TraceRecorder::Begin(name);
+        };
+        ~Scope() {
+            TraceRecorder::End();
+        };
+    };
+};
+
+} // namespace Oryol
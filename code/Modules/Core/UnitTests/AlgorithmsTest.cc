@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+//  AlgorithmsTest.cc
+//  Test sort and search algorithms.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Containers/Algorithms.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include <algorithm>
+
+using namespace Oryol;
+
+namespace {
+
+//------------------------------------------------------------------------------
+uint64_t
+xorshift(uint64_t& x) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+radixSortMatches(int num, uint64_t mask) {
+    Array<TYPE> values;
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < num; i++) {
+        values.Add(TYPE(xorshift(x) & mask));
+    }
+    Array<TYPE> expected = values;
+    std::sort(expected.begin(), expected.end());
+    Algorithms::RadixSort(values.MakeSlice());
+    return std::equal(values.begin(), values.end(), expected.begin());
+}
+
+struct item {
+    uint32_t key;
+    int order;
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(RadixSortTest) {
+    const uint64_t all = ~0ULL;
+    CHECK(radixSortMatches<uint8_t>(1000, all));
+    CHECK(radixSortMatches<int8_t>(1000, all));
+    CHECK(radixSortMatches<uint16_t>(1000, all));
+    CHECK(radixSortMatches<int16_t>(1000, all));
+    CHECK(radixSortMatches<uint32_t>(10000, all));
+    CHECK(radixSortMatches<int32_t>(10000, all));
+    CHECK(radixSortMatches<uint64_t>(10000, all));
+    CHECK(radixSortMatches<int64_t>(10000, all));
+    // only some digits differ, others are skipped
+    CHECK(radixSortMatches<uint32_t>(10000, 0x00FF00FF));
+    CHECK(radixSortMatches<int64_t>(10000, 0xFFFF00000000FFFFULL));
+    CHECK(radixSortMatches<int32_t>(1, all));
+
+    // all equal values
+    Array<int> same;
+    for (int i = 0; i < 100; i++) {
+        same.Add(7);
+    }
+    Algorithms::RadixSort(same.MakeSlice());
+    CHECK(same.Size() == 100);
+    CHECK(same[0] == 7 && same[99] == 7);
+
+    // sorting with a key function is stable
+    Array<item> items;
+    uint64_t x = 1234567;
+    for (int i = 0; i < 5000; i++) {
+        items.Add(item{ uint32_t(xorshift(x) % 100), i });
+    }
+    Algorithms::RadixSort(items.MakeSlice(), [](const item& i) {
+        return i.key;
+    });
+    bool sorted = true;
+    for (int i = 1; i < items.Size(); i++) {
+        const item& prev = items[i - 1];
+        const item& cur = items[i];
+        if ((prev.key > cur.key) || ((prev.key == cur.key) && (prev.order >= cur.order))) {
+            sorted = false;
+        }
+    }
+    CHECK(sorted);
+
+    // sorting a sub-slice leaves the other elements alone
+    Array<int> partial({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+    Algorithms::RadixSort(partial.MakeSlice(2, 5));
+    CHECK(partial[0] == 9 && partial[1] == 8);
+    CHECK(partial[2] == 3 && partial[3] == 4 && partial[4] == 5 && partial[5] == 6 && partial[6] == 7);
+    CHECK(partial[7] == 2 && partial[8] == 1 && partial[9] == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(ParallelSortTest) {
+    CoreSetup coreSetup;
+    coreSetup.NumJobWorkers = 3;
+    Core::Setup(coreSetup);
+
+    for (int num : { 0, 1, 100, 50000, 100000, 300001 }) {
+        Array<int> values;
+        uint64_t x = 88172645463325252ULL;
+        for (int i = 0; i < num; i++) {
+            values.Add(int(xorshift(x) % 10000) - 5000);
+        }
+        Array<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        if (num > 0) {
+            Array<int> copy = values;
+            Algorithms::ParallelSort(values.MakeSlice());
+            Algorithms::Sort(copy.MakeSlice());
+            CHECK(std::equal(values.begin(), values.end(), expected.begin()));
+            CHECK(std::equal(copy.begin(), copy.end(), expected.begin()));
+        }
+    }
+
+    // with a custom compare function
+    Array<int> values;
+    for (int i = 0; i < 100000; i++) {
+        values.Add(i);
+    }
+    Algorithms::Sort(values.MakeSlice(), [](int a, int b) {
+        return a > b;
+    });
+    CHECK(values[0] == 99999);
+    CHECK(values[99999] == 0);
+    CHECK(std::is_sorted(values.begin(), values.end(), [](int a, int b) { return a > b; }));
+
+    // big Map bulk-adds are sorted in parallel
+    Map<int, int> map;
+    map.BeginBulk();
+    for (int i = 0; i < 100000; i++) {
+        map.AddBulk((i * 7919) % 100000, i);
+    }
+    map.EndBulk();
+    CHECK(map.Size() == 100000);
+    bool mapSorted = true;
+    for (int i = 0; i < map.Size(); i++) {
+        if (map.KeyAtIndex(i) != i) {
+            mapSorted = false;
+        }
+    }
+    CHECK(mapSorted);
+
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(FindIndexTest) {
+    // test every position and the tail loop of the SIMD search
+    for (int num = 0; num < 80; num++) {
+        Array<uint8_t> u8;
+        Array<int16_t> i16;
+        Array<int32_t> i32;
+        Array<uint64_t> u64;
+        Array<float> f32;
+        for (int i = 0; i < num; i++) {
+            u8.Add(uint8_t(i + 1));
+            i16.Add(int16_t(-i - 1));
+            i32.Add(i * 1000);
+            u64.Add(uint64_t(i) << 40);
+            f32.Add(float(i) * 0.5f);
+        }
+        for (int i = 0; i < num; i++) {
+            CHECK(Algorithms::FindIndex(u8.MakeSlice(), uint8_t(i + 1)) == i);
+            CHECK(Algorithms::FindIndex(i16.MakeSlice(), int16_t(-i - 1)) == i);
+            CHECK(Algorithms::FindIndex(i32.MakeSlice(), i * 1000) == i);
+            CHECK(Algorithms::FindIndex(u64.MakeSlice(), uint64_t(i) << 40) == i);
+            CHECK(Algorithms::FindIndex(f32.MakeSlice(), float(i) * 0.5f) == i);
+            CHECK(u64.FindIndexLinear(uint64_t(i) << 40) == i);
+        }
+        if (num > 0) {
+            CHECK(Algorithms::FindIndex(u8.MakeSlice(), uint8_t(0)) == InvalidIndex);
+            CHECK(Algorithms::FindIndex(i32.MakeSlice(), 1) == InvalidIndex);
+            // only the low 32 bits are equal
+            CHECK(Algorithms::FindIndex(u64.MakeSlice(), uint64_t(1) << 41 | 1) == InvalidIndex);
+            CHECK(u64.FindIndexLinear(uint64_t(1) << 36) == InvalidIndex);
+        }
+    }
+
+    // first match is returned, start and end index are respected
+    Array<int> values({ 1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4 });
+    CHECK(Algorithms::FindIndex(values.MakeSlice(), 3) == 2);
+    CHECK(Algorithms::FindIndex(values.MakeSlice(5), 3) == 1);
+    CHECK(values.FindIndexLinear(3) == 2);
+    CHECK(values.FindIndexLinear(3, 3) == 6);
+    CHECK(values.FindIndexLinear(3, 11, 14) == InvalidIndex);
+    CHECK(values.FindIndexLinear(4, 11, 16) == 11);
+
+    // pointers
+    int a = 0, b = 0, c = 0;
+    Array<int*> ptrs({ &a, &b, &c });
+    CHECK(Algorithms::FindIndex(ptrs.MakeSlice(), &c) == 2);
+    CHECK(Algorithms::FindIndex(ptrs.MakeSlice(), (int*)nullptr) == InvalidIndex);
+
+    // slices of arrays with erased front elements
+    values.Erase(0);
+    values.Erase(0);
+    CHECK(values[0] == 3);
+    CHECK(Algorithms::FindIndex(values.MakeSlice(), 3) == 0);
+    CHECK(values.MakeSlice()[1] == 4);
+}
+
+//------------------------------------------------------------------------------
+TEST(SetBulkTest) {
+    Set<int> set;
+    set.Add(5);
+    set.BeginBulk();
+    for (int i = 9; i >= 0; i--) {
+        set.AddBulk(i);
+        set.AddBulk(i);
+    }
+    set.EndBulk();
+    CHECK(set.Size() == 10);
+    for (int i = 0; i < 10; i++) {
+        CHECK(set.ValueAtIndex(i) == i);
+    }
+    CHECK(set.Contains(5));
+    CHECK(!set.Contains(10));
+    set.Add(10);
+    CHECK(set.Size() == 11);
+
+    // bulk-adding to an empty set
+    Set<int> empty;
+    empty.BeginBulk();
+    empty.EndBulk();
+    CHECK(empty.Empty());
+}
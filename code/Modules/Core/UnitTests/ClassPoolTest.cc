@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+//  ClassPoolTest.cc
+//  Test ClassPool and pool-allocated RefCounted classes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/RefCounted.h"
+#include "Core/Ptr.h"
+#include "Core/Containers/Array.h"
+#include "Core/Memory/ClassPool.h"
+#include <thread>
+
+using namespace Oryol;
+
+static int numLiveObjects = 0;
+
+class PooledClass : public RefCounted {
+    OryolClassPoolAllocDecl(PooledClass);
+public:
+    PooledClass() : val(0) { numLiveObjects++; };
+    PooledClass(int v) : val(v) { numLiveObjects++; };
+    virtual ~PooledClass() { numLiveObjects--; };
+    int val;
+};
+
+struct threadedObj {
+    int32_t vals[5];
+};
+
+//------------------------------------------------------------------------------
+TEST(ClassPoolTest) {
+    CHECK(ClassPool<PooledClass>::Capacity() == 0);
+    auto obj0 = PooledClass::Create(5);
+    CHECK(obj0->val == 5);
+    CHECK(obj0->GetRefCount() == 1);
+    CHECK(numLiveObjects == 1);
+    CHECK(ClassPool<PooledClass>::Capacity() == ClassPool<PooledClass>::ChunkSize);
+    CHECK((intptr_t(obj0.get()) & (alignof(PooledClass) - 1)) == 0);
+
+    // releasing the object puts its slot back into the pool
+    PooledClass* ptr0 = obj0.get();
+    obj0 = nullptr;
+    CHECK(numLiveObjects == 0);
+    auto obj1 = PooledClass::Create();
+    CHECK(obj1.get() == ptr0);
+    CHECK(obj1->val == 0);
+
+    // chunked growth
+    Array<Ptr<PooledClass>> objs;
+    const int num = ClassPool<PooledClass>::ChunkSize * 3;
+    for (int i = 0; i < num; i++) {
+        objs.Add(PooledClass::Create(i));
+    }
+    CHECK(numLiveObjects == num + 1);
+    CHECK(ClassPool<PooledClass>::Capacity() == ClassPool<PooledClass>::ChunkSize * 4);
+    bool check = true;
+    for (int i = 0; i < num; i++) {
+        if ((objs[i]->val != i) || (objs[i] == obj1)) {
+            check = false;
+        }
+    }
+    CHECK(check);
+    objs.Clear();
+    obj1 = nullptr;
+    CHECK(numLiveObjects == 0);
+
+    // freed slots are reused before the pool grows
+    for (int i = 0; i < num; i++) {
+        objs.Add(PooledClass::Create(i));
+    }
+    CHECK(ClassPool<PooledClass>::Capacity() == ClassPool<PooledClass>::ChunkSize * 4);
+    objs.Clear();
+}
+
+//------------------------------------------------------------------------------
+TEST(ClassPoolThreadedTest) {
+    // hammer the pool from several threads, each object is filled
+    // with a thread-specific pattern to detect slots handed out twice
+    const int numThreads = 4;
+    const int numIter = 20000;
+    const int numLive = 100;
+    std::atomic<int> errors(0);
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t, &errors] {
+            threadedObj* objs[numLive] = { };
+            for (int i = 0; i < numIter; i++) {
+                const int slot = i % numLive;
+                if (objs[slot]) {
+                    for (int32_t val : objs[slot]->vals) {
+                        if (val != (t * numIter + slot)) {
+                            errors++;
+                        }
+                    }
+                    ClassPool<threadedObj>::Free(objs[slot]);
+                }
+                objs[slot] = (threadedObj*) ClassPool<threadedObj>::Alloc();
+                for (int32_t& val : objs[slot]->vals) {
+                    val = t * numIter + slot;
+                }
+            }
+            for (threadedObj* obj : objs) {
+                ClassPool<threadedObj>::Free(obj);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(errors == 0);
+    CHECK(ClassPool<threadedObj>::Capacity() >= numLive);
+}
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+//  FrameArenaTest.cc
+//  Test FrameArena allocator and containers with custom allocator.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(FrameArenaTest) {
+    FrameArena arena(1024);
+    CHECK(arena.Capacity() == 1024);
+    CHECK(arena.Used() == 0);
+    CHECK(arena.HighWaterMark() == 0);
+
+    // allocations are aligned and bump the arena
+    uint8_t* p0 = (uint8_t*) arena.Alloc(10);
+    CHECK(nullptr != p0);
+    CHECK(arena.Owns(p0));
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(arena.Used() == Memory::RoundUp(10, ORYOL_MAX_PLATFORM_ALIGN));
+    uint8_t* p1 = (uint8_t*) arena.Alloc(100);
+    CHECK(arena.Owns(p1));
+    CHECK(p1 > p0);
+
+    // most recent allocation can grow in place and be freed
+    for (int i = 0; i < 100; i++) {
+        p1[i] = uint8_t(i);
+    }
+    CHECK(arena.ReAlloc(p1, 200) == p1);
+    const int used = arena.Used();
+    arena.Free(p1);
+    CHECK(arena.Used() < used);
+
+    // re-allocating an older allocation moves the content
+    p1 = (uint8_t*) arena.Alloc(16);
+    for (int i = 0; i < 10; i++) {
+        p0[i] = uint8_t(i);
+    }
+    uint8_t* p2 = (uint8_t*) arena.ReAlloc(p0, 64);
+    CHECK(p2 != p0);
+    CHECK(arena.Owns(p2));
+    bool check = true;
+    for (int i = 0; i < 10; i++) {
+        if (p2[i] != i) {
+            check = false;
+        }
+    }
+    CHECK(check);
+
+    // overflow falls back to the heap
+    CHECK(arena.NumOverflows() == 0);
+    void* big = arena.Alloc(2048);
+    CHECK(nullptr != big);
+    CHECK(!arena.Owns(big));
+    CHECK(arena.NumOverflows() == 1);
+    CHECK(arena.Used() > 2048);
+    arena.Free(big);
+
+    // reset throws away everything, but keeps the high-water-mark
+    const int highWater = arena.Used();
+    arena.Reset();
+    CHECK(arena.Used() == 0);
+    CHECK(arena.HighWaterMark() == highWater);
+    void* p3 = arena.Alloc(32);
+    CHECK(p3 == p0);
+
+    // a stale pointer from the previous frame doesn't free the new allocation
+    void* p4 = arena.Alloc(32);
+    const int usedBeforeReset = arena.Used();
+    arena.Reset();
+    void* p5 = arena.Alloc(16);
+    CHECK(p5 == p3);
+    arena.Free(p4);
+    CHECK(arena.Used() == Memory::RoundUp(16, ORYOL_MAX_PLATFORM_ALIGN));
+    CHECK(arena.HighWaterMark() >= usedBeforeReset);
+    arena.Free(p5);
+    CHECK(arena.Used() == 0);
+    arena.ResetStats();
+    CHECK(arena.NumOverflows() == 0);
+    CHECK(arena.HighWaterMark() == arena.Used());
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameArenaContainerTest) {
+    FrameArena arena(64 * 1024);
+
+    Array<int> array;
+    CHECK(nullptr == array.GetAllocator());
+    array.SetAllocator(&arena);
+    CHECK(array.GetAllocator() == &arena);
+    for (int i = 0; i < 100; i++) {
+        array.Add(i);
+    }
+    CHECK(arena.Owns(&array[0]));
+    CHECK(array.Size() == 100);
+    CHECK(array[99] == 99);
+
+    // a copy uses the default allocator, a move takes over the allocator
+    Array<int> copy(array);
+    CHECK(nullptr == copy.GetAllocator());
+    CHECK(!arena.Owns(&copy[0]));
+    CHECK(copy[99] == 99);
+    Array<int> moved(std::move(array));
+    CHECK(moved.GetAllocator() == &arena);
+    CHECK(arena.Owns(&moved[0]));
+    CHECK(moved[50] == 50);
+
+    Buffer buffer;
+    buffer.SetAllocator(&arena);
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    buffer.Add(bytes, sizeof(bytes));
+    buffer.Add(bytes, sizeof(bytes));
+    CHECK(arena.Owns(buffer.Data()));
+    CHECK(buffer.Size() == 16);
+    CHECK(buffer.Data()[15] == 8);
+    Buffer movedBuffer(std::move(buffer));
+    CHECK(movedBuffer.GetAllocator() == &arena);
+    CHECK(nullptr == buffer.GetAllocator());
+
+    StringBuilder builder;
+    builder.SetAllocator(&arena);
+    builder.Append("Hello ");
+    builder.Append("World!");
+    CHECK(arena.Owns(builder.AsCStr()));
+    CHECK(builder.GetString() == "Hello World!");
+    CHECK(!arena.Owns(builder.GetString().AsCStr()));
+}
+
+//------------------------------------------------------------------------------
+TEST(CoreFrameArenaTest) {
+    CoreSetup coreSetup;
+    coreSetup.FrameArenaSize = 4096;
+    Core::Setup(coreSetup);
+    FrameArena* arena = Core::FrameAllocator();
+    CHECK(nullptr != arena);
+    CHECK(arena->Capacity() == 4096);
+    arena->Alloc(128);
+    CHECK(arena->Used() == 128);
+
+    // the post-runloop resets the arena at the end of the frame
+    Core::PostRunLoop()->Run();
+    CHECK(arena->Used() == 0);
+    CHECK(arena->HighWaterMark() == 128);
+    Core::Discard();
+    CHECK(nullptr == Core::FrameAllocator());
+
+    // no frame arena if size is 0
+    coreSetup.FrameArenaSize = 0;
+    Core::Setup(coreSetup);
+    CHECK(nullptr == Core::FrameAllocator());
+    Core::Discard();
+}
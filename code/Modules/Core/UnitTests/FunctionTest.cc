@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//  FunctionTest.cc
+//  Test Function class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Function.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/String/String.h"
+#include <memory>
+
+using namespace Oryol;
+
+namespace {
+int add(int a, int b) {
+    return a + b;
+}
+}
+
+TEST(FunctionTest) {
+    // empty functions
+    Function<int(int, int)> f0;
+    CHECK(!f0);
+    CHECK(!f0.IsInline());
+    Function<int(int, int)> f1(nullptr);
+    CHECK(!f1);
+    int (*nullFunc)(int, int) = nullptr;
+    Function<int(int, int)> f2(nullFunc);
+    CHECK(!f2);
+
+    // function pointer
+    f0 = &add;
+    CHECK(f0);
+    CHECK(f0.IsInline());
+    CHECK(f0(1, 2) == 3);
+
+    // lambda with small capture is stored inline
+    int base = 10;
+    Function<int(int, int)> f3 = [base](int a, int b) { return base + a + b; };
+    CHECK(f3.IsInline());
+    CHECK(f3(1, 2) == 13);
+
+    // move
+    Function<int(int, int)> f4(std::move(f3));
+    CHECK(!f3);
+    CHECK(f4);
+    CHECK(f4(1, 2) == 13);
+    f3 = std::move(f4);
+    CHECK(!f4);
+    CHECK(f3(2, 3) == 15);
+    f3 = nullptr;
+    CHECK(!f3);
+
+    // mutable state in the callable
+    int counter = 0;
+    Function<void()> inc = [&counter] { counter++; };
+    inc();
+    inc();
+    CHECK(counter == 2);
+}
+
+TEST(FunctionStorageTest) {
+    // a capture bigger than the inline storage is heap-allocated
+    StaticArray<int, 16> big;
+    big.Fill(2);
+    Function<int()> f0 = [big] {
+        int sum = 0;
+        for (int val : big) {
+            sum += val;
+        }
+        return sum;
+    };
+    CHECK(!f0.IsInline());
+    CHECK(f0() == 32);
+    Function<int()> f1(std::move(f0));
+    CHECK(!f0);
+    CHECK(!f1.IsInline());
+    CHECK(f1() == 32);
+
+    // ...unless the inline storage is big enough
+    Function<int(), 128> f2 = [big] { return big[0]; };
+    CHECK(f2.IsInline());
+    CHECK(f2() == 2);
+
+    // captured objects are destroyed with the function
+    String str("a string which is not stored inline in the String object");
+    {
+        Function<int()> f3 = [str] { return str.Length(); };
+        CHECK(str.RefCount() == 2);
+        Function<int()> f4(std::move(f3));
+        CHECK(str.RefCount() == 2);
+        CHECK(f4() == str.Length());
+        f4 = [] { return 0; };
+        CHECK(str.RefCount() == 1);
+        f3 = [str] { return str.Length(); };
+        CHECK(str.RefCount() == 2);
+    }
+    CHECK(str.RefCount() == 1);
+
+    // move-only captures
+    std::unique_ptr<int> ptr(new int(42));
+    Function<int()> f5 = [p = std::move(ptr)] { return *p; };
+    CHECK(f5() == 42);
+
+    // functions in an array are moved on re-allocation
+    Array<Function<int(int)>> funcs;
+    for (int i = 0; i < 64; i++) {
+        funcs.Add([i, str](int val) { return i + val + str.Length() * 0; });
+    }
+    CHECK(str.RefCount() == 65);
+    int sum = 0;
+    for (const auto& func : funcs) {
+        sum += func(1);
+    }
+    CHECK(sum == 64 + (63 * 64) / 2);
+    funcs.Clear();
+    CHECK(str.RefCount() == 1);
+}
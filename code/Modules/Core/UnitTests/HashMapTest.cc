@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+
+using namespace Oryol;
+
+// a hasher which puts all keys into the same slot
+struct collidingHasher {
+    uint32_t operator()(int) const {
+        return 0;
+    };
+};
+
+//------------------------------------------------------------------------------
+template<class MAP> static bool
+checkMap(const MAP& map) {
+    // check that all elements can be found at their index
+    for (int i = 0; i < map.Size(); i++) {
+        if (map.FindIndex(map.KeyAtIndex(i)) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(HashMapTest) {
+
+    // test simple insertion of unique elements
+    HashMap<int, int> map;
+    CHECK(map.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(map.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(map.FindIndex(1) == InvalidIndex);
+    map.Add(0, 0);
+    map.Add(3, 3);
+    map.Add(8, 8);
+    map.Add(6, 6);
+    map.Add(4, 4);
+    map.Add(1, 1);
+    map.Add(2, 2);
+    map.Add(7, 7);
+    map.Add(5, 5);
+    CHECK(map.Size() == 9);
+    CHECK(map.Capacity() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(!map.Empty());
+    CHECK(map.Contains(4));
+    CHECK(!map.Contains(11));
+    for (int i = 0; i < 9; i++) {
+        CHECK(map[i] == i);
+    }
+    // elements are stored in insertion order
+    CHECK(map.KeyAtIndex(0) == 0);
+    CHECK(map.KeyAtIndex(1) == 3);
+    CHECK(map.ValueAtIndex(2) == 8);
+    CHECK(checkMap(map));
+
+    // copy construct
+    HashMap<int, int> map1(map);
+    CHECK(map1.Size() == 9);
+    CHECK(map1.Capacity() == 9); // copy trims
+    CHECK(map1.Contains(4));
+    CHECK(!map1.Contains(11));
+    for (int i = 0; i < 9; i++) {
+        CHECK(map1[i] == i);
+    }
+    CHECK(checkMap(map1));
+
+    // copy-assign
+    HashMap<int, int> map2;
+    map2 = map;
+    CHECK(map2.Size() == 9);
+    CHECK(map2.Capacity() == 9);    // copy trims
+    for (int i = 0; i < 9; i++) {
+        CHECK(map2[i] == i);
+    }
+
+    // move-construct
+    HashMap<int, int> map3(std::move(map2));
+    CHECK(map2.Size() == 0);
+    CHECK(map2.Empty());
+    CHECK(!map2.Contains(4));
+    CHECK(map3.Size() == 9);
+    for (int i = 0; i < 9; i++) {
+        CHECK(map3[i] == i);
+    }
+
+    // move-assign
+    HashMap<int, int> map4;
+    map4 = std::move(map3);
+    CHECK(map3.Size() == 0);
+    CHECK(map4.Size() == 9);
+    for (int i = 0; i < 9; i++) {
+        CHECK(map4[i] == i);
+    }
+    // a moved-from map is still usable
+    map3.Add(1, 2);
+    CHECK(map3.Size() == 1);
+    CHECK(map3[1] == 2);
+
+    // AddUnique
+    CHECK(!map.AddUnique(3, 33));
+    CHECK(map[3] == 3);
+    CHECK(map.AddUnique(10, 10));
+    CHECK(map.Size() == 10);
+    CHECK(map[10] == 10);
+
+    // write access
+    map[3] = 33;
+    CHECK(map[3] == 33);
+    const int index = map.FindIndex(3);
+    CHECK(map.KeyAtIndex(index) == 3);
+    map.ValueAtIndex(index) = 3;
+    CHECK(map[3] == 3);
+
+    // erase (the last element is moved into the gap)
+    map.Erase(3);
+    CHECK(map.Size() == 9);
+    CHECK(!map.Contains(3));
+    CHECK(map.KeyAtIndex(1) == 10);
+    CHECK(checkMap(map));
+    map.Erase(3);
+    CHECK(map.Size() == 9);
+    map.EraseIndex(0);
+    CHECK(map.Size() == 8);
+    CHECK(!map.Contains(0));
+    CHECK(checkMap(map));
+    map.EraseIndex(map.Size() - 1);
+    CHECK(map.Size() == 7);
+    CHECK(checkMap(map));
+    for (const auto& kvp : map) {
+        CHECK(kvp.key == kvp.value);
+    }
+
+    // clear keeps the capacity
+    const int capacity = map.Capacity();
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == capacity);
+    CHECK(!map.Contains(4));
+    map.Add(4, 4);
+    CHECK(map[4] == 4);
+
+    // reserve and trim
+    HashMap<int, int> map5;
+    map5.Reserve(100);
+    CHECK(map5.Capacity() == 100);
+    map5.Add(1, 1);
+    map5.Add(2, 2);
+    map5.Trim();
+    CHECK(map5.Capacity() == 2);
+    CHECK(map5[1] == 1);
+    CHECK(map5[2] == 2);
+
+    // bulk mode
+    HashMap<int, int> map6;
+    map6.BeginBulk();
+    for (int i = 0; i < 100; i++) {
+        map6.AddBulk(i * 7, i);
+    }
+    map6.EndBulk();
+    CHECK(map6.Size() == 100);
+    for (int i = 0; i < 100; i++) {
+        CHECK(map6[i * 7] == i);
+    }
+    CHECK(!map6.Contains(1));
+    CHECK(checkMap(map6));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStringTest) {
+    HashMap<String, int> map;
+    map.Add("Bla", 1);
+    map.Add("Blub", 2);
+    map.Add("Blob", 3);
+    CHECK(map.Size() == 3);
+    CHECK(map.Contains("Bla"));
+    CHECK(!map.Contains("Blubber"));
+    CHECK(map["Blub"] == 2);
+    map.Erase("Bla");
+    CHECK(!map.Contains("Bla"));
+    CHECK(map["Blob"] == 3);
+
+    HashMap<StringAtom, int> atomMap;
+    atomMap.Add(StringAtom("file"), 1);
+    atomMap.Add(StringAtom("http"), 2);
+    CHECK(atomMap[StringAtom("file")] == 1);
+    CHECK(atomMap[StringAtom("http")] == 2);
+    CHECK(!atomMap.Contains(StringAtom("https")));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStressTest) {
+    // many elements, with erasing and re-adding
+    const int num = 10000;
+    HashMap<int, int> map;
+    for (int i = 0; i < num; i++) {
+        map.Add(i, i * 2);
+    }
+    CHECK(map.Size() == num);
+    CHECK(checkMap(map));
+    for (int i = 0; i < num; i += 2) {
+        map.Erase(i);
+    }
+    CHECK(map.Size() == num / 2);
+    bool allOk = true;
+    for (int i = 0; i < num; i++) {
+        if ((i & 1) != int(map.Contains(i))) {
+            allOk = false;
+        }
+        else if ((i & 1) && (map[i] != i * 2)) {
+            allOk = false;
+        }
+    }
+    CHECK(allOk);
+    CHECK(checkMap(map));
+    for (int i = 0; i < num; i += 2) {
+        CHECK(map.AddUnique(i, i * 2));
+    }
+    CHECK(map.Size() == num);
+    CHECK(checkMap(map));
+
+    // worst-case: all keys collide
+    HashMap<int, int, collidingHasher> collMap;
+    for (int i = 0; i < 100; i++) {
+        collMap.Add(i, i);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        collMap.Erase(i);
+    }
+    CHECK(collMap.Size() == 66);
+    CHECK(checkMap(collMap));
+    for (int i = 0; i < 100; i++) {
+        CHECK(collMap.Contains(i) == ((i % 3) != 0));
+    }
+}
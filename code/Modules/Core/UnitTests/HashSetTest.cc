@@ -16,7 +16,7 @@ struct IntHasher {
 
 TEST(HashSetTest) {
     
-    HashSet<int, IntHasher, 4> hashSet;
+    HashSet<int, IntHasher> hashSet;
     CHECK(hashSet.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
     CHECK(hashSet.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     CHECK(hashSet.Size() == 0);
@@ -45,7 +45,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet.Contains(123));
     
     // copy-construction
-    HashSet<int, IntHasher, 4> hashSet1(hashSet);
+    HashSet<int, IntHasher> hashSet1(hashSet);
     CHECK(hashSet1.Size() == 8);
     CHECK(!hashSet1.Empty());
     CHECK(hashSet1.Contains(1));
@@ -59,7 +59,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet1.Contains(123));
     
     // copy-assignment
-    HashSet<int, IntHasher, 4> hashSet2;
+    HashSet<int, IntHasher> hashSet2;
     hashSet2 = hashSet;
     CHECK(hashSet2.Size() == 8);
     CHECK(!hashSet2.Empty());
@@ -74,7 +74,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet2.Contains(123));
     
     // move-construction
-    HashSet<int, IntHasher, 4> hashSet3(std::move(hashSet2));
+    HashSet<int, IntHasher> hashSet3(std::move(hashSet2));
     CHECK(hashSet2.Size() == 0);
     CHECK(hashSet2.Empty());
     CHECK(hashSet3.Size() == 8);
@@ -90,7 +90,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet3.Contains(123));
     
     // move-assignment
-    HashSet<int, IntHasher, 4> hashSet4;
+    HashSet<int, IntHasher> hashSet4;
     hashSet4 = std::move(hashSet3);
     CHECK(hashSet3.Size() == 0);
     CHECK(hashSet3.Empty());
@@ -137,3 +137,90 @@ TEST(HashSetTest) {
     CHECK(hashSet4.Size() == 0);
     CHECK(!hashSet4.Contains(10));
 }
+
+// a hasher which puts all values into the same probe sequence
+struct CollidingHasher {
+    uint32_t operator()(int val) const {
+        return 0;
+    };
+};
+
+TEST(HashSetGrowTest) {
+
+    // many elements, the set must grow
+    const int num = 100000;
+    HashSet<int> hashSet;
+    CHECK(hashSet.Capacity() == 0);
+    for (int i = 0; i < num; i++) {
+        hashSet.Add(i * 3);
+    }
+    CHECK(hashSet.Size() == num);
+    CHECK(hashSet.Capacity() >= num);
+    bool allOk = true;
+    for (int i = 0; i < num * 3; i++) {
+        if (hashSet.Contains(i) != ((i % 3) == 0)) {
+            allOk = false;
+        }
+    }
+    CHECK(allOk);
+    CHECK(hashSet.Find(3) && (*hashSet.Find(3) == 3));
+    CHECK(nullptr == hashSet.Find(4));
+
+    // erase and re-add many times, deleted slots must be recycled
+    const int capacity = hashSet.Capacity();
+    for (int round = 0; round < 8; round++) {
+        for (int i = 0; i < num; i += 2) {
+            hashSet.Erase(i * 3);
+        }
+        CHECK(hashSet.Size() == num / 2);
+        for (int i = 0; i < num; i += 2) {
+            hashSet.Add(i * 3);
+        }
+        CHECK(hashSet.Size() == num);
+    }
+    CHECK(hashSet.Capacity() == capacity);
+    allOk = true;
+    for (int i = 0; i < num; i++) {
+        if (!hashSet.Contains(i * 3)) {
+            allOk = false;
+        }
+    }
+    CHECK(allOk);
+    hashSet.Erase(1);
+    CHECK(hashSet.Size() == num);
+
+    // clear keeps capacity
+    hashSet.Clear();
+    CHECK(hashSet.Empty());
+    CHECK(hashSet.Capacity() == capacity);
+    CHECK(!hashSet.Contains(3));
+    hashSet.Add(3);
+    CHECK(hashSet.Contains(3));
+
+    // reserve
+    HashSet<int> hashSet1;
+    hashSet1.Reserve(1000);
+    const int capacity1 = hashSet1.Capacity();
+    CHECK(capacity1 >= 1000);
+    for (int i = 0; i < 1000; i++) {
+        hashSet1.Add(i);
+    }
+    CHECK(hashSet1.Capacity() == capacity1);
+
+    // worst case, all values have the same hash
+    HashSet<int, CollidingHasher> hashSet2;
+    for (int i = 0; i < 200; i++) {
+        hashSet2.Add(i);
+    }
+    for (int i = 0; i < 200; i += 2) {
+        hashSet2.Erase(i);
+    }
+    CHECK(hashSet2.Size() == 100);
+    allOk = true;
+    for (int i = 0; i < 200; i++) {
+        if (hashSet2.Contains(i) != ((i & 1) == 1)) {
+            allOk = false;
+        }
+    }
+    CHECK(allOk);
+}
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//  JobsTest.cc
+//  Test the job system.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Jobs/Jobs.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/StringAtom.h"
+#include <atomic>
+#include <thread>
+
+using namespace Oryol;
+
+TEST(JobsTest) {
+    CoreSetup coreSetup;
+    coreSetup.NumJobWorkers = 3;
+    Core::Setup(coreSetup);
+    CHECK(Jobs::IsValid());
+    #if ORYOL_HAS_THREADS
+    CHECK(Jobs::NumWorkers() == 3);
+    #endif
+
+    // simple jobs with a counter
+    std::atomic<int> sum(0);
+    JobCounter counter;
+    CHECK(counter.IsDone());
+    for (int i = 1; i <= 1000; i++) {
+        Jobs::Run([&sum, i] {
+            sum += i;
+        }, &counter);
+    }
+    Jobs::Wait(&counter);
+    CHECK(counter.IsDone());
+    CHECK(counter.Value() == 0);
+    CHECK(sum == 500500);
+
+    // dependencies: each stage must see the result of the previous stage
+    int stage0 = 0, stage1 = 0, stage2 = 0;
+    JobCounter done0, done1, done2;
+    Jobs::Run([&stage0] {
+        std::this_thread::yield();
+        stage0 = 1;
+    }, &done0);
+    Jobs::RunAfter(&done0, [&stage0, &stage1] {
+        stage1 = stage0 + 1;
+    }, &done1);
+    Jobs::RunAfter(&done1, [&stage1, &stage2] {
+        stage2 = stage1 + 1;
+    }, &done2);
+    Jobs::Wait(&done2);
+    CHECK(done0.IsDone() && done1.IsDone());
+    CHECK(stage2 == 3);
+
+    // ParallelFor over a slice
+    Array<int> values;
+    for (int i = 0; i < 10000; i++) {
+        values.Add(i);
+    }
+    Jobs::ParallelFor(values.MakeSlice(), [](int& val) {
+        val *= 2;
+    });
+    bool allDoubled = true;
+    for (int i = 0; i < values.Size(); i++) {
+        allDoubled &= values[i] == i * 2;
+    }
+    CHECK(allDoubled);
+
+    // ParallelFor over an index range, with explicit batch size and nesting
+    std::atomic<int> numItems(0);
+    std::atomic<int> numBatches(0);
+    Jobs::ParallelFor(100, [&numItems, &numBatches](int begin, int end) {
+        numBatches += (end - begin) == 10 ? 1 : 0;
+        Jobs::ParallelFor(end - begin, [&numItems](int innerBegin, int innerEnd) {
+            numItems += innerEnd - innerBegin;
+        });
+    }, 10);
+    CHECK(numBatches == 10);
+    CHECK(numItems == 100);
+
+    #if ORYOL_HAS_THREADS
+    // worker threads have their own RunLoops and StringAtom tables
+    std::atomic<int> numEntered(0);
+    std::atomic<int> numAtoms(0);
+    StringAtom mainAtom("JobsTest");
+    JobCounter atomCounter;
+    for (int i = 0; i < 64; i++) {
+        Jobs::Run([&numEntered, &numAtoms, &mainAtom] {
+            if (Core::PreRunLoop() && Core::PostRunLoop()) {
+                numEntered++;
+            }
+            StringAtom atom("JobsTest");
+            if (atom == mainAtom) {
+                numAtoms++;
+            }
+        }, &atomCounter);
+    }
+    Jobs::Wait(&atomCounter);
+    CHECK(numEntered == 64);
+    CHECK(numAtoms == 64);
+
+    // jobs started on a thread outside of the job system
+    std::atomic<int> numForeign(0);
+    JobCounter foreignCounter;
+    std::thread thread([&numForeign, &foreignCounter] {
+        for (int i = 0; i < 100; i++) {
+            Jobs::Run([&numForeign] {
+                numForeign++;
+            }, &foreignCounter);
+        }
+        Jobs::Wait(&foreignCounter);
+    });
+    thread.join();
+    CHECK(numForeign == 100);
+    #endif
+
+    // pending fire-and-forget jobs run before Core::Discard() returns
+    std::atomic<int> numPending(0);
+    for (int i = 0; i < 100; i++) {
+        Jobs::Run([&numPending] {
+            numPending++;
+        });
+    }
+    Core::Discard();
+    CHECK(!Jobs::IsValid());
+    CHECK(numPending == 100);
+}
+
+TEST(JobsNoWorkersTest) {
+    // without worker threads, jobs run on the calling thread
+    CoreSetup coreSetup;
+    coreSetup.NumJobWorkers = 0;
+    Core::Setup(coreSetup);
+    CHECK(Jobs::NumWorkers() == 0);
+    int sum = 0;
+    JobCounter counter;
+    Jobs::Run([&sum] {
+        sum += 1;
+    }, &counter);
+    CHECK(counter.IsDone());
+    CHECK(sum == 1);
+    Jobs::RunAfter(&counter, [&sum] {
+        sum += 2;
+    });
+    CHECK(sum == 3);
+    Jobs::ParallelFor(10, [&sum](int begin, int end) {
+        sum += end - begin;
+    });
+    CHECK(sum == 13);
+    Jobs::Wait(&counter);
+    Core::Discard();
+}
@@ -6,6 +6,12 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
 #include "Core/Logger.h"
+#include "Core/Containers/Array.h"
+#include "Core/Metrics/Metrics.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <atomic>
 
 using namespace Oryol;
 
@@ -54,4 +60,163 @@ TEST(LogTest) {
     test_log();
 }
 
+#if ORYOL_HAS_THREADS
+// a logger which records thread index and sequence number of messages
+class RecordLogger : public Logger {
+    OryolClassDecl(RecordLogger);
+public:
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        char buf[512];
+        std::vsnprintf(buf, sizeof(buf), msg, args);
+        int thread = 0, seq = 0;
+        if (2 == std::sscanf(buf, "async %d %d", &thread, &seq)) {
+            Records.Add(thread * 1000 + seq);
+            NumRecords++;
+        }
+        else {
+            Other.Add(l);
+        }
+    };
+    Array<int> Records;
+    Array<Log::Level> Other;
+    std::atomic<int> NumRecords{0};
+};
+
+TEST(LogAsyncTest) {
+    CHECK(!Log::IsAsync());
+    const int numLoggers = Log::GetNumLoggers();
+    Ptr<RecordLogger> logger = RecordLogger::Create();
+    Log::AddLogger(logger);
+    Log::StartAsync(64);
+    CHECK(Log::IsAsync());
+
+    // messages from several threads, the queue is small enough that
+    // some messages may be dropped
+    const int64_t dropped = Log::NumDropped();
+    const int numThreads = 4;
+    const int numMessages = 200;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([i] {
+            for (int j = 0; j < numMessages; j++) {
+                Log::Dbg("async %d %d\n", i, j);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    Log::Flush();
+    const int numDropped = int(Log::NumDropped() - dropped);
+    CHECK(logger->Records.Size() + numDropped == numThreads * numMessages);
+    // messages of each thread must arrive in order
+    int lastSeq[numThreads] = { -1, -1, -1, -1 };
+    for (int rec : logger->Records) {
+        const int thread = rec / 1000;
+        const int seq = rec % 1000;
+        CHECK(seq > lastSeq[thread]);
+        lastSeq[thread] = seq;
+    }
+    logger->Records.Clear();
+    logger->Other.Clear();
+
+    // errors and long messages are printed synchronously, after
+    // the pending messages
+    Log::Dbg("async 0 1\n");
+    Log::Error("error\n");
+    CHECK(logger->Records.Size() == 1);
+    CHECK(logger->Other.Size() == 1);
+    if (1 == logger->Other.Size()) {
+        CHECK(logger->Other[0] == Log::Level::Error);
+    }
+    char longMsg[Log::MaxAsyncMessageLength + 16];
+    std::memset(longMsg, 'x', sizeof(longMsg) - 1);
+    longMsg[sizeof(longMsg) - 1] = 0;
+    Log::Dbg("async 0 2\n");
+    Log::Warn("%s\n", longMsg);
+    CHECK(logger->Records.Size() == 2);
+    CHECK(logger->Other.Size() == 2);
+
+    Log::Info("async 0 3\n");
+    Log::StopAsync();
+    CHECK(!Log::IsAsync());
+    CHECK(logger->Records.Size() == 3);
+    Log::RemoveLogger(logger);
+    CHECK(Log::GetNumLoggers() == numLoggers);
+}
+
+TEST(LogAsyncStopTest) {
+    Ptr<RecordLogger> logger = RecordLogger::Create();
+    Log::AddLogger(logger);
+
+    // start and stop async logging while other threads are logging
+    const int64_t dropped = Log::NumDropped();
+    const int numThreads = 4;
+    const int numMessages = 5000;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([i] {
+            for (int j = 0; j < numMessages; j++) {
+                Log::Dbg("async %d %d\n", i, j % 1000);
+            }
+        });
+    }
+    for (int i = 0; i < 20; i++) {
+        Log::StartAsync(64);
+        std::this_thread::yield();
+        Log::StopAsync();
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    CHECK(!Log::IsAsync());
+    const int numDropped = int(Log::NumDropped() - dropped);
+    CHECK(logger->Records.Size() + numDropped == numThreads * numMessages);
+
+    // a message arrives without Flush()
+    Log::StartAsync(64);
+    const int numRecords = logger->NumRecords;
+    Log::Dbg("async 0 0\n");
+    for (int i = 0; (i < 10000) && (logger->NumRecords == numRecords); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(logger->NumRecords == numRecords + 1);
+    Log::StopAsync();
+    Log::RemoveLogger(logger);
+}
+
+// a logger which records a metric
+class MetricLogger : public Logger {
+    OryolClassDecl(MetricLogger);
+public:
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        static const Metric printed = Metrics::Counter("test.log.printed");
+        Metrics::Add(printed, 1);
+        NumPrinted++;
+    };
+    std::atomic<int> NumPrinted{0};
+};
+
+TEST(LogAsyncThreadExitTest) {
+    // the async log thread hands its metric slots back when it stops
+    Ptr<MetricLogger> logger = MetricLogger::Create();
+    Log::AddLogger(logger);
+    int numSlots = 0;
+    for (int i = 0; i < 32; i++) {
+        Log::StartAsync(64);
+        Log::Dbg("async 0 %d\n", i);
+        // wait until the log thread has printed the message
+        for (int j = 0; (j < 10000) && (logger->NumPrinted == i); j++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        Log::StopAsync();
+        if (0 == i) {
+            numSlots = Metrics::NumThreadSlots();
+        }
+    }
+    CHECK(Metrics::NumThreadSlots() == numSlots);
+    Log::RemoveLogger(logger);
+}
+#endif
+
 
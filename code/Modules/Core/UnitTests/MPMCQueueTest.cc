@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//  MPMCQueueTest.cc
+//  Test MPMCQueue functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/String/String.h"
+#include <atomic>
+#include <thread>
+
+using namespace Oryol;
+
+TEST(MPMCQueueTest) {
+    MPMCQueue<int> queue;
+    CHECK(!queue.IsValid());
+    queue.Setup(7);
+    CHECK(queue.IsValid());
+    CHECK(queue.Capacity() == 8);
+    CHECK(queue.Empty());
+
+    // fill and drain a few times to wrap around
+    int val = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.Enqueue(round * 8 + i));
+        }
+        CHECK(!queue.Enqueue(123));
+        CHECK(queue.Size() == 8);
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.Dequeue(val));
+            CHECK(val == round * 8 + i);
+        }
+        CHECK(!queue.Dequeue(val));
+        CHECK(queue.Empty());
+    }
+
+    // batches
+    int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    int out[10] = { };
+    CHECK(queue.EnqueueBatch(in, 3) == 3);
+    CHECK(queue.EnqueueBatch(in + 3, 7) == 5);
+    CHECK(queue.EnqueueBatch(in, 1) == 0);
+    CHECK(queue.DequeueBatch(out, 6) == 6);
+    CHECK(queue.DequeueBatch(out + 6, 4) == 2);
+    CHECK(queue.DequeueBatch(out, 4) == 0);
+    for (int i = 0; i < 8; i++) {
+        CHECK(out[i] == i);
+    }
+    queue.Discard();
+    CHECK(!queue.IsValid());
+
+    // elements left in the queue are destroyed
+    MPMCQueue<String> strQueue;
+    strQueue.Setup(4);
+    CHECK(strQueue.Enqueue(String("Bla")));
+    CHECK(strQueue.Enqueue(String("Blub")));
+    String res;
+    CHECK(strQueue.Dequeue(res));
+    CHECK(res == "Bla");
+}
+
+TEST(MPMCQueueThreadedTest) {
+    // several producers and consumers, every element must be received
+    // exactly once, and the elements of one producer must arrive in
+    // order at each consumer
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numPerProducer = 50000;
+    MPMCQueue<int> queue;
+    queue.Setup(256);
+    std::atomic<int> numReceived(0);
+    std::atomic<int> errors(0);
+    static std::atomic<uint8_t> received[numProducers * numPerProducer];
+    for (auto& r : received) {
+        r.store(0, std::memory_order_relaxed);
+    }
+
+    std::thread producers[numProducers];
+    for (int p = 0; p < numProducers; p++) {
+        producers[p] = std::thread([&queue, p] {
+            int batch[8];
+            int i = 0;
+            while (i < numPerProducer) {
+                if (p & 1) {
+                    int n = 0;
+                    for (; (n < 8) && ((i + n) < numPerProducer); n++) {
+                        batch[n] = p * numPerProducer + i + n;
+                    }
+                    int done = 0;
+                    while (done < n) {
+                        done += queue.EnqueueBatch(batch + done, n - done);
+                    }
+                    i += n;
+                }
+                else {
+                    while (!queue.Enqueue(p * numPerProducer + i)) {
+                        std::this_thread::yield();
+                    }
+                    i++;
+                }
+            }
+        });
+    }
+    std::thread consumers[numConsumers];
+    for (int c = 0; c < numConsumers; c++) {
+        consumers[c] = std::thread([&queue, &numReceived, &errors, c] {
+            int last[numProducers];
+            for (int& l : last) {
+                l = -1;
+            }
+            int batch[8];
+            while (numReceived.load(std::memory_order_relaxed) < numProducers * numPerProducer) {
+                const int n = queue.DequeueBatch(batch, (c & 1) ? 8 : 1);
+                for (int i = 0; i < n; i++) {
+                    const int val = batch[i];
+                    const int p = val / numPerProducer;
+                    if ((val <= last[p]) || (0 != received[val].fetch_add(1))) {
+                        errors++;
+                    }
+                    last[p] = val;
+                }
+                if (0 == n) {
+                    std::this_thread::yield();
+                }
+                numReceived += n;
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+    CHECK(errors == 0);
+    CHECK(numReceived == numProducers * numPerProducer);
+    CHECK(queue.Empty());
+}
@@ -6,6 +6,9 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Core.h"
 
 using namespace Oryol;
 
@@ -156,3 +159,24 @@ TEST(MapTest) {
         testMap.Erase(counter);
     }
 }
+
+TEST(MapBulkStringAtomTest) {
+    // EndBulk() must sort on the calling thread, StringAtoms can't be
+    // moved to job worker threads
+    CoreSetup coreSetup;
+    coreSetup.NumJobWorkers = 3;
+    Core::Setup(coreSetup);
+    StringBuilder strBuilder;
+    Map<StringAtom, int> map;
+    map.BeginBulk();
+    for (int i = 0; i < 40000; i++) {
+        strBuilder.Format(32, "key%d", (i * 7919) % 40000);
+        map.AddBulk(StringAtom(strBuilder.AsCStr()), i);
+    }
+    map.EndBulk();
+    CHECK(map.Size() == 40000);
+    for (int i = 1; i < map.Size(); i++) {
+        CHECK(map.KeyAtIndex(i - 1) < map.KeyAtIndex(i));
+    }
+    Core::Discard();
+}
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+//  MemoryTrackerTest.cc
+//  Test memory tracking by category and thread.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include <thread>
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MemoryCategoryTest) {
+    CHECK(MemoryTracker::Category() == MemoryCategory::General);
+    {
+        o_memory_scope(IO);
+        if (MemoryTracker::IsEnabled()) {
+            CHECK(MemoryTracker::Category() == MemoryCategory::IO);
+            {
+                o_memory_scope(Gfx);
+                CHECK(MemoryTracker::Category() == MemoryCategory::Gfx);
+            }
+            CHECK(MemoryTracker::Category() == MemoryCategory::IO);
+        }
+    }
+    CHECK(MemoryTracker::Category() == MemoryCategory::General);
+    CHECK(0 == std::strcmp(MemoryCategory::ToString(MemoryCategory::StringAtom), "StringAtom"));
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerTest) {
+    const MemorySnapshot before = MemoryTracker::TakeSnapshot();
+    void* p0 = nullptr;
+    void* p1 = nullptr;
+    {
+        o_memory_scope(App);
+        p0 = Memory::Alloc(100);
+        p1 = Memory::Alloc(28);
+        CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    }
+    MemorySnapshot diff = MemoryTracker::TakeSnapshot().Diff(before);
+    if (MemoryTracker::IsEnabled()) {
+        CHECK(diff.Categories[MemoryCategory::App].LiveBytes == 128);
+        CHECK(diff.Categories[MemoryCategory::App].NumLiveAllocs == 2);
+        CHECK(diff.Categories[MemoryCategory::App].NumAllocs == 2);
+        CHECK(diff.Categories[MemoryCategory::App].PeakBytes >= 128);
+        CHECK(diff.Total().LiveBytes == 128);
+    }
+    else {
+        CHECK(diff.NumThreads == 0);
+        CHECK(diff.Total().LiveBytes == 0);
+    }
+
+    // re-allocation keeps the category
+    p0 = Memory::ReAlloc(p0, 200);
+    diff = MemoryTracker::TakeSnapshot().Diff(before);
+    if (MemoryTracker::IsEnabled()) {
+        CHECK(diff.Categories[MemoryCategory::App].LiveBytes == 228);
+        CHECK(diff.Categories[MemoryCategory::App].NumLiveAllocs == 2);
+        CHECK(diff.Categories[MemoryCategory::General].LiveBytes == 0);
+    }
+
+    // memory freed on another thread is charged to the allocating thread
+    std::thread thread([p1]() {
+        MemoryTracker::SetThreadName("freeThread");
+        Memory::Free(p1);
+        MemoryTracker::ReleaseThreadCounters();
+    });
+    thread.join();
+    Memory::Free(p0);
+    diff = MemoryTracker::TakeSnapshot().Diff(before);
+    CHECK(diff.Categories[MemoryCategory::App].LiveBytes == 0);
+    CHECK(diff.Categories[MemoryCategory::App].NumLiveAllocs == 0);
+    if (MemoryTracker::IsEnabled()) {
+        CHECK(diff.Categories[MemoryCategory::App].NumAllocs == 3);
+        CHECK(diff.NumThreads >= 2);
+        diff.Dump();
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerThreadChurnTest) {
+    // threads which release their counters don't fill up the thread table
+    const MemorySnapshot before = MemoryTracker::TakeSnapshot();
+    const int numThreads = MemorySnapshot::MaxThreads * 2;
+    void* ptrs[numThreads] = { };
+    for (int i = 0; i < numThreads; i++) {
+        std::thread thread([&ptrs, i]() {
+            MemoryTracker::SetThreadName("churnThread");
+            o_memory_scope(App);
+            ptrs[i] = Memory::Alloc(16);
+            MemoryTracker::ReleaseThreadCounters();
+        });
+        thread.join();
+    }
+    MemorySnapshot diff = MemoryTracker::TakeSnapshot().Diff(before);
+    if (MemoryTracker::IsEnabled()) {
+        CHECK(diff.NumThreads <= (before.NumThreads + 1));
+        CHECK(diff.NumThreads < MemorySnapshot::MaxThreads);
+        CHECK(diff.Categories[MemoryCategory::App].LiveBytes == numThreads * 16);
+        CHECK(diff.Categories[MemoryCategory::App].NumAllocs == numThreads);
+    }
+
+    // memory of exited threads can still be freed
+    for (void* ptr : ptrs) {
+        Memory::Free(ptr);
+    }
+    diff = MemoryTracker::TakeSnapshot().Diff(before);
+    CHECK(diff.Categories[MemoryCategory::App].LiveBytes == 0);
+    CHECK(diff.Categories[MemoryCategory::App].NumLiveAllocs == 0);
+}
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//  MetricsTest.cc
+//  Test Metrics registry.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Logger.h"
+#include "Core/Ptr.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace Oryol;
+
+class MetricsRecordLogger : public Logger {
+    OryolClassDecl(MetricsRecordLogger);
+public:
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        char buf[256];
+        std::vsnprintf(buf, sizeof(buf), msg, args);
+        if (std::strstr(buf, "test.dump.counter")) {
+            this->numMatches++;
+        }
+        this->numLines++;
+    };
+    int numLines = 0;
+    int numMatches = 0;
+};
+
+TEST(MetricsRegistryTest) {
+    const int numMetrics = Metrics::NumMetrics();
+    const Metric counter = Metrics::Counter("test.counter");
+    const Metric gauge = Metrics::Gauge("test.gauge");
+    const Metric histogram = Metrics::Histogram("test.histogram");
+    CHECK(counter.IsValid() && gauge.IsValid() && histogram.IsValid());
+    CHECK(counter.Type == MetricType::Counter);
+    CHECK(gauge.Type == MetricType::Gauge);
+    CHECK(histogram.Type == MetricType::Histogram);
+    CHECK(Metrics::NumMetrics() == numMetrics + 3);
+
+    // registering again returns the same handle
+    const Metric counter1 = Metrics::Counter("test.counter");
+    CHECK(counter1.Index == counter.Index);
+    CHECK(counter1.Slot == counter.Slot);
+    CHECK(Metrics::NumMetrics() == numMetrics + 3);
+    CHECK(Metrics::Lookup("test.gauge").Index == gauge.Index);
+    CHECK(!Metrics::Lookup("test.unknown").IsValid());
+
+    Metrics::Add(counter, 3);
+    Metrics::Add(counter, 4);
+    Metrics::Set(gauge, 10);
+    Metrics::Add(gauge, -3);
+    Metrics::Record(histogram, 0);
+    Metrics::Record(histogram, 3);
+    Metrics::Record(histogram, Duration::FromMicroSeconds(100.0));
+
+    MetricsSnapshot snapshot = Metrics::Snapshot();
+    const MetricsSnapshot::Value* c = snapshot.Find("test.counter");
+    const MetricsSnapshot::Value* g = snapshot.Find("test.gauge");
+    const MetricsSnapshot::Value* h = snapshot.Find("test.histogram");
+    CHECK(c && g && h);
+    CHECK(nullptr == snapshot.Find("test.unknown"));
+    CHECK(c->Type == MetricType::Counter);
+    CHECK(c->Total == 7);
+    CHECK(g->Total == 7);
+    CHECK(h->Total == 3);
+    CHECK(h->Sum == 103);
+    CHECK_CLOSE(h->Mean(), 103.0 / 3.0, 0.001);
+    CHECK(h->Buckets[0] == 1);
+    CHECK(h->Buckets[2] == 1);
+    CHECK(h->Buckets[7] == 1);
+    CHECK(h->Percentile(0.5) == 4);
+    CHECK(h->Percentile(1.0) == 128);
+
+    // frame rollover
+    Metrics::NextFrame();
+    Metrics::Add(counter, 5);
+    Metrics::Record(histogram, 1);
+    Metrics::NextFrame();
+    snapshot = Metrics::Snapshot();
+    c = snapshot.Find("test.counter");
+    g = snapshot.Find("test.gauge");
+    h = snapshot.Find("test.histogram");
+    CHECK(c->Total == 12);
+    CHECK(c->LastFrame == 5);
+    CHECK(g->LastFrame == 7);
+    CHECK(h->Total == 4);
+    CHECK(h->LastFrame == 1);
+    CHECK(h->LastFrameSum == 1);
+    CHECK(h->LastFrameBuckets[1] == 1);
+    CHECK(h->LastFrameBuckets[7] == 0);
+    Metrics::NextFrame();
+    CHECK(Metrics::Snapshot().Find("test.counter")->LastFrame == 0);
+}
+
+TEST(MetricsBucketTest) {
+    CHECK(MetricsSnapshot::BucketIndex(-5) == 0);
+    CHECK(MetricsSnapshot::BucketIndex(0) == 0);
+    CHECK(MetricsSnapshot::BucketIndex(1) == 1);
+    CHECK(MetricsSnapshot::BucketIndex(2) == 2);
+    CHECK(MetricsSnapshot::BucketIndex(3) == 2);
+    CHECK(MetricsSnapshot::BucketIndex(4) == 3);
+    CHECK(MetricsSnapshot::BucketIndex(1000) == 10);
+    CHECK(MetricsSnapshot::BucketIndex(int64_t(1) << 40) == MetricsSnapshot::NumBuckets - 1);
+    CHECK(MetricsSnapshot::BucketUpperBound(0) == 1);
+    CHECK(MetricsSnapshot::BucketUpperBound(10) == 1024);
+}
+
+TEST(MetricsThreadTest) {
+    const Metric counter = Metrics::Counter("test.thread.counter");
+    const Metric histogram = Metrics::Histogram("test.thread.histogram");
+    const int numThreads = 4;
+    const int numIters = 10000;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([counter, histogram]() {
+            for (int j = 0; j < numIters; j++) {
+                Metrics::Add(counter, 1);
+                Metrics::Record(histogram, j & 15);
+            }
+            Metrics::ReleaseThreadSlots();
+        });
+    }
+    // snapshots while the threads are running
+    for (int i = 0; i < 10; i++) {
+        MetricsSnapshot snapshot = Metrics::Snapshot();
+        CHECK(snapshot.Find("test.thread.counter")->Total <= numThreads * numIters);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    MetricsSnapshot snapshot = Metrics::Snapshot();
+    CHECK(snapshot.Find("test.thread.counter")->Total == numThreads * numIters);
+    CHECK(snapshot.Find("test.thread.histogram")->Total == numThreads * numIters);
+    CHECK(snapshot.Find("test.thread.histogram")->Sum == numThreads * (numIters / 16) * (15 * 16 / 2));
+
+    // released slot blocks keep their values when reused by another thread
+    std::thread t([counter]() {
+        Metrics::Add(counter, 1);
+    });
+    t.join();
+    CHECK(Metrics::Snapshot().Find("test.thread.counter")->Total == numThreads * numIters + 1);
+}
+
+TEST(MetricsDumpTest) {
+    const Metric counter = Metrics::Counter("test.dump.counter");
+    Metrics::Add(counter, 1);
+    Ptr<MetricsRecordLogger> logger = MetricsRecordLogger::Create();
+    Metrics::Dump(logger);
+    CHECK(logger->numMatches == 1);
+    CHECK(logger->numLines == Metrics::NumMetrics() + 1);
+
+    // periodic dump
+    logger->numMatches = 0;
+    Metrics::SetDumpInterval(2, logger);
+    for (int i = 0; i < 6; i++) {
+        Metrics::NextFrame();
+    }
+    Metrics::SetDumpInterval(0, nullptr);
+    CHECK(logger->numMatches == 3);
+    Metrics::NextFrame();
+    CHECK(logger->numMatches == 3);
+}
@@ -5,6 +5,8 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RunLoop.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/String/String.h"
 
 using namespace Oryol;
 
@@ -28,4 +30,116 @@ TEST(RunLoopTest) {
     runLoop.Run();
     CHECK(x == 2);
     CHECK(y == 4);
+    CHECK(runLoop.NumCallbacks() == 0);
+}
+
+TEST(RunLoopPriorityTest) {
+    RunLoop runLoop;
+    Array<int> calls;
+    runLoop.Add([&calls] { calls.Add(1); }, 10);
+    runLoop.Add([&calls] { calls.Add(2); }, -5);
+    runLoop.Add([&calls] { calls.Add(3); }, 10);
+    auto id4 = runLoop.Add([&calls] { calls.Add(4); });
+    CHECK(runLoop.NumCallbacks() == 4);
+    runLoop.Run();
+    CHECK(calls.Size() == 4);
+    CHECK((calls[0] == 2) && (calls[1] == 4) && (calls[2] == 1) && (calls[3] == 3));
+
+    // callbacks added during Run() are called from the next frame on,
+    // removed callbacks are not called anymore, even in the same frame
+    calls.Clear();
+    RunLoop::Id id5 = RunLoop::InvalidId;
+    RunLoop::Id id6 = RunLoop::InvalidId;
+    id5 = runLoop.Add([&] {
+        calls.Add(5);
+        runLoop.Remove(id5);
+        runLoop.Remove(id4);
+        id6 = runLoop.Add([&calls] { calls.Add(6); }, 5);
+    }, -10);
+    runLoop.Run();
+    CHECK(calls.Size() == 4);
+    CHECK((calls[0] == 5) && (calls[1] == 2) && (calls[2] == 1) && (calls[3] == 3));
+    CHECK(!runLoop.HasCallback(id4));
+    CHECK(!runLoop.HasCallback(id5));
+    CHECK(runLoop.HasCallback(id6));
+    calls.Clear();
+    runLoop.Run();
+    CHECK(calls.Size() == 4);
+    CHECK((calls[0] == 2) && (calls[1] == 6) && (calls[2] == 1) && (calls[3] == 3));
+}
+
+TEST(RunLoopIdTest) {
+    RunLoop runLoop;
+    int x = 0;
+    auto id0 = runLoop.Add([&x] { x++; });
+    runLoop.Remove(id0);
+    CHECK(!runLoop.HasCallback(id0));
+    CHECK(!runLoop.HasCallback(RunLoop::InvalidId));
+
+    // the slot is reused, but with a new generation
+    auto id1 = runLoop.Add([&x] { x += 10; });
+    CHECK(id1 != id0);
+    CHECK((id1 & 0xFFFF) == (id0 & 0xFFFF));
+    CHECK(!runLoop.HasCallback(id0));
+    CHECK(runLoop.HasCallback(id1));
+    runLoop.Run();
+    CHECK(x == 10);
+    CHECK(runLoop.NumCallbacks() == 1);
+
+    // many add/remove cycles don't grow the runloop
+    for (int i = 0; i < 1000; i++) {
+        runLoop.Remove(id1);
+        id1 = runLoop.Add([&x] { x++; });
+        runLoop.Run();
+    }
+    CHECK(x == 1010);
+    CHECK(runLoop.NumCallbacks() == 1);
+}
+
+TEST(RunLoopCallbackStorageTest) {
+    RunLoop runLoop;
+    // captures bigger than the inline storage are allocated on the heap
+    StaticArray<int, 64> big;
+    big.Fill(1);
+    int sum = 0;
+    String str("a string which is too long to be stored inline");
+    auto id0 = runLoop.Add([big, &sum] {
+        for (int val : big) {
+            sum += val;
+        }
+    });
+    runLoop.Add([str, &sum] { sum += str.Length(); });
+    // function pointers
+    static int numCalls = 0;
+    struct helper {
+        static void func() {
+            numCalls++;
+        }
+    };
+    runLoop.Add(&helper::func);
+    CHECK(str.RefCount() == 2);
+    runLoop.Run();
+    runLoop.Run();
+    CHECK(sum == 2 * (64 + str.Length()));
+    CHECK(numCalls == 2);
+    runLoop.Remove(id0);
+    runLoop.Run();
+    CHECK(sum == 2 * 64 + 3 * str.Length());
+}
+
+TEST(RunLoopTimingTest) {
+    RunLoop runLoop;
+    CHECK(!runLoop.IsTimingEnabled());
+    volatile int x = 0;
+    auto id0 = runLoop.Add([&x] {
+        for (int i = 0; i < 10000; i++) {
+            x = x + 1;
+        }
+    }, RunLoop::DefaultPriority, "RunLoopTimingTest");
+    runLoop.Run();
+    CHECK(runLoop.LastDuration(id0).AsTicks() == 0);
+    runLoop.SetTimingEnabled(true);
+    runLoop.Run();
+    CHECK(runLoop.LastDuration(id0).AsTicks() > 0);
+    CHECK(Metrics::Lookup("runloop.RunLoopTimingTest").IsValid());
 }
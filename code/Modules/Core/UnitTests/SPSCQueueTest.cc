@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//  SPSCQueueTest.cc
+//  Test SPSCQueue functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/String/String.h"
+#include <thread>
+
+using namespace Oryol;
+
+TEST(SPSCQueueTest) {
+    SPSCQueue<int> queue;
+    CHECK(!queue.IsValid());
+    CHECK(queue.Capacity() == 0);
+    queue.Setup(5);
+    CHECK(queue.IsValid());
+    CHECK(queue.Capacity() == 8);   // rounded up to power of 2
+    CHECK(queue.Empty());
+    CHECK(queue.Size() == 0);
+
+    // fill and drain a few times to wrap around
+    int val = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.Enqueue(round * 8 + i));
+        }
+        CHECK(!queue.Enqueue(123));
+        CHECK(queue.Size() == 8);
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.Dequeue(val));
+            CHECK(val == round * 8 + i);
+        }
+        CHECK(!queue.Dequeue(val));
+        CHECK(queue.Empty());
+    }
+
+    // batches
+    int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    int out[10] = { };
+    CHECK(queue.EnqueueBatch(in, 3) == 3);
+    CHECK(queue.EnqueueBatch(in + 3, 7) == 5);     // only 5 slots left
+    CHECK(queue.Size() == 8);
+    CHECK(queue.DequeueBatch(out, 6) == 6);
+    CHECK(queue.DequeueBatch(out + 6, 4) == 2);
+    CHECK(queue.DequeueBatch(out, 4) == 0);
+    for (int i = 0; i < 8; i++) {
+        CHECK(out[i] == i);
+    }
+    queue.Discard();
+    CHECK(!queue.IsValid());
+
+    // elements left in the queue are destroyed
+    SPSCQueue<String> strQueue;
+    strQueue.Setup(4);
+    CHECK(strQueue.Enqueue(String("Bla")));
+    String str("Blub");
+    CHECK(strQueue.Enqueue(str));
+    CHECK(strQueue.Enqueue(String("Blob")));
+    String res;
+    CHECK(strQueue.Dequeue(res));
+    CHECK(res == "Bla");
+    CHECK(strQueue.Dequeue(res));
+    CHECK(res == "Blub");
+}
+
+TEST(SPSCQueueThreadedTest) {
+    // one producer, one consumer, elements must arrive in order
+    const int num = 1000000;
+    SPSCQueue<int> queue;
+    queue.Setup(1024);
+    std::thread producer([&queue, num] {
+        int batch[16];
+        int i = 0;
+        while (i < num) {
+            if (i & 1024) {
+                // alternate between single and batched enqueue
+                int n = 0;
+                for (; (n < 16) && ((i + n) < num); n++) {
+                    batch[n] = i + n;
+                }
+                int done = 0;
+                while (done < n) {
+                    done += queue.EnqueueBatch(batch + done, n - done);
+                }
+                i += n;
+            }
+            else {
+                while (!queue.Enqueue(i)) {
+                    std::this_thread::yield();
+                }
+                i++;
+            }
+        }
+    });
+    int expected = 0;
+    bool inOrder = true;
+    int batch[32];
+    while (expected < num) {
+        const int n = queue.DequeueBatch(batch, (expected & 2048) ? 32 : 1);
+        for (int i = 0; i < n; i++) {
+            if (batch[i] != expected++) {
+                inOrder = false;
+            }
+        }
+        if (0 == n) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(inOrder);
+    CHECK(expected == num);
+    CHECK(queue.Empty());
+}
@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------------
+//  SizeClassAllocatorTest.cc
+//  Test the built-in size-class allocator backend.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/SizeClassAllocator.h"
+#include "Core/Containers/Array.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(SizeClassAllocatorSizeClasses) {
+    CHECK(SizeClassAllocator::SizeClass(0) == 0);
+    CHECK(SizeClassAllocator::SizeClass(1) == 0);
+    CHECK(SizeClassAllocator::SizeClass(16) == 0);
+    CHECK(SizeClassAllocator::SizeClass(17) == 1);
+    CHECK(SizeClassAllocator::SizeClass(128) == 7);
+    CHECK(SizeClassAllocator::SizeClass(129) == 8);
+    CHECK(SizeClassAllocator::SizeClass(160) == 8);
+    CHECK(SizeClassAllocator::SizeClass(161) == 9);
+    CHECK(SizeClassAllocator::SizeClass(257) == 12);
+    CHECK(SizeClassAllocator::SizeClass(SizeClassAllocator::MaxSize) == SizeClassAllocator::NumSizeClasses - 1);
+    for (int size = 0; size <= SizeClassAllocator::MaxSize; size++) {
+        const int sizeClass = SizeClassAllocator::SizeClass(size);
+        CHECK(SizeClassAllocator::ClassSize(sizeClass) >= size);
+        if (sizeClass > 0) {
+            CHECK(SizeClassAllocator::ClassSize(sizeClass - 1) < size);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(SizeClassAllocatorAllocFree) {
+    SizeClassAllocator* alloc = SizeClassAllocator::Instance();
+    CHECK(nullptr != alloc);
+    CHECK(alloc == SizeClassAllocator::Instance());
+
+    // memory from std::malloc isn't owned
+    void* sysPtr = std::malloc(32);
+    CHECK(!alloc->Owns(sysPtr));
+    CHECK(!alloc->Owns(nullptr));
+    std::free(sysPtr);
+
+    // allocate a mix of sizes and check alignment and block sizes
+    Array<uint8_t*> ptrs;
+    for (int i = 0; i < 4096; i++) {
+        const int size = (i * 7) % (SizeClassAllocator::MaxSize + 1);
+        uint8_t* p = (uint8_t*) alloc->Alloc(size);
+        CHECK(nullptr != p);
+        CHECK(alloc->Owns(p));
+        CHECK((intptr_t(p) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+        CHECK(alloc->BlockSize(p) >= size);
+        Memory::Fill(p, size, uint8_t(i));
+        ptrs.Add(p);
+    }
+    bool check = true;
+    for (int i = 0; i < ptrs.Size(); i++) {
+        const int size = (i * 7) % (SizeClassAllocator::MaxSize + 1);
+        for (int j = 0; j < size; j++) {
+            if (ptrs[i][j] != uint8_t(i)) {
+                check = false;
+            }
+        }
+    }
+    CHECK(check);
+    for (uint8_t* p : ptrs) {
+        alloc->Free(p);
+    }
+
+    // freed blocks are recycled
+    alloc->ReleaseThreadCache();
+    void* p0 = alloc->Alloc(48);
+    alloc->Free(p0);
+    void* p1 = alloc->Alloc(40);
+    CHECK(p0 == p1);
+    alloc->Free(p1);
+
+    // big allocations are not owned by the allocator
+    void* big = alloc->Alloc(SizeClassAllocator::MaxSize + 1);
+    CHECK(nullptr != big);
+    CHECK(!alloc->Owns(big));
+    std::free(big);
+}
+
+//------------------------------------------------------------------------------
+TEST(SizeClassAllocatorReAlloc) {
+    SizeClassAllocator* alloc = SizeClassAllocator::Instance();
+    uint8_t* p = (uint8_t*) alloc->Alloc(20);
+    CHECK(alloc->BlockSize(p) == 32);
+    for (int i = 0; i < 20; i++) {
+        p[i] = uint8_t(i);
+    }
+    // growing within the block keeps the pointer
+    CHECK(alloc->ReAlloc(p, 32) == p);
+    // growing beyond the block moves the content
+    uint8_t* p1 = (uint8_t*) alloc->ReAlloc(p, 100);
+    CHECK(alloc->BlockSize(p1) == 112);
+    bool check = true;
+    for (int i = 0; i < 20; i++) {
+        if (p1[i] != i) {
+            check = false;
+        }
+    }
+    CHECK(check);
+    alloc->Free(p1);
+}
+
+//------------------------------------------------------------------------------
+TEST(SizeClassAllocatorThreads) {
+    SizeClassAllocator* alloc = SizeClassAllocator::Instance();
+
+    // blocks allocated on one thread are freed on another thread
+    const int numPtrs = 10000;
+    Array<void*> ptrs;
+    ptrs.Reserve(numPtrs);
+    std::thread producer([alloc, &ptrs]() {
+        for (int i = 0; i < numPtrs; i++) {
+            ptrs.Add(alloc->Alloc(16 + (i % 256)));
+        }
+        alloc->ReleaseThreadCache();
+    });
+    producer.join();
+    std::thread consumer([alloc, &ptrs]() {
+        for (void* p : ptrs) {
+            alloc->Free(p);
+        }
+        alloc->ReleaseThreadCache();
+    });
+    consumer.join();
+
+    // several threads hammering the allocator at the same time
+    const int numThreads = 4;
+    std::thread threads[numThreads];
+    bool results[numThreads] = { };
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([alloc, t, &results]() {
+            bool ok = true;
+            uint8_t* live[64] = { };
+            for (int i = 0; i < 20000; i++) {
+                const int slot = (i * 13) & 63;
+                if (live[slot]) {
+                    if (live[slot][0] != uint8_t(t)) {
+                        ok = false;
+                    }
+                    alloc->Free(live[slot]);
+                }
+                live[slot] = (uint8_t*) alloc->Alloc(1 + ((i * 31) % SizeClassAllocator::MaxSize));
+                live[slot][0] = uint8_t(t);
+            }
+            for (uint8_t* p : live) {
+                if (p) {
+                    alloc->Free(p);
+                }
+            }
+            alloc->ReleaseThreadCache();
+            results[t] = ok;
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+        CHECK(results[t]);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(SizeClassAllocatorMemoryBackend) {
+    // memory allocated before the allocator is installed goes back to std::free
+    void* before = Memory::Alloc(64);
+    Memory::SetAllocator(SizeClassAllocator::Instance());
+    CHECK(Memory::GetAllocator() == SizeClassAllocator::Instance());
+    CHECK(!SizeClassAllocator::Instance()->Owns(before));
+    before = Memory::ReAlloc(before, 128);
+    CHECK(!SizeClassAllocator::Instance()->Owns(before));
+    Memory::Free(before);
+
+    void* p = Memory::Alloc(64);
+    CHECK(SizeClassAllocator::Instance()->Owns(p));
+    p = Memory::ReAlloc(p, 512);
+    CHECK(SizeClassAllocator::Instance()->Owns(p));
+    p = Memory::ReAlloc(p, 4096);
+    CHECK(!SizeClassAllocator::Instance()->Owns(p));
+    Memory::Free(p);
+    void* p1 = Memory::ReAlloc(nullptr, 16);
+    CHECK(SizeClassAllocator::Instance()->Owns(p1));
+    Memory::Free(p1);
+}
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//  SlotMapTest.cc
+//  Test SlotMap functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SlotMap.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+
+using namespace Oryol;
+
+TEST(SlotMapTest) {
+    SlotMap<int> map;
+    CHECK(!map.IsValid());
+    CHECK(map.Capacity() == 0);
+    map.Setup(4);
+    CHECK(map.IsValid());
+    CHECK(map.Capacity() == 4);
+    CHECK(map.Empty());
+    CHECK(!map.Full());
+    CHECK(!map.Contains(SlotMap<int>::InvalidHandle));
+    CHECK(nullptr == map.Find(SlotMap<int>::InvalidHandle));
+
+    const auto h0 = map.Add(0);
+    const auto h1 = map.Add(1);
+    const auto h2 = map.Add(2);
+    const auto h3 = map.Add(3);
+    CHECK(map.Size() == 4);
+    CHECK(map.Full());
+    CHECK(h0 != SlotMap<int>::InvalidHandle);
+    CHECK((h0 != h1) && (h1 != h2) && (h2 != h3));
+    CHECK(map[h0] == 0);
+    CHECK(map[h1] == 1);
+    CHECK(*map.Find(h2) == 2);
+    CHECK(*map.Find(h3) == 3);
+    map[h3] = 33;
+    CHECK(map.ValueAtIndex(3) == 33);
+    CHECK(map.HandleAtIndex(3) == h3);
+
+    // erase moves the last element into the hole
+    map.Erase(h1);
+    CHECK(map.Size() == 3);
+    CHECK(!map.Contains(h1));
+    CHECK(nullptr == map.Find(h1));
+    CHECK(map.ValueAtIndex(1) == 33);
+    CHECK(map.HandleAtIndex(1) == h3);
+    CHECK(map[h3] == 33);
+    CHECK(map[h0] == 0);
+    CHECK(map[h2] == 2);
+
+    // a new element doesn't reuse the stale handle
+    const auto h4 = map.Add(4);
+    CHECK(h4 != h1);
+    CHECK(!map.Contains(h1));
+    CHECK(map[h4] == 4);
+
+    // iteration
+    int sum = 0;
+    for (int val : map) {
+        sum += val;
+    }
+    CHECK(sum == 0 + 33 + 2 + 4);
+
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(!map.Contains(h0));
+    CHECK(!map.Contains(h2));
+    CHECK(!map.Contains(h3));
+    CHECK(!map.Contains(h4));
+    map.Discard();
+    CHECK(!map.IsValid());
+}
+
+TEST(SlotMapHandleTest) {
+    // freed slots are reused in FIFO order, so one slot's generation
+    // counter only increases every capacity erases
+    SlotMap<int> map;
+    map.Setup(16);
+    Array<SlotMap<int>::Handle> stale;
+    auto h = map.Add(0);
+    for (int i = 0; i < 1000; i++) {
+        stale.Add(h);
+        map.Erase(h);
+        h = map.Add(i);
+        CHECK(map[h] == i);
+        CHECK(map.Size() == 1);
+    }
+    for (auto staleHandle : stale) {
+        CHECK(!map.Contains(staleHandle));
+    }
+
+    // 64-bit handles
+    SlotMap<int, uint64_t> map64;
+    map64.Setup(100000);
+    Array<uint64_t> handles;
+    for (int i = 0; i < 100000; i++) {
+        handles.Add(map64.Add(i));
+    }
+    CHECK(map64.Full());
+    for (int i = 0; i < 100000; i += 2) {
+        map64.Erase(handles[i]);
+    }
+    CHECK(map64.Size() == 50000);
+    for (int i = 0; i < 100000; i++) {
+        if (i & 1) {
+            CHECK(map64[handles[i]] == i);
+        }
+        else {
+            CHECK(!map64.Contains(handles[i]));
+        }
+    }
+    // the first used generation is 2, so handles are never 0
+    CHECK((handles[0] >> 32) == 2);
+}
+
+TEST(SlotMapStaleHandleTest) {
+    // handles with the generation of a free slot are invalid
+    SlotMap<int> map;
+    map.Setup(4);
+    CHECK(!map.Contains((1 << 16) | 0));
+    CHECK(!map.Contains((1 << 16) | 3));
+    const auto h0 = map.Add(0);
+    CHECK(map.Contains(h0));
+    CHECK(!map.Contains(h0 + (1 << 16)));
+    CHECK(!map.Contains((1 << 16) | 1));
+    CHECK(!map.Contains((2 << 16) | 1));
+
+    // handles from before Discard() don't match elements after Setup()
+    Array<SlotMap<int>::Handle> old;
+    for (int i = 0; i < 3; i++) {
+        old.Add(map.Add(i + 1));
+    }
+    old.Add(h0);
+    map.Discard();
+    map.Setup(4);
+    for (int i = 0; i < 4; i++) {
+        map.Add(i);
+    }
+    CHECK(map.Full());
+    for (auto oldHandle : old) {
+        CHECK(!map.Contains(oldHandle));
+    }
+
+    // the 16-bit generation counter skips 0 when it wraps around
+    SlotMap<int> map1;
+    map1.Setup(1);
+    bool check = true;
+    for (int i = 0; i < 0x10000; i++) {
+        const auto h = map1.Add(i);
+        if ((h == SlotMap<int>::InvalidHandle) || !map1.Contains(h)) {
+            check = false;
+        }
+        map1.Erase(h);
+        if (map1.Contains(h)) {
+            check = false;
+        }
+    }
+    CHECK(check);
+}
+
+TEST(SlotMapObjectTest) {
+    // elements are destroyed on Erase, Clear and Discard
+    String str("a string which is not stored inline in the String object");
+    SlotMap<String> map;
+    map.Setup(8);
+    const auto h0 = map.Add(str);
+    const auto h1 = map.Add(str);
+    const auto h2 = map.Add("another string");
+    CHECK(str.RefCount() == 3);
+    CHECK(map[h2] == "another string");
+    map.Erase(h0);
+    CHECK(str.RefCount() == 2);
+    CHECK(map[h1] == str);
+    map.Clear();
+    CHECK(str.RefCount() == 1);
+    map.Add(str);
+    map.Add(str);
+    CHECK(str.RefCount() == 3);
+    map.Discard();
+    CHECK(str.RefCount() == 1);
+    {
+        SlotMap<String> map2;
+        map2.Setup(2);
+        map2.Add(std::move(String(str)));
+        CHECK(str.RefCount() == 2);
+    }
+    CHECK(str.RefCount() == 1);
+}
@@ -9,6 +9,7 @@
 #include "Core/Core.h"
 
 #include <cstring>
+#include <cstdio>
 #include <thread>
 #include <array>
 
@@ -81,8 +82,86 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// test the process-global string atom table
+TEST(StringAtomGlobalTable) {
+
+    StringAtom local("LOCAL");
+    CHECK(!StringAtom::IsUsingGlobalTable());
+    StringAtom::UseGlobalTable(true);
+    CHECK(StringAtom::IsUsingGlobalTable());
+
+    StringAtom atom0("GLOBAL");
+    StringAtom atom1(String("GLOBAL"));
+    CHECK(atom0.AsCStr() == atom1.AsCStr());
+    CHECK(atom0 == atom1);
+    // existing thread-local atoms still work
+    StringAtom local1("LOCAL");
+    CHECK(local == local1);
+    StringAtom local2(local);
+    CHECK(local2.AsCStr() == local.AsCStr());
+
+    // atoms created on other threads must share the same string data
+    const int numThreads = 4;
+    const int numStrings = 1000;
+    static StringAtom atoms[numThreads][numStrings];
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([i] {
+            Oryol::Core::EnterThread();
+            char buf[32];
+            for (int j = 0; j < numStrings; j++) {
+                std::snprintf(buf, sizeof(buf), "str_%d", (j * (i + 1)) % numStrings);
+                atoms[i][j] = buf;
+            }
+            Oryol::Core::LeaveThread();
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    char buf[32];
+    for (int j = 0; j < numStrings; j++) {
+        std::snprintf(buf, sizeof(buf), "str_%d", j);
+        StringAtom atom(buf);
+        CHECK(atom == buf);
+        for (int i = 0; i < numThreads; i++) {
+            const StringAtom& other = atoms[(j + i) % numThreads][j];
+            CHECK(other == other.AsCStr());
+            StringAtom copy(other);
+            CHECK(copy.AsCStr() == other.AsCStr());
+        }
+        CHECK(atom.AsCStr() == atoms[0][j].AsCStr());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        for (int j = 0; j < numStrings; j++) {
+            atoms[i][j].Clear();
+        }
+    }
+
+    StringAtom::UseGlobalTable(false);
+    CHECK(!StringAtom::IsUsingGlobalTable());
+    StringAtom atom2("GLOBAL");
+    CHECK(atom2 == atom0);
+    StringAtom atom3(atom0);
+    CHECK(atom3.AsCStr() == atom0.AsCStr());
+}
 #endif
 
+// Core::Discard() switches off the global table if Core::Setup() switched it on
+TEST(StringAtomCoreSetupGlobalTable) {
+    CoreSetup coreSetup;
+    coreSetup.GlobalStringAtomTable = true;
+    Core::Setup(coreSetup);
+    CHECK(StringAtom::IsUsingGlobalTable());
+    Core::Discard();
+    CHECK(!StringAtom::IsUsingGlobalTable());
+
+    Core::Setup();
+    CHECK(!StringAtom::IsUsingGlobalTable());
+    Core::Discard();
+}
+
 // test string atom creation performance
 TEST(StringAtomPerformance) {
 
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringBuilder.h"
+#include <cstring>
 
 using namespace Oryol;
 
@@ -215,3 +216,74 @@ TEST(StringBuilderTest) {
     CHECK(builder.GetString() == "One: 1, Two: 2, Three: 3 Bla: 46");
 }
 
+//------------------------------------------------------------------------------
+TEST(StringBuilderSearchTest) {
+    // compare the SIMD search functions against plain loops, with matches
+    // at every position of long strings (to test the SIMD loops and tails)
+    StringBuilder builder;
+    for (int len = 1; len < 80; len++) {
+        for (int pos = 0; pos < len; pos++) {
+            builder.Clear();
+            for (int i = 0; i < len; i++) {
+                builder.Append(i == pos ? ':' : 'a' + (i % 3));
+            }
+            CHECK(builder.FindFirstOf(0, EndOfString, ":") == pos);
+            CHECK(builder.FindFirstOf(0, EndOfString, "xyz:\t\n") == pos);
+            CHECK(builder.FindFirstOf(0, EndOfString, "0123456789:") == pos);
+            CHECK(builder.FindFirstOf(0, pos, ":") == InvalidIndex);
+            CHECK(builder.FindFirstNotOf(0, EndOfString, "abc") == pos);
+            CHECK(builder.FindFirstNotOf(0, EndOfString, "abcdefghijklm") == pos);
+            CHECK(builder.FindLastOf(0, EndOfString, ":") == pos);
+            CHECK(builder.FindSubString(0, EndOfString, ":") == pos);
+            if (pos >= 2) {
+                // the match must start before the end index, but may extend beyond it
+                const String sub = builder.GetSubString(pos - 2, pos + 1);
+                CHECK(builder.FindSubString(0, EndOfString, sub.AsCStr()) == pos - 2);
+                CHECK(builder.FindSubString(0, pos - 1, sub.AsCStr()) == pos - 2);
+                CHECK(builder.FindSubString(0, pos - 2, sub.AsCStr()) == InvalidIndex);
+                CHECK(StringBuilder::FindSubString(builder.AsCStr(), 0, EndOfString, sub.AsCStr()) == pos - 2);
+            }
+            CHECK(builder.FindSubString(0, EndOfString, ":x") == InvalidIndex);
+        }
+    }
+    builder.Set("abababababababababababababababababababab_abc");
+    CHECK(builder.FindSubString(0, EndOfString, "abc") == 41);
+    CHECK(builder.FindSubString(0, EndOfString, "ab_") == 38);
+    CHECK(builder.FindSubString(3, EndOfString, "ba") == 3);
+    CHECK(builder.FindSubString(0, EndOfString, "abcd") == InvalidIndex);
+    CHECK(builder.FindSubString(0, EndOfString, "") == 0);
+
+    // SubstituteAll doesn't substitute inside substituted text
+    builder.Set("a.b.c.d");
+    CHECK(builder.SubstituteAll(".", ".."));
+    CHECK(builder.GetString() == "a..b..c..d");
+    CHECK(builder.SubstituteAll("..", ".") == 3);
+    CHECK(builder.GetString() == "a.b.c.d");
+    CHECK(builder.SubstituteAll("b.c", "xyz") == 1);
+    CHECK(builder.GetString() == "a.xyz.d");
+    CHECK(builder.SubstituteAll("a", "") == 1);
+    CHECK(builder.GetString() == ".xyz.d");
+    CHECK(builder.SubstituteAll("q", "r") == 0);
+    CHECK(builder.GetString() == ".xyz.d");
+    builder.Clear();
+    for (int i = 0; i < 1000; i++) {
+        builder.Append("root:tex.dds;");
+    }
+    CHECK(builder.SubstituteAll("root:", "data:textures/") == 1000);
+    CHECK(builder.Length() == 1000 * 22);
+    CHECK(builder.FindSubString(0, EndOfString, "root:") == InvalidIndex);
+    CHECK(0 == std::strncmp(builder.AsCStr(), "data:textures/tex.dds;data:", 27));
+    CHECK(builder.SubstituteAll("data:textures/", "") == 1000);
+    CHECK(builder.Length() == 1000 * 8);
+
+    // Tokenize with fence
+    Array<String> tokens;
+    builder.Set("  one \"two three\"  four\t\"\" \"five");
+    CHECK(builder.Tokenize(" \t", '"', tokens) == 5);
+    CHECK(tokens[0] == "one");
+    CHECK(tokens[1] == "two three");
+    CHECK(tokens[2] == "four");
+    CHECK(tokens[3] == "");
+    CHECK(tokens[4] == "five");
+}
+
@@ -4,6 +4,8 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringConverter.h"
+#include "Core/String/utf.h"
+#include <cstring>
 
 using namespace Oryol;
 
@@ -37,6 +39,67 @@ TEST(StringConverterTest_UTF8) {
     CHECK(ldst == longString);
 }
 
+TEST(StringConverterTest_UTF8Strict) {
+
+    // ASCII runs longer than a SIMD block, mixed with 2-, 3- and 4-byte sequences
+    const char* mixed =
+        "0123456789abcdefghijklmnopqrstuvwxyz\xC3\xA4"
+        "\xE4\xB8\xAD\xE6\x96\x87\xF0\x9F\x98\x80"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    WideString wide = StringConverter::UTF8ToWide(String(mixed));
+    CHECK(wide.Length() == 36 + 1 + 2 + (2 == sizeof(wchar_t) ? 2 : 1) + 26);
+    CHECK(wide.AsCStr()[36] == 0xE4);
+    CHECK(wide.AsCStr()[37] == 0x4E2D);
+    CHECK(StringConverter::WideToUTF8(wide) == mixed);
+    CHECK(String(mixed).NumChars() == 36 + 1 + 2 + 1 + 26);
+
+    // NumChars stops at the first 0 byte
+    CHECK(String("\xE4\xB8\xAD\xE6\x96\x87", 0, 6).NumChars() == 2);
+    CHECK(String("0123456789abcdef\xC3\xA4\0xyz0123456789abcdef", 0, 38).NumChars() == 17);
+    CHECK(String().NumChars() == 0);
+
+    // invalid UTF-8: continuation byte, overlong, surrogate, > U+10FFFF, truncated
+    static const char* invalid[] = {
+        "abc\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF0\x8F\xBF\xBF",
+        "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xE4\xB8", "0123456789abcdefghij\xF0\x9F\x98"
+    };
+    for (const char* str : invalid) {
+        const int len = int(std::strlen(str));
+        CHECK(!_priv::utf8Validate((const uint8_t*) str, len));
+        CHECK(_priv::utf8ToUTF16Length((const uint8_t*) str, len) == InvalidIndex);
+        CHECK(StringConverter::UTF8ToWide(String(str)).Empty());
+    }
+    CHECK(_priv::utf8Validate((const uint8_t*) mixed, int(std::strlen(mixed))));
+    CHECK(_priv::utf8Validate((const uint8_t*) "\xEF\xBF\xBF\xF4\x8F\xBF\xBF", 7));
+
+    // UTF-16 surrogate pairs, independent from the size of wchar_t
+    const uint16_t utf16[] = { 'a', 0xE4, 0x4E2D, 0xD83D, 0xDE00, 'b' };
+    uint8_t utf8[16];
+    CHECK(_priv::utf16ToUTF8Length(utf16, 6) == 11);
+    CHECK(_priv::utf16ToUTF8(utf16, 6, utf8) == 11);
+    CHECK(std::memcmp(utf8, "a\xC3\xA4\xE4\xB8\xAD\xF0\x9F\x98\x80" "b", 11) == 0);
+    uint16_t utf16Back[8];
+    CHECK(_priv::utf8ToUTF16Length(utf8, 11) == 6);
+    CHECK(_priv::utf8ToUTF16(utf8, 11, utf16Back) == 6);
+    CHECK(std::memcmp(utf16, utf16Back, sizeof(utf16)) == 0);
+    const uint16_t unpaired[] = { 'a', 0xD83D, 'b' };
+    CHECK(_priv::utf16ToUTF8Length(unpaired, 3) == InvalidIndex);
+    CHECK(_priv::utf16ToUTF8Length(unpaired + 1, 1) == InvalidIndex);
+    const uint32_t utf32[] = { 'a', 0x110000 };
+    CHECK(_priv::utf32ToUTF8Length(utf32, 1) == 1);
+    CHECK(_priv::utf32ToUTF8Length(utf32, 2) == InvalidIndex);
+
+    // raw functions return number of written chars including the 0, or 0 if too small
+    wchar_t wbuf[4];
+    CHECK(StringConverter::UTF8ToWide((const unsigned char*) "\xC3\xA4" "bc", 4, wbuf, sizeof(wbuf)) == 4);
+    CHECK((wbuf[0] == 0xE4) && (wbuf[3] == 0));
+    CHECK(StringConverter::UTF8ToWide((const unsigned char*) "abcd", 4, wbuf, sizeof(wbuf)) == 0);
+    unsigned char buf[4];
+    CHECK(StringConverter::WideToUTF8(L"\x4E2D", 1, buf, sizeof(buf)) == 4);
+    CHECK(std::memcmp(buf, "\xE4\xB8\xAD", 4) == 0);
+    CHECK(StringConverter::WideToUTF8(L"\xE4\xE4", 2, buf, sizeof(buf)) == 0);
+}
+
 TEST(StringConverterTest_FromString) {
 
     // conversion to simple types
@@ -64,15 +64,30 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment of short strings copies the inline bytes
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
+    CHECK(str0.IsInline() && str2.IsInline());
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
+    CHECK(str0.AsCStr() != str2.AsCStr());
+    str0.Clear();
+    CHECK(str0.Empty());
+
+    // copy-assignment of long strings shares the string data
+    const char* longStr = "A string which is too long to be stored inline";
+    str2 = longStr;
+    CHECK(!str2.IsInline());
+    CHECK(str2.RefCount() == 1);
+    str0 = str2;
+    CHECK(str0 == longStr);
+    CHECK(str0 == str2);
     CHECK(str0.RefCount() == 2);
     CHECK(str2.RefCount() == 2);
     CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
     str2.Clear();
-    CHECK(str0 == "Bla");
+    CHECK(str0 == longStr);
     CHECK(str2.Empty());
     CHECK(str0.RefCount() == 1);
     CHECK(str2.RefCount() == 0);
@@ -151,3 +166,50 @@ TEST(StringTest) {
     CHECK(nullString.AsCStr() != nullptr);
     CHECK(nullString.AsCStr()[0] == 0);    
 }
+
+//------------------------------------------------------------------------------
+TEST(StringInlineTest) {
+    // strings up to InlineCapacity bytes are stored inline
+    char chars[String::InlineCapacity + 2] = { };
+    for (int i = 0; i <= String::InlineCapacity; i++) {
+        chars[i] = 'a' + (i % 26);
+    }
+    String maxInline(chars, 0, String::InlineCapacity);
+    CHECK(maxInline.IsInline());
+    CHECK(maxInline.Length() == String::InlineCapacity);
+    CHECK(maxInline.Back() == chars[String::InlineCapacity - 1]);
+    CHECK(maxInline.AsCStr()[String::InlineCapacity] == 0);
+    String minHeap(chars, 0, String::InlineCapacity + 1);
+    CHECK(!minHeap.IsInline());
+    CHECK(minHeap.Length() == String::InlineCapacity + 1);
+    CHECK(std::strcmp(minHeap.AsCStr(), chars) == 0);
+    CHECK(maxInline < minHeap);
+    CHECK(minHeap > maxInline);
+
+    // move leaves the source empty
+    String moved(std::move(maxInline));
+    CHECK(moved.Length() == String::InlineCapacity);
+    CHECK(maxInline.Empty());
+    CHECK(maxInline.Length() == 0);
+    moved = std::move(minHeap);
+    CHECK(!moved.IsInline());
+    CHECK(moved.RefCount() == 1);
+    CHECK(minHeap.Empty());
+    CHECK(minHeap.IsInline());
+
+    // assigning from the own (inline) string data
+    String self("Hello World!");
+    self.Assign(self, 6, EndOfString);
+    CHECK(self == "World!");
+    self.Assign(self.AsCStr(), 1, 3);
+    CHECK(self == "or");
+    self = self.AsCStr();
+    CHECK(self == "or");
+
+    // embedded 0 bytes are kept in inline strings
+    const char raw[] = { 'a', 0, 'b' };
+    String rawStr(raw, 0, 3);
+    CHECK(rawStr.IsInline());
+    CHECK(rawStr.Length() == 3);
+    CHECK(rawStr.Back() == 'b');
+}
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+//  TraceRecorderTest.cc
+//  Test the built-in trace event recorder.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/TraceRecorder.h"
+#include "Core/String/StringBuilder.h"
+#include <thread>
+
+using namespace Oryol;
+
+TEST(TraceRecorderTest) {
+    CHECK(!TraceRecorder::IsValid());
+    // events are ignored if the recorder isn't setup
+    TraceRecorder::Begin("Ignored");
+    TraceRecorder::End();
+
+    TraceRecorder::Setup(16);
+    CHECK(TraceRecorder::IsValid());
+    CHECK(TraceRecorder::NumEvents() == 0);
+    TraceRecorder::SetThreadName("main");
+    TraceRecorder::BeginFrame();
+    {
+        TraceRecorder::Scope scope("Outer");
+        TraceRecorder::Begin("Inner \"quoted\"");
+        TraceRecorder::End();
+    }
+    TraceRecorder::EndFrame();
+    CHECK(TraceRecorder::NumEvents() == 6);
+    CHECK(TraceRecorder::NumDropped() == 0);
+
+    #if ORYOL_HAS_THREADS
+    std::thread thread([] {
+        TraceRecorder::SetThreadName("ioWorker");
+        TraceRecorder::Scope scope("Load");
+    });
+    thread.join();
+    CHECK(TraceRecorder::NumEvents() == 8);
+    #endif
+
+    StringBuilder json;
+    TraceRecorder::WriteJSON(json);
+    CHECK(json.Contains("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    CHECK(json.Contains("\"args\":{\"name\":\"main\"}"));
+    CHECK(json.Contains("{\"name\":\"Frame\",\"ph\":\"B\",\"pid\":1,\"tid\":"));
+    CHECK(json.Contains("{\"name\":\"Outer\",\"ph\":\"B\""));
+    CHECK(json.Contains("{\"name\":\"Inner \\\"quoted\\\"\",\"ph\":\"B\""));
+    CHECK(json.Contains("{\"ph\":\"E\",\"pid\":1,\"tid\":"));
+    #if ORYOL_HAS_THREADS
+    CHECK(json.Contains("\"args\":{\"name\":\"ioWorker\"}"));
+    CHECK(json.Contains("{\"name\":\"Load\",\"ph\":\"B\""));
+    #endif
+
+    // a full buffer drops new events, but keeps room for the end
+    // events of open events
+    for (int i = 0; i < 8; i++) {
+        TraceRecorder::Begin("Nested");
+    }
+    for (int i = 0; i < 8; i++) {
+        TraceRecorder::End();
+    }
+    CHECK(TraceRecorder::NumDropped() > 0);
+    json.Clear();
+    TraceRecorder::WriteJSON(json);
+    int numBegin = 0;
+    int numEnd = 0;
+    for (int i = 0; (i = StringBuilder::FindSubString(json.AsCStr(), i, EndOfString, "\"ph\":\"B\"")) != InvalidIndex; i++) {
+        numBegin++;
+    }
+    for (int i = 0; (i = StringBuilder::FindSubString(json.AsCStr(), i, EndOfString, "\"ph\":\"E\"")) != InvalidIndex; i++) {
+        numEnd++;
+    }
+    CHECK(numBegin == numEnd);
+
+    TraceRecorder::Discard();
+    CHECK(!TraceRecorder::IsValid());
+
+    // setup again, the old events are gone
+    TraceRecorder::Setup(16);
+    CHECK(TraceRecorder::NumEvents() == 0);
+    TraceRecorder::Begin("Again");
+    TraceRecorder::End();
+    CHECK(TraceRecorder::NumEvents() == 2);
+    TraceRecorder::Discard();
+}
@@ -0,0 +1,56 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file Core/bitOps.h
+    @ingroup _priv
+    @brief private bit scan helpers for SIMD compare masks
+
+    Used by HashSet (control byte groups), and by the UTF-8 and string
+    search functions to find the first matching byte in a compare mask.
+    The masks must not be 0.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+/// get index of the lowest set bit
+inline int
+lowestBit(uint64_t m) {
+    o_assert_dbg(0 != m);
+    const uint32_t lo = uint32_t(m);
+    const uint32_t hi = uint32_t(m >> 32);
+    #if defined(_MSC_VER)
+    unsigned long index;
+    if (lo) {
+        _BitScanForward(&index, lo);
+        return int(index);
+    }
+    _BitScanForward(&index, hi);
+    return 32 + int(index);
+    #else
+    return lo ? __builtin_ctz(lo) : 32 + __builtin_ctz(hi);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/// get index of the highest set bit
+inline int
+highestBit(uint32_t m) {
+    o_assert_dbg(0 != m);
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, m);
+    return int(index);
+    #else
+    return 31 - __builtin_clz(m);
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -113,16 +113,14 @@ debugTextRenderer::drawTextBuffer() {
         Gfx::PopResourceLabel();
     }
     
-    // get the currently accumulated string
-    String str;
+    // convert the currently accumulated string into vertices, this
+    // happens directly on the string builder buffer to not create a
+    // temporary string object each frame
     {
         SCOPED_LOCK;
-        str = this->stringBuilder.GetString();
+        this->convertStringToVertices(this->stringBuilder.AsCStr(), this->stringBuilder.Length());
         this->stringBuilder.Clear();
     }
-    
-    // convert string into vertices
-    this->convertStringToVertices(str);
 
     // draw the vertices
     if (this->curNumVertices > 0) {
@@ -237,7 +235,7 @@ debugTextRenderer::addVertex(uint8_t x, uint8_t y, uint8_t u, uint8_t v, uint32_
 
 //------------------------------------------------------------------------------
 void
-debugTextRenderer::convertStringToVertices(const String& str) {
+debugTextRenderer::convertStringToVertices(const char* ptr, int length) {
 
     int cursorX = 0;
     int cursorY = 0;
@@ -245,8 +243,7 @@ debugTextRenderer::convertStringToVertices(const String& str) {
     const int cursorMaxY = this->numRows - 1;
     uint32_t rgba = 0xFF00FFFF;
     
-    const int numChars = str.Length() > this->maxNumChars ? this->maxNumChars : str.Length();
-    const char* ptr = str.AsCStr();
+    const int numChars = length > this->maxNumChars ? this->maxNumChars : length;
     for (int charIndex = 0; charIndex < numChars; charIndex++) {
         unsigned char c = (unsigned char) ptr[charIndex];
         
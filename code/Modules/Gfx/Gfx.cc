@@ -5,6 +5,7 @@
 #include "Gfx.h"
 #include "Core/Core.h"
 #include "Core/Trace.h"
+#include "Core/Time/Clock.h"
 #include "Gfx/private/gfxPointers.h"
 #include "Gfx/private/displayMgr.h"
 #include "Gfx/private/gfxResourceContainer.h"
@@ -23,6 +24,13 @@ namespace {
         class _priv::renderer renderer;
         _priv::gfxResourceContainer resourceContainer;
         bool inPass = false;
+        Metric passesMetric;
+        Metric applyDrawStateMetric;
+        Metric applyUniformBlockMetric;
+        Metric updatesMetric;
+        Metric drawMetric;
+        Metric drawInstancedMetric;
+        Metric commitFrameTimeMetric;
     };
     _state* state = nullptr;
 }
@@ -31,6 +39,7 @@ namespace {
 void
 Gfx::Setup(const class GfxSetup& setup) {
     o_assert_dbg(!IsValid());
+    o_memory_scope(Gfx);
     state = Memory::New<_state>();
     state->gfxSetup = setup;
 
@@ -49,8 +58,15 @@ Gfx::Setup(const class GfxSetup& setup) {
     state->resourceContainer.setup(setup, pointers);
     state->runLoopId = Core::PreRunLoop()->Add([] {
         state->displayManager.ProcessSystemEvents();
-    });
+    }, RunLoop::DefaultPriority, "gfx");
     state->gfxFrameInfo = GfxFrameInfo();
+    state->passesMetric = Metrics::Counter("gfx.passes");
+    state->applyDrawStateMetric = Metrics::Counter("gfx.applyDrawState");
+    state->applyUniformBlockMetric = Metrics::Counter("gfx.applyUniformBlock");
+    state->updatesMetric = Metrics::Counter("gfx.updates");
+    state->drawMetric = Metrics::Counter("gfx.draw");
+    state->drawInstancedMetric = Metrics::Counter("gfx.drawInstanced");
+    state->commitFrameTimeMetric = Metrics::Histogram("gfx.commitFrameTime");
 }
 
 //------------------------------------------------------------------------------
@@ -85,7 +101,7 @@ Gfx::QuitRequested() {
 Gfx::EventHandlerId
 Gfx::Subscribe(EventHandler handler) {
     o_assert_dbg(IsValid());
-    return state->displayManager.Subscribe(handler);
+    return state->displayManager.Subscribe(std::move(handler));
 }
 
 //------------------------------------------------------------------------------
@@ -343,9 +359,20 @@ Gfx::CommitFrame() {
     o_trace_scoped(Gfx_CommitFrame);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
+    const TimePoint startTime = Clock::Now();
     state->renderer.commitFrame();
     state->displayManager.Present();
     state->resourceContainer.GarbageCollect();
+    Metrics::Record(state->commitFrameTimeMetric, Clock::Since(startTime));
+
+    // accumulate the per-frame stats into the metrics registry
+    const GfxFrameInfo& info = state->gfxFrameInfo;
+    Metrics::Add(state->passesMetric, info.NumPasses);
+    Metrics::Add(state->applyDrawStateMetric, info.NumApplyDrawState);
+    Metrics::Add(state->applyUniformBlockMetric, info.NumApplyUniformBlock);
+    Metrics::Add(state->updatesMetric, info.NumUpdateVertices + info.NumUpdateIndices + info.NumUpdateTextures);
+    Metrics::Add(state->drawMetric, info.NumDraw);
+    Metrics::Add(state->drawInstancedMetric, info.NumDrawInstanced);
     state->gfxFrameInfo = GfxFrameInfo();
 }
 
@@ -641,6 +668,7 @@ Gfx::validateShaderSetup(const ShaderSetup& setup) {
 template<> Id
 Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    o_memory_scope(Gfx);
     #if ORYOL_DEBUG
     validateTextureSetup(setup, data, size);
     #endif
@@ -651,6 +679,7 @@ Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
 template<> Id
 Gfx::CreateResource(const MeshSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    o_memory_scope(Gfx);
     #if ORYOL_DEBUG
     validateMeshSetup(setup, data, size);
     #endif
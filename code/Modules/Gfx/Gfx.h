@@ -9,6 +9,7 @@
     @brief Gfx module facade
 */
 #include "Core/RunLoop.h"
+#include "Core/Function.h"
 #include "Gfx/GfxTypes.h"
 #include "Resource/ResourceLabel.h"
 #include "Resource/ResourceLoader.h"
@@ -38,7 +39,7 @@ public:
     static bool QuitRequested();
 
     /// event handler callback typedef
-    typedef std::function<void(const GfxEvent&)> EventHandler;
+    typedef Function<void(const GfxEvent&)> EventHandler;
     /// event handler id typedef
     typedef unsigned int EventHandlerId;
     /// subscribe to display events
@@ -7,7 +7,7 @@
 */
 #include "Resource/ResourceLoader.h"
 #include "Gfx/GfxTypes.h"
-#include <functional>
+#include "Core/Function.h"
 
 namespace Oryol {
 
@@ -15,7 +15,7 @@ class MeshLoaderBase : public ResourceLoader {
     OryolClassDecl(MeshLoaderBase);
 public:
     /// optional callback when loading has succeeded
-    typedef std::function<void(MeshSetup&)> LoadedFunc;
+    typedef Function<void(MeshSetup&)> LoadedFunc;
 
     /// constructor
     MeshLoaderBase(const MeshSetup& setup);
@@ -26,7 +26,7 @@ public:
 
 protected:
     MeshSetup setup;
-    std::function<void(MeshSetup&)> onLoaded;
+    LoadedFunc onLoaded;
 };
 
 } // namespace Oryol
\ No newline at end of file
@@ -7,7 +7,7 @@
 */
 #include "Resource/ResourceLoader.h"
 #include "Gfx/GfxTypes.h"
-#include <functional>
+#include "Core/Function.h"
 
 namespace Oryol {
 
@@ -15,7 +15,7 @@ class TextureLoaderBase : public ResourceLoader {
     OryolClassDecl(TextureLoaderBase);
 public:
     /// optional callback when loading has succeeded
-    typedef std::function<void(TextureSetup&)> LoadedFunc;
+    typedef Function<void(TextureSetup&)> LoadedFunc;
 
     /// constructor
     TextureLoaderBase(const TextureSetup& setup);
@@ -26,7 +26,7 @@ public:
 
 protected:
     TextureSetup setup;
-    std::function<void(TextureSetup&)> onLoaded;
+    LoadedFunc onLoaded;
 };
 
 } // namespace Oryol
@@ -100,7 +100,7 @@ displayMgrBase::GetDisplayAttrs() const {
 displayMgrBase::eventHandlerId
 displayMgrBase::Subscribe(eventHandler handler) {
     eventHandlerId id = this->uniqueIdCounter++;
-    this->handlers.Add(id, handler);
+    this->handlers.Add(KeyValuePair<eventHandlerId, eventHandler>(std::move(id), std::move(handler)));
     return id;
 }
 
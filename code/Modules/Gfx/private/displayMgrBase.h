@@ -10,7 +10,7 @@
 #include "Gfx/GfxTypes.h"
 #include "Core/Containers/Map.h"
 #include "Gfx/private/gfxPointers.h"
-#include <functional>
+#include "Core/Function.h"
 
 namespace Oryol {
 namespace _priv {
@@ -18,7 +18,7 @@ namespace _priv {
 class displayMgrBase {
 public:
     /// event handler typedef
-    typedef std::function<void(const GfxEvent&)> eventHandler;
+    typedef Function<void(const GfxEvent&)> eventHandler;
     /// event handler id
     typedef unsigned int eventHandlerId;
 
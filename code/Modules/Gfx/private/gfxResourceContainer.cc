@@ -26,7 +26,7 @@ gfxResourceContainer::setup(const GfxSetup& setup, const gfxPointers& ptrs) {
     this->factory.setup(this->pointers);
     this->runLoopId = Core::PostRunLoop()->Add([this]() {
         this->update();
-    });
+    }, RunLoop::DefaultPriority, "gfxResources");
     
     ResourceContainerBase::Setup(setup.ResourceLabelStackCapacity, setup.ResourceRegistryCapacity);
 }
@@ -279,7 +279,8 @@ gfxResourceContainer::Load(const Ptr<ResourceLoader>& loader) {
 void
 gfxResourceContainer::DestroyDeferred(const ResourceLabel& label) {
     o_assert_dbg(this->IsValid());
-    Array<Id> ids = this->registry.Remove(label);
+    // the ids are copied into the destroy queue, a frame-allocated array is fine
+    Array<Id> ids = this->registry.Remove(label, Core::FrameAllocator());
     if (ids.Size() > 0) {
         this->destroyQueue.Reserve(ids.Size());
         for (const Id& id : ids) {
@@ -372,7 +373,7 @@ gfxResourceContainer::destroyResource(const Id& id) {
 void
 gfxResourceContainer::Destroy(const ResourceLabel& label) {
     o_assert_dbg(this->IsValid());
-    Array<Id> ids = this->registry.Remove(label);
+    Array<Id> ids = this->registry.Remove(label, Core::FrameAllocator());
     for (const Id& id : ids) {
         this->destroyResource(id);
     }
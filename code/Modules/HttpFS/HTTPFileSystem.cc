@@ -3,15 +3,31 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "HTTPFileSystem.h"
+#include "Core/Time/Clock.h"
 
 namespace Oryol {
     
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::initLane() {
+    FileSystemBase::initLane();
+    this->bytesReadMetric = Metrics::Counter("io.http.bytesRead");
+    this->readTimeMetric = Metrics::Histogram("io.http.readTime");
+}
+
 //------------------------------------------------------------------------------
 void
 HTTPFileSystem::onMsg(const Ptr<IORequest>& ioReq) {
     Ptr<IORead> ioReadRequest = ioReq->DynamicCast<IORead>();
     if (ioReadRequest.isValid()) {
+        const TimePoint startTime = Clock::Now();
         this->loader.doRequest(ioReadRequest);
+        // asynchronous loaders (emscripten) finish the request later,
+        // only the synchronous loaders can be measured here
+        if (ioReadRequest->Handled) {
+            Metrics::Add(this->bytesReadMetric, ioReadRequest->Data.Size());
+            Metrics::Record(this->readTimeMetric, Clock::Since(startTime));
+        }
     }
 }
 
@@ -13,6 +13,7 @@
 */
 #include "IO/FileSystemBase.h"
 #include "Core/Creator.h"
+#include "Core/Metrics/Metrics.h"
 #include "HttpFS/private/urlLoader.h"
 
 namespace Oryol {
@@ -21,11 +22,15 @@ class HTTPFileSystem : public FileSystemBase {
     OryolClassDecl(HTTPFileSystem);
     OryolClassCreator(HTTPFileSystem);
 public:
+    /// called per IO-lane
+    virtual void initLane() override;
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq) override;
 
 private:
     _priv::urlLoader loader;
+    Metric bytesReadMetric;
+    Metric readTimeMetric;
 };
     
 } // namespace Oryol
@@ -30,4 +30,10 @@ FileSystemBase::onMsg(const Ptr<IORequest>& ioReq) {
     o_warn("FileSystem::onMsg(): message not handled by FileSystem!\n");
 }
 
+//------------------------------------------------------------------------------
+void
+FileSystemBase::onFlush() {
+    // empty
+}
+
 } // namespace Oryol
@@ -26,6 +26,8 @@ public:
     virtual void initLane();
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq);
+    /// called after a batch of IO messages has been handled (for submitting batched requests)
+    virtual void onFlush();
 
     StringAtom scheme;
 };
@@ -9,6 +9,8 @@
 #include "IO/private/ioRouter.h"
 #include "IO/private/assignRegistry.h"
 #include "IO/private/schemeRegistry.h"
+#include "IO/private/ioBudgets.h"
+#include "IO/private/ioCoalescer.h"
 #include "IO/private/loadQueue.h"
 #include "Core/RunLoop.h"
 
@@ -20,7 +22,9 @@ namespace {
     struct _state {
         _priv::assignRegistry assignReg;
         _priv::schemeRegistry schemeReg;
+        _priv::ioBudgets budgets;
         _priv::ioRouter router;
+        _priv::ioCoalescer coalescer;
         RunLoop::Id runLoopId = RunLoop::InvalidId;
         class loadQueue loadQueue;
     };
@@ -31,12 +35,15 @@ namespace {
 void
 IO::Setup(const IOSetup& setup) {
     o_assert(!IsValid());
+    o_memory_scope(IO);
 
     state = Memory::New<_state>();
     ioPointers ptrs;
     ptrs.schemeRegistry = &state->schemeReg;
     ptrs.assignRegistry = &state->assignReg;
-    state->router.setup(ptrs);
+    ptrs.budgets = &state->budgets;
+    state->router.setup(ptrs, setup.NumWorkers, setup.ImmediateDispatch);
+    state->coalescer.setup(setup.CoalesceReads);
 
     // setup initial assigns
     for (const auto& assign : setup.Assigns) {
@@ -48,7 +55,7 @@ IO::Setup(const IOSetup& setup) {
         RegisterFileSystem(fs.Key(), fs.Value());
     }
 
-    state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); });
+    state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); }, RunLoop::DefaultPriority, "io");
 }
 
 //------------------------------------------------------------------------------
@@ -57,6 +64,7 @@ IO::Discard() {
     o_assert(IsValid());
     Core::PreRunLoop()->Remove(state->runLoopId);
     state->router.discard();
+    state->coalescer.discard();
     Memory::Delete(state);
     state = nullptr;
 }
@@ -66,8 +74,11 @@ void
 IO::doWork() {
     o_assert_dbg(IsValid());
     o_assert_dbg(Core::IsMainThread());
+    state->budgets.newFrame();
+    // hand finished reads to coalesced followers before the loadQueue checks them
+    state->coalescer.update(&state->router);
     state->router.doWork();
-    state->loadQueue.update();
+    state->loadQueue.update(&state->coalescer);
 }
 
 //------------------------------------------------------------------------------
@@ -114,12 +125,14 @@ IO::RegisterFileSystem(const StringAtom& scheme, std::function<Ptr<FileSystemBas
         // notify IO threads that a filesystem was added
         Ptr<notifyFileSystemAdded> msg = notifyFileSystemAdded::Create();
         msg->Scheme = scheme;
+        msg->Creator = fsCreator;
         state->router.put(msg);
     }
     else {
         // notify IO threads that a filesystem was replaced
         Ptr<notifyFileSystemReplaced> msg = notifyFileSystemReplaced::Create();
         msg->Scheme = scheme;
+        msg->Creator = fsCreator;
         state->router.put(msg);
     }
 }
@@ -129,6 +142,11 @@ void
 IO::UnregisterFileSystem(const StringAtom& scheme) {
     o_assert_dbg(IsValid());
     state->schemeReg.UnregisterFileSystem(scheme);
+
+    // notify IO threads that a filesystem was removed
+    Ptr<notifyFileSystemRemoved> msg = notifyFileSystemRemoved::Create();
+    msg->Scheme = scheme;
+    state->router.put(msg);
 }
 
 //------------------------------------------------------------------------------
@@ -140,16 +158,23 @@ IO::IsFileSystemRegistered(const StringAtom& scheme) {
 
 //------------------------------------------------------------------------------
 void
-IO::Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed) {
+IO::Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed, IOPriority::Code priority, TimePoint deadline) {
     o_assert_dbg(IsValid());
-    state->loadQueue.add(url, onSuccess, onFailed);
+    state->loadQueue.add(url, std::move(onSuccess), std::move(onFailed), priority, deadline);
 }
 
 //------------------------------------------------------------------------------
 void
-IO::LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed) {
+IO::LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed, IOPriority::Code priority) {
     o_assert_dbg(IsValid());
-    state->loadQueue.addGroup(urls, onSuccess, onFailed);
+    state->loadQueue.addGroup(urls, std::move(onSuccess), std::move(onFailed), priority);
+}
+
+//------------------------------------------------------------------------------
+void
+IO::SetLoadPriority(const URL& url, IOPriority::Code priority) {
+    o_assert_dbg(IsValid());
+    state->loadQueue.setPriority(url, priority);
 }
 
 //------------------------------------------------------------------------------
@@ -161,11 +186,25 @@ IO::NumPendingLoads() {
 
 //------------------------------------------------------------------------------
 Ptr<IORead>
-IO::LoadFile(const URL& url) {
+IO::LoadFile(const URL& url, IOPriority::Code priority, TimePoint deadline) {
     o_assert_dbg(IsValid());
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
-    state->router.put(ioReq);
+    ioReq->Priority = priority;
+    ioReq->Deadline = deadline;
+    Put(ioReq);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORead>
+IO::MapFile(const URL& url, IOPriority::Code priority) {
+    o_assert_dbg(IsValid());
+    Ptr<IORead> ioReq = IORead::Create();
+    ioReq->Url = url;
+    ioReq->Priority = priority;
+    ioReq->MapEnabled = true;
+    Put(ioReq);
     return ioReq;
 }
 
@@ -184,7 +223,28 @@ IO::WriteFile(const URL& url, const Buffer& data) {
 void
 IO::Put(const Ptr<IORequest>& ioReq) {
     o_assert_dbg(IsValid());
-    state->router.put(ioReq);
+    if (!state->coalescer.put(ioReq)) {
+        state->router.put(ioReq);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IO::SetPriority(const Ptr<IORequest>& ioReq, IOPriority::Code priority) {
+    o_assert_dbg(IsValid());
+    o_assert_range_dbg(priority, IOPriority::NumPriorities);
+    if (ioReq->Priority != priority) {
+        ioReq->Priority = priority;
+        // the IO threads resort their queues before they start the next request
+        ioWorker::priorityChanged();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IO::SetFrameBudget(const StringAtom& scheme, int maxBytes, int maxRequests) {
+    o_assert_dbg(IsValid());
+    state->budgets.set(scheme, maxBytes, maxRequests);
 }
 
 } // namespace Oryol
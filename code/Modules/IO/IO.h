@@ -10,6 +10,7 @@
 */
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Time/TimePoint.h"
 #include "IO/IOTypes.h"
 #include "IO/private/loadQueue.h"
 
@@ -49,19 +50,28 @@ public:
     /// result of an asynchronous loading operation
     typedef loadQueue::result LoadResult;
     
-    /// async load a file, with success and fail callbacks
-    static void Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc());
-    /// async load a group of files, with success and fail callbacks
-    static void LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc());
+    /// async load a file, with success and fail callbacks, optional priority and deadline
+    static void Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc(), IOPriority::Code priority=IOPriority::Normal, TimePoint deadline=TimePoint());
+    /// async load a group of files, with success and fail callbacks and optional priority
+    static void LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc(), IOPriority::Code priority=IOPriority::Normal);
+    /// change the priority of pending Load() and LoadGroup() actions for an URL
+    static void SetLoadPriority(const URL& url, IOPriority::Code priority);
     /// get number of pending Load() and LoadGroup() actions
     static int NumPendingLoads();
 
     /// low-level: start async loading of file from URL, return message for polling result
-    static Ptr<IORead> LoadFile(const URL& url);
+    static Ptr<IORead> LoadFile(const URL& url, IOPriority::Code priority=IOPriority::Normal, TimePoint deadline=TimePoint());
+    /// low-level: like LoadFile, but the file system may return a read-only mapped View instead of Data
+    static Ptr<IORead> MapFile(const URL& url, IOPriority::Code priority=IOPriority::Normal);
     /// low-level: start async writing of file via URL, return message for polling result
     static Ptr<IOWrite> WriteFile(const URL& url, const Buffer& data);
     /// low-level: push a generic asynchronous IO request
     static void Put(const Ptr<IORequest>& ioReq);
+    /// low-level: change the priority of a request which hasn't started yet
+    static void SetPriority(const Ptr<IORequest>& ioReq, IOPriority::Code priority);
+
+    /// limit the bytes and requests per frame which are started for an URL scheme (0 is unlimited)
+    static void SetFrameBudget(const StringAtom& scheme, int maxBytes, int maxRequests);
     
 private:
     /// pump the ioRequestRouter
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "IOTypes.h"
 #include "IO/IO.h"
+#include "Core/Core.h"
 
 namespace Oryol {
 
@@ -210,6 +211,7 @@ URL::crack(String urlString) {
     if (urlString.IsValid()) {
     
         StringBuilder builder;
+        builder.SetAllocator(Core::FrameAllocator());
         builder.Set(urlString);
         this->content = urlString;
         
@@ -474,6 +476,7 @@ URL::Query() const {
     if (this->HasQuery()) {
         Map<String, String> query;
         StringBuilder builder;
+        builder.SetAllocator(Core::FrameAllocator());
         builder.Set(this->content.AsCStr(), this->indices[queryStart], this->indices[queryEnd]);
         int kvpStartIndex = 0;
         int kvpEndIndex = 0;
@@ -23,6 +23,34 @@ public:
     Map<String, String> Assigns;
     /// initial file systems
     Map<StringAtom, std::function<Ptr<FileSystemBase>()>> FileSystems;
+    /// number of IO worker threads (1..MaxNumIOWorkers)
+    int NumWorkers = 4;
+    /// max number of IO worker threads
+    static const int MaxNumIOWorkers = 16;
+    /// hand requests to the workers in IO::Put() instead of once per frame in the runloop
+    bool ImmediateDispatch = false;
+    /// identical in-flight reads share one file system operation (followers get the data in IORequest::View)
+    bool CoalesceReads = false;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOPriority
+    @ingroup IO
+    @brief IO request priorities
+
+    The IO threads handle queued requests with higher priority first,
+    requests with the same priority in the order they have been put.
+*/
+class IOPriority {
+public:
+    /// priority enum
+    enum Code {
+        Low = 0,        ///< background loading and streaming
+        Normal,         ///< the default
+        High,           ///< data which is needed right now
+        NumPriorities,
+    };
 };
 
 //------------------------------------------------------------------------------
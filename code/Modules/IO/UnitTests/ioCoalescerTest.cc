@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//  ioCoalescerTest.cc
+//  Test coalescing of identical in-flight reads.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/UnitTests/ioTestHelper.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Time/Clock.h"
+#include "Core/Metrics/Metrics.h"
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static int64_t
+metricTotal(const char* name) {
+    const MetricsSnapshot snapshot = Metrics::Snapshot();
+    const MetricsSnapshot::Value* val = snapshot.Find(name);
+    return val ? val->Total : 0;
+}
+
+//------------------------------------------------------------------------------
+// check the data of a coalesced or normal read
+static bool
+checkData(const Ptr<IORead>& req, int start, int end) {
+    const uint8_t* ptr = req->View ? req->View->Data() : req->Data.Data();
+    const int size = req->View ? req->View->Size() : req->Data.Size();
+    if ((IOStatus::OK != req->Status) || (size != (end - start))) {
+        return false;
+    }
+    for (int i = 0; i < size; i++) {
+        if (ptr[i] != uint8_t(start + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ioCoalesceReadsTest) {
+    Core::Setup();
+    setupTestIO(4, false, true);
+    const int64_t coalescedBefore = metricTotal("io.coalescedReads");
+    const int64_t bytesBefore = metricTotal("io.coalescedBytes");
+
+    // 10 reads of the same file, 3 reads of the same range, 1 other file
+    Array<Ptr<IORead>> fileReqs;
+    for (int i = 0; i < 10; i++) {
+        fileReqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    }
+    Array<Ptr<IORead>> rangeReqs;
+    for (int i = 0; i < 3; i++) {
+        Ptr<IORead> req = IORead::Create();
+        req->Url = "test://bla/atlas.bin";
+        req->StartOffset = 10;
+        req->EndOffset = 20;
+        IO::Put(req);
+        rangeReqs.Add(req);
+    }
+    Array<Ptr<IORead>> otherReqs;
+    otherReqs.Add(IO::LoadFile("test://bla/other.bin"));
+    CHECK(waitHandled(fileReqs));
+    CHECK(waitHandled(rangeReqs));
+    CHECK(waitHandled(otherReqs));
+    CHECK(ioTestFileSystem::NumHandled() == 3);
+
+    // the first read has its own data, the followers share one view
+    CHECK(checkData(fileReqs[0], 0, 100));
+    CHECK(!fileReqs[0]->View);
+    for (int i = 1; i < fileReqs.Size(); i++) {
+        CHECK(checkData(fileReqs[i], 0, 100));
+        CHECK(fileReqs[i]->Data.Empty());
+        CHECK(fileReqs[i]->View == fileReqs[1]->View);
+    }
+    for (const auto& req : rangeReqs) {
+        CHECK(checkData(req, 10, 20));
+    }
+    CHECK(checkData(otherReqs[0], 0, 100));
+    CHECK((metricTotal("io.coalescedReads") - coalescedBefore) == 11);
+    CHECK((metricTotal("io.coalescedBytes") - bytesBefore) == (9 * 100 + 2 * 10));
+
+    // finished reads aren't coalesced
+    ioTestFileSystem::Reset();
+    Array<Ptr<IORead>> laterReqs;
+    laterReqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    CHECK(waitHandled(laterReqs));
+    CHECK(ioTestFileSystem::NumHandled() == 1);
+    CHECK(checkData(laterReqs[0], 0, 100));
+
+    discardTestIO();
+    Core::Discard();
+}
+
+TEST(ioCoalesceDisabledTest) {
+    Core::Setup();
+    setupTestIO(4, false, false);
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 4; i++) {
+        reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    }
+    CHECK(waitHandled(reqs));
+    CHECK(ioTestFileSystem::NumHandled() == 4);
+    for (const auto& req : reqs) {
+        CHECK(!req->View);
+        CHECK(checkData(req, 0, 100));
+    }
+    discardTestIO();
+    Core::Discard();
+}
+
+TEST(ioCoalesceCancelTest) {
+    Core::Setup();
+    // immediate dispatch, so that the first read finishes without the runloop
+    setupTestIO(1, true, true);
+
+    // a follower still gets the data if the first read is cancelled
+    // while it is queued behind another request
+    Ptr<IORead> blocker = startBlocker();
+    Array<Ptr<IORead>> reqs;
+    reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    reqs[0]->Cancelled = true;
+    reqs[2]->Cancelled = true;
+    ioTestFileSystem::Release();
+    CHECK(waitHandled(reqs));
+    CHECK(IOStatus::Cancelled == reqs[0]->Status);
+    CHECK(checkData(reqs[1], 0, 100));
+    CHECK(IOStatus::Cancelled == reqs[2]->Status);
+    CHECK(ioTestFileSystem::NumHandled() == 2);
+    // let the coalescer forget the finished read
+    Core::PreRunLoop()->Run();
+
+    // a follower still gets the data if the data of the first read has been taken
+    reqs.Clear();
+    reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    reqs.Add(IO::LoadFile("test://bla/atlas.bin"));
+    const TimePoint start = Clock::Now();
+    while (!reqs[0]->Handled && (Clock::Since(start).AsSeconds() < 10.0)) {
+        std::this_thread::yield();
+    }
+    Buffer taken = std::move(reqs[0]->Data);
+    CHECK(taken.Size() == 100);
+    CHECK(waitHandled(reqs));
+    CHECK(checkData(reqs[1], 0, 100));
+
+    discardTestIO();
+    Core::Discard();
+}
+
+TEST(ioCoalesceLoadTest) {
+    Core::Setup();
+    setupTestIO(4, false, true);
+    int numLoaded = 0;
+    for (int i = 0; i < 3; i++) {
+        IO::Load("test://bla/atlas.bin", [&numLoaded](IO::LoadResult res) {
+            CHECK(res.Data.Size() == 100);
+            CHECK(res.Data.Data()[99] == 99);
+            numLoaded++;
+        });
+    }
+    const TimePoint start = Clock::Now();
+    while ((IO::NumPendingLoads() > 0) && (Clock::Since(start).AsSeconds() < 10.0)) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::yield();
+    }
+    CHECK(numLoaded == 3);
+    CHECK(ioTestFileSystem::NumHandled() == 1);
+    discardTestIO();
+    Core::Discard();
+}
@@ -0,0 +1,283 @@
+//------------------------------------------------------------------------------
+//  ioPriorityTest.cc
+//  Test request priorities, deadlines and frame budgets.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/UnitTests/ioTestHelper.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Time/Clock.h"
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static int
+numHandled(const Array<Ptr<IORead>>& reqs) {
+    int num = 0;
+    for (const auto& req : reqs) {
+        if (req->Handled) {
+            num++;
+        }
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+// wait without running the runloop until num requests are handled
+static bool
+waitNumHandled(const Array<Ptr<IORead>>& reqs, int num) {
+    const TimePoint start = Clock::Now();
+    while (numHandled(reqs) < num) {
+        if (Clock::Since(start).AsSeconds() > 10.0) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// check that the requests were handled in the given order after the blocker
+static bool
+checkOrder(const Ptr<IORead>& blocker, const Array<Ptr<IORead>>& reqs) {
+    const Array<Ptr<IORequest>> handled = ioTestFileSystem::HandledRequests();
+    if ((handled.Size() != reqs.Size() + 1) || (handled[0] != blocker)) {
+        return false;
+    }
+    for (int i = 0; i < reqs.Size(); i++) {
+        if (handled[i + 1] != reqs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ioPriorityOrderTest) {
+    Core::Setup();
+    for (int immediate = 0; immediate < 2; immediate++) {
+        setupTestIO(1, 0 != immediate);
+
+        // queue requests behind a running request
+        Ptr<IORead> blocker = startBlocker();
+        Array<Ptr<IORead>> lowReqs;
+        for (int i = 0; i < 100; i++) {
+            lowReqs.Add(IO::LoadFile("test://bla/low.bin", IOPriority::Low));
+        }
+        Array<Ptr<IORead>> normalReqs;
+        for (int i = 0; i < 5; i++) {
+            normalReqs.Add(IO::LoadFile("test://bla/normal.bin"));
+        }
+        Ptr<IORead> highReq = IO::LoadFile("test://bla/high.bin", IOPriority::High);
+        Core::PreRunLoop()->Run();
+        ioTestFileSystem::Release();
+        CHECK(waitHandled(lowReqs));
+
+        // the high-priority request only waited for the running request,
+        // requests of the same priority keep their order
+        Array<Ptr<IORead>> expected;
+        expected.Add(highReq);
+        for (const auto& req : normalReqs) {
+            expected.Add(req);
+        }
+        for (const auto& req : lowReqs) {
+            expected.Add(req);
+        }
+        CHECK(checkOrder(blocker, expected));
+        CHECK(IOStatus::OK == highReq->Status);
+        discardTestIO();
+    }
+    Core::Discard();
+}
+
+TEST(ioReprioritizeTest) {
+    Core::Setup();
+    for (int immediate = 0; immediate < 2; immediate++) {
+        setupTestIO(1, 0 != immediate);
+        Ptr<IORead> blocker = startBlocker();
+        Array<Ptr<IORead>> lowReqs;
+        for (int i = 0; i < 100; i++) {
+            lowReqs.Add(IO::LoadFile("test://bla/low.bin", IOPriority::Low));
+        }
+        Core::PreRunLoop()->Run();
+
+        // the last queued request jumps the queue
+        Ptr<IORead> lastReq = lowReqs.PopBack();
+        IO::SetPriority(lastReq, IOPriority::High);
+        CHECK(lastReq->Priority == IOPriority::High);
+        ioTestFileSystem::Release();
+        CHECK(waitHandled(lowReqs));
+        CHECK(waitHandled(lastReq));
+
+        Array<Ptr<IORead>> expected;
+        expected.Add(lastReq);
+        for (const auto& req : lowReqs) {
+            expected.Add(req);
+        }
+        CHECK(checkOrder(blocker, expected));
+        discardTestIO();
+    }
+    Core::Discard();
+}
+
+TEST(ioDeadlineTest) {
+    Core::Setup();
+    for (int immediate = 0; immediate < 2; immediate++) {
+        setupTestIO(1, 0 != immediate);
+        startBlocker();
+
+        // the deadline of the late request expires while it is queued
+        const TimePoint deadline = Clock::Now() + Duration::FromMilliSeconds(1.0);
+        Ptr<IORead> lateReq = IO::LoadFile("test://bla/late.bin", IOPriority::Low, deadline);
+        Ptr<IORead> okReq = IO::LoadFile("test://bla/ok.bin", IOPriority::Low, Clock::Now() + Duration::FromSeconds(3600.0));
+        Core::PreRunLoop()->Run();
+        while (Clock::Now() <= deadline) {
+            std::this_thread::yield();
+        }
+        ioTestFileSystem::Release();
+        CHECK(waitHandled(lateReq));
+        CHECK(waitHandled(okReq));
+        CHECK(IOStatus::RequestTimeout == lateReq->Status);
+        CHECK(IOStatus::OK == okReq->Status);
+        CHECK(InvalidIndex == ioTestFileSystem::HandledFrame(lateReq));
+        discardTestIO();
+    }
+    Core::Discard();
+}
+
+// marks requests as 'Accepted' instead of 'OK'
+class OtherTestFileSystem : public FileSystemBase {
+    OryolClassDecl(OtherTestFileSystem);
+    OryolClassCreator(OtherTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        msg->Status = IOStatus::Accepted;
+        msg->Handled = true;
+    };
+};
+
+TEST(ioFileSystemNotifyOrderTest) {
+    Core::Setup();
+    setupTestIO(1, false);
+
+    // requests which were sent before a file system is replaced go to the old file system
+    Array<Ptr<IORead>> oldReqs;
+    for (int i = 0; i < 10; i++) {
+        oldReqs.Add(IO::LoadFile("test://bla/blub.bin", IOPriority::Low));
+    }
+    IO::RegisterFileSystem("test", OtherTestFileSystem::Creator());
+    Ptr<IORead> newReq = IO::LoadFile("test://bla/blub.bin", IOPriority::Low);
+    CHECK(waitHandled(newReq));
+    CHECK(waitHandled(oldReqs));
+    for (const auto& req : oldReqs) {
+        CHECK(IOStatus::OK == req->Status);
+    }
+    CHECK(IOStatus::Accepted == newReq->Status);
+
+    // queued requests of a removed file system fail
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 10; i++) {
+        reqs.Add(IO::LoadFile("test://bla/blub.bin"));
+    }
+    IO::UnregisterFileSystem("test");
+    CHECK(waitHandled(reqs));
+    for (const auto& req : reqs) {
+        CHECK(IOStatus::NotFound == req->Status);
+    }
+
+    // ...and it can be registered again
+    IO::RegisterFileSystem("test", ioTestFileSystem::Creator());
+    newReq = IO::LoadFile("test://bla/blub.bin");
+    CHECK(waitHandled(newReq));
+    CHECK(IOStatus::OK == newReq->Status);
+
+    discardTestIO();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+// run frames until the requests are handled, and check that each pair
+// of requests was handled in its own frame
+static bool
+checkTwoPerFrame(const Array<Ptr<IORead>>& reqs, bool immediate) {
+    // immediate dispatch starts requests before the next frame
+    if (!immediate) {
+        ioTestFileSystem::RunFrame();
+    }
+    for (int i = 2; i <= reqs.Size(); i += 2) {
+        if (!waitNumHandled(reqs, i)) {
+            return false;
+        }
+        if (i < reqs.Size()) {
+            ioTestFileSystem::RunFrame();
+        }
+    }
+    for (int i = 0; i < reqs.Size(); i += 2) {
+        const int frame = ioTestFileSystem::HandledFrame(reqs[i]);
+        if ((InvalidIndex == frame) || (frame != ioTestFileSystem::HandledFrame(reqs[i + 1]))) {
+            return false;
+        }
+        if ((i > 0) && (frame != ioTestFileSystem::HandledFrame(reqs[i - 1]) + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(ioFrameBudgetTest) {
+    Core::Setup();
+    for (int immediate = 0; immediate < 2; immediate++) {
+        setupTestIO(1, 0 != immediate);
+
+        // 2 requests per frame
+        IO::SetFrameBudget("test", 0, 2);
+        Array<Ptr<IORead>> reqs;
+        for (int i = 0; i < 6; i++) {
+            reqs.Add(IO::LoadFile("test://bla/blub.bin"));
+        }
+        CHECK(checkTwoPerFrame(reqs, 0 != immediate));
+
+        // 100 bytes per frame, a request is started while the budget isn't used up
+        IO::SetFrameBudget("test", 100, 0);
+        ioTestFileSystem::RunFrame();
+        reqs.Clear();
+        for (int i = 0; i < 6; i++) {
+            Ptr<IORead> req = IORead::Create();
+            req->Url = "test://bla/blub.bin";
+            req->StartOffset = i * 10;
+            req->EndOffset = i * 10 + 60;
+            IO::Put(req);
+            reqs.Add(req);
+        }
+        CHECK(checkTwoPerFrame(reqs, 0 != immediate));
+
+        // a read to the end of the file (100 bytes) is charged in
+        // the frame after it has been handled
+        ioTestFileSystem::RunFrame();
+        Ptr<IORead> fileReq = IO::LoadFile("test://bla/blub.bin");
+        if (0 == immediate) {
+            ioTestFileSystem::RunFrame();
+        }
+        CHECK(waitHandled(fileReq, false));
+        CHECK(100 == fileReq->Data.Size());
+        Ptr<IORead> rangeReq = IORead::Create();
+        rangeReq->Url = "test://bla/blub.bin";
+        rangeReq->EndOffset = 10;
+        if (0 == immediate) {
+            IO::Put(rangeReq);
+        }
+        ioTestFileSystem::RunFrame();
+        const int chargedFrame = ioTestFileSystem::HandledFrame(fileReq) + 1;
+        if (0 != immediate) {
+            IO::Put(rangeReq);
+        }
+        ioTestFileSystem::RunFrame();
+        CHECK(waitHandled(rangeReq, false));
+        CHECK(ioTestFileSystem::HandledFrame(rangeReq) == chargedFrame + 1);
+
+        IO::SetFrameBudget("test", 0, 0);
+        discardTestIO();
+    }
+    Core::Discard();
+}
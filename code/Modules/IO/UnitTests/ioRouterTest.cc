@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//  ioRouterTest.cc
+//  Test ioRouter dispatch and immediate dispatch through the IO facade.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/UnitTests/ioTestHelper.h"
+#include "IO/private/ioRouter.h"
+#include "IO/private/assignRegistry.h"
+#include "IO/private/schemeRegistry.h"
+#include "Core/Core.h"
+#include <thread>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+TEST(ioRouterLeastLoadedTest) {
+    Core::Setup();
+    assignRegistry assignReg;
+    schemeRegistry schemeReg;
+    ioPointers ptrs;
+    ptrs.assignRegistry = &assignReg;
+    ptrs.schemeRegistry = &schemeReg;
+    ioRouter router;
+    router.setup(ptrs, 3, false);
+    CHECK(router.numWorkers == 3);
+
+    // without doWork(), requests are only queued on the workers,
+    // cancelled requests are handled without a file system
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 3; i++) {
+        auto req = IORead::Create();
+        req->Cancelled = true;
+        router.workers[0].put(req);
+        reqs.Add(req);
+    }
+    CHECK(router.workers[0].load() == 3);
+    CHECK(router.workers[1].load() == 0);
+    CHECK(router.workers[2].load() == 0);
+
+    // new requests go to the less loaded workers
+    for (int i = 0; i < 6; i++) {
+        auto req = IORead::Create();
+        req->Cancelled = true;
+        router.put(req);
+        reqs.Add(req);
+    }
+    CHECK(router.workers[0].load() == 3);
+    CHECK(router.workers[1].load() == 3);
+    CHECK(router.workers[2].load() == 3);
+
+    // equally loaded workers take turns
+    for (int i = 0; i < 3; i++) {
+        auto req = IORead::Create();
+        req->Cancelled = true;
+        router.put(req);
+        reqs.Add(req);
+    }
+    CHECK(router.workers[0].load() == 4);
+    CHECK(router.workers[1].load() == 4);
+    CHECK(router.workers[2].load() == 4);
+
+    router.doWork();
+    CHECK(waitHandled(reqs, false));
+    for (const auto& req : reqs) {
+        CHECK(req->Status == IOStatus::Cancelled);
+    }
+    router.discard();
+    Core::Discard();
+}
+
+TEST(ioRouterImmediateDispatchTest) {
+    const int numWorkers[] = { 1, 3 };
+    for (const int num : numWorkers) {
+        Core::Setup();
+        setupTestIO(num, true);
+
+        // requests are handled without running the runloop
+        Array<Ptr<IORead>> reqs;
+        for (int i = 0; i < 1000; i++) {
+            reqs.Add(IO::LoadFile("test://bla/blub.txt"));
+        }
+        CHECK(waitHandled(reqs, false));
+        for (const auto& req : reqs) {
+            CHECK(req->Status == IOStatus::OK);
+        }
+
+        // more requests than fit into the handoff queues, the
+        // overflow is dispatched by the runloop
+        reqs.Clear();
+        for (int i = 0; i < 3 * ioWorker::HandoffQueueSize; i++) {
+            reqs.Add(IO::LoadFile("test://bla/blub.txt"));
+        }
+        CHECK(waitHandled(reqs));
+        for (const auto& req : reqs) {
+            CHECK(req->Status == IOStatus::OK);
+        }
+
+        // a single request after the workers went to sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        reqs.Clear();
+        reqs.Add(IO::LoadFile("test://bla/blob.txt"));
+        CHECK(waitHandled(reqs, false));
+
+        discardTestIO();
+        Core::Discard();
+    }
+}
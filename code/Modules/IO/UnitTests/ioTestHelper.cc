@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+//  ioTestHelper.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioTestHelper.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Time/Clock.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Oryol {
+
+namespace {
+struct record {
+    Ptr<IORequest> req;
+    int frame = 0;
+};
+std::mutex mutex;
+std::condition_variable cond;
+bool holding = false;
+int numHolding = 0;
+Array<record> records;
+std::atomic<int> curFrame{0};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+ioTestFileSystem::onMsg(const Ptr<IORequest>& msg) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (holding) {
+            numHolding++;
+            cond.notify_all();
+            cond.wait(lock, [] { return !holding; });
+            numHolding--;
+        }
+        record rec;
+        rec.req = msg;
+        rec.frame = curFrame;
+        records.Add(rec);
+    }
+    if (msg->IsA<IORead>()) {
+        const int end = (EndOfFile == msg->EndOffset) ? 100 : msg->EndOffset;
+        for (int i = msg->StartOffset; i < end; i++) {
+            const uint8_t c = uint8_t(i);
+            msg->Data.Add(&c, 1);
+        }
+    }
+    msg->Status = IOStatus::OK;
+    msg->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioTestFileSystem::Reset() {
+    Release();
+    std::lock_guard<std::mutex> lock(mutex);
+    records.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+ioTestFileSystem::Hold() {
+    std::lock_guard<std::mutex> lock(mutex);
+    holding = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioTestFileSystem::Release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    holding = false;
+    cond.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioTestFileSystem::WaitHolding() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cond.wait_for(lock, std::chrono::seconds(10), [] { return numHolding > 0; });
+}
+
+//------------------------------------------------------------------------------
+void
+ioTestFileSystem::RunFrame() {
+    curFrame++;
+    Core::PreRunLoop()->Run();
+}
+
+//------------------------------------------------------------------------------
+Array<Ptr<IORequest>>
+ioTestFileSystem::HandledRequests() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Array<Ptr<IORequest>> result;
+    for (const record& rec : records) {
+        result.Add(rec.req);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+int
+ioTestFileSystem::HandledFrame(const Ptr<IORequest>& req) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const record& rec : records) {
+        if (rec.req == req) {
+            return rec.frame;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+int
+ioTestFileSystem::NumHandled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records.Size();
+}
+
+//------------------------------------------------------------------------------
+void
+setupTestIO(int numWorkers, bool immediate, bool coalesce) {
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = numWorkers;
+    ioSetup.ImmediateDispatch = immediate;
+    ioSetup.CoalesceReads = coalesce;
+    ioSetup.FileSystems.Add("test", ioTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    Core::PreRunLoop()->Run();
+    ioTestFileSystem::Reset();
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORead>
+startBlocker() {
+    ioTestFileSystem::Hold();
+    Ptr<IORead> blocker = IO::LoadFile("test://bla/blocker.bin", IOPriority::Low);
+    Core::PreRunLoop()->Run();
+    ioTestFileSystem::WaitHolding();
+    return blocker;
+}
+
+//------------------------------------------------------------------------------
+void
+discardTestIO() {
+    ioTestFileSystem::Reset();
+    IO::Discard();
+}
+
+//------------------------------------------------------------------------------
+bool
+waitHandled(const Ptr<IORequest>& req, bool runLoop) {
+    const TimePoint start = Clock::Now();
+    while (!req->Handled) {
+        if (Clock::Since(start).AsSeconds() > 10.0) {
+            return false;
+        }
+        if (runLoop) {
+            Core::PreRunLoop()->Run();
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+waitHandled(const Array<Ptr<IORead>>& reqs, bool runLoop) {
+    for (const auto& req : reqs) {
+        if (!waitHandled(req, runLoop)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Oryol
@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file ioTestHelper.h
+    @brief file system and helper functions shared by the IO unit tests
+
+    The ioTestFileSystem answers every request with IOStatus::OK (reads
+    return the requested range of a 100 byte file where byte i is i), and
+    records the order and the frame (counted by RunFrame()) in which the
+    requests were handled. With Hold(), the IO threads wait in onMsg()
+    until Release() is called, so that tests can queue up requests
+    behind a running request. setupTestIO() registers the file system
+    for the URL scheme 'test'.
+*/
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "Core/Creator.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+class ioTestFileSystem : public FileSystemBase {
+    OryolClassDecl(ioTestFileSystem);
+    OryolClassCreator(ioTestFileSystem);
+public:
+    /// handle a request
+    virtual void onMsg(const Ptr<IORequest>& msg) override;
+
+    /// forget the handled requests, release held requests
+    static void Reset();
+    /// hold requests in onMsg() until Release() is called
+    static void Hold();
+    /// continue held requests
+    static void Release();
+    /// wait until an IO thread holds a request, false after 10 seconds
+    static bool WaitHolding();
+    /// run the runloop for one frame, and count the frame
+    static void RunFrame();
+    /// get the handled requests in the order in which they were handled
+    static Array<Ptr<IORequest>> HandledRequests();
+    /// get the frame in which a request was handled, or InvalidIndex
+    static int HandledFrame(const Ptr<IORequest>& req);
+    /// get the number of handled requests
+    static int NumHandled();
+};
+
+/// setup the IO module with the ioTestFileSystem for the 'test' scheme
+void setupTestIO(int numWorkers, bool immediate, bool coalesce = false);
+/// start a request which blocks an IO thread until ioTestFileSystem::Release()
+Ptr<IORead> startBlocker();
+/// discard the IO module and the recorded requests
+void discardTestIO();
+/// wait until a request is handled, optionally running the runloop, false after 10 seconds
+bool waitHandled(const Ptr<IORequest>& req, bool runLoop = true);
+/// wait until requests are handled, optionally running the runloop, false after 10 seconds
+bool waitHandled(const Array<Ptr<IORead>>& reqs, bool runLoop = true);
+
+} // namespace Oryol
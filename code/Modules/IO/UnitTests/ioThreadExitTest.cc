@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+//  ioThreadExitTest.cc
+//  Test that IO threads release their per-thread data when they exit.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/UnitTests/ioTestHelper.h"
+#include "Core/Core.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Memory/SizeClassAllocator.h"
+
+using namespace Oryol;
+
+// records a metric on the IO thread, like the LocalFileSystem
+class MetricsTestFileSystem : public FileSystemBase {
+    OryolClassDecl(MetricsTestFileSystem);
+    OryolClassCreator(MetricsTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        static const Metric handled = Metrics::Counter("test.io.handled");
+        Metrics::Add(handled, 1);
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+//------------------------------------------------------------------------------
+static void
+runIOCycle() {
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 4;
+    ioSetup.FileSystems.Add("test", MetricsTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 32; i++) {
+        reqs.Add(IO::LoadFile("test://bla/blub.bin"));
+    }
+    CHECK(waitHandled(reqs));
+    IO::Discard();
+}
+
+TEST(ioThreadExitMetricsTest) {
+    Core::Setup();
+    // the metric slot blocks of exited IO threads are reused
+    runIOCycle();
+    const int numSlots = Metrics::NumThreadSlots();
+    for (int i = 0; i < 8; i++) {
+        runIOCycle();
+    }
+    CHECK(Metrics::NumThreadSlots() == numSlots);
+    Core::Discard();
+}
+
+TEST(ioThreadExitCacheTest) {
+    CoreSetup coreSetup;
+    coreSetup.MemoryAllocator = SizeClassAllocator::Instance();
+    Core::Setup(coreSetup);
+    // IO threads hand their allocator thread cache back
+    runIOCycle();
+    const int numCaches = SizeClassAllocator::NumThreadCaches();
+    CHECK(numCaches > 0);
+    for (int i = 0; i < 8; i++) {
+        runIOCycle();
+    }
+    CHECK(SizeClassAllocator::NumThreadCaches() == numCaches);
+    Core::Discard();
+}
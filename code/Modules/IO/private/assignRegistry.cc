@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "assignRegistry.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Core.h"
 
 #if ORYOL_HAS_THREADS
 #include <mutex>
@@ -24,8 +25,9 @@ assignRegistry::SetAssign(const String& assign, const String& path) {
     o_assert_dbg(assign.Length() > 1);  // assigns must be at least 2 chars to not be confused with DOS drive letters
     o_assert_dbg(!path.Empty());
     o_assert_dbg((path.Back() == '/') || (path.Back() == ':')); // path must end in a '/' (dir) or ':' (other assign)
-    if (this->assigns.Contains(assign)) {
-        this->assigns[assign] = path;
+    const int index = this->assigns.FindIndex(assign);
+    if (InvalidIndex != index) {
+        this->assigns.ValueAtIndex(index) = path;
     }
     else {
         this->assigns.Add(assign, path);
@@ -48,8 +50,9 @@ assignRegistry::LookupAssign(const String& assign) const {
     o_assert_dbg(!assign.Empty());
     o_assert_dbg(assign.Back() == ':');
     String result;
-    if (this->assigns.Contains(assign)) {
-        result = this->assigns[assign];
+    const int index = this->assigns.FindIndex(assign);
+    if (InvalidIndex != index) {
+        result = this->assigns.ValueAtIndex(index);
     }
     return result;
 }
@@ -59,6 +62,7 @@ String
 assignRegistry::ResolveAssigns(const String& str) const {
     SCOPED_LOCK;
     StringBuilder builder;
+    builder.SetAllocator(Core::FrameAllocator());
     builder.Set(str);
     
     // while there are assigns to replace...
@@ -69,10 +73,11 @@ assignRegistry::ResolveAssigns(const String& str) const {
             String assignString = builder.GetSubString(0, index + 1);
 
             // lookup the assign, ignore unknown assigns, may be URL schemes
-            if (this->assigns.Contains(assignString)) {
+            const int assignIndex = this->assigns.FindIndex(assignString);
+            if (InvalidIndex != assignIndex) {
                 
                 // replace assign string
-                builder.SubstituteFirst(assignString, this->assigns[assignString]);
+                builder.SubstituteFirst(assignString, this->assigns.ValueAtIndex(assignIndex));
             }
             else break;
         }
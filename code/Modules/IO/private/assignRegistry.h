@@ -8,7 +8,7 @@
     Central registry for assign definitions. Assigns are
     path aliases (google for AmigaOS assign).
 */
-#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/String/String.h"
 
 namespace Oryol {
@@ -28,7 +28,7 @@ public:
     /// setup the standard assigns
     void setStandardAssigns();
     
-    Map<String, String> assigns;
+    HashMap<String, String> assigns;
 };
     
 } // namespace _priv
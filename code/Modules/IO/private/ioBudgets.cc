@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+//  ioBudgets.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioBudgets.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(this->mutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+//------------------------------------------------------------------------------
+ioBudgets::entry*
+ioBudgets::find(const StringAtom& scheme) {
+    for (int i = 0; i < this->numEntries; i++) {
+        if (this->entries[i].scheme == scheme) {
+            return &this->entries[i];
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+ioBudgets::set(const StringAtom& scheme, int maxBytes, int maxRequests) {
+    o_assert_dbg(scheme.IsValid() && (maxBytes >= 0) && (maxRequests >= 0));
+    SCOPED_LOCK;
+    entry* e = this->find(scheme);
+    if (!e) {
+        o_assert(this->numEntries < MaxBudgets);
+        e = &this->entries[this->numEntries++];
+        e->scheme = scheme;
+    }
+    e->maxBytes = maxBytes;
+    e->maxRequests = maxRequests;
+    int num = 0;
+    for (int i = 0; i < this->numEntries; i++) {
+        if ((this->entries[i].maxBytes > 0) || (this->entries[i].maxRequests > 0)) {
+            num++;
+        }
+    }
+    this->numActive = num;
+    if (0 == num) {
+        this->uncharged.Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioBudgets::newFrame() {
+    if (0 == this->numActive) {
+        return;
+    }
+    SCOPED_LOCK;
+    for (int i = 0; i < this->numEntries; i++) {
+        this->entries[i].usedBytes = 0;
+        this->entries[i].usedRequests = 0;
+    }
+    // the data of handled requests is only taken on the main thread
+    for (int i = this->uncharged.Size() - 1; i >= 0; i--) {
+        const Ptr<IORequest>& req = this->uncharged[i];
+        if (req->Handled) {
+            entry* e = this->find(req->Url.Scheme());
+            if (e) {
+                e->usedBytes += req->View ? req->View->Size() : req->Data.Size();
+            }
+            this->uncharged.EraseSwap(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+ioBudgets::result
+ioBudgets::acquire(const Ptr<IORequest>& req) {
+    if (0 == this->numActive) {
+        return unlimited;
+    }
+    SCOPED_LOCK;
+    entry* e = this->find(req->Url.Scheme());
+    if (!e || ((0 == e->maxBytes) && (0 == e->maxRequests))) {
+        return unlimited;
+    }
+    if (((e->maxRequests > 0) && (e->usedRequests >= e->maxRequests)) ||
+        ((e->maxBytes > 0) && (e->usedBytes >= e->maxBytes))) {
+        return denied;
+    }
+    e->usedRequests++;
+    if (EndOfFile != req->EndOffset) {
+        e->usedBytes += req->EndOffset - req->StartOffset;
+    }
+    else if (req->IsA<IOWrite>()) {
+        e->usedBytes += req->Data.Size();
+    }
+    else if (e->maxBytes > 0) {
+        this->uncharged.Add(req);
+    }
+    return granted;
+}
+
+} // namespace _priv
+} // namespace Oryol
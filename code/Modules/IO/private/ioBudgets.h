@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioBudgets
+    @ingroup _priv
+    @brief per-frame byte and request budgets per URL scheme
+
+    The IO worker threads ask for budget before they hand a request to
+    its file system, requests which are denied wait until the next frame.
+    Requests with a byte range (StartOffset to EndOffset) and writes are
+    charged when they start. The size of reads to the end of the file
+    isn't known before they are done, they are charged on the main thread
+    at the start of the first frame after they have been handled (before
+    the loadQueue takes their data). A request is granted as long as the
+    used bytes are below the byte budget, so that requests which are
+    bigger than the budget are loaded too. Budgets are set and reset
+    (once per frame) on the main thread, and acquired from the IO worker
+    threads.
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/String/StringAtom.h"
+#include "IO/private/ioRequests.h"
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class ioBudgets {
+public:
+    /// result of acquire()
+    enum result {
+        unlimited,      ///< the scheme has no budget
+        granted,        ///< the request fits into the budget
+        denied,         ///< the budget for this frame is used up
+    };
+    /// max number of schemes with budgets
+    static const int MaxBudgets = 16;
+
+    /// set budget of a scheme, 0 means unlimited (main thread)
+    void set(const StringAtom& scheme, int maxBytes, int maxRequests);
+    /// reset the used budgets and charge handled reads (main thread, once per frame)
+    void newFrame();
+    /// try to acquire budget for a request (IO worker threads)
+    result acquire(const Ptr<IORequest>& req);
+
+private:
+    struct entry {
+        StringAtom scheme;
+        int maxBytes = 0;
+        int maxRequests = 0;
+        int usedBytes = 0;
+        int usedRequests = 0;
+    };
+    /// find entry by scheme, or nullptr
+    entry* find(const StringAtom& scheme);
+
+    StaticArray<entry, MaxBudgets> entries;
+    int numEntries = 0;
+    /// started reads to the end of the file, charged once they are handled
+    Array<Ptr<IORequest>> uncharged;
+    #if ORYOL_HAS_THREADS
+    std::mutex mutex;
+    std::atomic<int> numActive{0};
+    #else
+    int numActive = 0;
+    #endif
+};
+
+} // namespace _priv
+} // namespace Oryol
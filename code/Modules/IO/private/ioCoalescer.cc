@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+//  ioCoalescer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioCoalescer.h"
+#include "IO/private/ioRouter.h"
+#include "IO/private/ioWorker.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+// a read-only copy of a buffer, shared by all followers of a read
+class ioSharedView : public IOView {
+    OryolClassDecl(ioSharedView);
+public:
+    ioSharedView(const Buffer& src) {
+        if (!src.Empty()) {
+            this->buffer.Add(src.Data(), src.Size());
+        }
+        this->data = this->buffer.Data();
+        this->size = this->buffer.Size();
+    };
+private:
+    Buffer buffer;
+};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::setup(bool enabled_) {
+    this->enabled = enabled_;
+    this->numReads = 0;
+    this->coalescedReadsMetric = Metrics::Counter("io.coalescedReads");
+    this->coalescedBytesMetric = Metrics::Counter("io.coalescedBytes");
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::discard() {
+    this->reads.Clear();
+    this->numReads = 0;
+    this->enabled = false;
+}
+
+//------------------------------------------------------------------------------
+int
+ioCoalescer::numInflight() const {
+    return this->numReads;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCoalescer::put(const Ptr<IORequest>& req) {
+    if (!this->enabled || !req->IsA<IORead>() || req->Cancelled) {
+        return false;
+    }
+    Ptr<IORead> read = req->DynamicCast<IORead>();
+    const StringAtom& url = read->Url.Get();
+    const int index = this->reads.FindIndex(url);
+    if (InvalidIndex != index) {
+        for (inflight& entry : this->reads.ValueAtIndex(index)) {
+            if ((entry.read->StartOffset == read->StartOffset) &&
+                (entry.read->EndOffset == read->EndOffset) &&
+                !entry.read->Cancelled) {
+
+                // the in-flight read is at least as urgent as its followers
+                if (read->Priority > entry.read->Priority) {
+                    entry.read->Priority = int(read->Priority);
+                    ioWorker::priorityChanged();
+                }
+                entry.followers.Add(read);
+                Metrics::Add(this->coalescedReadsMetric, 1);
+                return true;
+            }
+        }
+    }
+    else {
+        this->reads.Add(url, Array<inflight>());
+    }
+    inflight entry;
+    entry.read = read;
+    this->reads[url].Add(std::move(entry));
+    this->numReads++;
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCoalescer::isShared(const Ptr<IORequest>& req) const {
+    if (0 == this->numReads) {
+        return false;
+    }
+    const int index = this->reads.FindIndex(req->Url.Get());
+    if (InvalidIndex != index) {
+        for (const inflight& entry : this->reads.ValueAtIndex(index)) {
+            if ((entry.read == req) && !entry.followers.Empty()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::update(ioRouter* router) {
+    o_assert_dbg(router);
+    if (0 == this->numReads) {
+        return;
+    }
+    for (auto& kvp : this->reads) {
+        Array<inflight>& entries = kvp.Value();
+        for (int i = entries.Size() - 1; i >= 0; i--) {
+            inflight& entry = entries[i];
+
+            // cancelled followers don't need to wait for the read
+            for (int j = entry.followers.Size() - 1; j >= 0; j--) {
+                const Ptr<IORead>& follower = entry.followers[j];
+                if (follower->Cancelled) {
+                    follower->Status = IOStatus::Cancelled;
+                    follower->Handled = true;
+                    entry.followers.EraseSwap(j);
+                }
+            }
+            if (!entry.read->Handled) {
+                continue;
+            }
+            const bool cancelled = IOStatus::Cancelled == entry.read->Status;
+            const bool dataTaken = (IOStatus::OK == entry.read->Status) && !entry.read->View && entry.read->Data.Empty();
+            if ((cancelled || dataTaken) && !entry.followers.Empty()) {
+                // the read was cancelled (or its owner has already moved
+                // the data away), but the followers still want the data
+                entry.read = entry.followers.PopBack();
+                router->put(entry.read);
+                continue;
+            }
+            this->finish(entry);
+            entries.EraseSwap(i);
+            this->numReads--;
+        }
+        if (entries.Empty()) {
+            this->finishedUrls.Add(kvp.Key());
+        }
+    }
+    for (const StringAtom& url : this->finishedUrls) {
+        this->reads.Erase(url);
+    }
+    this->finishedUrls.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::finish(inflight& entry) {
+    if (entry.followers.Empty()) {
+        return;
+    }
+    const Ptr<IORead>& read = entry.read;
+    Ptr<IOView> view = read->View;
+    if (!view && (IOStatus::OK == read->Status)) {
+        view = ioSharedView::Create(read->Data);
+    }
+    for (const Ptr<IORead>& follower : entry.followers) {
+        follower->Status = read->Status;
+        follower->ErrorDesc = read->ErrorDesc;
+        follower->View = view;
+        if (view) {
+            Metrics::Add(this->coalescedBytesMetric, view->Size());
+        }
+        follower->Handled = true;
+    }
+    entry.followers.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,70 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioCoalescer
+    @ingroup _priv
+    @brief share one file system operation between identical IORead requests
+
+    If IOSetup::CoalesceReads is enabled, an IORead which reads the same
+    URL and byte range as an IORead which is still in flight isn't sent
+    to an IO thread, instead it is attached to the in-flight read as a
+    'follower'. Once per frame, update() copies the status of finished
+    reads to their followers. The first read keeps its result in Data as
+    usual, the followers share a single read-only IOView of the data
+    (the first read's View if the file system has mapped the file, or
+    one copy of the first read's Data), so that N identical reads only
+    cost one file system operation and at most 2 buffers.
+
+    The priority of an in-flight read is raised to the highest priority
+    of its followers. If the in-flight read is cancelled, or its owner
+    has moved the Data away before update() was called, one of the
+    followers is sent to the IO threads instead.
+
+    The number of coalesced reads and the bytes which didn't need to be
+    read again are counted in the io.coalescedReads and io.coalescedBytes
+    metrics. The ioCoalescer is only used on the main thread.
+*/
+#include "Core/Containers/Array.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Metrics/Metrics.h"
+#include "IO/private/ioRequests.h"
+
+namespace Oryol {
+namespace _priv {
+
+class ioRouter;
+
+class ioCoalescer {
+public:
+    /// setup the coalescer, if disabled, put() always returns false
+    void setup(bool enabled);
+    /// discard the coalescer
+    void discard();
+    /// attach a request to an identical in-flight read, return false if the request must be sent to the IO threads
+    bool put(const Ptr<IORequest>& req);
+    /// hand results of finished reads to their followers (once per frame)
+    void update(ioRouter* router);
+    /// return true if the result of a read still has to be handed to followers
+    bool isShared(const Ptr<IORequest>& req) const;
+    /// number of tracked in-flight reads
+    int numInflight() const;
+
+private:
+    struct inflight {
+        Ptr<IORead> read;
+        Array<Ptr<IORead>> followers;
+    };
+    /// hand the result of a finished read to its followers
+    void finish(inflight& entry);
+
+    bool enabled = false;
+    int numReads = 0;
+    HashMap<StringAtom, Array<inflight>> reads;
+    Array<StringAtom> finishedUrls;
+    Metric coalescedReadsMetric;
+    Metric coalescedBytesMetric;
+};
+
+} // namespace _priv
+} // namespace Oryol
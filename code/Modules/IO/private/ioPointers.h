@@ -12,10 +12,12 @@ namespace _priv {
 
 class assignRegistry;
 class schemeRegistry;
+class ioBudgets;
 
 struct ioPointers {
-    class assignRegistry* assignRegistry;
-    class schemeRegistry* schemeRegistry;
+    class assignRegistry* assignRegistry = nullptr;
+    class schemeRegistry* schemeRegistry = nullptr;
+    class ioBudgets* budgets = nullptr;
 };
 
 } // namespace _priv
@@ -11,7 +11,9 @@
 #include "Core/Config.h"
 #include "Core/RefCounted.h"
 #include "Core/Containers/Buffer.h"
+#include "Core/Time/TimePoint.h"
 #include "IO/IOTypes.h"
+#include <functional>
 
 namespace Oryol {
 namespace _priv {
@@ -31,6 +33,40 @@ public:
 };
 } // namespace _priv;
 
+class FileSystemBase;
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOView
+    @ingroup IO
+    @brief read-only view of file data owned by a file system
+
+    A file system which supports zero-copy reads (for instance the
+    LocalFS with memory-mapped files) sets the IORequest::View of a
+    read request to an IOView subclass instead of copying the data into
+    IORequest::Data. The data is released when the last reference to
+    the view goes away. The accessors are the same as Buffer's.
+*/
+class IOView : public RefCounted {
+    OryolClassDecl(IOView);
+public:
+    /// get number of bytes in the view
+    int Size() const {
+        return this->size;
+    };
+    /// return true if the view is empty
+    bool Empty() const {
+        return 0 == this->size;
+    };
+    /// get read-only pointer to data
+    const uint8_t* Data() const {
+        return this->data;
+    };
+protected:
+    const uint8_t* data = nullptr;
+    int size = 0;
+};
+
 //------------------------------------------------------------------------------
 class IORequest : public _priv::ioMsg {
     OryolClassDecl(IORequest);
@@ -40,22 +76,34 @@ public:
     int StartOffset = 0;
     int EndOffset = EndOfFile;
     Buffer Data;
+    /// read-only data if the file system didn't copy the data into Data (see IORead::MapEnabled)
+    Ptr<IOView> View;
     IOStatus::Code Status = IOStatus::InvalidIOStatus;
     String ErrorDesc;
+    /// IOPriority::Code, can be changed with IO::SetPriority() while the request is queued
+    #if ORYOL_HAS_ATOMIC
+    std::atomic<int> Priority{IOPriority::Normal};
+    #else
+    int Priority = IOPriority::Normal;
+    #endif
+    /// optional, fail with IOStatus::RequestTimeout if the request hasn't started until then
+    TimePoint Deadline;
 };
 
 //------------------------------------------------------------------------------
 class IORead : public IORequest {
-    OryolClassDecl(IORead);
+    OryolClassPoolAllocDecl(IORead);
     OryolTypeDecl(IORead, IORequest);
 public:
     bool CacheReadEnabled = false;
     bool CacheWriteEnabled = false;
+    /// if supported by the file system, return a read-only mapped View instead of a copy in Data
+    bool MapEnabled = false;
 };
 
 //------------------------------------------------------------------------------
 class IOWrite : public IORequest {
-    OryolClassDecl(IOWrite);
+    OryolClassPoolAllocDecl(IOWrite);
     OryolTypeDecl(IOWrite, IORequest);
 };
 
@@ -65,6 +113,8 @@ class notifyWorkers : public _priv::ioMsg {
     OryolTypeDecl(notifyWorkers, ioMsg);
 public:
     StringAtom Scheme;
+    /// creates the added or replacing file system (the scheme registry may already have changed again)
+    std::function<Ptr<FileSystemBase>()> Creator;
 };
 
 //------------------------------------------------------------------------------
@@ -9,25 +9,29 @@ namespace _priv {
 
 //------------------------------------------------------------------------------
 void
-ioRouter::setup(const ioPointers& ptrs) {
-    for (auto& worker : this->workers) {
-        worker.start(ptrs);
+ioRouter::setup(const ioPointers& ptrs, int num, bool immediateDispatch) {
+    o_assert((num > 0) && (num <= MaxNumWorkers));
+    this->numWorkers = num;
+    this->curWorker = 0;
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].start(ptrs, immediateDispatch);
     }
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::discard() {
-    for (auto& worker : this->workers) {
-        worker.stop();
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].stop();
     }
+    this->numWorkers = 0;
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::doWork() {
-    for (auto& worker : this->workers) {
-        worker.doWork();
+    for (int i = 0; i < this->numWorkers; i++) {
+        this->workers[i].doWork();
     }
 }
 
@@ -36,14 +40,29 @@ void
 ioRouter::put(const Ptr<ioMsg>& msg) {
     if (msg->IsA<notifyWorkers>()) {
         // notifyWorker messages must be distributed to all workers
-        for (auto& worker : this->workers) {
-            worker.put(msg);
+        for (int i = 0; i < this->numWorkers; i++) {
+            this->workers[i].put(msg);
         }
     }
     else {
-        // for all other messages, use a round-robin dispatch
-        this->curWorker = (this->curWorker + 1) % NumWorkers;
-        this->workers[this->curWorker].put(msg);
+        // for all other messages, pick the least loaded worker, starting
+        // the search behind the last picked worker, so that idle workers
+        // take turns
+        int best = InvalidIndex;
+        int bestLoad = 0;
+        for (int i = 1; i <= this->numWorkers; i++) {
+            const int index = (this->curWorker + i) % this->numWorkers;
+            const int load = this->workers[index].load();
+            if ((InvalidIndex == best) || (load < bestLoad)) {
+                best = index;
+                bestLoad = load;
+                if (0 == load) {
+                    break;
+                }
+            }
+        }
+        this->curWorker = best;
+        this->workers[best].put(msg);
     }
 }
 
@@ -4,8 +4,13 @@
     @class Oryol::_priv::ioRouter
     @ingroup IO
     @brief route IO requests to ioWorkers
+
+    IO requests go to the worker with the fewest queued requests (on
+    ties the workers take turns), notifyWorkers messages go to all
+    workers.
 */
 #include "Core/Containers/StaticArray.h"
+#include "IO/IOTypes.h"
 #include "IO/private/ioPointers.h"
 #include "IO/private/ioWorker.h"
 
@@ -15,7 +20,7 @@ namespace _priv {
 class ioRouter {
 public:
     /// setup the router
-    void setup(const ioPointers& ptrs);
+    void setup(const ioPointers& ptrs, int numWorkers, bool immediateDispatch);
     /// discard the router
     void discard();
     /// route a ioMsg to one or more workers
@@ -23,9 +28,10 @@ public:
     /// perform per-frame work
     void doWork();
 
-    static const int NumWorkers = 4;
+    static const int MaxNumWorkers = IOSetup::MaxNumIOWorkers;
+    int numWorkers = 0;
     int curWorker = 0;
-    StaticArray<ioWorker, NumWorkers> workers;
+    StaticArray<ioWorker, MaxNumWorkers> workers;
 };
 
 } // namespace _priv
@@ -3,11 +3,38 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ioWorker.h"
-#include "IO/private/schemeRegistry.h"
+#include "IO/private/ioBudgets.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Time/Clock.h"
+#include "Core/Trace.h"
 
 namespace Oryol {
 namespace _priv {
 
+#if ORYOL_HAS_ATOMIC
+std::atomic<int> ioWorker::globalPriorityEpoch{0};
+#else
+int ioWorker::globalPriorityEpoch = 0;
+#endif
+
+namespace {
+
+//------------------------------------------------------------------------------
+int
+priorityIndex(const Ptr<IORequest>& req) {
+    const int prio = req->Priority;
+    if (prio < IOPriority::Low) {
+        return IOPriority::Low;
+    }
+    else if (prio > IOPriority::High) {
+        return IOPriority::High;
+    }
+    return prio;
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 ioWorker::ioWorker() :
 threadStopRequested(false) {
@@ -16,10 +43,15 @@ threadStopRequested(false) {
 
 //------------------------------------------------------------------------------
 void
-ioWorker::start(const ioPointers& ptrs) {
+ioWorker::start(const ioPointers& ptrs, bool immediateDispatch) {
     o_assert(!this->threadStartRequested);
     this->pointers = ptrs;
+    this->queueDepthMetric = Metrics::Gauge("io.queueDepth");
     #if ORYOL_HAS_THREADS
+        this->immediate = immediateDispatch;
+        if (this->immediate) {
+            this->handoffQueue.Setup(HandoffQueueSize);
+        }
         this->sendThreadId = std::this_thread::get_id();
         this->thread = std::thread(threadFunc, this);
     #endif
@@ -30,10 +62,18 @@ ioWorker::start(const ioPointers& ptrs) {
 void
 ioWorker::stop() {
     o_assert(this->threadStartRequested);
-    this->threadStopRequested = true;
     #if ORYOL_HAS_THREADS
-        this->transferCondVar.notify_one();
+        {
+            std::lock_guard<std::mutex> lock(this->transferMutex);
+            this->threadStopRequested = true;
+            this->transferCondVar.notify_one();
+        }
         this->thread.join();
+        if (this->handoffQueue.IsValid()) {
+            this->handoffQueue.Discard();
+        }
+    #else
+        this->threadStopRequested = true;
     #endif
     this->threadStopped = true;
 }
@@ -44,9 +84,39 @@ ioWorker::put(const Ptr<ioMsg>& msg) {
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
+    if (msg->IsA<IORequest>()) {
+        Metrics::Add(this->queueDepthMetric, 1);
+        this->numQueued++;
+    }
+    #if ORYOL_HAS_THREADS
+    if (this->immediate) {
+        // fast path: nothing is waiting in the write queue, and the
+        // handoff queue isn't full
+        if (this->writeQueue.Empty() && this->handoffQueue.Enqueue(msg)) {
+            this->wakeup();
+        }
+        else {
+            this->writeQueue.Enqueue(msg);
+            this->handoff();
+        }
+        return;
+    }
+    #endif
     this->writeQueue.Enqueue(msg);
 }
 
+//------------------------------------------------------------------------------
+int
+ioWorker::load() const {
+    return this->numQueued;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::priorityChanged() {
+    globalPriorityEpoch++;
+}
+
 //------------------------------------------------------------------------------
 void
 ioWorker::doWork() {
@@ -54,27 +124,37 @@ ioWorker::doWork() {
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
-    if (!this->writeQueue.Empty()) {
-        this->moveWriteToTransferQueue();
-    }
-    o_assert_dbg(this->writeQueue.Empty());
-
     #if ORYOL_HAS_THREADS
-    {
+    if (this->immediate) {
+        // messages which didn't fit into the handoff queue
+        if (!this->writeQueue.Empty()) {
+            this->handoff();
+        }
+    }
+    else {
+        if (!this->writeQueue.Empty()) {
+            this->moveWriteToTransferQueue();
+        }
+        o_assert_dbg(this->writeQueue.Empty());
         std::lock_guard<std::mutex> lock(this->transferMutex);
         if (!this->transferQueue.Empty()) {
             this->transferCondVar.notify_one();
         }
     }
-    #endif
-
-    #if !ORYOL_HAS_THREADS
+    // the frame budgets have been reset, requests which were over budget may continue
+    if (this->hasBlocked) {
+        this->kick();
+    }
+    #else
         // if platform has no threads, pump the message queue right
         // FIXME: we could do without all those queue transfers here!
-        this->moveTransferToReadQueue();
-        while (!this->readQueue.Empty()) {
-            this->onMsg(std::move(this->readQueue.Dequeue()));
+        if (!this->writeQueue.Empty()) {
+            this->moveWriteToTransferQueue();
         }
+        this->unblock();
+        this->moveTransferToReadQueue();
+        this->processPending();
+        this->onFlush();
     #endif
 }
 
@@ -83,25 +163,95 @@ ioWorker::doWork() {
 void
 ioWorker::threadFunc(ioWorker* self) {
     self->workThreadId = std::this_thread::get_id();
+    MemoryTracker::SetThreadName("ioWorker");
+    o_trace_thread_name("ioWorker");
+    o_memory_scope(IO);
 
-    // the message processing loop waits for messages to arrive,
-    // moves them from the transfer queue, processes them then goes back to sleep
+    // the message processing loop waits for messages to arrive, sorts
+    // them by priority, processes them then goes back to sleep
     while (!self->threadStopRequested) {
+        self->waitForWork();
+        if (self->newFrame.exchange(false)) {
+            self->unblock();
+        }
+        self->processPending();
+        self->onFlush();
+    }
 
-        // wait for messages to arrive, and if so, transfer to read queue
-        {
-            std::unique_lock<std::mutex> lock(self->transferMutex);
-            self->transferCondVar.wait(lock);
-            self->moveTransferToReadQueue();
-            lock.unlock();
+    // hand the per-thread data over to the next thread (file systems record metrics)
+    Memory::ReleaseThreadCache();
+    Metrics::ReleaseThreadSlots();
+    MemoryTracker::ReleaseThreadCounters();
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::waitForWork() {
+    o_assert_dbg(this->isWorkerThread());
+    if (this->immediate) {
+        // immediate dispatch: go to sleep until wakeup() or kick() is called
+        if (!this->handoffQueue.Empty() || this->newFrame) {
+            return;
         }
+        std::unique_lock<std::mutex> lock(this->transferMutex);
+        this->workerSleeping = true;
+        // pairs with the fence in wakeup(): either the sender sees
+        // workerSleeping, or we see the new message
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->handoffQueue.Empty() && !this->newFrame) {
+            this->transferCondVar.wait(lock, [this] {
+                return !this->workerSleeping || this->threadStopRequested;
+            });
+        }
+        this->workerSleeping = false;
+    }
+    else {
+        std::unique_lock<std::mutex> lock(this->transferMutex);
+        this->transferCondVar.wait(lock, [this] {
+            return !this->transferQueue.Empty() || this->threadStopRequested || this->newFrame;
+        });
+    }
+}
+#endif
 
-        // now process the messages, this happens without locking
-        while (!self->readQueue.Empty()) {
-            self->onMsg(std::move(self->readQueue.Dequeue()));
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_THREADS
+void
+ioWorker::handoff() {
+    o_assert_dbg(this->isSendThread() && this->immediate);
+    bool any = false;
+    while (!this->writeQueue.Empty()) {
+        // NOTE: Enqueue() doesn't move from the message if the queue is full
+        if (!this->handoffQueue.Enqueue(std::move(this->writeQueue.Front()))) {
+            break;
         }
+        this->writeQueue.Dequeue();
+        any = true;
+    }
+    if (any) {
+        this->wakeup();
     }
 }
+
+//------------------------------------------------------------------------------
+void
+ioWorker::wakeup() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->workerSleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(this->transferMutex);
+        this->workerSleeping = false;
+        this->transferCondVar.notify_one();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::kick() {
+    std::lock_guard<std::mutex> lock(this->transferMutex);
+    this->newFrame = true;
+    this->workerSleeping = false;
+    this->transferCondVar.notify_one();
+}
 #endif
 
 //------------------------------------------------------------------------------
@@ -142,6 +292,9 @@ ioWorker::moveWriteToTransferQueue() {
                 this->transferQueue.Enqueue(this->writeQueue.Dequeue());
             }
         }
+        #if ORYOL_HAS_THREADS
+        this->transferPending = true;
+        #endif
     }
 }
 
@@ -153,12 +306,239 @@ ioWorker::moveTransferToReadQueue() {
     this->readQueue = std::move(this->transferQueue);
 }
 
+//------------------------------------------------------------------------------
+bool
+ioWorker::hasIncoming() {
+    #if ORYOL_HAS_THREADS
+    if (this->immediate) {
+        return !this->handoffQueue.Empty();
+    }
+    return this->transferPending;
+    #else
+    return !this->readQueue.Empty();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::receive() {
+    o_assert_dbg(this->isWorkerThread());
+    #if ORYOL_HAS_THREADS
+    if (this->immediate) {
+        Ptr<ioMsg> msg;
+        while (this->handoffQueue.Dequeue(msg)) {
+            this->enqueue(std::move(msg));
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->transferMutex);
+        this->moveTransferToReadQueue();
+        this->transferPending = false;
+    }
+    #endif
+    while (!this->readQueue.Empty()) {
+        this->enqueue(this->readQueue.Dequeue());
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::enqueue(Ptr<ioMsg>&& msg) {
+    if (msg->IsA<IORequest>()) {
+        Ptr<IORequest> req = msg->DynamicCast<IORequest>();
+        msg = nullptr;
+        const int prio = priorityIndex(req);
+        this->pending[prio].Enqueue(std::move(req));
+    }
+    else {
+        // file system notifications don't wait for queued requests,
+        // onNotify() takes care of the queued requests of the file system
+        this->onMsg(msg);
+        msg = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::processPending() {
+    o_assert_dbg(this->isWorkerThread());
+    while (!this->threadStopRequested) {
+        // look for new (maybe higher priority) requests before each request
+        if (this->hasIncoming()) {
+            this->receive();
+        }
+        Ptr<IORequest> req = this->popNext();
+        if (!req) {
+            break;
+        }
+        this->onMsg(req);
+    }
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORequest>
+ioWorker::popNext() {
+    const int epoch = globalPriorityEpoch;
+    if (epoch != this->priorityEpoch) {
+        this->priorityEpoch = epoch;
+        this->reprioritize();
+    }
+    for (int prio = IOPriority::NumPriorities - 1; prio >= 0; prio--) {
+        Queue<Ptr<IORequest>>& queue = this->pending[prio];
+        while (!queue.Empty()) {
+            Ptr<IORequest> req = queue.Dequeue();
+            if (req->Cancelled) {
+                // onMsg() takes care of cancelled requests
+                return req;
+            }
+            if ((req->Deadline.getRaw() != 0) && (Clock::Now() > req->Deadline)) {
+                this->finish(req, IOStatus::RequestTimeout, "deadline expired before request started");
+                continue;
+            }
+            if (this->pointers.budgets) {
+                if (ioBudgets::denied == this->pointers.budgets->acquire(req)) {
+                    // over the frame budget, wait until the next frame
+                    this->blocked[prio].Enqueue(std::move(req));
+                    this->numBlocked++;
+                    #if ORYOL_HAS_THREADS
+                    this->hasBlocked = true;
+                    #endif
+                    continue;
+                }
+            }
+            return req;
+        }
+    }
+    return Ptr<IORequest>();
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::unblock() {
+    o_assert_dbg(this->isWorkerThread());
+    if (0 == this->numBlocked) {
+        return;
+    }
+    // blocked requests are older than the pending requests of the same priority
+    for (int prio = 0; prio < IOPriority::NumPriorities; prio++) {
+        Queue<Ptr<IORequest>>& blockedQueue = this->blocked[prio];
+        if (!blockedQueue.Empty()) {
+            Queue<Ptr<IORequest>>& pendingQueue = this->pending[prio];
+            while (!pendingQueue.Empty()) {
+                blockedQueue.Enqueue(pendingQueue.Dequeue());
+            }
+            pendingQueue = std::move(blockedQueue);
+        }
+    }
+    this->numBlocked = 0;
+    #if ORYOL_HAS_THREADS
+    this->hasBlocked = false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::reprioritize() {
+    o_assert_dbg(this->isWorkerThread());
+    // move requests with a changed priority to the end of their new queue,
+    // the other requests keep their order
+    StaticArray<Queue<Ptr<IORequest>>, IOPriority::NumPriorities>* queues[2] = { &this->pending, &this->blocked };
+    for (auto* prioQueues : queues) {
+        for (int prio = 0; prio < IOPriority::NumPriorities; prio++) {
+            Queue<Ptr<IORequest>>& queue = (*prioQueues)[prio];
+            const int num = queue.Size();
+            for (int i = 0; i < num; i++) {
+                Ptr<IORequest> req = queue.Dequeue();
+                const int newPrio = priorityIndex(req);
+                (*prioQueues)[newPrio].Enqueue(std::move(req));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::takeQueued(const StringAtom& scheme, Array<Ptr<IORequest>>& outReqs) {
+    o_assert_dbg(this->isWorkerThread());
+    // highest priority first, blocked requests before pending requests
+    for (int prio = IOPriority::NumPriorities - 1; prio >= 0; prio--) {
+        Queue<Ptr<IORequest>>* queues[2] = { &this->blocked[prio], &this->pending[prio] };
+        for (Queue<Ptr<IORequest>>* queue : queues) {
+            const int num = queue->Size();
+            for (int i = 0; i < num; i++) {
+                Ptr<IORequest> req = queue->Dequeue();
+                if (req->Url.Scheme() == scheme) {
+                    if (queue == &this->blocked[prio]) {
+                        this->numBlocked--;
+                    }
+                    outReqs.Add(std::move(req));
+                }
+                else {
+                    queue->Enqueue(std::move(req));
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::onNotify(const Ptr<notifyWorkers>& msg) {
+    o_assert_dbg(this->isWorkerThread());
+    // notifications are handled as soon as they arrive, but requests which
+    // were sent before them still belong to the old file system
+    const StringAtom& urlScheme = msg->Scheme;
+    if (msg->IsA<notifyFileSystemAdded>()) {
+        o_assert(!this->fileSystems.Contains(urlScheme));
+        Ptr<FileSystemBase> newFileSystem = msg->Creator();
+        newFileSystem->initLane();
+        this->fileSystems.Add(urlScheme, newFileSystem);
+    }
+    else if (msg->IsA<notifyFileSystemRemoved>()) {
+        o_assert(this->fileSystems.Contains(urlScheme));
+        Array<Ptr<IORequest>> reqs;
+        this->takeQueued(urlScheme, reqs);
+        for (const auto& req : reqs) {
+            this->finish(req, IOStatus::NotFound, "file system has been removed");
+        }
+        this->fileSystems[urlScheme]->onFlush();
+        this->fileSystems.Erase(urlScheme);
+    }
+    else if (msg->IsA<notifyFileSystemReplaced>()) {
+        o_assert(this->fileSystems.Contains(urlScheme));
+        // hand the queued requests to the old file system (ignoring the
+        // frame budget) before it is replaced
+        Array<Ptr<IORequest>> reqs;
+        this->takeQueued(urlScheme, reqs);
+        for (const auto& req : reqs) {
+            this->onMsg(req);
+        }
+        this->fileSystems[urlScheme]->onFlush();
+        Ptr<FileSystemBase> newFileSystem = msg->Creator();
+        newFileSystem->initLane();
+        this->fileSystems[urlScheme] = newFileSystem;
+    }
+    msg->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::finish(const Ptr<IORequest>& req, IOStatus::Code status, const char* errorDesc) {
+    req->Status = status;
+    req->ErrorDesc = errorDesc;
+    Metrics::Add(this->queueDepthMetric, -1);
+    this->numQueued--;
+    req->Handled = true;
+}
+
 //------------------------------------------------------------------------------
 Ptr<FileSystemBase>
 ioWorker::fileSystemForURL(const URL& url) {
     StringAtom scheme = url.Scheme();
-    if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
+    const int index = this->fileSystems.FindIndex(scheme);
+    if (InvalidIndex != index) {
+        return this->fileSystems.ValueAtIndex(index);
     }
     else {
         o_warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
@@ -179,6 +559,14 @@ ioWorker::checkCancelled(const Ptr<IORequest>& msg) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+ioWorker::onFlush() {
+    for (const auto& kvp : this->fileSystems) {
+        kvp.Value()->onFlush();
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 ioWorker::onMsg(const Ptr<ioMsg>& msg) {
@@ -192,26 +580,18 @@ ioWorker::onMsg(const Ptr<ioMsg>& msg) {
             if (fs) {
                 fs->onMsg(ioReq);
             }
+            else {
+                ioReq->Status = IOStatus::NotFound;
+                ioReq->ErrorDesc = "no file system registered for URL scheme";
+                ioReq->Handled = true;
+            }
         }
+        Metrics::Add(this->queueDepthMetric, -1);
+        this->numQueued--;
     }
     else if (msg->IsA<notifyWorkers>()) {
         // add, remove or replace a filesystem association
-        const StringAtom& urlScheme = msg->DynamicCast<notifyWorkers>()->Scheme;
-        if (msg->IsA<notifyFileSystemAdded>()) {
-            o_assert(!this->fileSystems.Contains(urlScheme));
-            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(urlScheme);
-            this->fileSystems.Add(urlScheme, newFileSystem);
-        }
-        else if (msg->IsA<notifyFileSystemRemoved>()) {
-            o_assert(this->fileSystems.Contains(urlScheme));
-            this->fileSystems.Erase(urlScheme);
-        }
-        else if (msg->IsA<notifyFileSystemReplaced>()) {
-            o_assert(this->fileSystems.Contains(urlScheme));
-            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(urlScheme);
-            this->fileSystems[urlScheme] = newFileSystem;
-        }
-        msg->Handled = true;
+        this->onNotify(msg->DynamicCast<notifyWorkers>());
     }
 }
 
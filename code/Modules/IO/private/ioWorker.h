@@ -4,18 +4,40 @@
     @class Oryol::_priv::ioWorker
     @ingroup IO
     @brief worker thread to forward IO requests to filesystem implementations
-    
+
     An ioWorker is basically a message queue with a thread behind it. To
     remove granular locking it is pumped by the runloop. Once per
     runloop-frame, messages from the main thread will be moved to a
-    'transfer queue', and the worker thread will be signaled. The 
+    'transfer queue', and the worker thread will be signaled. The
     worker thread wakes up, moves the messages from the transfer queue
     to a read-queue, processes them and goes back to sleep.
+
+    With immediate dispatch, put() hands messages to the worker thread
+    right away through a lock-free single-producer/single-consumer queue,
+    and only wakes up the worker thread if it is sleeping. If the handoff
+    queue is full, messages wait in the write queue (keeping their order)
+    until put() or doWork() is called again.
+
+    Received IO requests are sorted into one FIFO queue per IOPriority,
+    and the worker thread always handles the oldest request of the highest
+    priority next. Between two requests, the worker thread checks for
+    newly arrived messages, so that a high-priority request only waits for
+    the request which is currently handled. File system notifications are
+    handled as soon as they arrive: before a file system is replaced, its
+    queued requests are handed to the old file system, and the queued
+    requests of a removed file system fail with IOStatus::NotFound.
+    Requests which are over the frame byte or request budget of their URL
+    scheme (see ioBudgets) wait until the next frame, requests which
+    haven't started before their deadline fail.
 */
 #include "Core/Config.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Queue.h"
-#include "Core/Containers/Map.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Metrics/Metrics.h"
 #include "IO/private/ioPointers.h"
 #include "IO/private/ioRequests.h"
 #include "IO/FileSystemBase.h"
@@ -34,13 +56,17 @@ public:
     /// constructor
     ioWorker();
     /// setup and start the worker thread
-    void start(const ioPointers& ptrs);
+    void start(const ioPointers& ptrs, bool immediateDispatch);
     /// stop the worker thread, wait for join
     void stop();
     /// put an io message into the internal message queue
     void put(const Ptr<ioMsg>& msg);
     /// do work on the main thread, this moves queued messages to transfer queue
     void doWork();
+    /// number of queued IO requests which haven't been handled yet (any thread)
+    int load() const;
+    /// notify all workers that the priority of a queued request has changed (any thread)
+    static void priorityChanged();
 
     /// lookup filesystem for URL
     Ptr<FileSystemBase> fileSystemForURL(const URL& url);
@@ -48,9 +74,13 @@ public:
     bool checkCancelled(const Ptr<IORequest>& msg);
     /// called from thread to handle a generic message
     void onMsg(const Ptr<ioMsg>& msg);
+    /// called from thread after a batch of messages has been handled
+    void onFlush();
     /// the thread worker func
     #if ORYOL_HAS_THREADS
     static void threadFunc(ioWorker* self);
+    /// sleep until messages arrive, a new frame starts or the thread should stop
+    void waitForWork();
     #endif
     /// test if we are on the send-thread
     bool isSendThread();
@@ -60,13 +90,53 @@ public:
     void moveWriteToTransferQueue();
     /// move messages from transfer queue to read queue
     void moveTransferToReadQueue();
+    #if ORYOL_HAS_THREADS
+    /// move messages from the write queue to the handoff queue (immediate dispatch)
+    void handoff();
+    /// wake up the worker thread if it is sleeping (immediate dispatch)
+    void wakeup();
+    /// wake up the worker thread for a new frame
+    void kick();
+    #endif
+
+    /// return true if new messages have arrived (worker thread)
+    bool hasIncoming();
+    /// sort arrived messages into the priority queues (worker thread)
+    void receive();
+    /// sort a message into the priority queues, or handle it if it isn't a request
+    void enqueue(Ptr<ioMsg>&& msg);
+    /// handle queued requests until all are done or over budget (worker thread)
+    void processPending();
+    /// get the next request to handle, or nullptr (worker thread)
+    Ptr<IORequest> popNext();
+    /// move requests which were over budget back into the priority queues (worker thread)
+    void unblock();
+    /// sort queued requests by their current priority (worker thread)
+    void reprioritize();
+    /// add, remove or replace a file system (worker thread)
+    void onNotify(const Ptr<notifyWorkers>& msg);
+    /// remove the queued requests of an URL scheme, highest priority first (worker thread)
+    void takeQueued(const StringAtom& scheme, Array<Ptr<IORequest>>& outReqs);
+    /// finish a request without handing it to a file system
+    void finish(const Ptr<IORequest>& req, IOStatus::Code status, const char* errorDesc);
+
+    /// capacity of the immediate-dispatch handoff queue
+    static const int HandoffQueueSize = 4096;
 
     ioPointers pointers;
-    Map<StringAtom, Ptr<FileSystemBase>> fileSystems;
+    HashMap<StringAtom, Ptr<FileSystemBase>> fileSystems;
 
     Queue<Ptr<ioMsg>> writeQueue;     // written by sender thread
     Queue<Ptr<ioMsg>> transferQueue;  // written by sender, read by worker thread (locked)
     Queue<Ptr<ioMsg>> readQueue;      // read by worker thread
+    Metric queueDepthMetric;          // number of queued IORequests (all workers)
+    bool immediate = false;
+
+    // worker thread: queued requests by priority, and requests which are over budget
+    StaticArray<Queue<Ptr<IORequest>>, IOPriority::NumPriorities> pending;
+    StaticArray<Queue<Ptr<IORequest>>, IOPriority::NumPriorities> blocked;
+    int numBlocked = 0;
+    int priorityEpoch = 0;
 
     #if ORYOL_HAS_THREADS
     std::thread::id sendThreadId;
@@ -74,11 +144,20 @@ public:
     std::thread thread;
     std::mutex transferMutex;
     std::condition_variable transferCondVar;
+    SPSCQueue<Ptr<ioMsg>> handoffQueue;    // written by sender, read by worker thread (immediate dispatch)
+    std::atomic<bool> workerSleeping{false};
+    std::atomic<bool> transferPending{false};
+    std::atomic<bool> newFrame{false};
+    std::atomic<bool> hasBlocked{false};
     #endif
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> threadStopRequested;
+    std::atomic<int> numQueued{0};
+    static std::atomic<int> globalPriorityEpoch;
     #else
     bool threadStopRequested;
+    int numQueued = 0;
+    static int globalPriorityEpoch;
     #endif
     bool threadStartRequested = false;
     bool threadStopped = false;
@@ -6,35 +6,71 @@
 #include "Core/Core.h"
 #include "Core/RunLoop.h"
 #include "IO/IO.h"
+#include "IO/private/ioCoalescer.h"
 
 namespace Oryol {
 
+//------------------------------------------------------------------------------
+Buffer
+loadQueue::resultData(const Ptr<IORead>& ioReq) {
+    if (ioReq->Data.Empty() && ioReq->View) {
+        // coalesced reads share their data in a read-only view, but the
+        // callbacks get a Buffer they own
+        Buffer data;
+        data.Add(ioReq->View->Data(), ioReq->View->Size());
+        return data;
+    }
+    return std::move(ioReq->Data);
+}
+
 //------------------------------------------------------------------------------
 void
-loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail) {
+loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail, IOPriority::Code priority, TimePoint deadline) {
     o_assert_dbg(onSuccess);
+    o_memory_scope(IO);
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    ioReq->Priority = priority;
+    ioReq->Deadline = deadline;
     IO::Put(ioReq);
-    this->items.Add(item{ ioReq, onSuccess, onFail });
+    this->items.Add(item{ ioReq, std::move(onSuccess), std::move(onFail) });
 }
 
 //------------------------------------------------------------------------------
 void
-loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail) {
+loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail, IOPriority::Code priority) {
     o_assert_dbg(onSuccess);
-    
+    o_memory_scope(IO);
+
     groupItem item;
     item.ioRequests.Reserve(urls.Size());
     for (const URL& url : urls) {
         Ptr<IORead> ioReq = IORead::Create();
         ioReq->Url = url;
+        ioReq->Priority = priority;
         IO::Put(ioReq);
         item.ioRequests.Add(ioReq);
-        item.onSuccess = onSuccess;
-        item.onFail = onFail;
     }
-    this->groupItems.Add(item);
+    item.onSuccess = std::move(onSuccess);
+    item.onFail = std::move(onFail);
+    this->groupItems.Add(std::move(item));
+}
+
+//------------------------------------------------------------------------------
+void
+loadQueue::setPriority(const URL& url, IOPriority::Code priority) {
+    for (const auto& item : this->items) {
+        if (item.ioRequest->Url == url) {
+            IO::SetPriority(item.ioRequest, priority);
+        }
+    }
+    for (const auto& item : this->groupItems) {
+        for (const auto& ioReq : item.ioRequests) {
+            if (ioReq->Url == url) {
+                IO::SetPriority(ioReq, priority);
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -45,17 +81,21 @@ loadQueue::numPending() const {
 
 //------------------------------------------------------------------------------
 void
-loadQueue::update() {
+loadQueue::update(const _priv::ioCoalescer* coalescer) {
+    o_assert_dbg(coalescer);
 
-    // check single items
+    // check single items (handled items are removed before calling their
+    // callbacks, since callbacks may add new items to the queue), the data
+    // of coalesced reads is only taken after it was handed to the followers
     for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
-        const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled) {
+        if (this->items[i].ioRequest->Handled && !coalescer->isShared(this->items[i].ioRequest)) {
+            const item curItem = std::move(this->items[i]);
+            this->items.Erase(i);
+            const auto& ioReq = curItem.ioRequest;
             // io request has been handled
             if (IOStatus::OK == ioReq->Status) {
                 // io request was successful
-                curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
+                curItem.onSuccess(result(ioReq->Url, resultData(ioReq)));
             }
             else {
                 // io request failed
@@ -68,18 +108,23 @@ loadQueue::update() {
                         ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
                 }
             }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
         }
     }
     
-    // check group items
+    // check group items, a group is done when all its requests have been handled
     for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
         bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled) {
+        for (const auto& ioReq : this->groupItems[i].ioRequests) {
+            if (!ioReq->Handled || coalescer->isShared(ioReq)) {
+                allHandled = false;
+                break;
+            }
+        }
+        if (allHandled) {
+            const groupItem curItem = std::move(this->groupItems[i]);
+            this->groupItems.Erase(i);
+            bool anyFailed = false;
+            for (const auto& ioReq : curItem.ioRequests) {
                 if (IOStatus::OK != ioReq->Status) {
                     anyFailed = true;
                     if (curItem.onFail) {
@@ -91,24 +136,15 @@ loadQueue::update() {
                     }
                 }
             }
-            else {
-                allHandled = false;
-                break;
-            }
-        }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the success-callback
-        if (allHandled) {
+            // if all were successful, call the success-callback
             if (!anyFailed) {
                 Array<result> result;
                 result.Reserve(curItem.ioRequests.Size());
                 for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->Url, std::move(ioReq->Data));
+                    result.Add(ioReq->Url, resultData(ioReq));
                 }
                 curItem.onSuccess(std::move(result));
             }
-            this->groupItems.Erase(i);
         }
     }
 }
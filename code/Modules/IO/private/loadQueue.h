@@ -13,10 +13,14 @@
 #include "Core/Containers/Buffer.h"
 #include "IO/IOTypes.h"
 #include "IO/private/ioRequests.h"
-#include <functional>
+#include "Core/Function.h"
 
 namespace Oryol {
-    
+
+namespace _priv {
+class ioCoalescer;
+}
+
 class loadQueue {
 public:
     /// loading result (iff successful)
@@ -35,20 +39,24 @@ public:
     };
 
     /// callback function signature for success
-    typedef std::function<void(result result)> successFunc;
+    typedef Function<void(result result)> successFunc;
     /// callback function signature for success when loading URL groups
-    typedef std::function<void(Array<result>)> groupSuccessFunc;
+    typedef Function<void(Array<result>)> groupSuccessFunc;
     /// callback function signature for failure
-    typedef std::function<void(const URL& url, IOStatus::Code ioStatus)> failFunc;
+    typedef Function<void(const URL& url, IOStatus::Code ioStatus)> failFunc;
 
     /// add a file load request to the queue
-    void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc());
+    void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc(), IOPriority::Code priority=IOPriority::Normal, TimePoint deadline=TimePoint());
     /// add a file group request to the queue
-    void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc());
+    void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc(), IOPriority::Code priority=IOPriority::Normal);
+    /// change the priority of pending requests for an URL
+    void setPriority(const URL& url, IOPriority::Code priority);
     /// update the queue, called per frame from runloop
-    void update();
+    void update(const _priv::ioCoalescer* coalescer);
     /// get number of pending load actions
     int numPending() const;
+    /// move the loaded data out of a request (copies the View of a coalesced read)
+    static Buffer resultData(const Ptr<IORead>& ioReq);
 
     struct item {
         Ptr<IORead> ioRequest;
@@ -20,10 +20,15 @@ namespace _priv {
 //------------------------------------------------------------------------------
 void
 schemeRegistry::RegisterFileSystem(const StringAtom& scheme, std::function<Ptr<FileSystemBase>()> fsCreator) {
-    o_assert_dbg(!this->registry.Contains(scheme));
     {
         SCOPED_LOCK;
-        this->registry.Add(scheme, fsCreator);
+        // an existing association is replaced
+        if (this->registry.Contains(scheme)) {
+            this->registry[scheme] = fsCreator;
+        }
+        else {
+            this->registry.Add(scheme, fsCreator);
+        }
     }
     // create temp FileSystem object on main-thread to call the Init method
     auto fs = this->CreateFileSystem(scheme);
@@ -17,7 +17,7 @@ namespace _priv {
 
 class schemeRegistry {
 public:
-    /// associate URL scheme with filesystem
+    /// associate URL scheme with filesystem, or replace the filesystem of a scheme
     void RegisterFileSystem(const StringAtom& scheme, std::function<Ptr<FileSystemBase>()> fsCreator);
     /// unregister a filesystem
     void UnregisterFileSystem(const StringAtom& scheme);
@@ -43,7 +43,7 @@ Input::IsValid() {
 Input::CallbackId
 Input::SubscribeEvents(InputEventCallback cb) {
     o_assert_dbg(state);
-    return state->inputManager.dispatcher.subscribeEvents(cb);
+    return state->inputManager.dispatcher.subscribeEvents(std::move(cb));
 }
 
 //------------------------------------------------------------------------------
@@ -57,7 +57,7 @@ Input::UnsubscribeEvents(CallbackId id) {
 void
 Input::SetPointerLockHandler(PointerLockCallback cb) {
     o_assert_dbg(state);
-    state->inputManager.dispatcher.pointerLockHandler = cb;
+    state->inputManager.dispatcher.pointerLockHandler = std::move(cb);
 }
 
 //------------------------------------------------------------------------------
@@ -4,7 +4,7 @@
 #include "Core/Containers/Map.h"
 #include "Core/String/StringAtom.h"
 #include "glm/vec2.hpp"
-#include <functional>
+#include "Core/Function.h"
 
 namespace Oryol {
 
@@ -350,8 +350,8 @@ struct inputDefs {
     static const int maxNumGamepads = 4;
     static const int maxNumRawButtons = 32;
     static const int maxNumRawAxes = 16;
-    typedef std::function<void(const InputEvent&)> inputEventCallback;
-    typedef std::function<PointerLockMode::Code(const InputEvent&)> pointerLockCallback;
+    typedef Function<void(const InputEvent&)> inputEventCallback;
+    typedef Function<PointerLockMode::Code(const InputEvent&)> pointerLockCallback;
     typedef int callbackId;
 };
 } // namespace _priv
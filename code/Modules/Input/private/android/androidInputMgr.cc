@@ -48,7 +48,7 @@ androidInputMgr::setup(const InputSetup& setup) {
     this->sensors.attached = true;
     OryolAndroidAppState->onInputEvent = androidInputMgr::onInputEvent;
     androidBridge::ptr()->setSensorEventCallback(this->onSensorEvent);
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });   
+    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); }, RunLoop::DefaultPriority, "inputReset");   
 }
 
 //------------------------------------------------------------------------------
@@ -36,8 +36,8 @@ emscInputMgr::setup(const InputSetup& setup) {
     this->touchpad.attached = true;
     this->sensors.attached = true;
     this->setupCallbacks();
-    this->updateGamepadsRunLoopId = Core::PreRunLoop()->Add([this]() { this->updateGamepads(); });
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });
+    this->updateGamepadsRunLoopId = Core::PreRunLoop()->Add([this]() { this->updateGamepads(); }, RunLoop::DefaultPriority, "inputGamepads");
+    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); }, RunLoop::DefaultPriority, "inputReset");
 }
 
 //------------------------------------------------------------------------------
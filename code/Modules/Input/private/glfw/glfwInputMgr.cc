@@ -48,8 +48,8 @@ glfwInputMgr::setup(const InputSetup& setup) {
     this->setupCallbacks(glfwWindow);
 
     // attach per-frame callbacks to the global runloop
-    this->updateGamepadsRunLoopId = Core::PreRunLoop()->Add([this] { this->updateGamepads(); });
-    this->resetRunLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });
+    this->updateGamepadsRunLoopId = Core::PreRunLoop()->Add([this] { this->updateGamepads(); }, RunLoop::DefaultPriority, "inputGamepads");
+    this->resetRunLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); }, RunLoop::DefaultPriority, "inputReset");
 }
 
 //------------------------------------------------------------------------------
@@ -11,7 +11,7 @@ namespace _priv {
 inputDefs::callbackId
 inputDispatcher::subscribeEvents(inputDefs::inputEventCallback handler) {
     inputDefs::callbackId id = ++this->uniqueIdCounter;
-    this->inputEventHandlers.Add(id, handler);
+    this->inputEventHandlers.Add(KeyValuePair<inputDefs::callbackId, inputDefs::inputEventCallback>(std::move(id), std::move(handler)));
     return id;
 }
 
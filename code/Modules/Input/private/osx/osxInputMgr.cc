@@ -40,7 +40,7 @@ osxInputMgr::setup(const InputSetup& setup) {
     this->setupCallbacks();
     
     // attach our reset callback to the global runloop
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });    
+    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); }, RunLoop::DefaultPriority, "inputReset");    
 }
 
 //------------------------------------------------------------------------------
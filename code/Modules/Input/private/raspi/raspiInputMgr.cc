@@ -47,14 +47,14 @@ raspiInputMgr::setup(const InputSetup& setup) {
             this->mouse.attached = true;
         }
     }
-    this->runLoopId = Core::PreRunLoop()->Add([this]() { this->pollInput(); });
+    this->runLoopId = Core::PreRunLoop()->Add([this]() { this->pollInput(); }, RunLoop::DefaultPriority, "inputPoll");
 }
 
 //------------------------------------------------------------------------------
 void
 raspiInputMgr::discard() {
     this->closeDevices();
-    Core::PostRunLoop()->Remove(this->runLoopId);
+    Core::PreRunLoop()->Remove(this->runLoopId);
     this->runLoopId = RunLoop::InvalidId;
     inputMgrBase::discard();
 }
@@ -46,7 +46,7 @@ winInputMgr::setup(const InputSetup& setup) {
     this->setupCallbacks();
 
     // attach our reset callback to the global runloop
-    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); });
+    this->runLoopId = Core::PostRunLoop()->Add([this]() { this->reset(); }, RunLoop::DefaultPriority, "inputReset");
 }
 
 //------------------------------------------------------------------------------
@@ -4,13 +4,54 @@
 #include "Pre.h"
 #include "LocalFileSystem.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Time/Clock.h"
 #include "LocalFS/private/fsWrapper.h"
 #include "IO/IO.h"
+#if ORYOL_POSIX && ORYOL_HAS_THREADS
+#define ORYOL_LOCALFS_ASYNC_READ (1)
+#include "LocalFS/private/posix/asyncReader.h"
+#include <atomic>
+#else
+#define ORYOL_LOCALFS_ASYNC_READ (0)
+#endif
 
 namespace Oryol {
 
 using namespace _priv;
 
+#if ORYOL_LOCALFS_ASYNC_READ
+static std::atomic<int> defaultReadMode{LocalFileSystem::ReadMode::Sync};
+#endif
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::SetReadMode(ReadMode::Code mode) {
+    #if ORYOL_LOCALFS_ASYNC_READ
+    defaultReadMode = mode;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+LocalFileSystem::ReadMode::Code
+LocalFileSystem::GetReadMode() {
+    #if ORYOL_LOCALFS_ASYNC_READ
+    return (ReadMode::Code) defaultReadMode.load();
+    #else
+    return ReadMode::Sync;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+LocalFileSystem::~LocalFileSystem() {
+    #if ORYOL_LOCALFS_ASYNC_READ
+    if (this->reader) {
+        // waits for pending reads
+        Memory::Delete(this->reader);
+        this->reader = nullptr;
+    }
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::init(const StringAtom& scheme_) {
@@ -30,7 +71,10 @@ LocalFileSystem::init(const StringAtom& scheme_) {
 void
 LocalFileSystem::onMsg(const Ptr<IORequest>& req) {
     if (req->IsA<IORead>()) {
-        this->onRead(req->DynamicCast<IORead>());
+        if (!this->onRead(req->DynamicCast<IORead>())) {
+            // the reader sets Handled when the read is done
+            return;
+        }
     }
     else if (req->IsA<IOWrite>()) {
         this->onWrite(req->DynamicCast<IOWrite>());
@@ -40,7 +84,30 @@ LocalFileSystem::onMsg(const Ptr<IORequest>& req) {
 
 //------------------------------------------------------------------------------
 void
+LocalFileSystem::onFlush() {
+    #if ORYOL_LOCALFS_ASYNC_READ
+    if (this->reader) {
+        this->reader->flush();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::initLane() {
+    FileSystemBase::initLane();
+    this->bytesReadMetric = Metrics::Counter("io.file.bytesRead");
+    this->bytesMappedMetric = Metrics::Counter("io.file.bytesMapped");
+    // NOTE: the async reader is created on the first read, since initLane()
+    // is also called for the temporary file system object in init()
+    this->readMode = GetReadMode();
+    this->readTimeMetric = Metrics::Histogram("io.file.readTime");
+}
+
+//------------------------------------------------------------------------------
+bool
 LocalFileSystem::onRead(const Ptr<IORead>& msg) {
+    const TimePoint startTime = Clock::Now();
     if (msg->Url.HasPath()) {
         fsWrapper::handle h = fsWrapper::openRead(msg->Url.Path().AsCStr());
         if (fsWrapper::invalidHandle != h) {
@@ -56,16 +123,38 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
             else {
                 size = endOffset - startOffset;
             }
-            if (size > 0) {
+            if ((size > 0) && msg->MapEnabled) {
+                msg->View = fsWrapper::map(h, startOffset, size);
+            }
+            if (msg->View) {
+                msg->Status = IOStatus::OK;
+                Metrics::Add(this->bytesMappedMetric, size);
+            }
+            #if ORYOL_LOCALFS_ASYNC_READ
+            else if ((size > 0) && (ReadMode::Sync != this->readMode)) {
+                // hand the request and the file over to the async reader
+                if (!this->reader) {
+                    this->reader = Memory::New<asyncReader>();
+                    this->reader->setup(ReadMode::IOUring == this->readMode, this->bytesReadMetric, this->readTimeMetric);
+                }
+                this->reader->read(msg, h, startOffset, size);
+                return false;
+            }
+            #endif
+            else if (size > 0) {
+                // no mapping requested or mapping failed, copy into Data
                 uint8_t* ptr = msg->Data.Add(size);
                 int bytesRead = fsWrapper::read(h, ptr, size);
                 if (bytesRead != size) {
                     msg->Status = IOStatus::DownloadError;
-                    msg->ErrorDesc = "Fewer bytes read then expected";
+                    msg->ErrorDesc = "Fewer bytes read than expected";
                 }
                 else {
                     msg->Status = IOStatus::OK;
                 }
+                if (bytesRead > 0) {
+                    Metrics::Add(this->bytesReadMetric, bytesRead);
+                }
             }
             fsWrapper::close(h);
         }
@@ -78,6 +167,8 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
         msg->Status = IOStatus::BadRequest;
         msg->ErrorDesc = "No path in URL";
     }
+    Metrics::Record(this->readTimeMetric, Clock::Since(startTime));
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -7,26 +7,64 @@
     @class Oryol::LocalFileSystem
     @ingroup LocalFS
     @brief FileSystem subclass to access the local host file system
+
+    By default, files are read with blocking reads on the IO worker
+    thread. With SetReadMode() (called before the file system is
+    registered), reads can be made asynchronous instead: on Linux they
+    are submitted in batches to an io_uring, on other POSIX platforms
+    (or if io_uring isn't available) they are performed by a small
+    pread() thread pool, and read requests complete in the order in
+    which the reads finish.
 */
 #include "IO/FileSystemBase.h"
 #include "Core/Creator.h"
+#include "Core/Metrics/Metrics.h"
 
 namespace Oryol {
 
+namespace _priv {
+class asyncReader;
+}
+
 class LocalFileSystem : public FileSystemBase {
     OryolClassDecl(LocalFileSystem);
     OryolClassCreator(LocalFileSystem);
 public:
+    /// file read modes
+    struct ReadMode {
+        enum Code {
+            Sync,           ///< blocking reads on the IO worker thread
+            ThreadPool,     ///< asynchronous pread() on a thread pool (POSIX only)
+            IOUring,        ///< asynchronous batched io_uring reads (Linux only, falls back to ThreadPool)
+        };
+    };
+    /// set read mode of LocalFileSystem objects created afterwards (default is Sync)
+    static void SetReadMode(ReadMode::Code mode);
+    /// get read mode
+    static ReadMode::Code GetReadMode();
+
+    /// destructor
+    virtual ~LocalFileSystem();
     /// called once on main-thread
     virtual void init(const StringAtom& scheme) override;
+    /// called per IO-lane
+    virtual void initLane() override;
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq) override;
+    /// called after a batch of IO messages has been handled
+    virtual void onFlush() override;
 
 private:
-    /// handle IORead msg
-    void onRead(const Ptr<IORead>& ioRead);
+    /// handle IORead msg, return false if the read completes asynchronously
+    bool onRead(const Ptr<IORead>& ioRead);
     /// handle IOWrite msg
     void onWrite(const Ptr<IOWrite>& ioWrite);
+
+    Metric bytesReadMetric;
+    Metric bytesMappedMetric;
+    ReadMode::Code readMode = ReadMode::Sync;
+    _priv::asyncReader* reader = nullptr;
+    Metric readTimeMetric;
 };
 
 } // namespace Oryol
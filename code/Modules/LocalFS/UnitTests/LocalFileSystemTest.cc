@@ -5,10 +5,13 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Core.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Memory/SizeClassAllocator.h"
+#include "Core/Metrics/Metrics.h"
 #include "IO/IO.h"
 #include "LocalFS/LocalFileSystem.h"
 #include "LocalFS/private/fsWrapper.h"
 #include <thread>
+#include <cstdio>
 
 using namespace Oryol;
 
@@ -88,6 +91,208 @@ TEST(LocalFileSystemTest) {
     Core::Discard();
 }
 
+TEST(LocalFileSystemMapTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // write a file which spans several pages
+    const int numBytes = 3 * 4096 + 123;
+    auto write = IOWrite::Create();
+    write->Url = "root:map.bin";
+    uint8_t* ptr = write->Data.Add(numBytes);
+    for (int i = 0; i < numBytes; i++) {
+        ptr[i] = uint8_t(i * 7);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // map the whole file
+    auto read = IO::MapFile("root:map.bin");
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    #if !ORYOL_WINDOWS
+    CHECK(read->View);
+    CHECK(read->Data.Empty());
+    #endif
+    const uint8_t* data = read->View ? read->View->Data() : read->Data.Data();
+    const int size = read->View ? read->View->Size() : read->Data.Size();
+    CHECK(size == numBytes);
+    bool match = true;
+    for (int i = 0; i < size; i++) {
+        match &= data[i] == uint8_t(i * 7);
+    }
+    CHECK(match);
+
+    // the view stays valid when the request is gone
+    Ptr<IOView> view = read->View;
+    read = nullptr;
+    if (view) {
+        CHECK(view->Size() == numBytes);
+        CHECK(view->Data()[numBytes - 1] == uint8_t((numBytes - 1) * 7));
+        view = nullptr;
+    }
+
+    // map a range which doesn't start on a page boundary
+    read = IORead::Create();
+    read->Url = "root:map.bin";
+    read->MapEnabled = true;
+    read->StartOffset = 5000;
+    read->EndOffset = 9000;
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    data = read->View ? read->View->Data() : read->Data.Data();
+    CHECK((read->View ? read->View->Size() : read->Data.Size()) == 4000);
+    CHECK(data[0] == uint8_t(5000 * 7));
+    CHECK(data[3999] == uint8_t(8999 * 7));
+
+    // a range behind the end of the file isn't mapped
+    read = IORead::Create();
+    read->Url = "root:map.bin";
+    read->MapEnabled = true;
+    read->StartOffset = 4096;
+    read->EndOffset = numBytes + 100;
+    IO::Put(read);
+    wait(read);
+    CHECK(!read->View);
+    CHECK(read->Status == IOStatus::DownloadError);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(LocalFileSystemReadModeTest) {
+    const LocalFileSystem::ReadMode::Code defaultMode = LocalFileSystem::GetReadMode();
+    const LocalFileSystem::ReadMode::Code modes[] = {
+        LocalFileSystem::ReadMode::Sync,
+        LocalFileSystem::ReadMode::ThreadPool,
+        LocalFileSystem::ReadMode::IOUring,
+    };
+    const int numFiles = 200;
+    for (const auto mode : modes) {
+        LocalFileSystem::SetReadMode(mode);
+        Core::Setup();
+        IOSetup ioSetup;
+        ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+        IO::Setup(ioSetup);
+
+        // write files of different sizes
+        StringBuilder strBuilder;
+        Array<Ptr<IORequest>> reqs;
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, "root:readmode_%d.bin", i);
+            auto write = IOWrite::Create();
+            write->Url = strBuilder.GetString();
+            const int size = 1 + i * 97;
+            uint8_t* ptr = write->Data.Add(size);
+            for (int j = 0; j < size; j++) {
+                ptr[j] = uint8_t(i + j);
+            }
+            IO::Put(write);
+            reqs.Add(write);
+        }
+        for (const auto& req : reqs) {
+            wait(req);
+            CHECK(req->Status == IOStatus::OK);
+        }
+        reqs.Clear();
+
+        // read them back all at once, every other file from an offset
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, "root:readmode_%d.bin", i);
+            auto read = IORead::Create();
+            read->Url = strBuilder.GetString();
+            read->StartOffset = (i & 1) ? i / 2 : 0;
+            IO::Put(read);
+            reqs.Add(read);
+        }
+        for (int i = 0; i < numFiles; i++) {
+            wait(reqs[i]);
+            const Ptr<IORead> read = reqs[i]->DynamicCast<IORead>();
+            CHECK(read->Status == IOStatus::OK);
+            const int offset = read->StartOffset;
+            const int size = 1 + i * 97 - offset;
+            CHECK(read->Data.Size() == size);
+            bool match = read->Data.Size() == size;
+            for (int j = 0; match && (j < size); j++) {
+                match &= read->Data.Data()[j] == uint8_t(i + offset + j);
+            }
+            CHECK(match);
+        }
+
+        // a range behind the end of the file fails
+        auto read = IORead::Create();
+        read->Url = "root:readmode_1.bin";
+        read->EndOffset = 1000;
+        IO::Put(read);
+        wait(read);
+        CHECK(read->Status == IOStatus::DownloadError);
+
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, "root:readmode_%d.bin", i);
+            std::remove(URL(IO::ResolveAssigns(strBuilder.GetString())).Path().AsCStr());
+        }
+        IO::Discard();
+        Core::Discard();
+    }
+    LocalFileSystem::SetReadMode(defaultMode);
+}
+
+// write a file and read it back with the IO threads and the async reader threads
+static void
+runReadCycle() {
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+    auto write = IOWrite::Create();
+    write->Url = "root:threadexit.bin";
+    write->Data.Add(1000);
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+    Array<Ptr<IORequest>> reqs;
+    for (int i = 0; i < 16; i++) {
+        auto read = IORead::Create();
+        read->Url = "root:threadexit.bin";
+        IO::Put(read);
+        reqs.Add(read);
+    }
+    for (const auto& req : reqs) {
+        wait(req);
+        CHECK(req->Status == IOStatus::OK);
+    }
+    std::remove(URL(IO::ResolveAssigns("root:threadexit.bin")).Path().AsCStr());
+    IO::Discard();
+}
+
+TEST(LocalFileSystemThreadExitTest) {
+    // the async reader threads hand their allocator cache and metric slots back
+    const LocalFileSystem::ReadMode::Code defaultMode = LocalFileSystem::GetReadMode();
+    const LocalFileSystem::ReadMode::Code modes[] = {
+        LocalFileSystem::ReadMode::ThreadPool,
+        LocalFileSystem::ReadMode::IOUring,
+    };
+    for (const auto mode : modes) {
+        LocalFileSystem::SetReadMode(mode);
+        CoreSetup coreSetup;
+        coreSetup.MemoryAllocator = SizeClassAllocator::Instance();
+        Core::Setup(coreSetup);
+        runReadCycle();
+        const int numCaches = SizeClassAllocator::NumThreadCaches();
+        const int numSlots = Metrics::NumThreadSlots();
+        for (int i = 0; i < 4; i++) {
+            runReadCycle();
+        }
+        CHECK(SizeClassAllocator::NumThreadCaches() == numCaches);
+        CHECK(Metrics::NumThreadSlots() == numSlots);
+        Core::Discard();
+    }
+    LocalFileSystem::SetReadMode(defaultMode);
+}
+
 TEST(SameExtensionTest) {
     Core::Setup();
     IOSetup ioSetup;
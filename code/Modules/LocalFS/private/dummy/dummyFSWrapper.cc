@@ -43,6 +43,12 @@ dummyFSWrapper::size(handle f) {
     return 0;
 }
 
+//------------------------------------------------------------------------------
+Ptr<IOView>
+dummyFSWrapper::map(handle f, int offset, int numBytes) {
+    return Ptr<IOView>();
+}
+
 //------------------------------------------------------------------------------
 void
 dummyFSWrapper::close(handle f) {
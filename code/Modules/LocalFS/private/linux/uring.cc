@@ -0,0 +1,196 @@
+//------------------------------------------------------------------------------
+//  uring.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "uring.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+//------------------------------------------------------------------------------
+inline unsigned
+loadAcquire(const unsigned* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+//------------------------------------------------------------------------------
+inline void
+storeRelease(unsigned* ptr, unsigned val) {
+    __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+bool
+uring::setup(int num) {
+    o_assert_dbg(!this->isValid());
+    #if defined(__NR_io_uring_setup)
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int ringFd = int(syscall(__NR_io_uring_setup, unsigned(num), &params));
+    if (ringFd < 0) {
+        // not supported by the kernel, or disabled
+        return false;
+    }
+    this->fd = ringFd;
+    this->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    this->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool singleMmap = 0 != (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (singleMmap) {
+        this->sqRingSize = this->cqRingSize = std::max(this->sqRingSize, this->cqRingSize);
+    }
+    this->sqRing = mmap(nullptr, this->sqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == this->sqRing) {
+        this->sqRing = nullptr;
+        this->discard();
+        return false;
+    }
+    if (singleMmap) {
+        this->cqRing = this->sqRing;
+    }
+    else {
+        this->cqRing = mmap(nullptr, this->cqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == this->cqRing) {
+            this->cqRing = nullptr;
+            this->discard();
+            return false;
+        }
+    }
+    void* sqesPtr = mmap(nullptr, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (MAP_FAILED == sqesPtr) {
+        this->discard();
+        return false;
+    }
+    this->sqes = (struct io_uring_sqe*) sqesPtr;
+
+    uint8_t* sq = (uint8_t*) this->sqRing;
+    this->sqHead = (unsigned*) (sq + params.sq_off.head);
+    this->sqTail = (unsigned*) (sq + params.sq_off.tail);
+    this->sqArray = (unsigned*) (sq + params.sq_off.array);
+    this->sqMask = *(unsigned*) (sq + params.sq_off.ring_mask);
+    this->sqEntries = params.sq_entries;
+    this->sqLocalTail = *this->sqTail;
+    this->sqSubmitted = this->sqLocalTail;
+    uint8_t* cq = (uint8_t*) this->cqRing;
+    this->cqHead = (unsigned*) (cq + params.cq_off.head);
+    this->cqTail = (unsigned*) (cq + params.cq_off.tail);
+    this->cqMask = *(unsigned*) (cq + params.cq_off.ring_mask);
+    this->cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+uring::discard() {
+    if (this->sqes) {
+        munmap(this->sqes, this->sqEntries * sizeof(struct io_uring_sqe));
+        this->sqes = nullptr;
+    }
+    if (this->cqRing && (this->cqRing != this->sqRing)) {
+        munmap(this->cqRing, this->cqRingSize);
+    }
+    this->cqRing = nullptr;
+    if (this->sqRing) {
+        munmap(this->sqRing, this->sqRingSize);
+        this->sqRing = nullptr;
+    }
+    if (this->fd >= 0) {
+        close(this->fd);
+        this->fd = -1;
+    }
+    this->sqEntries = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+uring::isValid() const {
+    return nullptr != this->sqes;
+}
+
+//------------------------------------------------------------------------------
+int
+uring::numEntries() const {
+    return int(this->sqEntries);
+}
+
+//------------------------------------------------------------------------------
+struct io_uring_sqe*
+uring::getSqe() {
+    o_assert_dbg(this->isValid());
+    const unsigned head = loadAcquire(this->sqHead);
+    if ((this->sqLocalTail - head) >= this->sqEntries) {
+        return nullptr;
+    }
+    const unsigned index = this->sqLocalTail & this->sqMask;
+    struct io_uring_sqe* sqe = &this->sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    this->sqArray[index] = index;
+    this->sqLocalTail++;
+    return sqe;
+}
+
+//------------------------------------------------------------------------------
+bool
+uring::submit() {
+    o_assert_dbg(this->isValid());
+    if (this->sqSubmitted == this->sqLocalTail) {
+        return true;
+    }
+    // publish the new entries to the kernel, and tell it to consume them
+    storeRelease(this->sqTail, this->sqLocalTail);
+    while (this->sqSubmitted != this->sqLocalTail) {
+        const int res = int(syscall(__NR_io_uring_enter, this->fd, this->sqLocalTail - this->sqSubmitted, 0, 0, nullptr, 0));
+        if (res >= 0) {
+            this->sqSubmitted += unsigned(res);
+        }
+        else if ((EINTR != errno) && (EAGAIN != errno) && (EBUSY != errno)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+uring::waitCqes() {
+    o_assert_dbg(this->isValid());
+    for (;;) {
+        const unsigned num = loadAcquire(this->cqTail) - *this->cqHead;
+        if (num > 0) {
+            return int(num);
+        }
+        const int res = int(syscall(__NR_io_uring_enter, this->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if ((res < 0) && (EINTR != errno) && (EAGAIN != errno) && (EBUSY != errno)) {
+            o_error("uring::waitCqes(): io_uring_enter failed with '%s'\n", std::strerror(errno));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+const struct io_uring_cqe&
+uring::peekCqe(int index) const {
+    o_assert_dbg(this->isValid());
+    return this->cqes[(*this->cqHead + unsigned(index)) & this->cqMask];
+}
+
+//------------------------------------------------------------------------------
+void
+uring::advanceCqes(int num) {
+    o_assert_dbg(this->isValid());
+    storeRelease(this->cqHead, *this->cqHead + unsigned(num));
+}
+
+} // namespace _priv
+} // namespace Oryol
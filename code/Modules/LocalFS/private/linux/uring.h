@@ -0,0 +1,64 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::uring
+    @ingroup _priv
+    @brief minimal io_uring wrapper (Linux only)
+
+    Sets up an io_uring instance with the raw system calls (no liburing
+    dependency). One thread may fill and submit submission queue entries
+    while another thread waits for and consumes completion queue
+    entries, but neither side may be used by several threads at once.
+*/
+#include "Core/Types.h"
+#include <linux/io_uring.h>
+
+namespace Oryol {
+namespace _priv {
+
+class uring {
+public:
+    /// setup with a number of submission queue entries, return false if io_uring isn't available
+    bool setup(int numEntries);
+    /// discard the ring
+    void discard();
+    /// return true if the ring has been setup
+    bool isValid() const;
+    /// get number of submission queue entries
+    int numEntries() const;
+
+    /// get the next free submission queue entry (cleared), or nullptr if the queue is full
+    struct io_uring_sqe* getSqe();
+    /// submit all entries returned by getSqe(), return false on error
+    bool submit();
+    /// wait for at least one completion, return number of available completions
+    int waitCqes();
+    /// get an available completion (waitCqes() must have returned > index)
+    const struct io_uring_cqe& peekCqe(int index) const;
+    /// consume a number of completions
+    void advanceCqes(int num);
+
+private:
+    int fd = -1;
+    // submission queue
+    void* sqRing = nullptr;
+    size_t sqRingSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    struct io_uring_sqe* sqes = nullptr;
+    unsigned sqLocalTail = 0;
+    unsigned sqSubmitted = 0;
+    // completion queue
+    void* cqRing = nullptr;
+    size_t cqRingSize = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    struct io_uring_cqe* cqes = nullptr;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,270 @@
+//------------------------------------------------------------------------------
+//  asyncReader.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "asyncReader.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Time/Clock.h"
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+asyncReader::~asyncReader() {
+    if (this->valid) {
+        this->discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::setup(bool useUring, const Metric& bytesRead, const Metric& readTime) {
+    o_assert_dbg(!this->valid);
+    this->bytesReadMetric = bytesRead;
+    this->readTimeMetric = readTime;
+    this->stopRequested = false;
+    this->numUnsubmitted = 0;
+    this->freeOps.Reserve(MaxPendingReads);
+    for (int i = MaxPendingReads - 1; i >= 0; i--) {
+        this->freeOps.Add(i);
+    }
+    this->numThreads = 0;
+    #if ORYOL_LINUX
+    if (useUring && this->ring.setup(MaxPendingReads)) {
+        o_assert(this->ring.numEntries() >= MaxPendingReads);
+        this->threads[this->numThreads++] = std::thread(uringThreadFunc, this);
+    }
+    #endif
+    if (0 == this->numThreads) {
+        for (int i = 0; i < NumPoolThreads; i++) {
+            this->threads[this->numThreads++] = std::thread(poolThreadFunc, this);
+        }
+    }
+    this->valid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::discard() {
+    o_assert_dbg(this->valid);
+    // wait until all reads are done
+    this->flush();
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->freeCondVar.wait(lock, [this] { return this->freeOps.Size() == MaxPendingReads; });
+        this->stopRequested = true;
+    }
+    #if ORYOL_LINUX
+    if (this->ring.isValid()) {
+        // wake up the completion thread with a nop (user_data 0)
+        struct io_uring_sqe* sqe = this->ring.getSqe();
+        o_assert(sqe);
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        this->numSubmits.fetch_add(1, std::memory_order_release);
+        this->ring.submit();
+    }
+    #endif
+    this->poolCondVar.notify_all();
+    for (int i = 0; i < this->numThreads; i++) {
+        this->threads[i].join();
+    }
+    this->numThreads = 0;
+    #if ORYOL_LINUX
+    if (this->ring.isValid()) {
+        this->ring.discard();
+    }
+    #endif
+    this->freeOps.Clear();
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+asyncReader::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+bool
+asyncReader::isUring() const {
+    #if ORYOL_LINUX
+    return this->ring.isValid();
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+asyncReader::allocOp() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->freeOps.Empty()) {
+        // queued reads must be submitted before waiting for them
+        lock.unlock();
+        this->flush();
+        lock.lock();
+        this->freeCondVar.wait(lock, [this] { return !this->freeOps.Empty(); });
+    }
+    return this->freeOps.PopBack();
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::read(const Ptr<IORead>& msg, posixFSWrapper::handle file, int offset, int size) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(msg && (posixFSWrapper::invalidHandle != file) && (size > 0));
+    const int opIndex = this->allocOp();
+    readOp& op = this->ops[opIndex];
+    op.msg = msg;
+    op.file = file;
+    op.offset = offset;
+    op.size = size;
+    op.startTime = Clock::Now();
+    uint8_t* dst = msg->Data.Add(size);
+    #if ORYOL_LINUX
+    if (this->ring.isValid()) {
+        struct io_uring_sqe* sqe = this->ring.getSqe();
+        o_assert_dbg(sqe);
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fileno((FILE*)file);
+        sqe->addr = (uint64_t) dst;
+        sqe->len = unsigned(size);
+        sqe->off = uint64_t(offset);
+        sqe->user_data = uint64_t(opIndex) + 1;
+        if (++this->numUnsubmitted >= SubmitBatchSize) {
+            this->flush();
+        }
+        return;
+    }
+    #endif
+    (void)dst;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->poolQueue.Enqueue(opIndex);
+    }
+    this->poolCondVar.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::flush() {
+    #if ORYOL_LINUX
+    if ((this->numUnsubmitted > 0) && this->ring.isValid()) {
+        this->numSubmits.fetch_add(1, std::memory_order_release);
+        if (!this->ring.submit()) {
+            o_error("asyncReader::flush(): failed to submit io_uring reads!\n");
+        }
+        this->numUnsubmitted = 0;
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::complete(int opIndex, int numBytes) {
+    readOp& op = this->ops[opIndex];
+    uint8_t* dst = op.msg->Data.Data();
+    int done = numBytes;
+    if ((done >= 0) && (done < op.size)) {
+        // short io_uring read, or a pool thread (which passes 0), read the rest with pread()
+        const int fd = fileno((FILE*)op.file);
+        while (done < op.size) {
+            const ssize_t res = pread(fd, dst + done, size_t(op.size - done), off_t(op.offset) + done);
+            if (res > 0) {
+                done += int(res);
+            }
+            else if ((res < 0) && (EINTR == errno)) {
+                continue;
+            }
+            else {
+                break;
+            }
+        }
+    }
+    else if (-EINVAL == numBytes) {
+        // kernel doesn't know IORING_OP_READ (older than 5.6), read synchronously
+        return this->complete(opIndex, 0);
+    }
+    Ptr<IORead> msg = std::move(op.msg);
+    if (done == op.size) {
+        msg->Status = IOStatus::OK;
+    }
+    else {
+        msg->Status = IOStatus::DownloadError;
+        msg->ErrorDesc = "Fewer bytes read than expected";
+    }
+    if (done > 0) {
+        Metrics::Add(this->bytesReadMetric, done);
+    }
+    Metrics::Record(this->readTimeMetric, Clock::Since(op.startTime));
+    posixFSWrapper::close(op.file);
+    op.file = posixFSWrapper::invalidHandle;
+    msg->Handled = true;
+    msg = nullptr;
+
+    // put the readOp back into the free list
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->freeOps.Add(opIndex);
+    }
+    this->freeCondVar.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::uringThreadFunc(asyncReader* self) {
+    #if ORYOL_LINUX
+    MemoryTracker::SetThreadName("ioUring");
+    bool stop = false;
+    while (!stop) {
+        const int num = self->ring.waitCqes();
+        // the kernel orders the reads, but the C++ memory model doesn't know about that
+        self->numSubmits.load(std::memory_order_acquire);
+        for (int i = 0; i < num; i++) {
+            const struct io_uring_cqe& cqe = self->ring.peekCqe(i);
+            if (0 == cqe.user_data) {
+                stop = true;
+            }
+            else {
+                self->complete(int(cqe.user_data - 1), cqe.res);
+            }
+        }
+        self->ring.advanceCqes(num);
+    }
+    // complete() frees requests and records metrics on this thread
+    Memory::ReleaseThreadCache();
+    Metrics::ReleaseThreadSlots();
+    MemoryTracker::ReleaseThreadCounters();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+asyncReader::poolThreadFunc(asyncReader* self) {
+    MemoryTracker::SetThreadName("ioReadPool");
+    for (;;) {
+        int opIndex;
+        {
+            std::unique_lock<std::mutex> lock(self->mutex);
+            self->poolCondVar.wait(lock, [self] { return self->stopRequested || !self->poolQueue.Empty(); });
+            if (self->poolQueue.Empty()) {
+                break;
+            }
+            opIndex = self->poolQueue.Dequeue();
+        }
+        self->complete(opIndex, 0);
+    }
+    // complete() frees requests and records metrics on this thread
+    Memory::ReleaseThreadCache();
+    Metrics::ReleaseThreadSlots();
+    MemoryTracker::ReleaseThreadCounters();
+}
+
+} // namespace _priv
+} // namespace Oryol
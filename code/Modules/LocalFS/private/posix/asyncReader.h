@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::asyncReader
+    @ingroup _priv
+    @brief asynchronous file reads for the LocalFileSystem (POSIX only)
+
+    Reads a range of an open file into the Data buffer of an IORead
+    request without blocking the calling IO worker thread, and completes
+    the request (sets Status and Handled) from a background thread, in
+    the order in which the reads finish.
+
+    On Linux, reads are submitted in batches to an io_uring, and a
+    completion thread waits for the results. If io_uring isn't available
+    (or on other POSIX platforms), a small thread pool performs the reads
+    with pread().
+
+    read() and flush() must be called from the same thread (the IO
+    worker thread of the owning file system). read() blocks if
+    MaxPendingReads reads are in flight.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Containers/StaticArray.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Time/TimePoint.h"
+#include "IO/private/ioRequests.h"
+#include "LocalFS/private/posix/posixFSWrapper.h"
+#if ORYOL_LINUX
+#include "LocalFS/private/linux/uring.h"
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Oryol {
+namespace _priv {
+
+class asyncReader {
+public:
+    /// max number of reads in flight
+    static const int MaxPendingReads = 128;
+    /// number of queued io_uring reads which are submitted without waiting for flush()
+    static const int SubmitBatchSize = 16;
+    /// number of threads of the pread() thread pool
+    static const int NumPoolThreads = 2;
+
+    /// destructor
+    ~asyncReader();
+
+    /// setup, try io_uring first if useUring is true
+    void setup(bool useUring, const Metric& bytesReadMetric, const Metric& readTimeMetric);
+    /// discard, waits for pending reads
+    void discard();
+    /// return true if the reader has been setup
+    bool isValid() const;
+    /// return true if reads are performed with io_uring
+    bool isUring() const;
+
+    /// start reading a range of a file into msg->Data, takes ownership of the file handle
+    void read(const Ptr<IORead>& msg, posixFSWrapper::handle file, int offset, int size);
+    /// submit queued reads
+    void flush();
+
+private:
+    /// a read in flight
+    struct readOp {
+        Ptr<IORead> msg;
+        posixFSWrapper::handle file = posixFSWrapper::invalidHandle;
+        int offset = 0;
+        int size = 0;
+        TimePoint startTime;
+    };
+    /// get a free readOp index, blocks until one is free
+    int allocOp();
+    /// finish a read (numBytes is the result of the first read, or a negative error code)
+    void complete(int opIndex, int numBytes);
+    /// io_uring completion thread
+    static void uringThreadFunc(asyncReader* self);
+    /// pread() thread pool thread
+    static void poolThreadFunc(asyncReader* self);
+
+    bool valid = false;
+    bool stopRequested = false;
+    int numUnsubmitted = 0;
+    /// bumped before each io_uring submit, makes the submitted readOps visible to the completion thread
+    std::atomic<int> numSubmits{0};
+    Metric bytesReadMetric;
+    Metric readTimeMetric;
+    StaticArray<readOp, MaxPendingReads> ops;
+    std::mutex mutex;
+    std::condition_variable freeCondVar;
+    std::condition_variable poolCondVar;
+    Array<int> freeOps;         // protected by mutex
+    Queue<int> poolQueue;       // protected by mutex
+    StaticArray<std::thread, NumPoolThreads> threads;
+    int numThreads = 0;
+    #if ORYOL_LINUX
+    uring ring;
+    #endif
+};
+
+} // namespace _priv
+} // namespace Oryol
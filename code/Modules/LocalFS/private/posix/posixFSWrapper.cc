@@ -8,8 +8,12 @@
 #include "LocalFS/private/whereami/whereami.h"
 #if ORYOL_WINDOWS
 #include <direct.h>
+#include <io.h>
+#include <sys/stat.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 namespace Oryol {
@@ -17,6 +21,28 @@ namespace _priv {
 
 const posixFSWrapper::handle posixFSWrapper::invalidHandle = nullptr;
 
+#if !ORYOL_WINDOWS
+namespace {
+//------------------------------------------------------------------------------
+/// an IOView on a read-only file mapping, unmapped when destroyed
+class posixMappedView : public IOView {
+    OryolClassDecl(posixMappedView);
+public:
+    posixMappedView(void* addr, size_t len, int offset, int numBytes) :
+        mapAddr(addr), mapLen(len) {
+        this->data = ((const uint8_t*)addr) + offset;
+        this->size = numBytes;
+    };
+    ~posixMappedView() {
+        munmap(this->mapAddr, this->mapLen);
+    };
+private:
+    void* mapAddr;
+    size_t mapLen;
+};
+} // anonymous namespace
+#endif
+
 //------------------------------------------------------------------------------
 posixFSWrapper::handle
 posixFSWrapper::openRead(const char* path) {
@@ -58,12 +84,52 @@ posixFSWrapper::seek(handle h, int offset) {
 int
 posixFSWrapper::size(handle h) {
     o_assert_dbg(invalidHandle != h);
-    FILE* fp = (FILE*) h;
-    long off = ftell(fp);
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, off, SEEK_SET);
-    return (int) size;
+    #if ORYOL_WINDOWS
+    struct _stat st;
+    if (0 != _fstat(_fileno((FILE*)h), &st)) {
+        return 0;
+    }
+    #else
+    struct stat st;
+    if (0 != fstat(fileno((FILE*)h), &st)) {
+        return 0;
+    }
+    #endif
+    return (int) st.st_size;
+}
+
+//------------------------------------------------------------------------------
+Ptr<IOView>
+posixFSWrapper::map(handle h, int offset, int numBytes) {
+    o_assert_dbg(invalidHandle != h);
+    o_assert_dbg((offset >= 0) && (numBytes > 0));
+    #if ORYOL_WINDOWS
+    // memory-mapping isn't supported on Windows, the invalid view makes
+    // the caller fall back to reading the data into IORequest::Data
+    return Ptr<IOView>();
+    #else
+    // the range must be inside the file, touching mapped pages
+    // behind the end of the file would raise SIGBUS
+    const int fd = fileno((FILE*)h);
+    struct stat st;
+    if ((0 != fstat(fd, &st)) || ((int64_t(offset) + numBytes) > int64_t(st.st_size))) {
+        return Ptr<IOView>();
+    }
+    // the map offset must be page-aligned
+    static const long pageSize = sysconf(_SC_PAGESIZE);
+    const int mapOffset = int(offset - (offset % pageSize));
+    const size_t mapLen = size_t(offset - mapOffset) + numBytes;
+    int flags = MAP_PRIVATE;
+    #if defined(MAP_POPULATE)
+    // fault the pages in on the IO thread, not when the data is first accessed
+    flags |= MAP_POPULATE;
+    #endif
+    void* addr = mmap(nullptr, mapLen, PROT_READ, flags, fd, mapOffset);
+    if (MAP_FAILED == addr) {
+        return Ptr<IOView>();
+    }
+    return posixMappedView::Create(addr, mapLen, offset - mapOffset, numBytes);
+    #endif
 }
 
 //------------------------------------------------------------------------------
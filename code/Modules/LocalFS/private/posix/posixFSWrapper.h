@@ -7,6 +7,7 @@
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
+#include "IO/private/ioRequests.h"
 
 namespace Oryol {
 namespace _priv {
@@ -30,6 +31,8 @@ public:
     static bool seek(handle f, int offset);
     /// get file size
     static int size(handle f);
+    /// map a range of a file read-only into memory, return invalid ptr if not possible (always on Windows)
+    static Ptr<IOView> map(handle f, int offset, int numBytes);
     /// close file
     static void close(handle f);
     
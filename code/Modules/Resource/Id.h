@@ -11,6 +11,7 @@
     Resource identifiers are abstract handles to a resource object.
 */
 #include "Core/Types.h"
+#include "Core/Containers/Hash.h"
 
 namespace Oryol {
     
@@ -137,6 +138,14 @@ Id::Invalidate() {
     this->Value = invalidId;
 }
 
+//------------------------------------------------------------------------------
+/// hash function for Id (for HashMap)
+template<> struct Hash<Id, void> {
+    uint32_t operator()(const Id& id) const {
+        return Hash<uint64_t>()(id.Value);
+    };
+};
+
 } // namespace Oryol
     
  
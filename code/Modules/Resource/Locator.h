@@ -18,6 +18,7 @@
 */
 #include "Core/Types.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Containers/Hash.h"
 
 namespace Oryol {
 
@@ -139,4 +140,12 @@ Locator::Signature() const {
     return this->signature;
 }
 
+//------------------------------------------------------------------------------
+/// hash function for Locator (for HashMap)
+template<> struct Hash<Locator, void> {
+    uint32_t operator()(const Locator& loc) const {
+        return Hash<StringAtom>()(loc.Location()) ^ Hash<uint32_t>()(loc.Signature());
+    };
+};
+
 } // namespace Oryol
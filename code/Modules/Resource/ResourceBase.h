@@ -16,6 +16,7 @@
 #include "Core/Assertion.h"
 #include "Resource/Id.h"
 #include "Resource/ResourceState.h"
+#include "Core/Time/TimePoint.h"
 
 namespace Oryol {
     
@@ -27,6 +28,8 @@ public:
     ResourceState::Code State = ResourceState::Initial;
     /// frame count of last state change
     int StateStartFrame = 0;
+    /// time of last state change
+    TimePoint StateStartTime;
 };
 
 } // namespace Oryol
@@ -8,9 +8,12 @@
 */
 #include "Core/Containers/Queue.h"
 #include "Core/Containers/Array.h"
+#include "Core/Metrics/Metrics.h"
+#include "Core/Time/Clock.h"
 #include "Resource/Id.h"
 #include "Resource/ResourceInfo.h"
 #include "Resource/ResourcePoolInfo.h"
+#include <cstdio>
 
 namespace Oryol {
     
@@ -72,6 +75,9 @@ public:
     
     Array<RESOURCE> slots;
     Queue<uint16_t> freeSlots;
+
+    Metric usedSlotsMetric;
+    Metric pendingTimeMetric;
 };
     
 //------------------------------------------------------------------------------
@@ -101,6 +107,13 @@ ResourcePool<RESOURCE>::Setup(Id::TypeT resType, int poolSize) {
     for (uint16_t i = 0; i < poolSize; i++) {
         this->freeSlots.Enqueue(i);
     }
+
+    // pool occupancy and time spent in pending state (async loading)
+    char name[Metrics::MaxNameLength];
+    std::snprintf(name, sizeof(name), "resource.pool%d.usedSlots", int(resType));
+    this->usedSlotsMetric = Metrics::Gauge(name);
+    std::snprintf(name, sizeof(name), "resource.pool%d.pendingTime", int(resType));
+    this->pendingTimeMetric = Metrics::Histogram(name);
     
     this->isValid = true;
 }
@@ -128,6 +141,7 @@ template<class RESOURCE> void
 ResourcePool<RESOURCE>::Update() {
     o_assert_dbg(this->isValid);
     this->frameCounter++;
+    Metrics::Set(this->usedSlotsMetric, this->GetNumUsedSlots());
 }
 
 //------------------------------------------------------------------------------
@@ -169,6 +183,7 @@ ResourcePool<RESOURCE>::Assign(const Id& id, ResourceState::Code state) {
     o_assert_dbg(ResourceState::Valid != slot.State);
     slot.State = state;
     slot.StateStartFrame = this->frameCounter;
+    slot.StateStartTime = Clock::Now();
     slot.Id = id;
     return slot;
 }
@@ -184,6 +199,7 @@ ResourcePool<RESOURCE>::Unassign(const Id& id) {
         slot.Id.Invalidate();
         slot.State = ResourceState::Initial;
         slot.StateStartFrame = 0;
+        slot.StateStartTime = TimePoint();
         this->FreeId(id);
     }
     else {
@@ -232,8 +248,13 @@ ResourcePool<RESOURCE>::UpdateState(const Id& id, ResourceState::Code newState)
     auto& slot = this->slots[id.SlotIndex];
     if (id == slot.Id) {
         o_assert_dbg(ResourceState::Initial != slot.State);
+        const TimePoint now = Clock::Now();
+        if ((ResourceState::Pending == slot.State) && (ResourceState::Pending != newState)) {
+            Metrics::Record(this->pendingTimeMetric, now.Since(slot.StateStartTime));
+        }
         slot.State = newState;
         slot.StateStartFrame = this->frameCounter;
+        slot.StateStartTime = now;
     }
     else {
         o_warn("ResourcePool::UpdateState(): id not in pool (type: '%d', slot: '%d')\n", id.Type, id.SlotIndex);
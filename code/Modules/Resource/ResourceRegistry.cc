@@ -102,14 +102,14 @@ ResourceRegistry::Lookup(const Locator& loc) const {
 
 //------------------------------------------------------------------------------
 Array<Id>
-ResourceRegistry::Remove(ResourceLabel label) {
+ResourceRegistry::Remove(ResourceLabel label, Allocator* allocator) {
     o_assert_dbg(this->isValid);
     Array<Id> removed;
+    removed.SetAllocator(allocator);
     removed.Reserve(this->entries.Size() < 256 ? this->entries.Size() : 256);
     
     // for each entry where id.label matches label (from behind
     // because matching entries will be removed)
-    // FIXME: this can be slow if many resource are live!
     int entryIndex = this->entries.Size() - 1;
     for (; entryIndex >= 0; entryIndex--) {
         if ((ResourceLabel::All == label) || (this->entries[entryIndex].label == label)) {
@@ -124,20 +124,12 @@ ResourceRegistry::Remove(ResourceLabel label) {
                 this->locatorIndexMap.Erase(loc);
             }
             
-            // fixup the index maps (see elementBuffer)
-            const int swappedIndex = this->entries.Size();
-            if (entryIndex != swappedIndex) {
-                for (auto& elm : this->idIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
-                }
-                for (auto& elm : this->locatorIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
+            // fixup the index maps (the last entry has been moved to entryIndex)
+            if (entryIndex != this->entries.Size()) {
+                const Entry& swapped = this->entries[entryIndex];
+                this->idIndexMap[swapped.id] = entryIndex;
+                if (swapped.locator.IsShared()) {
+                    this->locatorIndexMap[swapped.locator] = entryIndex;
                 }
             }
             
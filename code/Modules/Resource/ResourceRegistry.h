@@ -9,7 +9,7 @@
 #include "Resource/Locator.h"
 #include "Resource/ResourceLabel.h"
 #include "Core/Containers/Array.h"
-#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
 
 namespace Oryol {
     
@@ -29,8 +29,8 @@ public:
     void Add(const Locator& loc, Id id, ResourceLabel label);
     /// lookup resource Id by locator
     Id Lookup(const Locator& loc) const;
-    /// remove all resource matching label from registry, returns removed Ids
-    Array<Id> Remove(ResourceLabel label);
+    /// remove all resource matching label from registry, returns removed Ids (in allocator's memory if not nullptr)
+    Array<Id> Remove(ResourceLabel label, Allocator* allocator = nullptr);
     
     /// check if resource is in registry
     bool Contains(Id id) const;
@@ -67,7 +67,7 @@ public:
     
     bool isValid = false;
     Array<Entry> entries;
-    Map<Locator, int> locatorIndexMap;
-    Map<Id, int> idIndexMap;
+    HashMap<Locator, int> locatorIndexMap;
+    HashMap<Id, int> idIndexMap;
 };
 } // namespace Oryol
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Resource/ResourceRegistry.h"
+#include "Core/Memory/FrameArena.h"
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -74,5 +75,15 @@ TEST(ResourceRegistryTest) {
     CHECK(removed.Size() == 1);
     CHECK(reg.GetNumResources() == 0);
 
+    // the removed ids can be allocated from a frame arena
+    FrameArena arena(1024);
+    reg.Add(blaLoc, blaId, 126);
+    reg.Add(blobLoc, blobId, 126);
+    Array<Id> arenaRemoved = reg.Remove(126, &arena);
+    CHECK(arenaRemoved.GetAllocator() == &arena);
+    CHECK(arena.Owns(&arenaRemoved[0]));
+    CHECK(arenaRemoved.Size() == 2);
+    CHECK(reg.GetNumResources() == 0);
+
     reg.Discard();
 }
@@ -10,8 +10,11 @@ endif()
 
 # cmake options
 option(ORYOL_SAMPLES "Build Oryol samples" ON)
+option(ORYOL_BENCHMARKS "Build Oryol benchmarks" OFF)
 set(ORYOL_SAMPLE_URL "http://floooh.github.com/oryol/data/" CACHE STRING "Sample data URL")
 option(ORYOL_DEBUG_SHADERS "Enable/disable debug info for shaders" OFF)
+option(ORYOL_MEMORY_TRACKING "Track memory allocations by category and thread" OFF)
+option(ORYOL_TRACE_JSON "Record o_trace events and write Chrome Trace Event JSON" OFF)
 if (FIPS_MACOS OR FIPS_LINUX OR FIPS_ANDROID)
     option(ORYOL_USE_LIBCURL "Use libcurl instead of native APIs" ON)
 else() 
@@ -22,6 +25,16 @@ if (ORYOL_USE_LIBCURL)
     add_definitions(-DORYOL_USE_LIBCURL=1)
 endif()
 
+# memory tracking enabled?
+if (ORYOL_MEMORY_TRACKING)
+    add_definitions(-DORYOL_MEMORY_TRACKING=1)
+endif()
+
+# built-in trace recorder enabled?
+if (ORYOL_TRACE_JSON)
+    add_definitions(-DORYOL_TRACE_JSON=1)
+endif()
+
 # profiling enabled?
 if (FIPS_PROFILING)
     add_definitions(-DORYOL_PROFILING=1)